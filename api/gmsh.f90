@@ -229,6 +229,8 @@ module gmsh
         gmshViewCombine
     procedure, nopass :: probe => &
         gmshViewProbe
+    procedure, nopass :: probeMany => &
+        gmshViewProbeMany
     procedure, nopass :: write => &
         gmshViewWrite
     procedure, nopass :: setVisibilityPerWindow => &
@@ -6525,30 +6527,48 @@ module gmsh
          ierr_=ierr)
   end subroutine gmshModelMeshReorderElements
 
-  !> Renumber the node tags in a continuous sequence.
-  subroutine gmshModelMeshRenumberNodes(ierr)
+  !> Renumber the node tags in a continuous sequence. The nodes are numbered in
+  !! the order of the entities if `method' is "Simple", or following the "RCMK"
+  !! (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph"
+  !! (element-to-node graph traversal) orderings. If `method' is empty, the
+  !! ordering is given by the `Mesh.RenumberAlgorithm' option.
+  subroutine gmshModelMeshRenumberNodes(method, &
+                                        ierr)
     interface
-    subroutine C_API(ierr_) &
+    subroutine C_API(method, &
+                     ierr_) &
       bind(C, name="gmshModelMeshRenumberNodes")
       use, intrinsic :: iso_c_binding
+      character(len=1, kind=c_char), dimension(*), intent(in), optional :: method
       integer(c_int), intent(out), optional :: ierr_
     end subroutine C_API
     end interface
+    character(len=*), intent(in), optional :: method
     integer(c_int), intent(out), optional :: ierr
-    call C_API(ierr_=ierr)
+    call C_API(method=istring_(optval_c_str("", method)), &
+         ierr_=ierr)
   end subroutine gmshModelMeshRenumberNodes
 
-  !> Renumber the element tags in a continuous sequence.
-  subroutine gmshModelMeshRenumberElements(ierr)
+  !> Renumber the element tags in a continuous sequence. The elements are
+  !! numbered in the order of the entities if `method' is "Simple", or following
+  !! the "RCMK" (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or
+  !! "ElementGraph" (element-to-node graph traversal) orderings. If `method' is
+  !! empty, the ordering is given by the `Mesh.RenumberAlgorithm' option.
+  subroutine gmshModelMeshRenumberElements(method, &
+                                           ierr)
     interface
-    subroutine C_API(ierr_) &
+    subroutine C_API(method, &
+                     ierr_) &
       bind(C, name="gmshModelMeshRenumberElements")
       use, intrinsic :: iso_c_binding
+      character(len=1, kind=c_char), dimension(*), intent(in), optional :: method
       integer(c_int), intent(out), optional :: ierr_
     end subroutine C_API
     end interface
+    character(len=*), intent(in), optional :: method
     integer(c_int), intent(out), optional :: ierr
-    call C_API(ierr_=ierr)
+    call C_API(method=istring_(optval_c_str("", method)), &
+         ierr_=ierr)
   end subroutine gmshModelMeshRenumberElements
 
   !> Set the meshes of the entities of dimension `dim' and tag `tags' as
@@ -13553,6 +13573,91 @@ module gmsh
       api_values_n_)
   end subroutine gmshViewProbe
 
+  !> Probe the view `tag' at several points, given by their coordinates `coord'
+  !! (concatenated x, y, z coordinates). The points are searched concurrently,
+  !! in spatial structures that are built on the first call and reused by later
+  !! calls. Return in `values' the same number of values for each point: the
+  !! values for all steps (or for step `step' if `step' is positive), with
+  !! `numComp' components (or with the number of components of the first kind of
+  !! field found in the view, scalar, vector or tensor, if `numComp' is not 1, 3
+  !! or 9), and for each component the 3 components of the gradient if
+  !! `gradient' is set. Return in `distances' the distance to the match for each
+  !! point, or -1 if no match was found (the values are then set to zero).
+  !! `distanceMax' and `dim' have the same meaning as in `probe'.
+  subroutine gmshViewProbeMany(tag, &
+                               coord, &
+                               values, &
+                               distances, &
+                               step, &
+                               numComp, &
+                               gradient, &
+                               distanceMax, &
+                               dim, &
+                               ierr)
+    interface
+    subroutine C_API(tag, &
+                     api_coord_, &
+                     api_coord_n_, &
+                     api_values_, &
+                     api_values_n_, &
+                     api_distances_, &
+                     api_distances_n_, &
+                     step, &
+                     numComp, &
+                     gradient, &
+                     distanceMax, &
+                     dim, &
+                     ierr_) &
+      bind(C, name="gmshViewProbeMany")
+      use, intrinsic :: iso_c_binding
+      integer(c_int), value, intent(in) :: tag
+      real(c_double), dimension(*) :: api_coord_
+      integer(c_size_t), value, intent(in) :: api_coord_n_
+      type(c_ptr), intent(out) :: api_values_
+      integer(c_size_t) :: api_values_n_
+      type(c_ptr), intent(out) :: api_distances_
+      integer(c_size_t) :: api_distances_n_
+      integer(c_int), value, intent(in) :: step
+      integer(c_int), value, intent(in) :: numComp
+      integer(c_int), value, intent(in) :: gradient
+      real(c_double), value, intent(in) :: distanceMax
+      integer(c_int), value, intent(in) :: dim
+      integer(c_int), intent(out), optional :: ierr_
+    end subroutine C_API
+    end interface
+    integer, intent(in) :: tag
+    real(c_double), dimension(:), intent(in) :: coord
+    real(c_double), dimension(:), allocatable, intent(out) :: values
+    real(c_double), dimension(:), allocatable, intent(out) :: distances
+    integer, intent(in), optional :: step
+    integer, intent(in), optional :: numComp
+    logical, intent(in), optional :: gradient
+    real(c_double), intent(in), optional :: distanceMax
+    integer, intent(in), optional :: dim
+    integer(c_int), intent(out), optional :: ierr
+    type(c_ptr) :: api_values_
+    integer(c_size_t) :: api_values_n_
+    type(c_ptr) :: api_distances_
+    integer(c_size_t) :: api_distances_n_
+    call C_API(tag=int(tag, c_int), &
+         api_coord_=coord, &
+         api_coord_n_=size_gmsh_double(coord), &
+         api_values_=api_values_, &
+         api_values_n_=api_values_n_, &
+         api_distances_=api_distances_, &
+         api_distances_n_=api_distances_n_, &
+         step=optval_c_int(-1, step), &
+         numComp=optval_c_int(-1, numComp), &
+         gradient=optval_c_bool(.false., gradient), &
+         distanceMax=optval_c_double(0., distanceMax), &
+         dim=optval_c_int(-1, dim), &
+         ierr_=ierr)
+    values = ovectordouble_(api_values_, &
+      api_values_n_)
+    distances = ovectordouble_(api_distances_, &
+      api_distances_n_)
+  end subroutine gmshViewProbeMany
+
   !> Write the view to a file `fileName'. The export format is determined by the
   !! file extension. Append to the file if `append' is set.
   subroutine gmshViewWrite(tag, &
@@ -1607,13 +1607,21 @@ namespace gmsh { // Top-level functions
 
       // gmsh::model::mesh::renumberNodes
       //
-      // Renumber the node tags in a continuous sequence.
-      GMSH_API void renumberNodes();
+      // Renumber the node tags in a continuous sequence. The nodes are numbered in
+      // the order of the entities if `method' is "Simple", or following the "RCMK"
+      // (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph"
+      // (element-to-node graph traversal) orderings. If `method' is empty, the
+      // ordering is given by the `Mesh.RenumberAlgorithm' option.
+      GMSH_API void renumberNodes(const std::string & method = "");
 
       // gmsh::model::mesh::renumberElements
       //
-      // Renumber the element tags in a continuous sequence.
-      GMSH_API void renumberElements();
+      // Renumber the element tags in a continuous sequence. The elements are
+      // numbered in the order of the entities if `method' is "Simple", or
+      // following the "RCMK" (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or
+      // "ElementGraph" (element-to-node graph traversal) orderings. If `method' is
+      // empty, the ordering is given by the `Mesh.RenumberAlgorithm' option.
+      GMSH_API void renumberElements(const std::string & method = "");
 
       // gmsh::model::mesh::setPeriodic
       //
@@ -3539,6 +3547,29 @@ namespace gmsh { // Top-level functions
                         const std::vector<double> & zElemCoord = std::vector<double>(),
                         const int dim = -1);
 
+    // gmsh::view::probeMany
+    //
+    // Probe the view `tag' at several points, given by their coordinates `coord'
+    // (concatenated x, y, z coordinates). The points are searched concurrently, in
+    // spatial structures that are built on the first call and reused by later
+    // calls. Return in `values' the same number of values for each point: the
+    // values for all steps (or for step `step' if `step' is positive), with
+    // `numComp' components (or with the number of components of the first kind of
+    // field found in the view, scalar, vector or tensor, if `numComp' is not 1, 3
+    // or 9), and for each component the 3 components of the gradient if `gradient'
+    // is set. Return in `distances' the distance to the match for each point, or
+    // -1 if no match was found (the values are then set to zero). `distanceMax'
+    // and `dim' have the same meaning as in `probe'.
+    GMSH_API void probeMany(const int tag,
+                            const std::vector<double> & coord,
+                            std::vector<double> & values,
+                            std::vector<double> & distances,
+                            const int step = -1,
+                            const int numComp = -1,
+                            const bool gradient = false,
+                            const double distanceMax = 0.,
+                            const int dim = -1);
+
     // gmsh::view::write
     //
     // Write the view to a file `fileName'. The export format is determined by the
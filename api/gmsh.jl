@@ -3883,30 +3883,44 @@ end
 const reorder_elements = reorderElements
 
 """
-    gmsh.model.mesh.renumberNodes()
+    gmsh.model.mesh.renumberNodes(method = "")
 
-Renumber the node tags in a continuous sequence.
+Renumber the node tags in a continuous sequence. The nodes are numbered in the
+order of the entities if `method` is "Simple", or following the "RCMK" (Reverse
+Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph" (element-to-node
+graph traversal) orderings. If `method` is empty, the ordering is given by the
+`Mesh.RenumberAlgorithm` option.
+
+Types:
+ - `method`: string
 """
-function renumberNodes()
+function renumberNodes(method = "")
     ierr = Ref{Cint}()
     ccall((:gmshModelMeshRenumberNodes, gmsh.lib), Cvoid,
-          (Ptr{Cint},),
-          ierr)
+          (Ptr{Cchar}, Ptr{Cint}),
+          method, ierr)
     ierr[] != 0 && error(gmsh.logger.getLastError())
     return nothing
 end
 const renumber_nodes = renumberNodes
 
 """
-    gmsh.model.mesh.renumberElements()
+    gmsh.model.mesh.renumberElements(method = "")
+
+Renumber the element tags in a continuous sequence. The elements are numbered in
+the order of the entities if `method` is "Simple", or following the "RCMK"
+(Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph" (element-
+to-node graph traversal) orderings. If `method` is empty, the ordering is given
+by the `Mesh.RenumberAlgorithm` option.
 
-Renumber the element tags in a continuous sequence.
+Types:
+ - `method`: string
 """
-function renumberElements()
+function renumberElements(method = "")
     ierr = Ref{Cint}()
     ccall((:gmshModelMeshRenumberElements, gmsh.lib), Cvoid,
-          (Ptr{Cint},),
-          ierr)
+          (Ptr{Cchar}, Ptr{Cint}),
+          method, ierr)
     ierr[] != 0 && error(gmsh.logger.getLastError())
     return nothing
 end
@@ -8369,6 +8383,50 @@ function probe(tag, x, y, z, step = -1, numComp = -1, gradient = false, distance
     return values, api_distance_[]
 end
 
+"""
+    gmsh.view.probeMany(tag, coord, step = -1, numComp = -1, gradient = false, distanceMax = 0., dim = -1)
+
+Probe the view `tag` at several points, given by their coordinates `coord`
+(concatenated x, y, z coordinates). The points are searched concurrently, in
+spatial structures that are built on the first call and reused by later calls.
+Return in `values` the same number of values for each point: the values for all
+steps (or for step `step` if `step` is positive), with `numComp` components (or
+with the number of components of the first kind of field found in the view,
+scalar, vector or tensor, if `numComp` is not 1, 3 or 9), and for each component
+the 3 components of the gradient if `gradient` is set. Return in `distances` the
+distance to the match for each point, or -1 if no match was found (the values
+are then set to zero). `distanceMax` and `dim` have the same meaning as in
+`probe`.
+
+Return `values`, `distances`.
+
+Types:
+ - `tag`: integer
+ - `coord`: vector of doubles
+ - `values`: vector of doubles
+ - `distances`: vector of doubles
+ - `step`: integer
+ - `numComp`: integer
+ - `gradient`: boolean
+ - `distanceMax`: double
+ - `dim`: integer
+"""
+function probeMany(tag, coord, step = -1, numComp = -1, gradient = false, distanceMax = 0., dim = -1)
+    api_values_ = Ref{Ptr{Cdouble}}()
+    api_values_n_ = Ref{Csize_t}()
+    api_distances_ = Ref{Ptr{Cdouble}}()
+    api_distances_n_ = Ref{Csize_t}()
+    ierr = Ref{Cint}()
+    ccall((:gmshViewProbeMany, gmsh.lib), Cvoid,
+          (Cint, Ptr{Cdouble}, Csize_t, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Ptr{Ptr{Cdouble}}, Ptr{Csize_t}, Cint, Cint, Cint, Cdouble, Cint, Ptr{Cint}),
+          tag, convert(Vector{Cdouble}, coord), length(coord), api_values_, api_values_n_, api_distances_, api_distances_n_, step, numComp, gradient, distanceMax, dim, ierr)
+    ierr[] != 0 && error(gmsh.logger.getLastError())
+    values = unsafe_wrap(Array, api_values_[], api_values_n_[], own = true)
+    distances = unsafe_wrap(Array, api_distances_[], api_distances_n_[], own = true)
+    return values, distances
+end
+const probe_many = probeMany
+
 """
     gmsh.view.write(tag, fileName, append = false)
 
@@ -4438,28 +4438,44 @@ class model:
         reorder_elements = reorderElements
 
         @staticmethod
-        def renumberNodes():
+        def renumberNodes(method=""):
             """
-            gmsh.model.mesh.renumberNodes()
+            gmsh.model.mesh.renumberNodes(method="")
 
-            Renumber the node tags in a continuous sequence.
+            Renumber the node tags in a continuous sequence. The nodes are numbered in
+            the order of the entities if `method' is "Simple", or following the "RCMK"
+            (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph"
+            (element-to-node graph traversal) orderings. If `method' is empty, the
+            ordering is given by the `Mesh.RenumberAlgorithm' option.
+
+            Types:
+            - `method': string
             """
             ierr = c_int()
             lib.gmshModelMeshRenumberNodes(
+                c_char_p(method.encode()),
                 byref(ierr))
             if ierr.value != 0:
                 raise Exception(logger.getLastError())
         renumber_nodes = renumberNodes
 
         @staticmethod
-        def renumberElements():
+        def renumberElements(method=""):
             """
-            gmsh.model.mesh.renumberElements()
+            gmsh.model.mesh.renumberElements(method="")
+
+            Renumber the element tags in a continuous sequence. The elements are
+            numbered in the order of the entities if `method' is "Simple", or following
+            the "RCMK" (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or
+            "ElementGraph" (element-to-node graph traversal) orderings. If `method' is
+            empty, the ordering is given by the `Mesh.RenumberAlgorithm' option.
 
-            Renumber the element tags in a continuous sequence.
+            Types:
+            - `method': string
             """
             ierr = c_int()
             lib.gmshModelMeshRenumberElements(
+                c_char_p(method.encode()),
                 byref(ierr))
             if ierr.value != 0:
                 raise Exception(logger.getLastError())
@@ -9449,6 +9465,58 @@ class view:
             _ovectordouble(api_values_, api_values_n_.value),
             api_distance_.value)
 
+    @staticmethod
+    def probeMany(tag, coord, step=-1, numComp=-1, gradient=False, distanceMax=0., dim=-1):
+        """
+        gmsh.view.probeMany(tag, coord, step=-1, numComp=-1, gradient=False, distanceMax=0., dim=-1)
+
+        Probe the view `tag' at several points, given by their coordinates `coord'
+        (concatenated x, y, z coordinates). The points are searched concurrently,
+        in spatial structures that are built on the first call and reused by later
+        calls. Return in `values' the same number of values for each point: the
+        values for all steps (or for step `step' if `step' is positive), with
+        `numComp' components (or with the number of components of the first kind of
+        field found in the view, scalar, vector or tensor, if `numComp' is not 1, 3
+        or 9), and for each component the 3 components of the gradient if
+        `gradient' is set. Return in `distances' the distance to the match for each
+        point, or -1 if no match was found (the values are then set to zero).
+        `distanceMax' and `dim' have the same meaning as in `probe'.
+
+        Return `values', `distances'.
+
+        Types:
+        - `tag': integer
+        - `coord': vector of doubles
+        - `values': vector of doubles
+        - `distances': vector of doubles
+        - `step': integer
+        - `numComp': integer
+        - `gradient': boolean
+        - `distanceMax': double
+        - `dim': integer
+        """
+        api_coord_, api_coord_n_ = _ivectordouble(coord)
+        api_values_, api_values_n_ = POINTER(c_double)(), c_size_t()
+        api_distances_, api_distances_n_ = POINTER(c_double)(), c_size_t()
+        ierr = c_int()
+        lib.gmshViewProbeMany(
+            c_int(tag),
+            api_coord_, api_coord_n_,
+            byref(api_values_), byref(api_values_n_),
+            byref(api_distances_), byref(api_distances_n_),
+            c_int(step),
+            c_int(numComp),
+            c_int(bool(gradient)),
+            c_double(distanceMax),
+            c_int(dim),
+            byref(ierr))
+        if ierr.value != 0:
+            raise Exception(logger.getLastError())
+        return (
+            _ovectordouble(api_values_, api_values_n_.value),
+            _ovectordouble(api_distances_, api_distances_n_.value))
+    probe_many = probeMany
+
     @staticmethod
     def write(tag, fileName, append=False):
         """
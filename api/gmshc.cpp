@@ -1098,23 +1098,6 @@ GMSH_API void gmshModelMeshAffineTransform(const double * affineTransform, const
   }
 }
 
-GMSH_API void gmshModelMeshGetNodes(size_t ** nodeTags, size_t * nodeTags_n, double ** coord, size_t * coord_n, double ** parametricCoord, size_t * parametricCoord_n, const int dim, const int tag, const int includeBoundary, const int returnParametricCoord, int * ierr)
-{
-  if(ierr) *ierr = 0;
-  try {
-    std::vector<std::size_t> api_nodeTags_;
-    std::vector<double> api_coord_;
-    std::vector<double> api_parametricCoord_;
-    gmsh::model::mesh::getNodes(api_nodeTags_, api_coord_, api_parametricCoord_, dim, tag, includeBoundary, returnParametricCoord);
-    vector2ptr(api_nodeTags_, nodeTags, nodeTags_n);
-    vector2ptr(api_coord_, coord, coord_n);
-    vector2ptr(api_parametricCoord_, parametricCoord, parametricCoord_n);
-  }
-  catch(...){
-    if(ierr) *ierr = 1;
-  }
-}
-
 GMSH_API void gmshModelMeshGetNodesByElementType(const int elementType, size_t ** nodeTags, size_t * nodeTags_n, double ** coord, size_t * coord_n, double ** parametricCoord, size_t * parametricCoord_n, const int tag, const int returnParametricCoord, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -1352,21 +1335,6 @@ GMSH_API void gmshModelMeshGetElementProperties(const int elementType, char ** e
   }
 }
 
-GMSH_API void gmshModelMeshGetElementsByType(const int elementType, size_t ** elementTags, size_t * elementTags_n, size_t ** nodeTags, size_t * nodeTags_n, const int tag, const size_t task, const size_t numTasks, int * ierr)
-{
-  if(ierr) *ierr = 0;
-  try {
-    std::vector<std::size_t> api_elementTags_;
-    std::vector<std::size_t> api_nodeTags_;
-    gmsh::model::mesh::getElementsByType(elementType, api_elementTags_, api_nodeTags_, tag, task, numTasks);
-    vector2ptr(api_elementTags_, elementTags, elementTags_n);
-    vector2ptr(api_nodeTags_, nodeTags, nodeTags_n);
-  }
-  catch(...){
-    if(ierr) *ierr = 1;
-  }
-}
-
 GMSH_API void gmshModelMeshGetMaxElementTag(size_t * maxTag, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -1453,24 +1421,6 @@ GMSH_API void gmshModelMeshGetIntegrationPoints(const int elementType, const cha
   }
 }
 
-GMSH_API void gmshModelMeshGetJacobians(const int elementType, const double * localCoord, const size_t localCoord_n, double ** jacobians, size_t * jacobians_n, double ** determinants, size_t * determinants_n, double ** coord, size_t * coord_n, const int tag, const size_t task, const size_t numTasks, int * ierr)
-{
-  if(ierr) *ierr = 0;
-  try {
-    std::vector<double> api_localCoord_(localCoord, localCoord + localCoord_n);
-    std::vector<double> api_jacobians_;
-    std::vector<double> api_determinants_;
-    std::vector<double> api_coord_;
-    gmsh::model::mesh::getJacobians(elementType, api_localCoord_, api_jacobians_, api_determinants_, api_coord_, tag, task, numTasks);
-    vector2ptr(api_jacobians_, jacobians, jacobians_n);
-    vector2ptr(api_determinants_, determinants, determinants_n);
-    vector2ptr(api_coord_, coord, coord_n);
-  }
-  catch(...){
-    if(ierr) *ierr = 1;
-  }
-}
-
 GMSH_API void gmshModelMeshPreallocateJacobians(const int elementType, const int numEvaluationPoints, const int allocateJacobians, const int allocateDeterminants, const int allocateCoord, double ** jacobians, size_t * jacobians_n, double ** determinants, size_t * determinants_n, double ** coord, size_t * coord_n, const int tag, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -2087,22 +2037,22 @@ GMSH_API void gmshModelMeshReorderElements(const int elementType, const int tag,
   }
 }
 
-GMSH_API void gmshModelMeshRenumberNodes(int * ierr)
+GMSH_API void gmshModelMeshRenumberNodes(const char * method, int * ierr)
 {
   if(ierr) *ierr = 0;
   try {
-    gmsh::model::mesh::renumberNodes();
+    gmsh::model::mesh::renumberNodes(method);
   }
   catch(...){
     if(ierr) *ierr = 1;
   }
 }
 
-GMSH_API void gmshModelMeshRenumberElements(int * ierr)
+GMSH_API void gmshModelMeshRenumberElements(const char * method, int * ierr)
 {
   if(ierr) *ierr = 0;
   try {
-    gmsh::model::mesh::renumberElements();
+    gmsh::model::mesh::renumberElements(method);
   }
   catch(...){
     if(ierr) *ierr = 1;
@@ -4206,23 +4156,6 @@ GMSH_API void gmshViewAddHomogeneousModelData(const int tag, const int step, con
   }
 }
 
-GMSH_API void gmshViewGetHomogeneousModelData(const int tag, const int step, char ** dataType, size_t ** tags, size_t * tags_n, double ** data, size_t * data_n, double * time, int * numComponents, int * ierr)
-{
-  if(ierr) *ierr = 0;
-  try {
-    std::string api_dataType_;
-    std::vector<std::size_t> api_tags_;
-    std::vector<double> api_data_;
-    gmsh::view::getHomogeneousModelData(tag, step, api_dataType_, api_tags_, api_data_, *time, *numComponents);
-    *dataType = strdup(api_dataType_.c_str());
-    vector2ptr(api_tags_, tags, tags_n);
-    vector2ptr(api_data_, data, data_n);
-  }
-  catch(...){
-    if(ierr) *ierr = 1;
-  }
-}
-
 GMSH_API void gmshViewAddListData(const int tag, const char * dataType, const int numEle, const double * data, const size_t data_n, int * ierr)
 {
   if(ierr) *ierr = 0;
@@ -4338,6 +4271,22 @@ GMSH_API void gmshViewProbe(const int tag, const double x, const double y, const
   }
 }
 
+GMSH_API void gmshViewProbeMany(const int tag, const double * coord, const size_t coord_n, double ** values, size_t * values_n, double ** distances, size_t * distances_n, const int step, const int numComp, const int gradient, const double distanceMax, const int dim, int * ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    std::vector<double> api_coord_(coord, coord + coord_n);
+    std::vector<double> api_values_;
+    std::vector<double> api_distances_;
+    gmsh::view::probeMany(tag, api_coord_, api_values_, api_distances_, step, numComp, gradient, distanceMax, dim);
+    vector2ptr(api_values_, values, values_n);
+    vector2ptr(api_distances_, distances, distances_n);
+  }
+  catch(...){
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmshViewWrite(const int tag, const char * fileName, const int append, int * ierr)
 {
   if(ierr) *ierr = 0;
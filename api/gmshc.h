@@ -1420,11 +1420,21 @@ GMSH_API void gmshModelMeshReorderElements(const int elementType,
                                            const size_t * ordering, const size_t ordering_n,
                                            int * ierr);
 
-/* Renumber the node tags in a continuous sequence. */
-GMSH_API void gmshModelMeshRenumberNodes(int * ierr);
+/* Renumber the node tags in a continuous sequence. The nodes are numbered in
+ * the order of the entities if `method' is "Simple", or following the "RCMK"
+ * (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or "ElementGraph"
+ * (element-to-node graph traversal) orderings. If `method' is empty, the
+ * ordering is given by the `Mesh.RenumberAlgorithm' option. */
+GMSH_API void gmshModelMeshRenumberNodes(const char * method,
+                                         int * ierr);
 
-/* Renumber the element tags in a continuous sequence. */
-GMSH_API void gmshModelMeshRenumberElements(int * ierr);
+/* Renumber the element tags in a continuous sequence. The elements are
+ * numbered in the order of the entities if `method' is "Simple", or following
+ * the "RCMK" (Reverse Cuthill-McKee), "Hilbert" (Hilbert curve) or
+ * "ElementGraph" (element-to-node graph traversal) orderings. If `method' is
+ * empty, the ordering is given by the `Mesh.RenumberAlgorithm' option. */
+GMSH_API void gmshModelMeshRenumberElements(const char * method,
+                                            int * ierr);
 
 /* Set the meshes of the entities of dimension `dim' and tag `tags' as
  * periodic copies of the meshes of entities `tagsMaster', using the affine
@@ -3154,6 +3164,28 @@ GMSH_API void gmshViewProbe(const int tag,
                             const int dim,
                             int * ierr);
 
+/* Probe the view `tag' at several points, given by their coordinates `coord'
+ * (concatenated x, y, z coordinates). The points are searched concurrently,
+ * in spatial structures that are built on the first call and reused by later
+ * calls. Return in `values' the same number of values for each point: the
+ * values for all steps (or for step `step' if `step' is positive), with
+ * `numComp' components (or with the number of components of the first kind of
+ * field found in the view, scalar, vector or tensor, if `numComp' is not 1, 3
+ * or 9), and for each component the 3 components of the gradient if
+ * `gradient' is set. Return in `distances' the distance to the match for each
+ * point, or -1 if no match was found (the values are then set to zero).
+ * `distanceMax' and `dim' have the same meaning as in `probe'. */
+GMSH_API void gmshViewProbeMany(const int tag,
+                                const double * coord, const size_t coord_n,
+                                double ** values, size_t * values_n,
+                                double ** distances, size_t * distances_n,
+                                const int step,
+                                const int numComp,
+                                const int gradient,
+                                const double distanceMax,
+                                const int dim,
+                                int * ierr);
+
 /* Write the view to a file `fileName'. The export format is determined by the
  * file extension. Append to the file if `append' is set. */
 GMSH_API void gmshViewWrite(const int tag,
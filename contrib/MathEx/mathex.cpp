@@ -633,7 +633,7 @@
        double mathex::eval()
       //  Eval the parsed stack and return
       {
-         static vector <double> x; // suppose that eval does not eval
+         vector <double> x; // not static, so that eval() is reentrant
          evalstack.clear();
 
          if(status == notparsed) parse();
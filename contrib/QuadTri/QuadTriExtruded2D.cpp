@@ -338,7 +338,7 @@ int IsValidQuadToTriTop(GFace *face, int *quadToTri, bool *detectQuadToTriTop)
 // return 1 if success, return 0 if failed.
 // Added 2010-12-20
 static int MeshQuadToTriTopUnstructured(GFace *from, GFace *to,
-                                        MVertexRTree &pos)
+                                        MVertexHashGrid &pos)
 {
   // if the source is all triangles, then just return 1.
   if(from->triangles.size() && !from->quadrangles.size()) return 1;
@@ -350,8 +350,8 @@ static int MeshQuadToTriTopUnstructured(GFace *from, GFace *to,
   if(!from->triangles.size() && !from->quadrangles.size()) return 0;
 
   // make set of source edge vertices
-  MVertexRTree pos_src_edge(CTX::instance()->geom.tolerance *
-                            CTX::instance()->lc);
+  MVertexHashGrid pos_src_edge(CTX::instance()->geom.tolerance *
+                               CTX::instance()->lc);
   QuadToTriInsertFaceEdgeVertices(from, pos_src_edge);
 
   // Loop through all the quads and make the triangles with diagonals running
@@ -417,7 +417,7 @@ static int MeshQuadToTriTopUnstructured(GFace *from, GFace *to,
 //       'GFace *to' is the top surface to mesh,
 //       'from' is the source surface
 //       'pos' is a tree of vertex positions for the top surface.
-int MeshQuadToTriTopSurface(GFace *from, GFace *to, MVertexRTree &pos)
+int MeshQuadToTriTopSurface(GFace *from, GFace *to, MVertexHashGrid &pos)
 {
   if(!to->meshAttributes.extrude || !to->meshAttributes.extrude->mesh.QuadToTri)
     return 0;
@@ -451,8 +451,8 @@ int MeshQuadToTriTopSurface(GFace *from, GFace *to, MVertexRTree &pos)
   // number.
 
   if(!is_addverts) {
-    MVertexRTree pos_src_edge(CTX::instance()->geom.tolerance *
-                              CTX::instance()->lc);
+    MVertexHashGrid pos_src_edge(CTX::instance()->geom.tolerance *
+                                 CTX::instance()->lc);
     QuadToTriInsertFaceEdgeVertices(from, pos_src_edge);
 
     // loop through each element source quadrangle and extrude
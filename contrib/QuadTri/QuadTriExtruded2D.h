@@ -55,6 +55,6 @@ int IsValidQuadToTriTop(GFace *face, int *quadToTri, bool *detectQuadToTriTop);
 // if it is given a non-quadToTri extrusion or if it fails.  Args: 'GFace *to'
 // is the top surface to mesh, 'from' is the source surface, 'pos' is a tree
 // of vertex positions for the top surface.
-int MeshQuadToTriTopSurface(GFace *from, GFace *to, MVertexRTree &pos);
+int MeshQuadToTriTopSurface(GFace *from, GFace *to, MVertexHashGrid &pos);
 
 #endif
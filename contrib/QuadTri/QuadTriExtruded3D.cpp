@@ -118,7 +118,7 @@ static void deleteEdge(MVertex *v1, MVertex *v2,
 static std::vector<MVertex *>
 getExtrudedLateralVertices(MVertex *v0, MVertex *v1, GEntity *entity,
                            unsigned int j, unsigned int k,
-                           ExtrudeParams *loop_ep, MVertexRTree &pos)
+                           ExtrudeParams *loop_ep, MVertexHashGrid &pos)
 {
   std::vector<MVertex *> verts;
   double x[4] = {v0->x(), v1->x(), v0->x(), v1->x()};
@@ -147,7 +147,7 @@ getExtrudedLateralVertices(MVertex *v0, MVertex *v1, GEntity *entity,
 // 2010-01-26
 static int get2DExtrudedVertices(MElement *elem, ExtrudeParams *ep,
                                  unsigned int j, unsigned int k,
-                                 MVertexRTree &pos,
+                                 MVertexHashGrid &pos,
                                  std::vector<MVertex *> &verts)
 {
   std::vector<MVertex *> source_verts;
@@ -178,7 +178,8 @@ static int get2DExtrudedVertices(MElement *elem, ExtrudeParams *ep,
 // Copied from meshGRegionExtruded.cpp, By Geuzaine, Remacle...  Extrudes a set
 // of source vertices in 3D added 2010-01-18
 static int getExtrudedVertices(MElement *ele, ExtrudeParams *ep, int j, int k,
-                               MVertexRTree &pos, std::vector<MVertex *> &verts)
+                               MVertexHashGrid &pos,
+                               std::vector<MVertex *> &verts)
 {
   double x[8], y[8], z[8];
   int n = ele->getNumVertices();
@@ -2314,7 +2315,7 @@ static int ExtrudeDiags(
     &problems_new,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   if(!loop_ep || !loop_ep->mesh.QuadToTri || !loop_ep->mesh.ExtrudeMesh) {
     Msg::Error("In ExtrudeDiags(), invalid extrusion "
@@ -2419,7 +2420,8 @@ static int ExtrudeDiags(
 static bool QuadToTriGetRegionDiags(
   GRegion *gr, std::set<std::pair<MVertex *, MVertex *> > &quadToTri_edges,
   std::set<std::pair<MVertex *, MVertex *> > &forbidden_edges,
-  std::set<std::pair<MVertex *, MVertex *> > &lat_tri_diags, MVertexRTree &pos)
+  std::set<std::pair<MVertex *, MVertex *> > &lat_tri_diags,
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -2730,7 +2732,7 @@ static int makeEdgesForElemsWithAllVertsOnBnd(
   std::set<std::pair<MVertex *, MVertex *> > &forbidden_edges,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -2768,8 +2770,8 @@ static int makeEdgesForElemsWithAllVertsOnBnd(
   }
 
   // find edge verts of source face
-  MVertexRTree pos_src_edge(CTX::instance()->geom.tolerance *
-                            CTX::instance()->lc);
+  MVertexHashGrid pos_src_edge(CTX::instance()->geom.tolerance *
+                               CTX::instance()->lc);
   QuadToTriInsertFaceEdgeVertices(reg_source, pos_src_edge);
 
   // while Loop to diagonalize 3-boundary point triangles and 4-boundary point
@@ -2995,7 +2997,7 @@ static int makeEdgesForOtherBndPrisms(
   std::set<std::pair<MVertex *, MVertex *> > &forbidden_edges,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -3126,7 +3128,7 @@ static int makeEdgesForOtherBndHexa(
   std::set<std::pair<MVertex *, MVertex *> > &forbidden_edges,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   // Edge creation for extruded quadrangles with some but not all vertices on a
   // boundary. (draw from boundaries up toward interior) If no lat_tri_diags,
@@ -3481,7 +3483,7 @@ static int makeEdgesForElemsTouchPivotVert(
   std::set<std::pair<MVertex *, MVertex *> > &quadToTri_edges,
   std::set<std::pair<MVertex *, MVertex *> > &lat_tri_diags,
   std::set<std::pair<MVertex *, MVertex *> > &forbidden_edges,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   //  Draw diagonals toward the "pivot vertex" of a hexahedron whose source quad
   //  has only one vertex on a lateral boundary. Actually, this is only done in
@@ -3734,7 +3736,7 @@ static int makeEdgesForElemsTouchPivotVert(
 static int makeEdgesInternalTopLayer(
   GRegion *gr, bool is_addverts, CategorizedSourceElements &cat_src_elems,
   std::set<std::pair<MVertex *, MVertex *> > &quadToTri_edges,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -3829,7 +3831,7 @@ int QuadToTriEdgeGenerator(
   std::set<std::pair<MVertex *, MVertex *> > &lat_tri_diags,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -4127,7 +4129,7 @@ static bool addBodyCenteredVertices(
   std::set<std::pair<MVertex *, MVertex *> > &quadToTri_edges,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  bool is_addverts, unsigned int lat_tri_diags_size, MVertexRTree &pos)
+  bool is_addverts, unsigned int lat_tri_diags_size, MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
   if(!ep || !ep->mesh.ExtrudeMesh || !ep->mesh.QuadToTri) return false;
@@ -4287,7 +4289,7 @@ static bool addBodyCenteredVertices(
 static void MeshWithInternalVertex(GRegion *to, MElement *source,
                                    std::vector<MVertex *> v,
                                    std::vector<int> n1, std::vector<int> n2,
-                                   MVertexRTree &pos)
+                                   MVertexHashGrid &pos)
 {
   int v_size = v.size();
   int n_lat_tmp;
@@ -4382,7 +4384,7 @@ static inline void QuadToTriPriPyrTet(
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems_new,
   unsigned int lat_tri_diags_size, bool bnd_elem, bool is_addverts,
-  bool diag_search, MVertexRTree &pos)
+  bool diag_search, MVertexHashGrid &pos)
 {
   int dup[3];
   int m = 0;
@@ -5387,7 +5389,7 @@ static inline void QuadToTriHexPri(
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems_new,
   unsigned int lat_tri_diags_size, bool bnd_elem, bool is_addverts,
-  bool diag_search, MVertexRTree &pos)
+  bool diag_search, MVertexHashGrid &pos)
 {
   int dup[4];
   int m = 0;
@@ -5565,7 +5567,7 @@ static void listBodyCenteredVertices(
     *problems,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     *problems_new,
-  MVertexRTree *pos)
+  MVertexHashGrid *pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
 
@@ -5644,7 +5646,7 @@ bool QuadToTriCreateElements(
   std::set<std::pair<MVertex *, MVertex *> > &lat_tri_diags,
   std::map<MElement *, std::set<std::pair<unsigned int, unsigned int> > >
     &problems,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
   if(!ep || !ep->mesh.ExtrudeMesh || !ep->mesh.QuadToTri) return false;
@@ -5865,7 +5867,7 @@ bool QuadToTriCreateElements(
 
 // Mesh QuadToTri region from extrudeMesh() in meshGRegionExtruded.cpp
 // Added 04/08/2011:
-int meshQuadToTriRegion(GRegion *gr, MVertexRTree &pos)
+int meshQuadToTriRegion(GRegion *gr, MVertexHashGrid &pos)
 {
   // Perform some checks to see if this is a valid QuadToTri region.
   // If so, a decision has to be made: if this surface is NOT laterally adjacent
@@ -5949,7 +5951,7 @@ int meshQuadToTriRegion(GRegion *gr, MVertexRTree &pos)
 // command is called. Added 04/08/11.
 int meshQuadToTriRegionAfterGlobalSubdivide(
   GRegion *gr, std::set<std::pair<MVertex *, MVertex *> > *edges,
-  MVertexRTree &pos)
+  MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
 
@@ -46,13 +46,13 @@ bool IsValidQuadToTriRegion(GRegion *region, bool *allNonGlobalSharedLaterals);
 
 // Mesh QuadToTri region from extrudeMesh() from meshGRegionExtruded.cpp.  Added
 // 04/08/2011:
-int meshQuadToTriRegion(GRegion *gr, MVertexRTree &pos);
+int meshQuadToTriRegion(GRegion *gr, MVertexHashGrid &pos);
 
 // The function that is called from meshGRegionExtruded.cpp to mesh QuadToTri
 // regions that are adjacent to subdivided regions, after the global Subdivide
 // command is called.  Added 04/08/11.
 int meshQuadToTriRegionAfterGlobalSubdivide(
   GRegion *gr, std::set<std::pair<MVertex *, MVertex *> > *edges,
-  MVertexRTree &pos);
+  MVertexHashGrid &pos);
 
 #endif
@@ -168,8 +168,8 @@ void ReplaceBndQuadsInFace(GFace *face)
     is_struct = true;
   GFace *root_face = findRootSourceFaceForFace(face);
   if(root_face == face) {
-    MVertexRTree pos_src_edge(CTX::instance()->geom.tolerance *
-                              CTX::instance()->lc);
+    MVertexHashGrid pos_src_edge(CTX::instance()->geom.tolerance *
+                                 CTX::instance()->lc);
     QuadToTriInsertFaceEdgeVertices(face, pos_src_edge);
     std::vector<MQuadrangle *> quads2;
     // loop through source quads, if on boundary, delete them
@@ -228,7 +228,8 @@ void ReplaceBndQuadsInFace(GFace *face)
 
 // Insert all vertices on a region's source edge, including corners, into
 // pos_src_edge set.  Added 2010-01-09
-void QuadToTriInsertSourceEdgeVertices(GRegion *gr, MVertexRTree &pos_src_edge)
+void QuadToTriInsertSourceEdgeVertices(GRegion *gr,
+                                       MVertexHashGrid &pos_src_edge)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
   if(!ep || !ep->mesh.ExtrudeMesh || ep->geo.Mode != EXTRUDED_ENTITY) {
@@ -253,7 +254,7 @@ void QuadToTriInsertSourceEdgeVertices(GRegion *gr, MVertexRTree &pos_src_edge)
 
 // Insert all vertices on a faces edges, including corners, into pos_edges set.
 // Added 2010-01-18
-void QuadToTriInsertFaceEdgeVertices(GFace *face, MVertexRTree &pos_edges)
+void QuadToTriInsertFaceEdgeVertices(GFace *face, MVertexHashGrid &pos_edges)
 {
   std::vector<GEdge *> const &edges = face->edges();
   std::vector<GEdge *>::const_iterator ite = edges.begin();
@@ -310,7 +311,8 @@ CategorizedSourceElements::CategorizedSourceElements(GRegion *gr)
   source_face = source_tmp;
 
   // get source face boundary verts
-  MVertexRTree bnd_verts(CTX::instance()->geom.tolerance * CTX::instance()->lc);
+  MVertexHashGrid bnd_verts(CTX::instance()->geom.tolerance *
+                            CTX::instance()->lc);
   QuadToTriInsertSourceEdgeVertices(gr, bnd_verts);
 
   unsigned int num_tri = source_face->triangles.size();
@@ -507,7 +509,7 @@ std::vector<double> QtFindVertsCentroid(std::vector<MVertex *> v)
 // region Added 2010-02-06
 MVertex *QtMakeCentroidVertex(const std::vector<MVertex *> &v,
                               std::vector<MVertex *> *target, GEntity *entity,
-                              MVertexRTree &pos)
+                              MVertexHashGrid &pos)
 {
   int v_size = v.size();
   if(v_size != 6 && v_size != 8 && v_size != 3 && v_size != 4) {
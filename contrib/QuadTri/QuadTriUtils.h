@@ -25,7 +25,7 @@ cited appropriately. See the README.txt file for license information.
 #include "GModel.h"
 #include "GmshDefines.h"
 #include "MVertex.h"
-#include "MVertexRTree.h"
+#include "MVertexHashGrid.h"
 #include "Context.h"
 #include "GModel.h"
 #include "meshGFace.h"
@@ -119,12 +119,13 @@ std::vector<MElement*> *extrudedVector );
 // Insert all vertices on a region's source edge, including corners,
 // into pos_src_edge set.
 // Added 2010-01-09
-void QuadToTriInsertSourceEdgeVertices(GRegion *gr, MVertexRTree &pos_src_edge);
+void QuadToTriInsertSourceEdgeVertices(GRegion *gr,
+                                       MVertexHashGrid &pos_src_edge);
 
 // Insert all vertices on a faces edges, including corners,
 // into pos_edges set.
 // Added 2010-01-18
-void QuadToTriInsertFaceEdgeVertices(GFace *face, MVertexRTree &pos_edges);
+void QuadToTriInsertFaceEdgeVertices(GFace *face, MVertexHashGrid &pos_edges);
 
 // Find centroid of vertices in vector v, return in vector
 std::vector<double> QtFindVertsCentroid(std::vector<MVertex *> v);
@@ -133,7 +134,7 @@ std::vector<double> QtFindVertsCentroid(std::vector<MVertex *> v);
 // region Added 2010-02-06
 MVertex *QtMakeCentroidVertex(const std::vector<MVertex *> &v,
                               std::vector<MVertex *> *target, GEntity *entity,
-                              MVertexRTree &pos);
+                              MVertexHashGrid &pos);
 
 // Finds the index of the lowest valued pointer in a vector of MVertex pointers
 // Added 2011-03-10
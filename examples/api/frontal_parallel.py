@@ -0,0 +1,64 @@
+import gmsh
+import sys
+
+# With "Mesh.FrontalParallelThreshold", the Frontal-Delaunay 2D algorithm
+# inserts points in parallel in surfaces whose boundary has at least that many
+# mesh elements. The resulting mesh does not depend on the number of threads:
+# this meshes a large surface with 1 and 4 threads, and checks that the meshes
+# are identical.
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("frontal_parallel")
+lc = 0.005
+gmsh.model.geo.addPoint(0, 0, 0, lc, 1)
+gmsh.model.geo.addPoint(1, 0, 0, lc, 2)
+gmsh.model.geo.addPoint(1, 1, 0, lc, 3)
+gmsh.model.geo.addPoint(0, 1, 0, lc, 4)
+gmsh.model.geo.addPoint(0.5, 0.5, 0, lc, 5)
+gmsh.model.geo.addPoint(0.6, 0.5, 0, lc, 6)
+gmsh.model.geo.addPoint(0.4, 0.5, 0, lc, 7)
+gmsh.model.geo.addLine(1, 2, 1)
+gmsh.model.geo.addLine(2, 3, 2)
+gmsh.model.geo.addLine(3, 4, 3)
+gmsh.model.geo.addLine(4, 1, 4)
+gmsh.model.geo.addCircleArc(6, 5, 7, 5)
+gmsh.model.geo.addCircleArc(7, 5, 6, 6)
+gmsh.model.geo.addCurveLoop([1, 2, 3, 4], 1)
+gmsh.model.geo.addCurveLoop([5, 6], 2)
+gmsh.model.geo.addPlaneSurface([1, 2], 1)
+gmsh.model.geo.synchronize()
+
+# refine the mesh around the hole
+gmsh.model.mesh.field.add("Distance", 1)
+gmsh.model.mesh.field.setNumbers(1, "CurvesList", [5, 6])
+gmsh.model.mesh.field.add("Threshold", 2)
+gmsh.model.mesh.field.setNumber(2, "InField", 1)
+gmsh.model.mesh.field.setNumber(2, "SizeMin", lc / 2)
+gmsh.model.mesh.field.setNumber(2, "SizeMax", lc * 2)
+gmsh.model.mesh.field.setNumber(2, "DistMin", 0.05)
+gmsh.model.mesh.field.setNumber(2, "DistMax", 0.3)
+gmsh.model.mesh.field.setAsBackgroundMesh(2)
+
+gmsh.option.setNumber("Mesh.Algorithm", 6)
+gmsh.option.setNumber("Mesh.FrontalParallelThreshold", 100)
+
+# curves meshed concurrently number their nodes in the order in which the
+# threads create them, and the 2D mesh depends on this numbering: mesh the
+# curves with a single thread, so that only the 2D mesh is compared
+gmsh.option.setNumber("Mesh.MaxNumThreads1D", 1)
+
+meshes = []
+for n in [1, 4]:
+    gmsh.option.setNumber("General.NumThreads", n)
+    gmsh.model.mesh.clear()
+    gmsh.model.mesh.generate(2)
+    _, coord, _ = gmsh.model.mesh.getNodes(2, 1)
+    _, _, nodes = gmsh.model.mesh.getElements(2, 1)
+    meshes.append((list(coord), list(nodes[0])))
+
+if meshes[0] != meshes[1]:
+    raise Exception("The mesh depends on the number of threads")
+
+gmsh.finalize()
+print("All done")
@@ -0,0 +1,64 @@
+import gmsh
+import sys
+
+# MathEval, MathEvalAniso and Param fields can be evaluated concurrently: each
+# thread evaluates their expressions with its own evaluators. This meshes a
+# square with such a size field, inserting the points in parallel with 1 and 4
+# threads, and checks that the meshes are identical.
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("matheval_threads")
+gmsh.model.geo.addPoint(0, 0, 0, 0.1, 1)
+gmsh.model.geo.addPoint(1, 0, 0, 0.1, 2)
+gmsh.model.geo.addPoint(1, 1, 0, 0.1, 3)
+gmsh.model.geo.addPoint(0, 1, 0, 0.1, 4)
+gmsh.model.geo.addLine(1, 2, 1)
+gmsh.model.geo.addLine(2, 3, 2)
+gmsh.model.geo.addLine(3, 4, 3)
+gmsh.model.geo.addLine(4, 1, 4)
+gmsh.model.geo.addCurveLoop([1, 2, 3, 4], 1)
+gmsh.model.geo.addPlaneSurface([1], 1)
+gmsh.model.geo.synchronize()
+
+# the size is the minimum of a Param field, swapping x and y in a MathEval
+# field, and of the first component of a MathEvalAniso field
+gmsh.model.mesh.field.add("MathEval", 1)
+gmsh.model.mesh.field.setString(1, "F", "0.004 + 0.02 * x")
+gmsh.model.mesh.field.add("Param", 2)
+gmsh.model.mesh.field.setNumber(2, "InField", 1)
+gmsh.model.mesh.field.setString(2, "FX", "y")
+gmsh.model.mesh.field.setString(2, "FY", "x")
+gmsh.model.mesh.field.setString(2, "FZ", "z")
+gmsh.model.mesh.field.add("MathEvalAniso", 3)
+for c in ["M11", "M22", "M33"]:
+    gmsh.model.mesh.field.setString(3, c, "0.006 + 0.02 * (1 - x)")
+for c in ["M12", "M13", "M23"]:
+    gmsh.model.mesh.field.setString(3, c, "0")
+gmsh.model.mesh.field.add("Min", 4)
+gmsh.model.mesh.field.setNumbers(4, "FieldsList", [2, 3])
+gmsh.model.mesh.field.setAsBackgroundMesh(4)
+
+gmsh.option.setNumber("Mesh.MeshSizeExtendFromBoundary", 0)
+gmsh.option.setNumber("Mesh.Algorithm", 6)
+gmsh.option.setNumber("Mesh.FrontalParallelThreshold", 100)
+
+# the node tags of curves meshed concurrently, on which the 2D mesh depends,
+# follow the order in which the threads create the nodes: mesh the curves with
+# a single thread
+gmsh.option.setNumber("Mesh.MaxNumThreads1D", 1)
+
+meshes = []
+for n in [1, 4]:
+    gmsh.option.setNumber("General.NumThreads", n)
+    gmsh.model.mesh.clear()
+    gmsh.model.mesh.generate(2)
+    _, coord, _ = gmsh.model.mesh.getNodes(2, 1)
+    _, _, nodes = gmsh.model.mesh.getElements(2, 1)
+    meshes.append((list(coord), list(nodes[0])))
+
+if meshes[0] != meshes[1]:
+    raise Exception("The mesh depends on the number of threads")
+
+gmsh.finalize()
+print("All done")
@@ -0,0 +1,70 @@
+import gmsh
+import random
+import sys
+
+# gmsh.view.probeMany() probes a view at many points at once, concurrently;
+# this checks that it returns the same values as a loop of gmsh.view.probe()
+# calls on the same view
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("probe_many")
+lc = 0.05
+gmsh.model.geo.addPoint(0, 0, 0, lc, 1)
+gmsh.model.geo.addPoint(1, 0, 0, lc, 2)
+gmsh.model.geo.addPoint(1, 1, 0, lc, 3)
+gmsh.model.geo.addPoint(0, 1, 0, lc, 4)
+gmsh.model.geo.addLine(1, 2, 1)
+gmsh.model.geo.addLine(2, 3, 2)
+gmsh.model.geo.addLine(3, 4, 3)
+gmsh.model.geo.addLine(4, 1, 4)
+gmsh.model.geo.addCurveLoop([1, 2, 3, 4], 1)
+gmsh.model.geo.addPlaneSurface([1], 1)
+gmsh.model.geo.synchronize()
+gmsh.model.mesh.generate(2)
+
+# a view with 3 time steps of a scalar field, interpolated linearly in each
+# triangle
+tags, coord, _ = gmsh.model.mesh.getNodes()
+v = gmsh.view.add("f")
+for step in range(3):
+    data = [coord[3 * i] + 2 * coord[3 * i + 1] + step
+            for i in range(len(tags))]
+    gmsh.view.addHomogeneousModelData(v, step, "probe_many", "NodeData", tags,
+                                      data)
+
+# random points, some of them outside of the square
+random.seed(1234)
+n = 1000
+points = []
+for i in range(n):
+    points.extend([random.uniform(-0.2, 1.2), random.uniform(-0.2, 1.2), 0])
+
+def check(values, distances, i, val, dist):
+    num = len(values) // n
+    if not val:
+        if distances[i] != -1 or any(values[i * num:(i + 1) * num]):
+            raise Exception("Point {} should not have been found".format(i))
+        return
+    if len(val) != num or abs(distances[i] - dist) > 1e-12:
+        raise Exception("Point {} found at a different distance".format(i))
+    for j in range(num):
+        if abs(values[i * num + j] - val[j]) > 1e-10:
+            raise Exception("Wrong value at point {}".format(i))
+
+# exact matches only (distanceMax = 0), then the closest node if the point is
+# outside (distanceMax < 0), for all steps and then only for the last one
+for distanceMax in [0., -1.]:
+    for step in [-1, 2]:
+        values, distances = gmsh.view.probeMany(v, points, step=step,
+                                                distanceMax=distanceMax)
+        if len(distances) != n:
+            raise Exception("Wrong number of distances")
+        for i in range(n):
+            val, dist = gmsh.view.probe(v, points[3 * i], points[3 * i + 1],
+                                        points[3 * i + 2], step=step,
+                                        distanceMax=distanceMax)
+            check(values, distances, i, val, dist)
+
+gmsh.finalize()
+print("All done")
@@ -0,0 +1,54 @@
+import gmsh
+import sys
+
+# With "Mesh.StreamFileName", the 3D mesh is written to an MSH4 file volume by
+# volume while it is generated, and the mesh of each volume is deleted once it
+# has been written. This meshes 3 volumes this way, and checks that the file
+# contains the mesh of all of them.
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("stream_mesh")
+lc = 0.1
+gmsh.model.geo.addPoint(0, 0, 0, lc, 1)
+gmsh.model.geo.addPoint(1, 0, 0, lc, 2)
+gmsh.model.geo.addPoint(1, 1, 0, lc, 3)
+gmsh.model.geo.addPoint(0, 1, 0, lc, 4)
+gmsh.model.geo.addLine(1, 2, 1)
+gmsh.model.geo.addLine(2, 3, 2)
+gmsh.model.geo.addLine(3, 4, 3)
+gmsh.model.geo.addLine(4, 1, 4)
+gmsh.model.geo.addCurveLoop([1, 2, 3, 4], 1)
+gmsh.model.geo.addPlaneSurface([1], 1)
+
+# 3 stacked boxes
+top = (2, 1)
+for i in range(3):
+    ov = gmsh.model.geo.extrude([top], 0, 0, 1)
+    top = ov[0]
+gmsh.model.geo.synchronize()
+volumes = gmsh.model.getEntities(3)
+
+gmsh.option.setString("Mesh.StreamFileName", "stream_mesh.msh")
+gmsh.model.mesh.generate(3)
+gmsh.option.setString("Mesh.StreamFileName", "")
+
+# the volume meshes are not kept in memory...
+for v in volumes:
+    types, _, _ = gmsh.model.mesh.getElements(3, v[1])
+    if len(types):
+        raise Exception("Volume {} still has a mesh".format(v[1]))
+
+# ... but they are all in the file
+gmsh.clear()
+gmsh.open("stream_mesh.msh")
+for v in volumes:
+    types, tags, nodes = gmsh.model.mesh.getElements(3, v[1])
+    if len(types) != 1 or not len(tags[0]):
+        raise Exception("No mesh for volume {} in the file".format(v[1]))
+    # all the nodes of the tetrahedra are defined
+    for n in set(nodes[0]):
+        gmsh.model.mesh.getNode(n)
+
+gmsh.finalize()
+print("All done")
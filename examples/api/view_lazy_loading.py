@@ -0,0 +1,68 @@
+import gmsh
+import math
+import sys
+
+# With "PostProcessing.LazyLoading", the time steps of views stored in MSH
+# files are only read when they are used, and the least recently used ones are
+# unloaded when their data exceeds "PostProcessing.LazyLoadingMemory" (in
+# Mb). This checks that steps unloaded this way are correctly reloaded.
+
+gmsh.initialize(sys.argv)
+
+gmsh.model.add("lazy")
+lc = 0.01
+gmsh.model.geo.addPoint(0, 0, 0, lc, 1)
+gmsh.model.geo.addPoint(1, 0, 0, lc, 2)
+gmsh.model.geo.addPoint(1, 1, 0, lc, 3)
+gmsh.model.geo.addPoint(0, 1, 0, lc, 4)
+gmsh.model.geo.addLine(1, 2, 1)
+gmsh.model.geo.addLine(2, 3, 2)
+gmsh.model.geo.addLine(3, 4, 3)
+gmsh.model.geo.addLine(4, 1, 4)
+gmsh.model.geo.addCurveLoop([1, 2, 3, 4], 1)
+gmsh.model.geo.addPlaneSurface([1], 1)
+gmsh.model.geo.synchronize()
+gmsh.model.mesh.generate(2)
+
+def f(x, y, step):
+    return math.sin(10 * x * (step + 1)) + y
+
+# a view with 20 time steps of about 100 kb each, saved in a binary MSH file
+# together with the mesh
+num_steps = 20
+tags, coord, _ = gmsh.model.mesh.getNodes()
+v = gmsh.view.add("f")
+for step in range(num_steps):
+    data = [f(coord[3 * i], coord[3 * i + 1], step) for i in range(len(tags))]
+    gmsh.view.addHomogeneousModelData(v, step, "lazy", "NodeData", tags, data,
+                                      time=step)
+gmsh.option.setNumber("Mesh.Binary", 1)
+gmsh.view.write(v, "lazy.msh")
+gmsh.clear()
+
+# reload the file with a memory budget of 1 Mb, i.e. less than the data of all
+# the steps
+gmsh.option.setNumber("PostProcessing.LazyLoading", 1)
+gmsh.option.setNumber("PostProcessing.LazyLoadingMemory", 1)
+gmsh.merge("lazy.msh")
+v = gmsh.view.getTags()[0]
+
+tags, coord, _ = gmsh.model.mesh.getNodes()
+xy = {}
+for i in range(len(tags)):
+    xy[tags[i]] = (coord[3 * i], coord[3 * i + 1])
+
+# go through all the steps twice: the first steps have been unloaded when they
+# are accessed again
+for it in range(2):
+    for step in range(num_steps):
+        _, dtags, data, time, _ = gmsh.view.getHomogeneousModelData(v, step)
+        if len(dtags) != len(tags) or time != step:
+            raise Exception("Wrong data for step {}".format(step))
+        for i in range(len(dtags)):
+            x, y = xy[dtags[i]]
+            if abs(data[i] - f(x, y, step)) > 1e-12:
+                raise Exception("Wrong value for step {}".format(step))
+
+gmsh.finalize()
+print("All done")
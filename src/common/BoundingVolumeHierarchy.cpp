@@ -0,0 +1,167 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <algorithm>
+#include "BoundingVolumeHierarchy.h"
+#include "HilbertCurve.h"
+#include "SBoundingBox3d.h"
+#include "GmshMessage.h"
+#include "Context.h"
+
+void BoundingVolumeHierarchy::clear()
+{
+  _nodes.clear();
+  _items.clear();
+  for(int i = 0; i < 6; i++) _box[i].clear();
+}
+
+std::size_t BoundingVolumeHierarchy::_split(const keys &k, std::size_t begin,
+                                            std::size_t end)
+{
+  // split where the highest bit differing between the keys of the range
+  // changes, or in the middle if all the keys are identical
+  uint64_t d = k[begin].first ^ k[end - 1].first;
+  if(!d) return (begin + end) / 2;
+  int bit = 63;
+  while(!((d >> bit) & 1)) bit--;
+  auto it = std::partition_point(
+    k.begin() + begin, k.begin() + end,
+    [bit](const std::pair<uint64_t, std::size_t> &a) {
+      return !((a.first >> bit) & 1);
+    });
+  return it - k.begin();
+}
+
+void BoundingVolumeHierarchy::_leafBounds(node &n) const
+{
+  for(int j = 0; j < 3; j++) {
+    n.min[j] = _box[j][n.index];
+    n.max[j] = _box[3 + j][n.index];
+  }
+  for(std::size_t i = n.index + 1; i < n.index + n.count; i++) {
+    for(int j = 0; j < 3; j++) {
+      n.min[j] = std::min(n.min[j], _box[j][i]);
+      n.max[j] = std::max(n.max[j], _box[3 + j][i]);
+    }
+  }
+}
+
+void BoundingVolumeHierarchy::_childBounds(node &n) const
+{
+  const node &c0 = _nodes[n.index], &c1 = _nodes[n.index + 1];
+  for(int j = 0; j < 3; j++) {
+    n.min[j] = std::min(c0.min[j], c1.min[j]);
+    n.max[j] = std::max(c0.max[j], c1.max[j]);
+  }
+}
+
+void BoundingVolumeHierarchy::_build(std::size_t index, std::size_t begin,
+                                     std::size_t end, const keys &k,
+                                     std::atomic<std::size_t> &numNodes)
+{
+  node &n = _nodes[index];
+  if(end - begin <= _leafSize) {
+    n.index = begin;
+    n.count = end - begin;
+    _leafBounds(n);
+    return;
+  }
+  std::size_t mid = _split(k, begin, end);
+  n.index = numNodes.fetch_add(2);
+  n.count = 0;
+  _build(n.index, begin, mid, k, numNodes);
+  _build(n.index + 1, mid, end, k, numNodes);
+  _childBounds(n);
+}
+
+void BoundingVolumeHierarchy::build(const std::vector<double> &boxes,
+                                    int nthreads)
+{
+  clear();
+  const std::size_t n = boxes.size() / 6;
+  if(!n) return;
+  if(!nthreads) nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // sort the items along the Morton curve of their box centers
+  const std::size_t chunk = 65536;
+  const std::size_t numChunks = (n + chunk - 1) / chunk;
+  std::vector<SBoundingBox3d> bbs(numChunks);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t c = 0; c < numChunks; c++) {
+    for(std::size_t i = c * chunk; i < std::min(n, (c + 1) * chunk); i++)
+      bbs[c] += SPoint3(0.5 * (boxes[6 * i] + boxes[6 * i + 3]),
+                        0.5 * (boxes[6 * i + 1] + boxes[6 * i + 4]),
+                        0.5 * (boxes[6 * i + 2] + boxes[6 * i + 5]));
+  }
+  SBoundingBox3d bb;
+  for(std::size_t c = 0; c < numChunks; c++) bb += bbs[c];
+  keys k(n);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    SPoint3 p(0.5 * (boxes[6 * i] + boxes[6 * i + 3]),
+              0.5 * (boxes[6 * i + 1] + boxes[6 * i + 4]),
+              0.5 * (boxes[6 * i + 2] + boxes[6 * i + 5]));
+    k[i] = std::make_pair(MortonIndex(p, bb), i);
+  }
+  SortCurveIndices(k, nthreads);
+
+  _items.resize(n);
+  for(int j = 0; j < 6; j++) _box[j].resize(n);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    _items[i] = k[i].second;
+    for(int j = 0; j < 6; j++) _box[j][i] = boxes[6 * k[i].second + j];
+  }
+
+  // split the top of the tree serially, until there are enough subtrees to
+  // build them concurrently; nodes are allocated by pairs of siblings, which
+  // gives at most 2 n - 1 nodes
+  _nodes.resize(2 * n);
+  std::atomic<std::size_t> numNodes(1);
+  const std::size_t grain =
+    std::max(4 * _leafSize, n / (16 * (std::size_t)nthreads));
+  std::vector<std::size_t> top;
+  std::vector<std::pair<std::size_t, std::pair<std::size_t, std::size_t> > >
+    jobs, todo;
+  todo.push_back(std::make_pair(0, std::make_pair(0, n)));
+  while(!todo.empty()) {
+    std::size_t index = todo.back().first;
+    std::size_t begin = todo.back().second.first;
+    std::size_t end = todo.back().second.second;
+    todo.pop_back();
+    if(end - begin <= grain) {
+      jobs.push_back(std::make_pair(index, std::make_pair(begin, end)));
+      continue;
+    }
+    std::size_t mid = _split(k, begin, end);
+    node &nd = _nodes[index];
+    nd.index = numNodes.fetch_add(2);
+    nd.count = 0;
+    top.push_back(index);
+    todo.push_back(std::make_pair(nd.index, std::make_pair(begin, mid)));
+    todo.push_back(std::make_pair(nd.index + 1, std::make_pair(mid, end)));
+  }
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < jobs.size(); i++)
+    _build(jobs[i].first, jobs[i].second.first, jobs[i].second.second, k,
+           numNodes);
+  // the children of the top nodes are allocated after them
+  for(std::size_t i = top.size(); i > 0; i--) _childBounds(_nodes[top[i - 1]]);
+  _nodes.resize(numNodes);
+
+  Msg::Debug("Built bounding volume hierarchy of %lu items with %lu nodes", n,
+             _nodes.size());
+}
+
+void BoundingVolumeHierarchy::searchAll(const double p[3],
+                                        std::vector<std::size_t> &items) const
+{
+  items.clear();
+  search(p, [&items](std::size_t i) {
+    items.push_back(i);
+    return false;
+  });
+}
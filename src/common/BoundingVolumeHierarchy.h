@@ -0,0 +1,88 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef BOUNDING_VOLUME_HIERARCHY_H
+#define BOUNDING_VOLUME_HIERARCHY_H
+
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A bounding volume hierarchy of axis-aligned boxes, used to find the items
+// (e.g. mesh elements) whose box contains a point. The hierarchy is a flat
+// array of nodes, built in parallel by splitting the items sorted along the
+// Morton curve of their box centers. The boxes of the items are stored
+// coordinate by coordinate in the order of the leaves, so that the tests in
+// the leaves are vectorized. Once built, the hierarchy is never modified by
+// the searches, which can thus be performed concurrently.
+class BoundingVolumeHierarchy {
+private:
+  static const std::size_t _leafSize = 8;
+  struct node {
+    double min[3], max[3];
+    // first child (the second one follows it) if count == 0, or first item
+    // of the leaf otherwise
+    std::size_t index;
+    std::size_t count;
+  };
+  std::vector<node> _nodes;
+  // items in the order of the leaves, and their boxes (xmin, ymin, zmin, xmax,
+  // ymax, zmax)
+  std::vector<std::size_t> _items;
+  std::vector<double> _box[6];
+  typedef std::vector<std::pair<uint64_t, std::size_t> > keys;
+  static std::size_t _split(const keys &k, std::size_t begin, std::size_t end);
+  void _leafBounds(node &n) const;
+  void _childBounds(node &n) const;
+  void _build(std::size_t index, std::size_t begin, std::size_t end,
+              const keys &k, std::atomic<std::size_t> &numNodes);
+
+public:
+  BoundingVolumeHierarchy() {}
+  // build the hierarchy of n boxes, given as (xmin, ymin, zmin, xmax, ymax,
+  // zmax) for each item; the items are identified by their index in boxes
+  void build(const std::vector<double> &boxes, int nthreads = 0);
+  void clear();
+  bool empty() const { return _items.empty(); }
+  std::size_t size() const { return _items.size(); }
+  // call f(i) for the items i whose box contains p, in an order that only
+  // depends on the boxes, until f returns true; return true if it does
+  template <class F> bool search(const double p[3], F f) const
+  {
+    if(_nodes.empty()) return false;
+    // the depth of the tree is at most 63 (the number of bits of the Morton
+    // keys) plus log2(size()) (splits of items with identical keys)
+    std::size_t stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while(top) {
+      const node &n = _nodes[stack[--top]];
+      if(p[0] < n.min[0] || p[0] > n.max[0] || p[1] < n.min[1] ||
+         p[1] > n.max[1] || p[2] < n.min[2] || p[2] > n.max[2])
+        continue;
+      if(n.count) {
+        const std::size_t b = n.index;
+        bool hit[_leafSize];
+        for(std::size_t i = 0; i < n.count; i++)
+          hit[i] = (p[0] >= _box[0][b + i]) & (p[1] >= _box[1][b + i]) &
+                   (p[2] >= _box[2][b + i]) & (p[0] <= _box[3][b + i]) &
+                   (p[1] <= _box[4][b + i]) & (p[2] <= _box[5][b + i]);
+        for(std::size_t i = 0; i < n.count; i++)
+          if(hit[i] && f(_items[b + i])) return true;
+      }
+      else {
+        stack[top++] = n.index + 1;
+        stack[top++] = n.index;
+      }
+    }
+    return false;
+  }
+  // get all the items whose box contains p
+  void searchAll(const double p[3], std::vector<std::size_t> &items) const;
+};
+
+#endif
@@ -16,13 +16,14 @@ class GamePad;
 
 struct contextMeshOptions {
   // mesh algorithms
-  int optimize, optimizeNetgen, refineSteps;
+  int optimize, optimizeNetgen, optimizeDeterministic, refineSteps;
   int smoothCrossField, crossFieldClosestPoint;
   double lcFactor, randFactor, randFactor3d, lcIntegrationPrecision;
   double optimizeThreshold, normals, tangents, explode, angleSmoothNormals;
   double allowSwapEdgeAngle;
   double qualityInf, qualitySup, radiusInf, radiusSup;
-  double lcMin, lcMax, toleranceEdgeLength, toleranceInitialDelaunay;
+  double lcMin, lcMax, lcFieldCache, toleranceEdgeLength;
+  double toleranceInitialDelaunay;
   double anisoMax, smoothRatio;
   int lcFromPoints, lcFromParametricPoints, lcFromCurvature, lcFromCurvatureIso;
   int lcExtendFromBoundary, checkSurfaceNormalValidity;
@@ -32,6 +33,7 @@ struct contextMeshOptions {
   double recombineMinimumQuality;
   int recombine3DAll, recombine3DLevel, recombine3DConformity;
   int flexibleTransfinite, transfiniteTri, maxRetries;
+  int frontalParallelThreshold;
   int order, secondOrderLinear, secondOrderIncomplete;
   int meshOnlyVisible, meshOnlyEmpty;
   int minCircleNodes, minCurveNodes, minLineNodes;
@@ -45,8 +47,9 @@ struct contextMeshOptions {
   int ignorePeriodicityMsh2, ignoreParametrizationMsh4, boundaryLayerFanElements;
   int maxNumThreads1D, maxNumThreads2D, maxNumThreads3D;
   double angleToleranceFacetOverlap, toleranceReferenceElement;
-  int renumber, compoundClassify, reparamMaxTriangles;
+  int renumber, renumberAlgorithm, compoundClassify, reparamMaxTriangles;
   double compoundLcFactor;
+  int contiguousNodeStorage;
   unsigned int randomSeed;
   int nLayersPerGap;
   double gradation;
@@ -56,10 +59,12 @@ struct contextMeshOptions {
   // mesh IO
   int fileFormat, firstElementTag, firstNodeTag;
   double mshFileVersion, medFileMinorVersion, scalingFactor;
+  int mshFileParallelWrite;
   int medImportGroupsOfNodes, medSingleModel;
   int saveAll, saveTri, saveGroupsOfNodes, saveGroupsOfElements;
   int readGroupsOfElements;
-  int binary, bdfFieldFormat;
+  int binary, bdfFieldFormat, vtuCompression;
+  std::string streamFileName;
   int unvStrictFormat, stlRemoveDuplicateTriangles, stlOneSolidPerSurface;
   double stlLinearDeflection, stlAngularDeflection;
   bool stlLinearDeflectionRelative;
@@ -74,7 +79,7 @@ struct contextMeshOptions {
   int partitionSaveTopologyFile, partitionTriWeight, partitionQuaWeight;
   int partitionTetWeight, partitionHexWeight, partitionLinWeight;
   int partitionPriWeight, partitionPyrWeight, partitionTrihWeight;
-  int partitionOldStyleMsh2, partitionConvertMsh2;
+  int partitionOldStyleMsh2, partitionConvertMsh2, partitionAlgorithm;
   int metisAlgorithm, metisEdgeMatching, metisRefinementAlgorithm;
   int metisObjective, metisMinConn;
   double metisMaxLoadImbalance;
@@ -318,7 +323,8 @@ public:
     int combineTime, combineRemoveOrig, combineCopyOptions;
     int fileFormat, plugins, forceNodeData, forceElementData;
     int saveMesh, saveInterpolationMatrices;
-    double animDelay;
+    int lazyLoading;
+    double animDelay, lazyLoadingMemory;
     std::string doubleClickedGraphPointCommand;
     double doubleClickedGraphPointX, doubleClickedGraphPointY;
     int doubleClickedView;
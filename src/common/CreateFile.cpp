@@ -50,6 +50,7 @@ int GetFileFormatFromExtension(const std::string &ext, double *version)
   else if(ext == ".opt")      return FORMAT_OPT;
   else if(ext == ".unv")      return FORMAT_UNV;
   else if(ext == ".vtk")      return FORMAT_VTK;
+  else if(ext == ".vtu")      return FORMAT_VTU;
   else if(ext == ".m")        return FORMAT_MATLAB;
   else if(ext == ".dat")      return FORMAT_TOCHNOG;
   else if(ext == ".txt")      return FORMAT_TXT;
@@ -118,6 +119,7 @@ std::string GetDefaultFileExtension(int format, bool onlyMeshFormats)
   case FORMAT_OPT:     name = ".opt"; break;
   case FORMAT_UNV:     name = ".unv"; mesh = true; break;
   case FORMAT_VTK:     name = ".vtk"; mesh = true; break;
+  case FORMAT_VTU:     name = ".vtu"; mesh = true; break;
   case FORMAT_MATLAB:  name = ".m"; mesh = true; break;
   case FORMAT_TOCHNOG: name = ".dat"; mesh = true; break;
   case FORMAT_STL:     name = ".stl"; mesh = true; break;
@@ -389,6 +391,14 @@ void CreateOutputFile(const std::string &fileName, int format,
        CTX::instance()->bigEndian);
     break;
 
+  case FORMAT_VTU:
+  case FORMAT_PVTU:
+    GModel::current()->writeVTU
+      (name, CTX::instance()->mesh.binary, CTX::instance()->mesh.saveAll,
+       CTX::instance()->mesh.scalingFactor,
+       CTX::instance()->mesh.vtuCompression);
+    break;
+
   case FORMAT_MATLAB:
     GModel::current()->writeMATLAB
       (name, CTX::instance()->mesh.binary, CTX::instance()->mesh.saveAll,
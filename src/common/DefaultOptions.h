@@ -168,6 +168,14 @@ StringXString GeometryOptions_String[] = {
 } ;
 
 StringXString MeshOptions_String[] = {
+  { F|O, "StreamFileName" , opt_mesh_stream_file_name , "" ,
+    "Stream the 3D mesh to this MSH4 file while it is generated: the mesh of "
+    "each volume is optimized, written and deleted as soon as it is done, which "
+    "reduces the memory footprint of large meshes (the volume meshes are thus "
+    "not available for further processing, e.g. high-order or subdivision). "
+    "Volumes meshed with the Delaunay or HXT algorithms that share a surface "
+    "are meshed together, and are only written once they are all done: no "
+    "memory is saved for a model made of a single connected set of volumes" },
   { 0, nullptr , nullptr , "" , nullptr }
 } ;
 
@@ -1139,6 +1147,10 @@ StringXNumber MeshOptions_Number[] = {
     "[Deprecated]" },
   { F|O, "CompoundMeshSizeFactor" , opt_mesh_compound_lc_factor , 0.5 ,
     "Mesh size factor applied to compound parts" },
+  { F|O, "ContiguousNodeStorage" , opt_mesh_contiguous_node_storage , 0. ,
+    "Store the coordinates of the mesh nodes of each model entity in a "
+    "contiguous array after mesh generation and after reading MSH4 files "
+    "(requires Gmsh to be compiled with ENABLE_CONTIGUOUS_NODES)" },
   { F,   "CpuTime" , opt_mesh_cpu_time , 0. ,
     "CPU time (in seconds) for the generation of the current mesh (read-only)" },
   { F|O, "CreateTopologyMsh2" , opt_mesh_create_topology_msh2, 0. ,
@@ -1162,10 +1174,15 @@ StringXNumber MeshOptions_Number[] = {
   { F|O, "FlexibleTransfinite" , opt_mesh_flexible_transfinite , 0 ,
     "Allow transfinite constraints to be modified for recombination (e.g. Blossom) or "
     "by global mesh size factor" },
+  { F|O, "FrontalParallelThreshold" , opt_mesh_frontal_parallel_threshold , 0 ,
+    "Minimum number of boundary mesh elements of a surface for the Frontal-Delaunay "
+    "2D algorithm to insert points in parallel, using all threads (0: never); "
+    "the resulting mesh does not depend on the number of threads" },
   { F|O, "Format" , opt_mesh_file_format , FORMAT_AUTO ,
     "Mesh output format (1: msh, 2: unv, 10: auto, 16: vtk, 19: vrml, 21: mail, "
     "26: pos stat, 27: stl, 28: p3d, 30: mesh, 31: bdf, 32: cgns, 33: med, 34: diff, "
-    "38: ir3, 39: inp, 40: ply2, 41: celum, 42: su2, 47: tochnog, 49: neu, 50: matlab)" },
+    "38: ir3, 39: inp, 40: ply2, 41: celum, 42: su2, 45: pvtu, 47: tochnog, 49: neu, "
+    "50: matlab, 56: vtu)" },
   { F|O, "Hexahedra" , opt_mesh_hexahedra , 1. ,
     "Display mesh hexahedra?" },
 
@@ -1266,6 +1283,10 @@ StringXNumber MeshOptions_Number[] = {
     "-2: only for surfaces; -3: only for volumes)"},
   { F|O, "MeshSizeFactor" , opt_mesh_lc_factor , 1.0 ,
     "Factor applied to all mesh element sizes" },
+  { F|O, "MeshSizeFieldCache" , opt_mesh_lc_field_cache , 0. ,
+    "Cache the background mesh size field on an adaptive octree, refined until "
+    "the relative interpolation error is below the given value (0: no cache); "
+    "the field should not depend on the entity being meshed" },
   { F|O, "MeshSizeMin" , opt_mesh_lc_min, 0.0 ,
     "Minimum mesh element size" },
   { F|O, "MeshSizeMax" , opt_mesh_lc_max, 1.e22,
@@ -1308,6 +1329,10 @@ StringXNumber MeshOptions_Number[] = {
     "[Deprecated]"},
   { F|O, "MinimumElementsPerTwoPi" , opt_mesh_lc_from_curvature, 0. ,
     "[Deprecated]" },
+  { F|O, "MshFileParallelWrite" , opt_mesh_msh_file_parallel_write , 1. ,
+    "Write mode for MSH4 files (0: serial, 1: parallel serialization with "
+    "ordered writes, 2: parallel serialization with positional writes at "
+    "precomputed offsets for binary files)" },
   { F|O, "MshFileVersion" , opt_mesh_msh_file_version , 4.1 ,
     "Version of the MSH file format to use" },
   { F|O, "MedFileMinorVersion" , opt_mesh_med_file_minor_version , -1. ,
@@ -1355,12 +1380,19 @@ StringXNumber MeshOptions_Number[] = {
     "Use old initial 2D Delaunay code" },
   { F|O, "Optimize" , opt_mesh_optimize , 1. ,
     "Optimize the mesh to improve the quality of tetrahedral elements" },
+  { F|O, "OptimizeDeterministic" , opt_mesh_optimize_deterministic , 0 ,
+    "Make the (parallel) optimization of tetrahedral meshes independent of the "
+    "number of threads" },
   { F|O, "OptimizeThreshold" , opt_mesh_optimize_threshold , 0.3 ,
     "Optimize tetrahedra that have a quality below ... " },
   { F|O, "OptimizeNetgen" , opt_mesh_optimize_netgen , 0 ,
     "Optimize the mesh using Netgen to improve the quality of tetrahedral "
     "elements" },
 
+  { F|O, "PartitionAlgorithm" , opt_mesh_partition_algorithm , 0 ,
+    "Mesh partitioner (0: METIS, 1: multithreaded recursive coordinate "
+    "bisection, 2: Hilbert space-filling curve, 3: Morton space-filling curve; "
+    "1, 2 and 3 do not require METIS)" },
   { F|O, "PartitionHexWeight" , opt_mesh_partition_hex_weight , -1 ,
     "Weight of hexahedral element for METIS load balancing (-1: automatic)" },
   { F|O, "PartitionLineWeight" , opt_mesh_partition_line_weight , -1 ,
@@ -1486,6 +1518,10 @@ StringXNumber MeshOptions_Number[] = {
     "Number of refinement steps in the MeshAdapt-based 2D algorithms" },
   { F|O, "Renumber" , opt_mesh_renumber , 1 ,
     "Renumber nodes and elements in a continuous sequence after mesh generation" },
+  { F|O, "RenumberAlgorithm" , opt_mesh_renumber_algorithm , 0 ,
+    "Order of the nodes and elements when they are renumbered (0: order of the "
+    "entities, 1: Reverse Cuthill-McKee, 2: Hilbert curve, 3: element-to-node "
+    "graph traversal)" },
   { F|O, "ReparamMaxTriangles" , opt_mesh_reparam_max_triangles , 250000 ,
     "Maximum number of triangles in a single parametrization patch" },
 
@@ -1595,6 +1631,9 @@ StringXNumber MeshOptions_Number[] = {
     "[Deprecated]" },
   { F|O, "Voronoi" , opt_mesh_voronoi , 0. ,
     "Display the voronoi diagram" },
+  { F|O, "VtuCompression" , opt_mesh_vtu_compression , 0 ,
+    "Compression level of the binary data in VTU files (0: none, 1-9: zlib "
+    "compression level, if Gmsh is compiled with zlib)" },
 
   { F|O, "ZoneDefinition" , opt_mesh_zone_definition , 0. ,
     "Method for defining a zone (0: single zone, 1: by partition, 2: by physical)" },
@@ -1677,6 +1716,16 @@ StringXNumber PostProcessingOptions_Number[] = {
   { F|O, "HorizontalScales" , opt_post_horizontal_scales , 1. ,
     "Display value scales horizontally" },
 
+  { F|O, "LazyLoading" , opt_post_lazy_loading , 0. ,
+    "Load the data of post-processing views from MSH files on demand: when a "
+    "file is merged, only the location of the data of each time step is "
+    "recorded, and the data is read when the time step is first used" },
+  { F|O, "LazyLoadingMemory" , opt_post_lazy_loading_memory , 4096. ,
+    "Maximum memory (in Mb) used by the data of time steps loaded on demand "
+    "(0: unlimited): when it is exceeded, the least recently used time steps "
+    "are unloaded when a time step is displayed, saved or accessed through the "
+    "API (plugins load the time steps they use without unloading others)" },
+
   { F|O, "Link" , opt_post_link , 0. ,
     "Post-processing view links (0: apply next option changes to selected views, "
     "1: force same options for all selected views)" },
@@ -39,6 +39,7 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
 #endif
 
 #if defined(WIN32)
@@ -726,3 +727,112 @@ void UnzipFile(const std::string &fileName, const std::string &prependDir)
   Msg::Error("Gmsh must be compiled with Zipper support to extract zip files");
 #endif
 }
+
+std::size_t GetFilePosition(FILE *fp)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+  __int64 pos = _ftelli64(fp);
+#else
+  off_t pos = ftello(fp);
+#endif
+  return pos < 0 ? 0 : (std::size_t)pos;
+}
+
+bool SetFilePosition(FILE *fp, std::size_t pos)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+  return !_fseeki64(fp, (__int64)pos, SEEK_SET);
+#else
+  return !fseeko(fp, (off_t)pos, SEEK_SET);
+#endif
+}
+
+std::size_t GetFileSize(FILE *fp)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+  struct _stat64 buf;
+  if(_fstat64(_fileno(fp), &buf)) return 0;
+#else
+  struct stat buf;
+  if(fstat(fileno(fp), &buf)) return 0;
+#endif
+  return (std::size_t)buf.st_size;
+}
+
+struct mappedFileRegion {
+  void *base;
+  std::size_t length;
+#if defined(WIN32) && !defined(__CYGWIN__)
+  HANDLE mapping;
+#endif
+};
+
+const char *MapFileRegion(FILE *fp, std::size_t offset, std::size_t size,
+                          void **handle)
+{
+  *handle = nullptr;
+  if(!fp || !size) return nullptr;
+#if defined(WIN32) && !defined(__CYGWIN__)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  std::size_t align = info.dwAllocationGranularity;
+  std::size_t start = offset - offset % align;
+  std::size_t length = size + (offset - start);
+  HANDLE file = (HANDLE)_get_osfhandle(_fileno(fp));
+  if(file == INVALID_HANDLE_VALUE) return nullptr;
+  HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0,
+                                     nullptr);
+  if(!mapping) return nullptr;
+  void *base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(start >> 32),
+                             (DWORD)(start & 0xffffffff), length);
+  if(!base) {
+    CloseHandle(mapping);
+    return nullptr;
+  }
+  mappedFileRegion *r = new mappedFileRegion;
+  r->mapping = mapping;
+#else
+  std::size_t align = (std::size_t)sysconf(_SC_PAGESIZE);
+  std::size_t start = offset - offset % align;
+  std::size_t length = size + (offset - start);
+  void *base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileno(fp),
+                    (off_t)start);
+  if(base == MAP_FAILED) return nullptr;
+  mappedFileRegion *r = new mappedFileRegion;
+#endif
+  r->base = base;
+  r->length = length;
+  *handle = r;
+  return (const char *)base + (offset - start);
+}
+
+void UnmapFileRegion(void *handle)
+{
+  if(!handle) return;
+  mappedFileRegion *r = (mappedFileRegion *)handle;
+#if defined(WIN32) && !defined(__CYGWIN__)
+  UnmapViewOfFile(r->base);
+  CloseHandle(r->mapping);
+#else
+  munmap(r->base, r->length);
+#endif
+  delete r;
+}
+
+bool WriteFileRegion(FILE *fp, std::size_t offset, const void *data,
+                     std::size_t size)
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+  return false;
+#else
+  const char *p = (const char *)data;
+  while(size) {
+    ssize_t n = pwrite(fileno(fp), p, size, (off_t)offset);
+    if(n <= 0) return false;
+    p += n;
+    offset += n;
+    size -= n;
+  }
+  return true;
+#endif
+}
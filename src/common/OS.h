@@ -33,4 +33,22 @@ int SystemCallExe(const std::string &exe, const std::string &argsOrCommand,
 void RedirectIOToConsole();
 void UnzipFile(const std::string &fileName, const std::string &prependDir = "");
 
+// 64-bit safe file positioning
+std::size_t GetFilePosition(FILE *fp);
+bool SetFilePosition(FILE *fp, std::size_t pos);
+std::size_t GetFileSize(FILE *fp);
+
+// read-only memory mapping of the region [offset, offset + size) of an open
+// file; returns nullptr if the region cannot be mapped, in which case the
+// caller should fall back to regular reads
+const char *MapFileRegion(FILE *fp, std::size_t offset, std::size_t size,
+                          void **handle);
+void UnmapFileRegion(void *handle);
+
+// positional write at the given offset of an open file, which does not modify
+// the file position and can be called concurrently; returns false if the data
+// could not be written (or if positional writes are not available)
+bool WriteFileRegion(FILE *fp, std::size_t offset, const void *data,
+                     std::size_t size);
+
 #endif
@@ -1436,6 +1436,12 @@ std::string opt_geometry_pipe_default_trihedron(OPT_ARGS_STR)
   return CTX::instance()->geom.pipeDefaultTrihedron;
 }
 
+std::string opt_mesh_stream_file_name(OPT_ARGS_STR)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.streamFileName = val;
+  return CTX::instance()->mesh.streamFileName;
+}
+
 std::string opt_solver_socket_name(OPT_ARGS_STR)
 {
   if(action & GMSH_SET) CTX::instance()->solver.socketName = val;
@@ -4892,6 +4898,17 @@ double opt_mesh_optimize_threshold(OPT_ARGS_NUM)
   return CTX::instance()->mesh.optimizeThreshold;
 }
 
+double opt_mesh_optimize_deterministic(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    if(!(action & GMSH_SET_DEFAULT) &&
+       (int)val != CTX::instance()->mesh.optimizeDeterministic)
+      Msg::SetOnelabChanged(2);
+    CTX::instance()->mesh.optimizeDeterministic = (int)val;
+  }
+  return CTX::instance()->mesh.optimizeDeterministic;
+}
+
 double opt_mesh_optimize_netgen(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -4925,6 +4942,12 @@ double opt_mesh_renumber(OPT_ARGS_NUM)
   return CTX::instance()->mesh.renumber;
 }
 
+double opt_mesh_renumber_algorithm(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.renumberAlgorithm = (int)val;
+  return CTX::instance()->mesh.renumberAlgorithm;
+}
+
 double opt_mesh_normals(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) { CTX::instance()->mesh.normals = val; }
@@ -5011,6 +5034,17 @@ double opt_mesh_lc_factor(OPT_ARGS_NUM)
   return CTX::instance()->mesh.lcFactor;
 }
 
+double opt_mesh_lc_field_cache(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    if(!(action & GMSH_SET_DEFAULT) &&
+       val != CTX::instance()->mesh.lcFieldCache)
+      Msg::SetOnelabChanged(2);
+    CTX::instance()->mesh.lcFieldCache = val;
+  }
+  return CTX::instance()->mesh.lcFieldCache;
+}
+
 double opt_mesh_lc_min(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -5703,6 +5737,12 @@ double opt_mesh_newton_convergence_test_xyz(OPT_ARGS_NUM)
   return CTX::instance()->mesh.NewtonConvergenceTestXYZ;
 }
 
+double opt_mesh_msh_file_parallel_write(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.mshFileParallelWrite = (int)val;
+  return CTX::instance()->mesh.mshFileParallelWrite;
+}
+
 double opt_mesh_msh_file_version(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.mshFileVersion = val;
@@ -6060,6 +6100,17 @@ double opt_mesh_flexible_transfinite(OPT_ARGS_NUM)
   return CTX::instance()->mesh.flexibleTransfinite;
 }
 
+double opt_mesh_frontal_parallel_threshold(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    if(!(action & GMSH_SET_DEFAULT) &&
+       (int)val != CTX::instance()->mesh.frontalParallelThreshold)
+      Msg::SetOnelabChanged(2);
+    CTX::instance()->mesh.frontalParallelThreshold = (int)val;
+  }
+  return CTX::instance()->mesh.frontalParallelThreshold;
+}
+
 double opt_mesh_algo_subdivide(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) {
@@ -6392,6 +6443,14 @@ double opt_mesh_voronoi(OPT_ARGS_NUM)
   return CTX::instance()->mesh.voronoi;
 }
 
+double opt_mesh_vtu_compression(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+    CTX::instance()->mesh.vtuCompression = std::max(0, std::min(9, (int)val));
+  }
+  return CTX::instance()->mesh.vtuCompression;
+}
+
 double opt_mesh_draw_skin_only(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) { CTX::instance()->mesh.drawSkinOnly = (int)val; }
@@ -6482,6 +6541,25 @@ double opt_mesh_compound_lc_factor(OPT_ARGS_NUM)
   return CTX::instance()->mesh.compoundLcFactor;
 }
 
+double opt_mesh_contiguous_node_storage(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) {
+#if !defined(HAVE_CONTIGUOUS_NODES)
+    if((int)val) {
+      Msg::Error("Contiguous node storage requires Gmsh to be compiled with "
+                 "ENABLE_CONTIGUOUS_NODES");
+      val = 0;
+    }
+#endif
+    // apply the change to the current mesh
+    if(((int)val != 0) != (CTX::instance()->mesh.contiguousNodeStorage != 0) &&
+       !GModel::list.empty())
+      GModel::current()->setContiguousMeshVertexStorage((int)val != 0);
+    CTX::instance()->mesh.contiguousNodeStorage = (int)val;
+  }
+  return CTX::instance()->mesh.contiguousNodeStorage;
+}
+
 double opt_mesh_random_seed(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.randomSeed = (unsigned int)val;
@@ -6586,6 +6664,12 @@ double opt_mesh_partition_num(OPT_ARGS_NUM)
   return CTX::instance()->mesh.numPartitions;
 }
 
+double opt_mesh_partition_algorithm(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->mesh.partitionAlgorithm = (int)val;
+  return CTX::instance()->mesh.partitionAlgorithm;
+}
+
 double opt_mesh_partition_metis_algorithm(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET) CTX::instance()->mesh.metisAlgorithm = (int)val;
@@ -6856,6 +6940,19 @@ double opt_post_smooth(OPT_ARGS_NUM)
   return CTX::instance()->post.smooth;
 }
 
+double opt_post_lazy_loading(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET) CTX::instance()->post.lazyLoading = (int)val;
+  return CTX::instance()->post.lazyLoading;
+}
+
+double opt_post_lazy_loading_memory(OPT_ARGS_NUM)
+{
+  if(action & GMSH_SET)
+    CTX::instance()->post.lazyLoadingMemory = std::max(0., val);
+  return CTX::instance()->post.lazyLoadingMemory;
+}
+
 double opt_post_anim_delay(OPT_ARGS_NUM)
 {
   if(action & GMSH_SET)
@@ -1551,6 +1551,23 @@ static void _getAdditionalNodesOnBoundary(GEntity *entity,
   }
 }
 
+static bool _getNodeEntities(const int dim, const int tag,
+                             std::vector<GEntity *> &entities)
+{
+  if(dim >= 0 && tag >= 0) {
+    GEntity *ge = GModel::current()->getEntityByTag(dim, tag);
+    if(!ge) {
+      Msg::Error("%s does not exist", _getEntityName(dim, tag).c_str());
+      return false;
+    }
+    entities.push_back(ge);
+  }
+  else {
+    GModel::current()->getEntities(entities, dim);
+  }
+  return true;
+}
+
 GMSH_API void gmsh::model::mesh::getNodes(std::vector<std::size_t> &nodeTags,
                                           std::vector<double> &coord,
                                           std::vector<double> &parametricCoord,
@@ -1563,17 +1580,7 @@ GMSH_API void gmsh::model::mesh::getNodes(std::vector<std::size_t> &nodeTags,
   coord.clear();
   parametricCoord.clear();
   std::vector<GEntity *> entities;
-  if(dim >= 0 && tag >= 0) {
-    GEntity *ge = GModel::current()->getEntityByTag(dim, tag);
-    if(!ge) {
-      Msg::Error("%s does not exist", _getEntityName(dim, tag).c_str());
-      return;
-    }
-    entities.push_back(ge);
-  }
-  else {
-    GModel::current()->getEntities(entities, dim);
-  }
+  if(!_getNodeEntities(dim, tag, entities)) return;
   std::size_t numNodes = 0;
   for(auto ge : entities) numNodes += ge->mesh_vertices.size();
   nodeTags.reserve(numNodes);
@@ -1599,6 +1606,119 @@ GMSH_API void gmsh::model::mesh::getNodes(std::vector<std::size_t> &nodeTags,
   }
 }
 
+template <class T>
+static void _vector2ptr(const std::vector<T> &v, T **p, size_t *size)
+{
+  *p = (T *)Malloc(v.size() * sizeof(T));
+  if(v.size()) std::copy(v.begin(), v.end(), *p);
+  *size = v.size();
+}
+
+// split the n[i] items of the entities i into chunks of at most chunk items,
+// given by their entity and their first item, so that all the items can be
+// processed in a single parallel loop; offset[i] is the global index of the
+// first item of entity i
+static void
+_getChunks(const std::vector<std::size_t> &n, std::size_t chunk,
+           std::vector<std::pair<std::size_t, std::size_t> > &chunks,
+           std::vector<std::size_t> &offset)
+{
+  chunks.clear();
+  offset.assign(n.size() + 1, 0);
+  for(std::size_t i = 0; i < n.size(); i++) {
+    offset[i + 1] = offset[i] + n[i];
+    for(std::size_t j = 0; j < n[i]; j += chunk)
+      chunks.push_back(std::make_pair(i, j));
+  }
+}
+
+// for better performance, manual C implementation of
+// gmsh::model::mesh::getNodes: the nodes are copied in parallel directly in
+// the arrays returned to the caller, without temporary vectors
+GMSH_API void gmshModelMeshGetNodes(size_t **nodeTags, size_t *nodeTags_n,
+                                    double **coord, size_t *coord_n,
+                                    double **parametricCoord,
+                                    size_t *parametricCoord_n, const int dim,
+                                    const int tag, const int includeBoundary,
+                                    const int returnParametricCoord, int *ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    *nodeTags = nullptr;
+    *nodeTags_n = 0;
+    *coord = nullptr;
+    *coord_n = 0;
+    *parametricCoord = nullptr;
+    *parametricCoord_n = 0;
+    if(includeBoundary) {
+      std::vector<std::size_t> t;
+      std::vector<double> c, p;
+      gmsh::model::mesh::getNodes(t, c, p, dim, tag, true,
+                                  returnParametricCoord);
+      _vector2ptr(t, nodeTags, nodeTags_n);
+      _vector2ptr(c, coord, coord_n);
+      _vector2ptr(p, parametricCoord, parametricCoord_n);
+      return;
+    }
+    if(!_checkInit()) {
+      if(ierr) *ierr = -1;
+      return;
+    }
+    std::vector<GEntity *> entities;
+    if(!_getNodeEntities(dim, tag, entities)) return;
+    std::vector<std::size_t> n(entities.size()), offset;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      n[i] = entities[i]->mesh_vertices.size();
+    const std::size_t chunk = 65536;
+    std::vector<std::pair<std::size_t, std::size_t> > chunks;
+    _getChunks(n, chunk, chunks, offset);
+    const std::size_t numNodes = offset.back();
+    if(!numNodes) return;
+    *nodeTags = (size_t *)Malloc(numNodes * sizeof(size_t));
+    *nodeTags_n = numNodes;
+    *coord = (double *)Malloc(3 * numNodes * sizeof(double));
+    *coord_n = 3 * numNodes;
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t c = 0; c < chunks.size(); c++) {
+      const std::size_t i = chunks[c].first;
+      const std::vector<MVertex *> &v = entities[i]->mesh_vertices;
+      for(std::size_t j = chunks[c].second;
+          j < std::min(v.size(), chunks[c].second + chunk); j++) {
+        const std::size_t k = offset[i] + j;
+        (*nodeTags)[k] = v[j]->getNum();
+        (*coord)[3 * k] = v[j]->x();
+        (*coord)[3 * k + 1] = v[j]->y();
+        (*coord)[3 * k + 2] = v[j]->z();
+      }
+    }
+    // parametric coordinates are not available for all the nodes
+    if(dim > 0 && returnParametricCoord) {
+      double *p = (double *)Malloc(dim * numNodes * sizeof(double));
+      std::size_t num = 0;
+      for(auto ge : entities) {
+        for(auto v : ge->mesh_vertices) {
+          double par;
+          for(int k = 0; k < dim; k++) {
+            if(v->getParameter(k, par)) p[num++] = par;
+          }
+        }
+      }
+      if(!num) {
+        Free(p);
+        p = nullptr;
+      }
+      else if(num < dim * numNodes)
+        p = (double *)Realloc(p, num * sizeof(double));
+      *parametricCoord = p;
+      *parametricCoord_n = num;
+    }
+  } catch(...) {
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmsh::model::mesh::getNodesByElementType(
   const int elementType, std::vector<std::size_t> &nodeTags,
   std::vector<double> &coord, std::vector<double> &parametricCoord,
@@ -2263,6 +2383,69 @@ GMSH_API void gmsh::model::mesh::preallocateElementsByType(
   }
 }
 
+// for better performance, manual C implementation of
+// gmsh::model::mesh::getElementsByType (for a single task)
+GMSH_API void gmshModelMeshGetElementsByType(
+  const int elementType, size_t **elementTags, size_t *elementTags_n,
+  size_t **nodeTags, size_t *nodeTags_n, const int tag, const size_t task,
+  const size_t numTasks, int *ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    *elementTags = nullptr;
+    *elementTags_n = 0;
+    *nodeTags = nullptr;
+    *nodeTags_n = 0;
+    if(numTasks != 1) {
+      std::vector<std::size_t> e, n;
+      gmsh::model::mesh::getElementsByType(elementType, e, n, tag, task,
+                                           numTasks);
+      _vector2ptr(e, elementTags, elementTags_n);
+      _vector2ptr(n, nodeTags, nodeTags_n);
+      return;
+    }
+    if(!_checkInit()) {
+      if(ierr) *ierr = -1;
+      return;
+    }
+    int dim = ElementType::getDimension(elementType);
+    std::map<int, std::vector<GEntity *> > typeEnt;
+    _getEntitiesForElementTypes(dim, tag, typeEnt);
+    const std::vector<GEntity *> &entities(typeEnt[elementType]);
+    int familyType = ElementType::getParentType(elementType);
+    std::vector<std::size_t> n(entities.size()), offset;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      n[i] = entities[i]->getNumMeshElementsByType(familyType);
+    const std::size_t chunk = 65536;
+    std::vector<std::pair<std::size_t, std::size_t> > chunks;
+    _getChunks(n, chunk, chunks, offset);
+    const std::size_t numElements = offset.back();
+    const std::size_t numNodes = ElementType::getNumVertices(elementType);
+    if(!numElements) return;
+    *elementTags = (size_t *)Malloc(numElements * sizeof(size_t));
+    *elementTags_n = numElements;
+    *nodeTags = (size_t *)Malloc(numElements * numNodes * sizeof(size_t));
+    *nodeTags_n = numElements * numNodes;
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t c = 0; c < chunks.size(); c++) {
+      const std::size_t i = chunks[c].first;
+      GEntity *ge = entities[i];
+      for(std::size_t j = chunks[c].second;
+          j < std::min(n[i], chunks[c].second + chunk); j++) {
+        MElement *e = ge->getMeshElementByType(familyType, j);
+        const std::size_t k = offset[i] + j;
+        (*elementTags)[k] = e->getNum();
+        for(std::size_t l = 0; l < numNodes; l++)
+          (*nodeTags)[k * numNodes + l] = e->getVertex(l)->getNum();
+      }
+    }
+  } catch(...) {
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmsh::model::mesh::getElementQualities(
   const std::vector<std::size_t> &elementTags,
   std::vector<double> &elementQualities, const std::string &qualityName,
@@ -2680,6 +2863,112 @@ GMSH_API void gmsh::model::mesh::preallocateJacobians(
   }
 }
 
+// for better performance, manual C implementation of
+// gmsh::model::mesh::getJacobians (for a single task), computing the data of
+// the elements in parallel
+GMSH_API void gmshModelMeshGetJacobians(
+  const int elementType, const double *localCoord, const size_t localCoord_n,
+  double **jacobians, size_t *jacobians_n, double **determinants,
+  size_t *determinants_n, double **coord, size_t *coord_n, const int tag,
+  const size_t task, const size_t numTasks, int *ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    *jacobians = nullptr;
+    *jacobians_n = 0;
+    *determinants = nullptr;
+    *determinants_n = 0;
+    *coord = nullptr;
+    *coord_n = 0;
+    if(numTasks != 1) {
+      std::vector<double> lc(localCoord, localCoord + localCoord_n);
+      std::vector<double> j, d, c;
+      gmsh::model::mesh::getJacobians(elementType, lc, j, d, c, tag, task,
+                                      numTasks);
+      _vector2ptr(j, jacobians, jacobians_n);
+      _vector2ptr(d, determinants, determinants_n);
+      _vector2ptr(c, coord, coord_n);
+      return;
+    }
+    if(!_checkInit()) {
+      if(ierr) *ierr = -1;
+      return;
+    }
+    const std::size_t numPoints = localCoord_n / 3;
+    if(!numPoints) {
+      Msg::Warning("No evaluation points in getJacobians");
+      return;
+    }
+    int dim = ElementType::getDimension(elementType);
+    std::map<int, std::vector<GEntity *> > typeEnt;
+    _getEntitiesForElementTypes(dim, tag, typeEnt);
+    const std::vector<GEntity *> &entities(typeEnt[elementType]);
+    int familyType = ElementType::getParentType(elementType);
+    std::vector<std::size_t> n(entities.size()), offset;
+    for(std::size_t i = 0; i < entities.size(); i++)
+      n[i] = entities[i]->getNumMeshElementsByType(familyType);
+    const std::size_t chunk = 4096;
+    std::vector<std::pair<std::size_t, std::size_t> > chunks;
+    _getChunks(n, chunk, chunks, offset);
+    const std::size_t numElements = offset.back();
+    if(!numElements) return;
+
+    // the shape functions and their gradients are evaluated once and for all
+    // on the first element
+    MElement *first = nullptr;
+    for(std::size_t i = 0; i < entities.size() && !first; i++)
+      if(n[i]) first = entities[i]->getMeshElementByType(familyType, 0);
+    std::vector<std::vector<double> > sf(numPoints);
+    std::vector<std::vector<SVector3> > gsf(numPoints);
+    for(std::size_t k = 0; k < numPoints; k++) {
+      double s[1256], value[1256][3];
+      first->getShapeFunctions(localCoord[3 * k], localCoord[3 * k + 1],
+                               localCoord[3 * k + 2], s);
+      sf[k].assign(s, s + first->getNumShapeFunctions());
+      first->getGradShapeFunctions(localCoord[3 * k], localCoord[3 * k + 1],
+                                   localCoord[3 * k + 2], value);
+      gsf[k].resize(first->getNumShapeFunctions());
+      for(std::size_t l = 0; l < first->getNumShapeFunctions(); l++) {
+        gsf[k][l][0] = value[l][0];
+        gsf[k][l][1] = value[l][1];
+        gsf[k][l][2] = value[l][2];
+      }
+    }
+
+    const std::size_t num = numElements * numPoints;
+    *jacobians = (double *)Malloc(9 * num * sizeof(double));
+    *jacobians_n = 9 * num;
+    *determinants = (double *)Malloc(num * sizeof(double));
+    *determinants_n = num;
+    *coord = (double *)Malloc(3 * num * sizeof(double));
+    *coord_n = 3 * num;
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t c = 0; c < chunks.size(); c++) {
+      const std::size_t i = chunks[c].first;
+      GEntity *ge = entities[i];
+      for(std::size_t j = chunks[c].second;
+          j < std::min(n[i], chunks[c].second + chunk); j++) {
+        MElement *e = ge->getMeshElementByType(familyType, j);
+        std::size_t idx = (offset[i] + j) * numPoints;
+        for(std::size_t k = 0; k < numPoints; k++) {
+          SPoint3 p;
+          e->pnt(sf[k], p);
+          (*coord)[idx * 3] = p.x();
+          (*coord)[idx * 3 + 1] = p.y();
+          (*coord)[idx * 3 + 2] = p.z();
+          (*determinants)[idx] =
+            e->getJacobian(gsf[k], &(*jacobians)[idx * 9]);
+          idx++;
+        }
+      }
+    }
+  } catch(...) {
+    if(ierr) *ierr = 1;
+  }
+}
+
 GMSH_API void gmsh::model::mesh::getJacobian(
   const std::size_t elementTag, const std::vector<double> &localCoord,
   std::vector<double> &jacobians, std::vector<double> &determinants,
@@ -5200,16 +5489,39 @@ gmsh::model::mesh::reorderElements(const int elementType, const int tag,
   }
 }
 
-GMSH_API void gmsh::model::mesh::renumberNodes()
+static bool _getRenumberAlgorithm(const std::string &method, int &algorithm)
+{
+  if(method.empty())
+    algorithm = -1;
+  else if(method == "Simple")
+    algorithm = 0;
+  else if(method == "RCMK")
+    algorithm = 1;
+  else if(method == "Hilbert")
+    algorithm = 2;
+  else if(method == "ElementGraph")
+    algorithm = 3;
+  else {
+    Msg::Error("Unknown renumbering method '%s'", method.c_str());
+    return false;
+  }
+  return true;
+}
+
+GMSH_API void gmsh::model::mesh::renumberNodes(const std::string &method)
 {
   if(!_checkInit()) return;
-  GModel::current()->renumberMeshVertices();
+  int algorithm;
+  if(!_getRenumberAlgorithm(method, algorithm)) return;
+  GModel::current()->renumberMeshVertices(algorithm);
 }
 
-GMSH_API void gmsh::model::mesh::renumberElements()
+GMSH_API void gmsh::model::mesh::renumberElements(const std::string &method)
 {
   if(!_checkInit()) return;
-  GModel::current()->renumberMeshElements();
+  int algorithm;
+  if(!_getRenumberAlgorithm(method, algorithm)) return;
+  GModel::current()->renumberMeshElements(algorithm);
 }
 
 GMSH_API void
@@ -7287,6 +7599,7 @@ static stepData<double> *_getModelData(const int tag, const int step,
     dataType = "Beam";
   else
     dataType = "Unknown";
+  if(step >= 0) d->loadStep(step);
   stepData<double> *s = d->getStepData(step);
   if(!s) {
     Msg::Error("View with tag %d does not contain model data for step %d", tag,
@@ -7305,6 +7618,29 @@ static stepData<double> *_getModelData(const int tag, const int step,
   }
   return s;
 }
+
+// copy the data of the numEnt entities of step s in tags and in data, padded
+// with zeros to maxMult values per entity
+static void _getHomogeneousModelData(stepData<double> *s, int numComponents,
+                                     int numEnt, int maxMult, std::size_t *tags,
+                                     double *data)
+{
+  std::vector<std::size_t> index;
+  index.reserve(numEnt);
+  for(std::size_t i = 0; i < s->getNumData(); i++)
+    if(s->getData(i)) index.push_back(i);
+  const std::size_t size = (std::size_t)numComponents * maxMult;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t j = 0; j < index.size(); j++) {
+    tags[j] = index[j];
+    double *dd = s->getData(index[j]);
+    std::size_t n = (std::size_t)numComponents * s->getMult(index[j]);
+    std::copy(dd, dd + n, data + j * size);
+    std::fill(data + j * size + n, data + (j + 1) * size, 0.);
+  }
+}
 #endif
 
 GMSH_API void gmsh::view::getModelData(const int tag, const int step,
@@ -7352,25 +7688,55 @@ GMSH_API void gmsh::view::getHomogeneousModelData(
   stepData<double> *s =
     _getModelData(tag, step, dataType, time, numComponents, numEnt, maxMult);
   if(!s || !numComponents || !numEnt || !maxMult) return;
-  data.resize(numEnt * numComponents * maxMult, 0.);
+  data.resize(numEnt * numComponents * maxMult);
   tags.resize(numEnt);
-  std::size_t j = 0;
-  for(std::size_t i = 0; i < s->getNumData(); i++) {
-    double *dd = s->getData(i);
-    if(dd) {
-      tags[j] = i;
-      int mult = s->getMult(i);
-      for(int k = 0; k < numComponents * mult; k++) {
-        data[j * numComponents * maxMult + k] = dd[k];
-      }
-      j++;
-    }
-  }
+  _getHomogeneousModelData(s, numComponents, numEnt, maxMult, &tags[0],
+                           &data[0]);
 #else
   Msg::Error("Views require the post-processing module");
 #endif
 }
 
+// for better performance, manual C implementation of
+// gmsh::view::getHomogeneousModelData
+GMSH_API void gmshViewGetHomogeneousModelData(
+  const int tag, const int step, char **dataType, size_t **tags,
+  size_t *tags_n, double **data, size_t *data_n, double *time,
+  int *numComponents, int *ierr)
+{
+  if(ierr) *ierr = 0;
+  try {
+    *tags = nullptr;
+    *tags_n = 0;
+    *data = nullptr;
+    *data_n = 0;
+    std::string type;
+#if defined(HAVE_POST)
+    int numEnt = 0, maxMult = 0;
+    stepData<double> *s =
+      _getModelData(tag, step, type, *time, *numComponents, numEnt, maxMult);
+    *dataType = strdup(type.c_str());
+    if(!s || !*numComponents || !numEnt || !maxMult) return;
+    const std::size_t size = (std::size_t)numEnt * *numComponents * maxMult;
+    *tags = (size_t *)Malloc(numEnt * sizeof(size_t));
+    *tags_n = numEnt;
+    *data = (double *)Malloc(size * sizeof(double));
+    *data_n = size;
+    _getHomogeneousModelData(s, *numComponents, numEnt, maxMult, *tags,
+                             *data);
+#else
+    *dataType = strdup(type.c_str());
+    if(!_checkInit()) {
+      if(ierr) *ierr = -1;
+      return;
+    }
+    Msg::Error("Views require the post-processing module");
+#endif
+  } catch(...) {
+    if(ierr) *ierr = 1;
+  }
+}
+
 // for better performance, manual C implementation of gmsh::view::getModelData
 GMSH_API void gmshViewGetModelData(const int tag, const int step,
                                    char **dataType, size_t **tags,
@@ -7807,6 +8173,7 @@ GMSH_API void gmsh::view::probe(const int tag, const double x, const double y,
     Msg::Error("No data in view %d", tag);
     return;
   }
+  data->loadStep(step);
   values.clear();
   std::vector<double> val(9 * data->getNumTimeSteps() * 3);
   int qn = 0;
@@ -7865,6 +8232,83 @@ GMSH_API void gmsh::view::probe(const int tag, const double x, const double y,
 #endif
 }
 
+GMSH_API void gmsh::view::probeMany(const int tag,
+                                    const std::vector<double> &coord,
+                                    std::vector<double> &values,
+                                    std::vector<double> &distances,
+                                    const int step, const int numComp,
+                                    const bool gradient,
+                                    const double distanceMax, const int dim)
+{
+  if(!_checkInit()) return;
+#if defined(HAVE_POST)
+  PView *view = PView::getViewByTag(tag);
+  if(!view) {
+    Msg::Error("Unknown view with tag %d", tag);
+    return;
+  }
+  PViewData *data = view->getData();
+  if(!data) {
+    Msg::Error("No data in view %d", tag);
+    return;
+  }
+  values.clear();
+  distances.clear();
+  if(coord.size() % 3) {
+    Msg::Error("Number of coordinates should be a multiple of 3");
+    return;
+  }
+  int nc = numComp;
+  if(nc != 1 && nc != 3 && nc != 9) {
+    if(data->getNumVectors() && !data->getNumScalars())
+      nc = 3;
+    else if(data->getNumTensors() && !data->getNumScalars() &&
+            !data->getNumVectors())
+      nc = 9;
+    else
+      nc = 1;
+  }
+  int numSteps = (step < 0) ? data->getNumTimeSteps() : 1;
+  std::size_t numVal = numSteps * (gradient ? 3 : 1) * nc;
+  std::size_t n = coord.size() / 3;
+  distances.resize(n, -1.);
+  if(!numVal) return;
+  values.resize(n * numVal, 0.);
+
+  // load the data and build the search structures once, before searching
+  // concurrently
+  data->loadStep(step);
+  data->initSearch(step, distanceMax != 0.);
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    const double x = coord[3 * i], y = coord[3 * i + 1], z = coord[3 * i + 2];
+    double *val = &values[i * numVal];
+    double d = distanceMax;
+    bool found;
+    if(nc == 1)
+      found = data->searchScalarClosest(x, y, z, d, val, step, nullptr, 0,
+                                        nullptr, nullptr, nullptr, gradient,
+                                        dim);
+    else if(nc == 3)
+      found = data->searchVectorClosest(x, y, z, d, val, step, nullptr, 0,
+                                        nullptr, nullptr, nullptr, gradient,
+                                        dim);
+    else
+      found = data->searchTensorClosest(x, y, z, d, val, step, nullptr, 0,
+                                        nullptr, nullptr, nullptr, gradient,
+                                        dim);
+    if(found)
+      distances[i] = d;
+    else
+      for(std::size_t j = 0; j < numVal; j++) val[j] = 0.;
+  }
+#else
+  Msg::Error("Views require the post-processing module");
+#endif
+}
+
 GMSH_API void gmsh::view::write(const int tag, const std::string &fileName,
                                 const bool append)
 {
@@ -13,6 +13,7 @@
 #include "GEdge.h"
 #include "GFace.h"
 #include "MLine.h"
+#include "MeshMemoryPool.h"
 #include "GaussLegendre1D.h"
 #include "Context.h"
 #include "closestPoint.h"
@@ -52,6 +53,7 @@ GEdge::~GEdge()
 
 void GEdge::deleteMesh()
 {
+  MeshMemoryPool::bulkRelease bulk;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   for(std::size_t i = 0; i < lines.size(); i++) delete lines[i];
@@ -18,8 +18,9 @@
 
 GEntity::GEntity(GModel *m, int t)
   : _model(m), _tag(t), _meshMaster(this), _visible(1), _selection(0),
-    _allElementsVisible(1), _obb(nullptr), va_lines(nullptr),
-    va_triangles(nullptr)
+    _allElementsVisible(1), _obb(nullptr),
+    _contiguousMeshVertexStorage(false), _meshVertexStorageModified(false),
+    va_lines(nullptr), va_triangles(nullptr)
 {
   _color = CTX::instance()->packColor(0, 0, 255, 0);
 }
@@ -117,6 +118,68 @@ void GEntity::removeMeshVertex(MVertex *v)
 {
   auto it = std::find(mesh_vertices.begin(), mesh_vertices.end(), v);
   if(it != mesh_vertices.end()) mesh_vertices.erase(it);
+  _meshVertexStorageModified = true;
+}
+
+GEntity::~GEntity() { _releaseMeshVertexStorage(); }
+
+void GEntity::_releaseMeshVertexStorage()
+{
+#if defined(HAVE_CONTIGUOUS_NODES)
+  for(auto v : _meshVertexViews)
+    if(v) v->_releaseStorage();
+  std::vector<double>().swap(_meshVertexCoordinates);
+  std::vector<std::size_t>().swap(_meshVertexTags);
+  std::vector<MVertex *>().swap(_meshVertexViews);
+#endif
+}
+
+void GEntity::_buildMeshVertexStorage()
+{
+#if defined(HAVE_CONTIGUOUS_NODES)
+  _releaseMeshVertexStorage();
+  const std::size_t n = mesh_vertices.size();
+  _meshVertexCoordinates.resize(3 * n);
+  _meshVertexTags.resize(n);
+  _meshVertexViews = mesh_vertices;
+  for(std::size_t i = 0; i < n; i++) {
+    MVertex *v = mesh_vertices[i];
+    v->_setStorage(&_meshVertexCoordinates[3 * i], this);
+    _meshVertexTags[i] = v->getNum();
+  }
+  _meshVertexStorageModified = false;
+#endif
+}
+
+void GEntity::setContiguousMeshVertexStorage(bool enable)
+{
+#if !defined(HAVE_CONTIGUOUS_NODES)
+  enable = false;
+#endif
+  _contiguousMeshVertexStorage = enable;
+  if(enable)
+    _buildMeshVertexStorage();
+  else
+    _releaseMeshVertexStorage();
+}
+
+void GEntity::syncMeshVertexStorage()
+{
+  if(!isMeshVertexStorageSynced()) _buildMeshVertexStorage();
+}
+
+double *GEntity::getMeshVertexCoordinates()
+{
+  if(!_contiguousMeshVertexStorage) return nullptr;
+  syncMeshVertexStorage();
+  return _meshVertexCoordinates.data();
+}
+
+const std::size_t *GEntity::getMeshVertexTags()
+{
+  if(!_contiguousMeshVertexStorage) return nullptr;
+  syncMeshVertexStorage();
+  return _meshVertexTags.data();
 }
 
 GVertex *GEntity::cast2Vertex() { return dynamic_cast<GVertex *>(this); }
@@ -51,6 +51,19 @@ private:
 protected:
   SOrientedBoundingBox *_obb;
 
+  // optional contiguous (structure-of-arrays) storage of the coordinates
+  // (x0 y0 z0 x1 y1 z1 ...) and of the tags of the mesh vertices: the
+  // coordinates of the vertices in _meshVertexViews are stored here, and not
+  // in the MVertex objects (a view is reset to nullptr when its vertex is
+  // deleted or leaves the storage, which marks the storage as modified)
+  std::vector<double> _meshVertexCoordinates;
+  std::vector<std::size_t> _meshVertexTags;
+  std::vector<MVertex *> _meshVertexViews;
+  bool _contiguousMeshVertexStorage, _meshVertexStorageModified;
+  void _buildMeshVertexStorage();
+  void _releaseMeshVertexStorage();
+  friend class MVertex;
+
 public: // these will become protected at some point
   // the mesh vertices uniquely owned by the entity
   std::vector<MVertex *> mesh_vertices;
@@ -181,7 +194,7 @@ public:
 
   GEntity(GModel *m, int t);
 
-  virtual ~GEntity() {}
+  virtual ~GEntity();
 
   // mesh generation of the entity
   virtual void mesh(bool verbose) {}
@@ -382,10 +395,51 @@ public:
   MVertex *getMeshVertex(std::size_t index) { return mesh_vertices[index]; }
 
   // add a MeshVertex
-  void addMeshVertex(MVertex *v) { mesh_vertices.push_back(v); }
+  void addMeshVertex(MVertex *v)
+  {
+    mesh_vertices.push_back(v);
+    _meshVertexStorageModified = true;
+  }
   // delete a MeshVertex
   void removeMeshVertex(MVertex *v);
 
+  // enable/disable the contiguous storage of the mesh vertex coordinates and
+  // tags: when enabled, the coordinates of mesh_vertices[i] are stored at
+  // position 3 * i in getMeshVertexCoordinates(), and its tag at position i
+  // in getMeshVertexTags(); the MVertex objects then read and write their
+  // coordinates directly in the contiguous array (this requires Gmsh to be
+  // compiled with ENABLE_CONTIGUOUS_NODES; otherwise the storage is never
+  // enabled)
+  void setContiguousMeshVertexStorage(bool enable);
+  bool hasContiguousMeshVertexStorage() const
+  {
+    return _contiguousMeshVertexStorage;
+  }
+  // check if the contiguous storage (if enabled) matches mesh_vertices, and
+  // rebuild it if mesh_vertices has been modified since it was built (this
+  // should not be called concurrently for entities sharing mesh vertices).
+  // The check is done in constant time: vertices added or removed with
+  // addMeshVertex() and removeMeshVertex(), deleted vertices and changes in
+  // the size or the ends of mesh_vertices are detected; code that reorders or
+  // replaces vertices in mesh_vertices directly must call
+  // invalidateMeshVertexStorage()
+  bool isMeshVertexStorageSynced() const
+  {
+    return !_contiguousMeshVertexStorage ||
+           (!_meshVertexStorageModified &&
+            _meshVertexViews.size() == mesh_vertices.size() &&
+            (mesh_vertices.empty() ||
+             (_meshVertexViews.front() == mesh_vertices.front() &&
+              _meshVertexViews.back() == mesh_vertices.back())));
+  }
+  void invalidateMeshVertexStorage() { _meshVertexStorageModified = true; }
+  void syncMeshVertexStorage();
+  // get a raw pointer to the contiguous coordinates and tags, after
+  // synchronizing the storage with mesh_vertices (or nullptr if the contiguous
+  // storage is not enabled)
+  double *getMeshVertexCoordinates();
+  const std::size_t *getMeshVertexTags();
+
   // add an element
   virtual void addElement(int type, MElement *e) {}
   // remove an element
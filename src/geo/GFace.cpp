@@ -12,6 +12,7 @@
 #include "MTriangle.h"
 #include "MQuadrangle.h"
 #include "MElementCut.h"
+#include "MeshMemoryPool.h"
 #include "VertexArray.h"
 #include "fullMatrix.h"
 #include "Numeric.h"
@@ -144,6 +145,7 @@ void GFace::setBoundEdges(const std::vector<int> &tagEdges,
 
 void GFace::deleteMesh()
 {
+  MeshMemoryPool::bulkRelease bulk;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   transfinite_vertices.clear();
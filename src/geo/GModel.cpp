@@ -37,7 +37,8 @@
 #include "OS.h"
 #include "StringUtils.h"
 #include "GEdgeLoop.h"
-#include "MVertexRTree.h"
+#include "MVertexHashGrid.h"
+#include "HilbertCurve.h"
 #include "OpenFile.h"
 #include "CreateFile.h"
 #include "Options.h"
@@ -55,6 +56,7 @@
 #include "meshGRegionMMG.h"
 #include "meshGFaceBamg.h"
 #include "meshRefine.h"
+#include "meshRenumber.h"
 #endif
 
 #if defined(HAVE_POST)
@@ -70,7 +72,7 @@ std::vector<GModel *> GModel::list;
 int GModel::_current = -1;
 
 GModel::GModel(const std::string &name)
-  : _name(name), _visible(1), _elementOctree(nullptr),
+  : _name(name), _visible(1), _elementOctree(nullptr), _msh4Stream(nullptr),
     _geo_internals(nullptr), _occ_internals(nullptr), _acis_internals(nullptr),
     _parasolid_internals(nullptr), _fields(nullptr),
     _currentMeshEntity(nullptr), _numPartitions(0), normals(nullptr),
@@ -110,6 +112,7 @@ GModel::~GModel()
     if(!othervisible && list.size()) list.back()->setVisibility(1);
   }
 
+  if(_msh4Stream) endStreamMSH4();
   destroy();
   deleteGEOInternals();
   deleteOCCInternals();
@@ -211,6 +214,40 @@ void GModel::destroy(bool keepName)
   gmshSurface::reset();
 }
 
+void GModel::setContiguousMeshVertexStorage(bool enable)
+{
+  std::vector<GEntity *> entities;
+  getEntities(entities);
+  _setContiguousMeshVertexStorage(entities, enable);
+}
+
+void GModel::syncMeshVertexStorage()
+{
+  std::vector<GEntity *> entities, modified;
+  getEntities(entities);
+  for(auto ge : entities) {
+    if(!ge->isMeshVertexStorageSynced()) modified.push_back(ge);
+  }
+  _setContiguousMeshVertexStorage(modified, true);
+}
+
+void GModel::_setContiguousMeshVertexStorage(
+  const std::vector<GEntity *> &entities, bool enable)
+{
+  // release all the storages before building the new ones, so that the
+  // entities can be processed in parallel even if vertices have been moved
+  // from one entity to another
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < entities.size(); i++)
+    entities[i]->setContiguousMeshVertexStorage(false);
+  if(!enable) return;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < entities.size(); i++)
+    entities[i]->setContiguousMeshVertexStorage(true);
+}
+
 void GModel::destroyMeshCaches()
 {
   // this is called in GEntity::deleteMesh()
@@ -219,11 +256,9 @@ void GModel::destroyMeshCaches()
     _vertexVectorCache.clear();
     std::vector<MVertex *>().swap(_vertexVectorCache);
     _vertexMapCache.clear();
-    std::map<int, MVertex *>().swap(_vertexMapCache);
     _elementVectorCache.clear();
     std::vector<std::pair<MElement *, int> >().swap(_elementVectorCache);
     _elementMapCache.clear();
-    std::map<int, std::pair<MElement *, int> >().swap(_elementMapCache);
     _elementIndexCache.clear();
     std::map<int, int>().swap(_elementIndexCache);
     if(_elementOctree) {
@@ -1690,8 +1725,45 @@ static void getDependentViewData(GModel *m, PViewDataGModel::DataType type,
 }
 #endif
 
-void GModel::renumberMeshVertices()
+// sort the mesh nodes or elements of each surface and volume by tag, so that
+// they are written in the new order by the mesh exporters (nodes and elements
+// on curves are kept in their order along the curve)
+static void sortMeshVerticesByTag(std::vector<GEntity *> &entities)
 {
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    if(entities[i]->dim() < 2) continue;
+    std::vector<MVertex *> &v = entities[i]->mesh_vertices;
+    std::sort(v.begin(), v.end(), MVertexPtrLessThan());
+  }
+}
+
+static void sortMeshElementsByTag(std::vector<GEntity *> &entities)
+{
+  const int types[] = {TYPE_PNT, TYPE_LIN,  TYPE_TRI, TYPE_QUA,
+                       TYPE_TET, TYPE_PYR,  TYPE_PRI, TYPE_HEX,
+                       TYPE_POLYG, TYPE_POLYH, TYPE_TRIH};
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    if(ge->dim() < 2) continue;
+    for(std::size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+      const std::size_t n = ge->getNumMeshElementsByType(types[t]);
+      if(n < 2) continue;
+      std::vector<std::pair<std::size_t, std::size_t> > tags(n);
+      for(std::size_t j = 0; j < n; j++)
+        tags[j] = std::make_pair(
+          ge->getMeshElementByType(types[t], j)->getNum(), j);
+      std::sort(tags.begin(), tags.end());
+      std::vector<std::size_t> ordering(n);
+      for(std::size_t j = 0; j < n; j++) ordering[j] = tags[j].second;
+      ge->reorder(ge->getMeshElementByType(types[t], 0)->getTypeForMSH(),
+                  ordering);
+    }
+  }
+}
+
+void GModel::renumberMeshVertices(int algorithm)
+{
+  if(algorithm < 0) algorithm = CTX::instance()->mesh.renumberAlgorithm;
   destroyMeshCaches();
   setMaxVertexNumber(CTX::instance()->mesh.firstNodeTag - 1);
   std::vector<GEntity *> entities;
@@ -1727,23 +1799,24 @@ void GModel::renumberMeshVertices()
   }
   bool pruneOrphans = CTX::instance()->mesh.saveWithoutOrphans;
 
+  // nodes in the order of their new tags
+  std::vector<MVertex *> vertices;
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    vertices.insert(vertices.end(), ge->mesh_vertices.begin(),
+                    ge->mesh_vertices.end());
+  }
+  SortMeshVertices(entities, algorithm, vertices);
+
   std::size_t n = CTX::instance()->mesh.firstNodeTag - 1;
   if(saveOnlyPhysicals || pruneOrphans) {
     Msg::Debug("Renumbering for potentially partial mesh save");
     // if we potentially only save a subset of elements, make sure to first
     // renumber the nodes that belong to those elements (so that we end up
     // with a dense node numbering in the output file)
-    std::size_t nv = CTX::instance()->mesh.firstNodeTag - 1;
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      nv += ge->getNumMeshVertices();
-    }
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
-        ge->getMeshVertex(j)->forceNum(nv + 1);
-      }
-    }
+    std::size_t nv = CTX::instance()->mesh.firstNodeTag - 1 + vertices.size();
+    for(std::size_t i = 0; i < vertices.size(); i++)
+      vertices[i]->forceNum(nv + 1);
     for(std::size_t i = 0; i < entities.size(); i++) {
       GEntity *ge = entities[i];
       if(!((pruneOrphans && ge->isOrphan()) ||
@@ -1756,30 +1829,19 @@ void GModel::renumberMeshVertices()
         }
       }
     }
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
-        MVertex *v = ge->getMeshVertex(j);
-        if(v->getNum() == 0) v->forceNum(++n);
-      }
+    for(std::size_t i = 0; i < vertices.size(); i++) {
+      if(vertices[i]->getNum() == 0) vertices[i]->forceNum(++n);
     }
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
-        MVertex *v = ge->getMeshVertex(j);
-        if(v->getNum() == nv + 1) v->forceNum(++n);
-      }
+    for(std::size_t i = 0; i < vertices.size(); i++) {
+      if(vertices[i]->getNum() == nv + 1) vertices[i]->forceNum(++n);
     }
   }
   else {
     // full save
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      for(std::size_t j = 0; j < ge->getNumMeshVertices(); j++) {
-        ge->getMeshVertex(j)->forceNum(++n);
-      }
-    }
+    for(std::size_t i = 0; i < vertices.size(); i++)
+      vertices[i]->forceNum(++n);
   }
+  if(algorithm > 0) sortMeshVerticesByTag(entities);
 
 #if defined(HAVE_POST)
   // renumber any dependent nodal post-processing datasets
@@ -1799,8 +1861,9 @@ void GModel::renumberMeshVertices()
 #endif
 }
 
-void GModel::renumberMeshElements()
+void GModel::renumberMeshElements(int algorithm)
 {
+  if(algorithm < 0) algorithm = CTX::instance()->mesh.renumberAlgorithm;
   destroyMeshCaches();
   setMaxElementNumber(CTX::instance()->mesh.firstElementTag - 1);
   std::vector<GEntity *> entities;
@@ -1837,36 +1900,27 @@ void GModel::renumberMeshElements()
   }
   bool pruneOrphans = CTX::instance()->mesh.saveWithoutOrphans;
 
-  std::size_t n = CTX::instance()->mesh.firstElementTag - 1;
-  if(saveOnlyPhysicals || pruneOrphans) {
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      if(!((pruneOrphans && ge->isOrphan()) ||
-           (saveOnlyPhysicals && ge->physicals.empty()))) {
-        for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
-          ge->getMeshElement(j)->forceNum(++n);
-        }
-      }
-    }
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      if(((pruneOrphans && ge->isOrphan()) ||
-          (saveOnlyPhysicals && ge->physicals.empty()))) {
-        for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
-          ge->getMeshElement(j)->forceNum(++n);
-        }
-      }
-    }
+  // elements that will be saved, then the others, in the order of their new
+  // tags
+  std::vector<MElement *> elements[2];
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    const int k = ((saveOnlyPhysicals || pruneOrphans) &&
+                   ((pruneOrphans && ge->isOrphan()) ||
+                    (saveOnlyPhysicals && ge->physicals.empty()))) ?
+                    1 :
+                    0;
+    for(std::size_t j = 0; j < ge->getNumMeshElements(); j++)
+      elements[k].push_back(ge->getMeshElement(j));
   }
-  else {
-    // full save
-    for(std::size_t i = 0; i < entities.size(); i++) {
-      GEntity *ge = entities[i];
-      for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
-        ge->getMeshElement(j)->forceNum(++n);
-      }
-    }
+
+  std::size_t n = CTX::instance()->mesh.firstElementTag - 1;
+  for(int k = 0; k < 2; k++) {
+    SortMeshElements(entities, algorithm, elements[k]);
+    for(std::size_t i = 0; i < elements[k].size(); i++)
+      elements[k][i]->forceNum(++n);
   }
+  if(algorithm > 0) sortMeshElementsByTag(entities);
 
 #if defined(HAVE_POST)
   // renumber any dependent element post-processing datasets
@@ -1932,6 +1986,14 @@ MElement *GModel::getMeshElementByCoord(SPoint3 &p, SPoint3 &param, int dim,
   return e;
 }
 
+void GModel::buildMeshElementOctree()
+{
+  if(!_elementOctree) {
+    Msg::Debug("Rebuilding mesh element octree");
+    _elementOctree = new MElementOctree(this);
+  }
+}
+
 std::vector<MElement *> GModel::getMeshElementsByCoord(SPoint3 &p, int dim,
                                                        bool strict)
 {
@@ -1964,19 +2026,30 @@ void GModel::rebuildMeshVertexCache(bool onlyIfNecessary)
     }
     std::vector<GEntity *> entities;
     getEntities(entities);
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
     if(dense) {
       // numbering starts at 1
       _vertexVectorCache.resize(_maxVertexNum + 1, (MVertex *)nullptr);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
       for(std::size_t i = 0; i < entities.size(); i++)
         for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
           _vertexVectorCache[entities[i]->mesh_vertices[j]->getNum()] =
             entities[i]->mesh_vertices[j];
     }
     else {
+      std::vector<std::size_t> offsets(entities.size() + 1, 0);
+      for(std::size_t i = 0; i < entities.size(); i++)
+        offsets[i + 1] = offsets[i] + entities[i]->mesh_vertices.size();
+      std::vector<std::pair<std::size_t, MVertex *> > values(offsets.back());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
       for(std::size_t i = 0; i < entities.size(); i++)
         for(std::size_t j = 0; j < entities[i]->mesh_vertices.size(); j++)
-          _vertexMapCache[entities[i]->mesh_vertices[j]->getNum()] =
-            entities[i]->mesh_vertices[j];
+          values[offsets[i] + j] =
+            std::make_pair(entities[i]->mesh_vertices[j]->getNum(),
+                           entities[i]->mesh_vertices[j]);
+      if(values.size())
+        _vertexMapCache.insert(&values[0], values.size(), nthreads);
     }
   }
 }
@@ -2000,9 +2073,12 @@ void GModel::rebuildMeshElementCache(bool onlyIfNecessary)
     }
     std::vector<GEntity *> entities;
     getEntities(entities);
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
     if(dense) {
       // numbering starts at 1
       _elementVectorCache.resize(_maxElementNum + 1, std::make_pair(nullptr, 0));
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
       for(std::size_t i = 0; i < entities.size(); i++)
         for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
           MElement *e = entities[i]->getMeshElement(j);
@@ -2011,16 +2087,25 @@ void GModel::rebuildMeshElementCache(bool onlyIfNecessary)
         }
     }
     else {
+      std::vector<std::size_t> offsets(entities.size() + 1, 0);
+      for(std::size_t i = 0; i < entities.size(); i++)
+        offsets[i + 1] = offsets[i] + entities[i]->getNumMeshElements();
+      std::vector<std::pair<std::size_t, std::pair<MElement *, int> > > values(
+        offsets.back());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
       for(std::size_t i = 0; i < entities.size(); i++)
         for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
           MElement *e = entities[i]->getMeshElement(j);
-          _elementMapCache[e->getNum()] = std::make_pair(e, entities[i]->tag());
+          values[offsets[i] + j] = std::make_pair(
+            e->getNum(), std::make_pair(e, entities[i]->tag()));
         }
+      if(values.size())
+        _elementMapCache.insert(&values[0], values.size(), nthreads);
     }
   }
 }
 
-MVertex *GModel::getMeshVertexByTag(int n)
+MVertex *GModel::getMeshVertexByTag(std::size_t n)
 {
   if(_vertexVectorCache.empty() && _vertexMapCache.empty()) {
 #pragma omp barrier
@@ -2031,10 +2116,10 @@ MVertex *GModel::getMeshVertexByTag(int n)
     }
   }
 
-  if(n < (int)_vertexVectorCache.size())
-    return _vertexVectorCache[n];
-  else
-    return _vertexMapCache[n];
+  if(n < _vertexVectorCache.size()) return _vertexVectorCache[n];
+  // do not insert missing tags, so that lookups are thread-safe
+  MVertex *const *v = _vertexMapCache.find(n);
+  return v ? *v : nullptr;
 }
 
 void GModel::addMVertexToVertexCache(MVertex* v)
@@ -2074,7 +2159,7 @@ void GModel::getMeshVerticesForPhysicalGroup(int dim, int num,
   v.insert(v.begin(), sv.begin(), sv.end());
 }
 
-MElement *GModel::getMeshElementByTag(int n, int &entityTag)
+MElement *GModel::getMeshElementByTag(std::size_t n, int &entityTag)
 {
   if(_elementVectorCache.empty() && _elementMapCache.empty()) {
 #pragma omp barrier
@@ -2085,11 +2170,13 @@ MElement *GModel::getMeshElementByTag(int n, int &entityTag)
     }
   }
 
-  std::pair<MElement*, int> ret;
-  if(n < (int)_elementVectorCache.size())
+  std::pair<MElement *, int> ret(nullptr, 0);
+  if(n < _elementVectorCache.size())
     ret = _elementVectorCache[n];
-  else
-    ret = _elementMapCache[n];
+  else {
+    const std::pair<MElement *, int> *e = _elementMapCache.find(n);
+    if(e) ret = *e;
+  }
   entityTag = ret.second;
   return ret.first;
 }
@@ -2278,7 +2365,7 @@ void GModel::setCurrentMeshEntity(GEntity *e)
 int GModel::partitionMesh(
   int numPart, std::vector<std::pair<MElement *, int> > elementPartition)
 {
-#if defined(HAVE_MESH) && (defined(HAVE_METIS))
+#if defined(HAVE_MESH)
   if(numPart > 0) {
     if(_numPartitions > 0) UnpartitionMesh(this);
     if(elementPartition.empty())
@@ -2288,7 +2375,7 @@ int GModel::partitionMesh(
   }
   return 1;
 #else
-  Msg::Error("Mesh or Metis module not compiled");
+  Msg::Error("Mesh module not compiled");
   return 1;
 #endif
 }
@@ -2305,11 +2392,11 @@ int GModel::unpartitionMesh()
 
 int GModel::convertOldPartitioningToNewOne()
 {
-#if defined(HAVE_MESH) && (defined(HAVE_METIS))
+#if defined(HAVE_MESH)
   int ier = ConvertOldPartitioningToNewOne(this);
   return ier;
 #else
-  Msg::Error("Mesh or Metis module not compiled");
+  Msg::Error("Mesh module not compiled");
   return 1;
 #endif
 }
@@ -2578,6 +2665,24 @@ void GModel::_storeVerticesInEntities(std::map<int, MVertex *> &vertices)
   }
 }
 
+void GModel::_storeVerticesInEntities(MTagHashMap<MVertex *> &vertices)
+{
+  // store the vertices in increasing tag order, as with an ordered map
+  std::vector<std::pair<std::size_t, MVertex *> > sorted;
+  vertices.getSorted(sorted);
+  for(std::size_t i = 0; i < sorted.size(); i++) {
+    MVertex *v = sorted[i].second;
+    if(!v) continue;
+    GEntity *ge = v->onWhat();
+    if(ge)
+      ge->mesh_vertices.push_back(v);
+    else {
+      delete v; // we delete all unused vertices
+      vertices[sorted[i].first] = nullptr;
+    }
+  }
+}
+
 void GModel::_storeVerticesInEntities(std::vector<MVertex *> &vertices)
 {
   for(std::size_t i = 0; i < vertices.size(); i++) {
@@ -2683,7 +2788,7 @@ void GModel::checkMeshCoherence(double tolerance)
     for(std::size_t i = 0; i < entities.size(); i++)
       vertices.insert(vertices.end(), entities[i]->mesh_vertices.begin(),
                       entities[i]->mesh_vertices.end());
-    MVertexRTree pos(eps);
+    MVertexHashGrid pos(eps);
     std::set<MVertex *, MVertexPtrLessThan> duplicates;
     int num = pos.insert(vertices, true, &duplicates);
     if(num) {
@@ -2721,7 +2826,7 @@ void GModel::checkMeshCoherence(double tolerance)
         vertices.push_back(new MVertex(p.x(), p.y(), p.z()));
       }
     }
-    MVertexRTree pos(eps);
+    MVertexHashGrid pos(eps);
     int num = pos.insert(vertices, true);
     for(std::size_t i = 0; i < vertices.size(); i++) delete vertices[i];
     if(num) Msg::Error("%d duplicate element%s", num, num > 1 ? "s" : "");
@@ -2765,34 +2870,22 @@ int GModel::removeDuplicateMeshVertices(double tolerance,
   std::vector<GEntity*> entities(ents);
   if(entities.empty()) getEntities(entities);
 
-  // re-index all vertices (don't use MVertex::getNum(), as we want to be able
-  // to remove duplicate vertices from "incorrect" meshes, where vertices with
-  // the same number are duplicated)
-  int n = 0;
-  for(std::size_t i = 0; i < entities.size(); i++) {
-    GEntity *ge = entities[i];
-    for(std::size_t j = 0; j < ge->mesh_vertices.size(); j++) {
-      MVertex *v = ge->mesh_vertices[j];
-      v->setIndex(++n);
-    }
-  }
+  // collect all the vertices (don't use MVertex::getNum(), as we want to be
+  // able to remove duplicate vertices from "incorrect" meshes, where vertices
+  // with the same number are duplicated)
+  std::vector<MVertex *> all;
+  for(std::size_t i = 0; i < entities.size(); i++)
+    all.insert(all.end(), entities[i]->mesh_vertices.begin(),
+               entities[i]->mesh_vertices.end());
 
-  MVertexRTree pos(eps);
-  std::map<int, MVertex *> vertices;
-  std::map<MVertex *, MVertex *> duplicates;
-  for(std::size_t i = 0; i < entities.size(); i++) {
-    GEntity *ge = entities[i];
-    for(std::size_t j = 0; j < ge->mesh_vertices.size(); j++) {
-      MVertex *v = ge->mesh_vertices[j];
-      MVertex *v2 = pos.insert(v);
-      if(v2)
-        duplicates[v] = v2; // v should be removed
-      else
-        vertices[v->getIndex()] = v;
-    }
-  }
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
 
-  int num = (int)duplicates.size();
+  // weld them in parallel: matches[i] is the vertex that replaces all[i], if
+  // all[i] is a duplicate
+  MVertexHashGrid pos(eps, nthreads);
+  std::vector<MVertex *> matches;
+  int num = (int)pos.insert(all, matches);
   Msg::Info("Found %d duplicate nodes ", num);
 
   if(!num) {
@@ -2800,25 +2893,45 @@ int GModel::removeDuplicateMeshVertices(double tolerance,
     return 0;
   }
 
+  // (address, index) pairs of the duplicates, sorted by address so that the
+  // replacements can be looked up concurrently
+  std::vector<std::pair<uint64_t, std::size_t> > duplicates;
+  std::vector<MVertex *> vertices;
+  duplicates.reserve(num);
+  vertices.reserve(all.size() - num);
+  for(std::size_t i = 0; i < all.size(); i++) {
+    if(matches[i])
+      duplicates.push_back(std::make_pair((uint64_t)(uintptr_t)all[i], i));
+    else
+      vertices.push_back(all[i]);
+  }
+  SortCurveIndices(duplicates, nthreads);
+  auto replacement = [&](MVertex *v) -> MVertex * {
+    std::pair<uint64_t, std::size_t> key((uint64_t)(uintptr_t)v, 0);
+    auto it = std::lower_bound(duplicates.begin(), duplicates.end(), key);
+    if(it == duplicates.end() || it->first != key.first) return nullptr;
+    return matches[it->second];
+  };
+
   for(std::size_t i = 0; i < entities.size(); i++) {
     GEntity *ge = entities[i];
     // clear list of vertices owned by entity
     ge->mesh_vertices.clear();
     // replace vertices in element
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
     for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
       MElement *e = ge->getMeshElement(j);
       for(std::size_t k = 0; k < e->getNumVertices(); k++) {
-        auto it = duplicates.find(e->getVertex(k));
-        if(it != duplicates.end()) e->setVertex(k, it->second);
+        MVertex *v = replacement(e->getVertex(k));
+        if(v) e->setVertex(k, v);
       }
     }
     // replace vertices in periodic copies
     std::map<MVertex *, MVertex *> &corrVtcs = ge->correspondingVertices;
     if(corrVtcs.size()) {
-      std::map<MVertex *, MVertex *>::iterator cIter;
-      for(cIter = duplicates.begin(); cIter != duplicates.end(); ++cIter) {
-        MVertex *oldTgt = cIter->first;
-        MVertex *newTgt = cIter->second;
+      for(std::size_t j = 0; j < duplicates.size(); j++) {
+        MVertex *oldTgt = all[duplicates[j].second];
+        MVertex *newTgt = matches[duplicates[j].second];
         auto cvIter = corrVtcs.find(oldTgt);
         if(cvIter != corrVtcs.end()) {
           MVertex *src = cvIter->second;
@@ -2826,14 +2939,9 @@ int GModel::removeDuplicateMeshVertices(double tolerance,
           corrVtcs[newTgt] = src;
         }
       }
-      for(cIter = corrVtcs.begin(); cIter != corrVtcs.end(); ++cIter) {
-        MVertex *oldSrc = cIter->second;
-        auto nIter = duplicates.find(oldSrc);
-        if(nIter != duplicates.end()) {
-          MVertex *tgt = cIter->first;
-          MVertex *newSrc = nIter->second;
-          corrVtcs[tgt] = newSrc;
-        }
+      for(auto cIter = corrVtcs.begin(); cIter != corrVtcs.end(); ++cIter) {
+        MVertex *newSrc = replacement(cIter->second);
+        if(newSrc) cIter->second = newSrc;
       }
     }
   }
@@ -2843,10 +2951,8 @@ int GModel::removeDuplicateMeshVertices(double tolerance,
   _storeVerticesInEntities(vertices);
 
   // delete duplicates
-  std::vector<MVertex *> to_delete;
-  for(auto it = duplicates.begin(); it != duplicates.end(); it++)
-    to_delete.push_back(it->first);
-  for(std::size_t i = 0; i < to_delete.size(); i++) delete to_delete[i];
+  for(std::size_t j = 0; j < duplicates.size(); j++)
+    delete all[duplicates[j].second];
 
   if(CTX::instance()->mesh.renumber) {
     renumberMeshVertices();
@@ -21,6 +21,7 @@
 #include "SBoundingBox3d.h"
 #include "MFaceHash.h"
 #include "MEdgeHash.h"
+#include "MTagHashMap.h"
 
 #define hashmapMFace                                                           \
   std::unordered_map<MFace, std::size_t, MFaceHash, MFaceEqual>
@@ -39,6 +40,7 @@ class gLevelset;
 class discreteFace;
 class discreteRegion;
 class MElementOctree;
+class MSH4Stream;
 
 // A geometric model. The model is a "not yet" non-manifold B-Rep.
 class GModel {
@@ -99,9 +101,9 @@ protected:
   // vertex and element caches to speed-up direct access by tag (mostly
   // used for post-processing I/O)
   std::vector<MVertex *> _vertexVectorCache;
-  std::map<int, MVertex *> _vertexMapCache;
+  MTagHashMap<MVertex *> _vertexMapCache;
   std::vector<std::pair<MElement *, int> > _elementVectorCache;
-  std::map<int, std::pair<MElement *, int> > _elementMapCache;
+  MTagHashMap<std::pair<MElement *, int> > _elementMapCache;
   std::map<int, int> _elementIndexCache;
 
   // ghost cell information (stores partitions for each element acting
@@ -112,6 +114,9 @@ protected:
   // an octree for fast mesh element lookup
   MElementOctree *_elementOctree;
 
+  // the MSH4 file the mesh is being streamed to, if any
+  MSH4Stream *_msh4Stream;
+
   // global cache storage of discrete curvatures
   std::map<MVertex *, std::pair<SVector3, SVector3> > _curvatures;
 
@@ -156,6 +161,10 @@ protected:
   std::map<std::string, std::vector<std::string> > _attributes;
 
 protected:
+  // enable/disable the contiguous mesh vertex storage of the given entities
+  void _setContiguousMeshVertexStorage(const std::vector<GEntity *> &entities,
+                                       bool enable);
+
   // store the elements given in the map (indexed by elementary region
   // number) into the model, creating discrete geometrical entities on
   // the fly if needed
@@ -172,6 +181,7 @@ protected:
   // with, and delete those that are not associated with any entity
   void _storeVerticesInEntities(std::map<int, MVertex *> &vertices);
   void _storeVerticesInEntities(std::vector<MVertex *> &vertices);
+  void _storeVerticesInEntities(MTagHashMap<MVertex *> &vertices);
 
   // store the physical tags in the geometrical entities
   void
@@ -288,9 +298,11 @@ public:
   hashmapMFace::const_iterator lastMFace() { return _mapFaceNum.end(); }
 
   // renumber mesh vertices and elements in a continuous sequence (this
-  // invalidates the mesh caches)
-  void renumberMeshVertices();
-  void renumberMeshElements();
+  // invalidates the mesh caches), in the order of the entities or following
+  // one of the orderings of Mesh.RenumberAlgorithm (if algorithm < 0, the
+  // value of the option is used)
+  void renumberMeshVertices(int algorithm = -1);
+  void renumberMeshElements(int algorithm = -1);
 
   // delete all the mesh-related caches (this must be called when the
   // mesh is changed)
@@ -298,6 +310,11 @@ public:
   // delete the mesh stored in entities and call destroMeshCaches
   void deleteMesh();
   void deleteMesh(const std::vector<GEntity *> &entities);
+  // enable/disable the contiguous storage of mesh vertex coordinates and tags
+  // in all the entities (see GEntity::setContiguousMeshVertexStorage), and
+  // rebuild the storage of the entities whose mesh vertices have changed
+  void setContiguousMeshVertexStorage(bool enable);
+  void syncMeshVertexStorage();
   // delete the vertex arrays used for efficient mesh drawing
   void deleteVertexArrays();
   // delete the vertex arrays used for efficient geometry drawing
@@ -537,14 +554,17 @@ public:
                                   bool strict = true);
   std::vector<MElement *> getMeshElementsByCoord(SPoint3 &p, int dim = -1,
                                                  bool strict = true);
+  // build the octree used by the two functions above if needed, so that they
+  // can then be called concurrently
+  void buildMeshElementOctree();
 
   // access a mesh element by tag, using the element cache
-  MElement *getMeshElementByTag(int n)
+  MElement *getMeshElementByTag(std::size_t n)
   {
     int tag;
     return getMeshElementByTag(n, tag);
   }
-  MElement *getMeshElementByTag(int n, int &entityTag);
+  MElement *getMeshElementByTag(std::size_t n, int &entityTag);
 
   // access temporary mesh element index
   int getMeshElementIndex(MElement *e);
@@ -554,15 +574,15 @@ public:
   std::size_t getNumMeshVertices(int dim = -1) const;
 
   // recompute _vertexVectorCache if there is a dense vertex numbering or
-  // _vertexMapCache if not.
+  // _vertexMapCache (a hash map) if not; the cache is built in parallel
   void rebuildMeshVertexCache(bool onlyIfNecessary = false);
 
   // recompute _elementVectorCache if there is a dense element numbering or
-  // _elementMapCache if not.
+  // _elementMapCache (a hash map) if not; the cache is built in parallel
   void rebuildMeshElementCache(bool onlyIfNecessary = false);
 
   // access a mesh vertex by tag, using the vertex cache
-  MVertex *getMeshVertexByTag(int n);
+  MVertex *getMeshVertexByTag(std::size_t n);
 
   // add a mesh vertex to the global mesh vertex cache
   void addMVertexToVertexCache(MVertex* v);
@@ -785,6 +805,16 @@ public:
                           bool saveParametric = false,
                           double scalingFactor = 1.0);
 
+  // streaming (out-of-core) MSH4 output: once the stream is open, the mesh of
+  // each entity passed to streamMSH4() is written out immediately and can
+  // then be deleted; endStreamMSH4() writes the mesh of the entities that
+  // have not been streamed yet and assembles the final file
+  int beginStreamMSH4(const std::string &name, bool binary = false,
+                      double scalingFactor = 1.0);
+  int streamMSH4(GEntity *ge);
+  int endStreamMSH4();
+  bool isStreamingMSH4() const { return _msh4Stream != nullptr; }
+
   // Iridium file format
   int writeIR3(const std::string &name, int elementTagType, bool saveAll,
                double scalingFactor);
@@ -868,6 +898,13 @@ public:
   int writeVTK(const std::string &name, bool binary = false,
                bool saveAll = false, double scalingFactor = 1.0,
                bool bigEndian = false);
+  // VTK XML format: write a single piece in a .vtu file, or one .vtu piece
+  // per partition and a .pvtu file referencing them if name ends with .pvtu;
+  // binary data is appended in raw form, compressed with zlib if compression
+  // is between 1 and 9
+  int writeVTU(const std::string &name, bool binary = false,
+               bool saveAll = false, double scalingFactor = 1.0,
+               int compression = 0);
 
   // Matlab format
   int writeMATLAB(const std::string &name, bool binary = false,
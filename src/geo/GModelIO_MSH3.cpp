@@ -425,8 +425,10 @@ int GModel::_readMSH3(const std::string &name)
           _vertexVectorCache[0] = nullptr;
         else
           _vertexVectorCache[numVertices] = nullptr;
-        for(auto it = _vertexMapCache.begin(); it != _vertexMapCache.end(); ++it)
-          _vertexVectorCache[it->first] = it->second;
+        std::vector<std::pair<std::size_t, MVertex *> > sorted;
+        _vertexMapCache.getSorted(sorted);
+        for(std::size_t i = 0; i < sorted.size(); i++)
+          _vertexVectorCache[sorted[i].first] = sorted[i].second;
         _vertexMapCache.clear();
       }
     }
@@ -16,6 +16,9 @@
 #include <cstdlib>
 #include <limits>
 #include <stdexcept>
+#include <cstring>
+#include <cstdarg>
+#include <functional>
 
 #include "GmshDefines.h"
 #include "OS.h"
@@ -459,6 +462,329 @@ static bool readMSH4Entities(GModel *const model, FILE *fp, bool partition,
   return true;
 }
 
+static GEntity *getOrCreateMSH4Entity(GModel *const model, int entityDim,
+                                      int entityTag)
+{
+  GEntity *entity = model->getEntityByTag(entityDim, entityTag);
+  if(entity) return entity;
+  switch(entityDim) {
+  case 0: {
+    Msg::Info("Creating discrete point %d", entityTag);
+    GVertex *gv = new discreteVertex(model, entityTag);
+    GModel::current()->add(gv);
+    return gv;
+  }
+  case 1: {
+    Msg::Info("Creating discrete curve %d", entityTag);
+    GEdge *ge = new discreteEdge(model, entityTag, nullptr, nullptr);
+    GModel::current()->add(ge);
+    return ge;
+  }
+  case 2: {
+    Msg::Info("Creating discrete surface %d", entityTag);
+    GFace *gf = new discreteFace(model, entityTag);
+    GModel::current()->add(gf);
+    return gf;
+  }
+  case 3: {
+    Msg::Info("Creating discrete volume %d", entityTag);
+    GRegion *gr = new discreteRegion(model, entityTag);
+    GModel::current()->add(gr);
+    return gr;
+  }
+  default:
+    Msg::Error("Invalid dimension %d to create discrete entity", entityDim);
+    return nullptr;
+  }
+}
+
+// Binary MSH 4.1 $Nodes and $Elements sections are read by memory-mapping the
+// file: the entity blocks are first indexed, then decoded in parallel (large
+// blocks being split in chunks) into the preallocated node or element cache;
+// the nodes and elements are finally added to their entities serially, in
+// file order, so that the resulting mesh is identical to the one produced by
+// the serial reader.
+
+struct MSH4BinaryBlock {
+  GEntity *entity;
+  int entityTag;
+  int type; // parametric flag for nodes, element type for elements
+  std::size_t num; // number of nodes or elements in the block
+  std::size_t first; // index of the first node or element in the section
+  std::size_t offset; // offset of the block data in the mapped region
+};
+
+struct MSH4BinaryChunk {
+  std::size_t block, begin, end;
+};
+
+static const std::size_t MSH4ChunkSize = 65536;
+
+static bool indexMSH4BinaryBlocks(GModel *const model, const char *data,
+                                  std::size_t size, std::size_t numBlock,
+                                  std::size_t totalNum, bool nodes, bool swap,
+                                  std::vector<MSH4BinaryBlock> &blocks,
+                                  std::vector<MSH4BinaryChunk> &chunks,
+                                  std::size_t &consumed)
+{
+  std::size_t pos = 0, first = 0;
+  blocks.resize(numBlock);
+  for(std::size_t i = 0; i < numBlock; i++) {
+    if(pos + 3 * sizeof(int) + sizeof(std::size_t) > size) return false;
+    int header[3];
+    std::size_t num;
+    memcpy(header, data + pos, 3 * sizeof(int));
+    memcpy(&num, data + pos + 3 * sizeof(int), sizeof(std::size_t));
+    pos += 3 * sizeof(int) + sizeof(std::size_t);
+    if(swap) {
+      SwapBytes((char *)header, sizeof(int), 3);
+      SwapBytes((char *)&num, sizeof(std::size_t), 1);
+    }
+    MSH4BinaryBlock &b = blocks[i];
+    b.entityTag = header[1];
+    b.type = header[2];
+    b.num = num;
+    b.first = first;
+    b.offset = pos;
+    std::size_t n;
+    if(nodes) {
+      b.entity = getOrCreateMSH4Entity(model, header[0], header[1]);
+      if(!b.entity) return false;
+      // tags, then coordinates
+      n = 1 + 3 + (b.type ? header[0] : 0);
+    }
+    else {
+      b.entity = model->getEntityByTag(header[0], header[1]);
+      if(!b.entity) {
+        Msg::Error("Unknown entity %d of dimension %d", header[1], header[0]);
+        return false;
+      }
+      if(b.type <= 0 || b.type > MSH_MAX_NUM) {
+        Msg::Error("Unknown element type %d", b.type);
+        return false;
+      }
+      n = 1 + MElement::getInfoMSH(b.type);
+    }
+    if(num > (size - pos) / (n * sizeof(std::size_t))) return false;
+    pos += num * n * sizeof(std::size_t);
+    first += num;
+    if(first > totalNum) return false;
+    for(std::size_t j = 0; j < num; j += MSH4ChunkSize) {
+      MSH4BinaryChunk c = {i, j, std::min(num, j + MSH4ChunkSize)};
+      chunks.push_back(c);
+    }
+  }
+  consumed = pos;
+  return first == totalNum;
+}
+
+// returns 1 if the nodes have been read, 0 if the file could not be mapped (in
+// which case nothing has been read) and -1 on error
+static int readMSH4NodesMapped(GModel *const model, FILE *fp,
+                               std::size_t numBlock, std::size_t totalNumNodes,
+                               bool swap,
+                               std::pair<std::size_t, MVertex *> *vertexCache,
+                               std::size_t &minNodeNum,
+                               std::size_t &maxNodeNum)
+{
+  std::size_t offset = GetFilePosition(fp);
+  std::size_t fileSize = GetFileSize(fp);
+  if(fileSize <= offset) return 0;
+  void *handle = nullptr;
+  const char *data = MapFileRegion(fp, offset, fileSize - offset, &handle);
+  if(!data) return 0;
+
+  std::vector<MSH4BinaryBlock> blocks;
+  std::vector<MSH4BinaryChunk> chunks;
+  std::size_t consumed = 0;
+  if(!indexMSH4BinaryBlocks(model, data, fileSize - offset, numBlock,
+                            totalNumNodes, true, swap, blocks, chunks,
+                            consumed)) {
+    UnmapFileRegion(handle);
+    return -1;
+  }
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::vector<std::size_t> minTags(chunks.size()), maxTags(chunks.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < chunks.size(); i++) {
+    const MSH4BinaryChunk &c = chunks[i];
+    const MSH4BinaryBlock &b = blocks[c.block];
+    const int dim = b.entity->dim();
+    const std::size_t n = 3 + (b.type ? dim : 0);
+    const std::size_t num = c.end - c.begin;
+    std::vector<std::size_t> tags(num);
+    std::vector<double> coord(n * num);
+    memcpy(&tags[0], data + b.offset + c.begin * sizeof(std::size_t),
+           num * sizeof(std::size_t));
+    memcpy(&coord[0],
+           data + b.offset + b.num * sizeof(std::size_t) +
+             c.begin * n * sizeof(double),
+           n * num * sizeof(double));
+    if(swap) {
+      SwapBytes((char *)&tags[0], sizeof(std::size_t), num);
+      SwapBytes((char *)&coord[0], sizeof(double), n * num);
+    }
+    std::size_t minTag = std::numeric_limits<std::size_t>::max(), maxTag = 0;
+    for(std::size_t j = 0, k = 0; j < num; j++, k += n) {
+      MVertex *mv = nullptr;
+      if(n == 5) {
+        mv = new MFaceVertex(coord[k], coord[k + 1], coord[k + 2], b.entity,
+                             coord[k + 3], coord[k + 4], tags[j]);
+      }
+      else if(n == 4) {
+        mv = new MEdgeVertex(coord[k], coord[k + 1], coord[k + 2], b.entity,
+                             coord[k + 3], tags[j]);
+      }
+      else {
+        mv = new MVertex(coord[k], coord[k + 1], coord[k + 2], b.entity,
+                         tags[j]);
+      }
+      minTag = std::min(minTag, tags[j]);
+      maxTag = std::max(maxTag, tags[j]);
+      vertexCache[b.first + c.begin + j] = std::make_pair(tags[j], mv);
+    }
+    minTags[i] = minTag;
+    maxTags[i] = maxTag;
+  }
+
+  for(std::size_t i = 0; i < chunks.size(); i++) {
+    minNodeNum = std::min(minNodeNum, minTags[i]);
+    maxNodeNum = std::max(maxNodeNum, maxTags[i]);
+  }
+  // the max vertex number is not updated atomically by the constructors
+  model->setMaxVertexNumber(maxNodeNum);
+
+  for(std::size_t i = 0; i < blocks.size(); i++) {
+    const MSH4BinaryBlock &b = blocks[i];
+    b.entity->mesh_vertices.reserve(b.entity->mesh_vertices.size() + b.num);
+    for(std::size_t j = 0; j < b.num; j++)
+      b.entity->addMeshVertex(vertexCache[b.first + j].second);
+  }
+
+  UnmapFileRegion(handle);
+  SetFilePosition(fp, offset + consumed);
+  return 1;
+}
+
+// returns 1 if the elements have been read, 0 if the file could not be mapped
+// (in which case nothing has been read) and -1 on error
+static int readMSH4ElementsMapped(
+  GModel *const model, FILE *fp, std::size_t numBlock,
+  std::size_t totalNumElements, bool swap,
+  std::pair<std::size_t, std::pair<MElement *, int> > *elementCache,
+  std::size_t &minElementNum, std::size_t &maxElementNum)
+{
+  std::size_t offset = GetFilePosition(fp);
+  std::size_t fileSize = GetFileSize(fp);
+  if(fileSize <= offset) return 0;
+  void *handle = nullptr;
+  const char *data = MapFileRegion(fp, offset, fileSize - offset, &handle);
+  if(!data) return 0;
+
+  std::vector<MSH4BinaryBlock> blocks;
+  std::vector<MSH4BinaryChunk> chunks;
+  std::size_t consumed = 0;
+  if(!indexMSH4BinaryBlocks(model, data, fileSize - offset, numBlock,
+                            totalNumElements, false, swap, blocks, chunks,
+                            consumed)) {
+    UnmapFileRegion(handle);
+    return -1;
+  }
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // make sure node lookups are read-only in the parallel loop
+  model->rebuildMeshVertexCache(true);
+
+  bool error = false;
+  std::vector<std::size_t> minTags(chunks.size()), maxTags(chunks.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t i = 0; i < chunks.size(); i++) {
+    if(error) continue;
+    const MSH4BinaryChunk &c = chunks[i];
+    const MSH4BinaryBlock &b = blocks[c.block];
+    const int numVertPerElm = MElement::getInfoMSH(b.type);
+    const std::size_t n = 1 + numVertPerElm;
+    const std::size_t num = c.end - c.begin;
+    std::vector<std::size_t> tags(n * num);
+    memcpy(&tags[0], data + b.offset + c.begin * n * sizeof(std::size_t),
+           n * num * sizeof(std::size_t));
+    if(swap) SwapBytes((char *)&tags[0], sizeof(std::size_t), n * num);
+    std::vector<MVertex *> vertices(numVertPerElm, (MVertex *)nullptr);
+    std::size_t minTag = std::numeric_limits<std::size_t>::max(), maxTag = 0;
+    MElementFactory elementFactory;
+    for(std::size_t j = 0, k = 0; j < num; j++, k += n) {
+      elementCache[b.first + c.begin + j] =
+        std::make_pair(tags[k], std::make_pair((MElement *)nullptr, 0));
+      for(int l = 0; l < numVertPerElm; l++) {
+        vertices[l] = model->getMeshVertexByTag(tags[k + l + 1]);
+        if(!vertices[l]) {
+          Msg::Error("Unknown node %lu in element %lu", tags[k + l + 1],
+                     tags[k]);
+          error = true;
+          break;
+        }
+      }
+      if(error) break;
+      MElement *element = elementFactory.create(
+        b.type, vertices, tags[k], 0, false, 0, nullptr, nullptr, nullptr);
+      if(!element) {
+        Msg::Error("Could not create element %lu of type %d", tags[k], b.type);
+        error = true;
+        break;
+      }
+      minTag = std::min(minTag, tags[k]);
+      maxTag = std::max(maxTag, tags[k]);
+      elementCache[b.first + c.begin + j].second.first = element;
+      elementCache[b.first + c.begin + j].second.second = b.entityTag;
+    }
+    minTags[i] = minTag;
+    maxTags[i] = maxTag;
+  }
+
+  UnmapFileRegion(handle);
+
+  if(error) {
+    // elements created in other chunks are not owned by any entity yet
+    for(std::size_t i = 0; i < totalNumElements; i++)
+      delete elementCache[i].second.first;
+    return -1;
+  }
+
+  for(std::size_t i = 0; i < chunks.size(); i++) {
+    minElementNum = std::min(minElementNum, minTags[i]);
+    maxElementNum = std::max(maxElementNum, maxTags[i]);
+  }
+  // the max element number is not updated atomically by the constructors
+  model->setMaxElementNumber(maxElementNum);
+
+  for(std::size_t i = 0; i < blocks.size(); i++) {
+    const MSH4BinaryBlock &b = blocks[i];
+    if(b.entity->geomType() == GEntity::GhostCurve) {
+      static_cast<ghostEdge *>(b.entity)->haveMesh(true);
+    }
+    else if(b.entity->geomType() == GEntity::GhostSurface) {
+      static_cast<ghostFace *>(b.entity)->haveMesh(true);
+    }
+    else if(b.entity->geomType() == GEntity::GhostVolume) {
+      static_cast<ghostRegion *>(b.entity)->haveMesh(true);
+    }
+    else {
+      for(std::size_t j = 0; j < b.num; j++) {
+        MElement *element = elementCache[b.first + j].second.first;
+        b.entity->addElement(element->getType(), element);
+      }
+    }
+  }
+
+  SetFilePosition(fp, offset + consumed);
+  return 1;
+}
+
 static std::pair<std::size_t, MVertex *> *
 readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
               std::size_t &totalNumNodes, std::size_t &maxNodeNum, bool swap,
@@ -498,9 +824,21 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
     new std::pair<std::size_t, MVertex *>[totalNumNodes];
 
   Msg::Info("%lu node%s", totalNumNodes, totalNumNodes > 1 ? "s" : "");
+
+  bool mapped = false;
+  if(binary) {
+    int ret = readMSH4NodesMapped(model, fp, numBlock, totalNumNodes, swap,
+                                  vertexCache, minNodeNum, maxNodeNum);
+    if(ret < 0) {
+      delete[] vertexCache;
+      return nullptr;
+    }
+    mapped = (ret == 1);
+  }
+
   Msg::StartProgressMeter(totalNumNodes);
 
-  for(std::size_t i = 0; i < numBlock; i++) {
+  for(std::size_t i = 0; !mapped && i < numBlock; i++) {
     int parametric = 0;
     int entityTag = 0, entityDim = 0;
     std::size_t numNodes = 0;
@@ -539,43 +877,10 @@ readMSH4Nodes(GModel *const model, FILE *fp, bool binary, bool &dense,
       }
     }
 
-    GEntity *entity = model->getEntityByTag(entityDim, entityTag);
+    GEntity *entity = getOrCreateMSH4Entity(model, entityDim, entityTag);
     if(!entity) {
-      switch(entityDim) {
-      case 0: {
-        Msg::Info("Creating discrete point %d", entityTag);
-        GVertex *gv = new discreteVertex(model, entityTag);
-        GModel::current()->add(gv);
-        entity = gv;
-        break;
-      }
-      case 1: {
-        Msg::Info("Creating discrete curve %d", entityTag);
-        GEdge *ge = new discreteEdge(model, entityTag, nullptr, nullptr);
-        GModel::current()->add(ge);
-        entity = ge;
-        break;
-      }
-      case 2: {
-        Msg::Info("Creating discrete surface %d", entityTag);
-        GFace *gf = new discreteFace(model, entityTag);
-        GModel::current()->add(gf);
-        entity = gf;
-        break;
-      }
-      case 3: {
-        Msg::Info("Creating discrete volume %d", entityTag);
-        GRegion *gr = new discreteRegion(model, entityTag);
-        GModel::current()->add(gr);
-        entity = gr;
-        break;
-      }
-      default: {
-        Msg::Error("Invalid dimension %d to create discrete entity", entityDim);
-        delete[] vertexCache;
-        return nullptr;
-      }
-      }
+      delete[] vertexCache;
+      return nullptr;
     }
 
     std::size_t n = 3;
@@ -749,9 +1054,22 @@ readMSH4Elements(GModel *const model, FILE *fp, bool binary, bool &dense,
   std::pair<std::size_t, std::pair<MElement *, int> > *elementCache =
     new std::pair<std::size_t, std::pair<MElement *, int> >[totalNumElements];
   Msg::Info("%lu element%s", totalNumElements, totalNumElements > 1 ? "s" : "");
+
+  bool mapped = false;
+  if(binary) {
+    int ret = readMSH4ElementsMapped(model, fp, numBlock, totalNumElements,
+                                     swap, elementCache, minElementNum,
+                                     maxElementNum);
+    if(ret < 0) {
+      delete[] elementCache;
+      return nullptr;
+    }
+    mapped = (ret == 1);
+  }
+
   Msg::StartProgressMeter(totalNumElements);
 
-  for(std::size_t i = 0; i < numBlock; i++) {
+  for(std::size_t i = 0; !mapped && i < numBlock; i++) {
     int entityTag = 0, entityDim = 0, elmType = 0;
     std::size_t numElements = 0;
 
@@ -1381,14 +1699,12 @@ int GModel::_readMSH4(const std::string &name)
         }
       }
       else {
-        for(std::size_t i = 0; i < totalNumNodes; i++) {
-          if(_vertexMapCache.count(vertexCache[i].first) == 0) {
-            _vertexMapCache[vertexCache[i].first] = vertexCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate node %d", vertexCache[i].first);
-          }
-        }
+        int nthreads = CTX::instance()->numThreads;
+        if(!nthreads) nthreads = Msg::GetMaxThreads();
+        _vertexMapCache.insert(vertexCache, totalNumNodes, nthreads);
+        if(_vertexMapCache.size() < totalNumNodes)
+          Msg::Info("Skipping %lu duplicate nodes",
+                    totalNumNodes - _vertexMapCache.size());
       }
       delete[] vertexCache;
     }
@@ -1416,14 +1732,13 @@ int GModel::_readMSH4(const std::string &name)
         }
       }
       else {
-        for(std::size_t i = 0; i < totalNumElements; i++) {
-          if(_elementMapCache.count(elementCache[i].first) == 0) {
-            _elementMapCache[elementCache[i].first] = elementCache[i].second;
-          }
-          else {
-            Msg::Info("Skipping duplicate element %d", elementCache[i].first);
-          }
-        }
+        int nthreads = CTX::instance()->numThreads;
+        if(!nthreads) nthreads = Msg::GetMaxThreads();
+        std::size_t numBefore = _elementMapCache.size();
+        _elementMapCache.insert(elementCache, totalNumElements, nthreads);
+        if(_elementMapCache.size() - numBefore < totalNumElements)
+          Msg::Info("Skipping %lu duplicate elements",
+                    totalNumElements - (_elementMapCache.size() - numBefore));
       }
       delete[] elementCache;
     }
@@ -1524,6 +1839,9 @@ int GModel::_readMSH4(const std::string &name)
     }
   }
 
+  if(CTX::instance()->mesh.contiguousNodeStorage)
+    setContiguousMeshVertexStorage(true);
+
   return postpro ? 2 : 1;
 }
 
@@ -1997,9 +2315,87 @@ static void writeMSH4Entities(GModel *const model, FILE *fp, bool partition,
     fprintf(fp, "$EndEntities\n");
 }
 
-static void writeMSH4EntityNodes(GEntity *ge, FILE *fp, bool binary,
-                                 int saveParametric, double scalingFactor,
-                                 double version)
+// The nodes and elements of binary and ASCII MSH4 files are serialized in
+// chunks (at most MSH4ChunkSize nodes or elements each). Chunks are
+// serialized in parallel into separate buffers, then written out in order
+// with large writes; or, for binary files and Mesh.MshFileParallelWrite = 2,
+// directly at their final offset in the file, which is known in advance.
+
+struct MSH4OutputChunk {
+  std::size_t size; // size in bytes if known in advance (binary), 0 otherwise
+  std::function<void(std::string &)> serialize;
+};
+
+static void appendBinary(std::string &buf, const void *data, std::size_t size)
+{
+  buf.append((const char *)data, size);
+}
+
+static void appendASCII(std::string &buf, const char *fmt, ...)
+{
+  char str[256];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(str, sizeof(str), fmt, args);
+  va_end(args);
+  if(n > 0) buf.append(str, std::min((std::size_t)n, sizeof(str) - 1));
+}
+
+static void writeMSH4OutputChunks(FILE *fp,
+                                  const std::vector<MSH4OutputChunk> &chunks)
+{
+  if(chunks.empty()) return;
+
+  int mode = CTX::instance()->mesh.mshFileParallelWrite;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  if(!mode) nthreads = 1;
+
+  if(mode == 2) {
+    std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+    bool known = true;
+    for(std::size_t i = 0; i < chunks.size(); i++) {
+      if(!chunks[i].size) known = false;
+      offsets[i + 1] = offsets[i] + chunks[i].size;
+    }
+    if(known) {
+      fflush(fp);
+      std::size_t base = GetFilePosition(fp);
+      bool ok = true;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(std::size_t i = 0; i < chunks.size(); i++) {
+        if(!ok) continue;
+        std::string buf;
+        buf.reserve(chunks[i].size);
+        chunks[i].serialize(buf);
+        if(buf.size() != chunks[i].size ||
+           !WriteFileRegion(fp, base + offsets[i], buf.data(), buf.size()))
+          ok = false;
+      }
+      if(SetFilePosition(fp, ok ? base + offsets.back() : base) && ok) return;
+      Msg::Debug("Positional writes failed: reverting to ordered writes");
+    }
+  }
+
+  // bound the memory used by the buffers by serializing a few chunks per
+  // thread at a time
+  std::vector<std::string> bufs(4 * nthreads);
+  for(std::size_t start = 0; start < chunks.size(); start += bufs.size()) {
+    std::size_t end = std::min(chunks.size(), start + bufs.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = start; i < end; i++) {
+      bufs[i - start].clear();
+      chunks[i].serialize(bufs[i - start]);
+    }
+    for(std::size_t i = start; i < end; i++)
+      fwrite(bufs[i - start].data(), 1, bufs[i - start].size(), fp);
+  }
+}
+
+static void addMSH4EntityNodesChunks(GEntity *ge, bool binary,
+                                     int saveParametric, double scalingFactor,
+                                     double version,
+                                     std::vector<MSH4OutputChunk> &chunks)
 {
   int parametric = saveParametric;
   if(ge->dim() != 1 && ge->dim() != 2)
@@ -2007,70 +2403,170 @@ static void writeMSH4EntityNodes(GEntity *ge, FILE *fp, bool binary,
 
   std::size_t numVerts = ge->getNumMeshVertices();
 
-  if(binary) {
-    int entityDim = ge->dim();
-    int entityTag = ge->tag();
-    fwrite(&entityDim, sizeof(int), 1, fp);
-    fwrite(&entityTag, sizeof(int), 1, fp);
-    fwrite(&parametric, sizeof(int), 1, fp);
-    fwrite(&numVerts, sizeof(std::size_t), 1, fp);
-  }
-  else {
-    fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? ge->dim() : ge->tag(),
-            (version >= 4.1) ? ge->tag() : ge->dim(), parametric,
-            ge->getNumMeshVertices());
-  }
+  MSH4OutputChunk header;
+  header.size = binary ? 3 * sizeof(int) + sizeof(std::size_t) : 0;
+  header.serialize = [=](std::string &buf) {
+    if(binary) {
+      int data[3] = {ge->dim(), ge->tag(), parametric};
+      appendBinary(buf, data, 3 * sizeof(int));
+      appendBinary(buf, &numVerts, sizeof(std::size_t));
+    }
+    else {
+      appendASCII(buf, "%d %d %d %lu\n",
+                  (version >= 4.1) ? ge->dim() : ge->tag(),
+                  (version >= 4.1) ? ge->tag() : ge->dim(), parametric,
+                  numVerts);
+    }
+  };
+  chunks.push_back(header);
 
-  if(!numVerts) {
-    return;
-  }
+  if(!numVerts) return;
 
   std::size_t n = 3;
   if(parametric) n += ge->dim();
 
-  if(binary) {
-    std::vector<size_t> tags(numVerts);
-    for(std::size_t i = 0; i < numVerts; i++)
-      tags[i] = ge->getMeshVertex(i)->getNum();
-    fwrite(&tags[0], sizeof(std::size_t), numVerts, fp);
-    std::vector<double> coord(n * numVerts);
-    std::size_t j = 0;
-    for(std::size_t i = 0; i < numVerts; i++) {
-      MVertex *mv = ge->getMeshVertex(i);
-      coord[j++] = mv->x() * scalingFactor;
-      coord[j++] = mv->y() * scalingFactor;
-      coord[j++] = mv->z() * scalingFactor;
-      if(n >= 4) mv->getParameter(0, coord[j++]);
-      if(n == 5) mv->getParameter(1, coord[j++]);
-    }
-    fwrite(&coord[0], sizeof(double), n * numVerts, fp);
+  // with contiguous node storage, binary tags and coordinates are copied
+  // directly from the arrays of the entity (which are synchronized here, as
+  // the chunks are serialized concurrently)
+  const double *storedXYZ = nullptr;
+  const std::size_t *storedTags = nullptr;
+  if(binary && ge->hasContiguousMeshVertexStorage()) {
+    storedXYZ = ge->getMeshVertexCoordinates();
+    storedTags = ge->getMeshVertexTags();
+  }
+
+  // tags first (in binary and in ASCII for version >= 4.1), then coordinates
+  if(binary || version >= 4.1) {
+    for(std::size_t begin = 0; begin < numVerts;
+        begin += MSH4ChunkSize) {
+      std::size_t end = std::min(numVerts, begin + MSH4ChunkSize);
+      MSH4OutputChunk c;
+      c.size = binary ? (end - begin) * sizeof(std::size_t) : 0;
+      c.serialize = [=](std::string &buf) {
+        if(binary && storedTags) {
+          appendBinary(buf, &storedTags[begin],
+                       (end - begin) * sizeof(std::size_t));
+        }
+        else if(binary) {
+          std::vector<std::size_t> tags(end - begin);
+          for(std::size_t i = begin; i < end; i++)
+            tags[i - begin] = ge->getMeshVertex(i)->getNum();
+          appendBinary(buf, &tags[0], tags.size() * sizeof(std::size_t));
+        }
+        else {
+          for(std::size_t i = begin; i < end; i++)
+            appendASCII(buf, "%lu\n", ge->getMeshVertex(i)->getNum());
+        }
+      };
+      chunks.push_back(c);
+    }
   }
-  else {
-    if(version >= 4.1) {
-      for(std::size_t i = 0; i < numVerts; i++)
-        fprintf(fp, "%lu\n", ge->getMeshVertex(i)->getNum());
-    }
-    for(std::size_t i = 0; i < numVerts; i++) {
-      MVertex *mv = ge->getMeshVertex(i);
-      double x = mv->x() * scalingFactor;
-      double y = mv->y() * scalingFactor;
-      double z = mv->z() * scalingFactor;
-      if(version < 4.1) fprintf(fp, "%lu ", mv->getNum());
-      if(n == 5) {
-        double u, v;
-        mv->getParameter(0, u);
-        mv->getParameter(1, v);
-        fprintf(fp, "%.16g %.16g %.16g %.16g %.16g\n", x, y, z, u, v);
+
+  for(std::size_t begin = 0; begin < numVerts; begin += MSH4ChunkSize) {
+    std::size_t end = std::min(numVerts, begin + MSH4ChunkSize);
+    MSH4OutputChunk c;
+    c.size = binary ? (end - begin) * n * sizeof(double) : 0;
+    c.serialize = [=](std::string &buf) {
+      if(storedXYZ && n == 3 && scalingFactor == 1.) {
+        appendBinary(buf, &storedXYZ[3 * begin],
+                     3 * (end - begin) * sizeof(double));
+        return;
       }
-      else if(n == 4) {
-        double u;
-        mv->getParameter(0, u);
-        fprintf(fp, "%.16g %.16g %.16g %.16g\n", x, y, z, u);
+      if(binary) {
+        std::vector<double> coord(n * (end - begin));
+        std::size_t j = 0;
+        for(std::size_t i = begin; i < end; i++) {
+          MVertex *mv = ge->getMeshVertex(i);
+          coord[j++] = mv->x() * scalingFactor;
+          coord[j++] = mv->y() * scalingFactor;
+          coord[j++] = mv->z() * scalingFactor;
+          if(n >= 4) mv->getParameter(0, coord[j++]);
+          if(n == 5) mv->getParameter(1, coord[j++]);
+        }
+        appendBinary(buf, &coord[0], coord.size() * sizeof(double));
+        return;
+      }
+      for(std::size_t i = begin; i < end; i++) {
+        MVertex *mv = ge->getMeshVertex(i);
+        double x = mv->x() * scalingFactor;
+        double y = mv->y() * scalingFactor;
+        double z = mv->z() * scalingFactor;
+        if(version < 4.1) appendASCII(buf, "%lu ", mv->getNum());
+        if(n == 5) {
+          double u, v;
+          mv->getParameter(0, u);
+          mv->getParameter(1, v);
+          appendASCII(buf, "%.16g %.16g %.16g %.16g %.16g\n", x, y, z, u, v);
+        }
+        else if(n == 4) {
+          double u;
+          mv->getParameter(0, u);
+          appendASCII(buf, "%.16g %.16g %.16g %.16g\n", x, y, z, u);
+        }
+        else {
+          appendASCII(buf, "%.16g %.16g %.16g\n", x, y, z);
+        }
+      }
+    };
+    chunks.push_back(c);
+  }
+}
+
+static void addMSH4ElementsChunks(int dim, int entityTag, int elmType,
+                                  const std::vector<MElement *> *elements,
+                                  bool binary, double version,
+                                  std::vector<MSH4OutputChunk> &chunks)
+{
+  std::size_t numElm = elements->size();
+  MSH4OutputChunk header;
+  header.size = binary ? 3 * sizeof(int) + sizeof(std::size_t) : 0;
+  header.serialize = [=](std::string &buf) {
+    if(binary) {
+      int data[3] = {dim, entityTag, elmType};
+      appendBinary(buf, data, 3 * sizeof(int));
+      appendBinary(buf, &numElm, sizeof(std::size_t));
+    }
+    else {
+      appendASCII(buf, "%d %d %d %lu\n",
+                  (version >= 4.1) ? dim : entityTag,
+                  (version >= 4.1) ? entityTag : dim, elmType, numElm);
+    }
+  };
+  chunks.push_back(header);
+
+  const int numVertPerElm = MElement::getInfoMSH(elmType);
+  for(std::size_t begin = 0; begin < numElm; begin += MSH4ChunkSize) {
+    std::size_t end = std::min(numElm, begin + MSH4ChunkSize);
+    MSH4OutputChunk c;
+    c.size =
+      binary ? (end - begin) * (1 + numVertPerElm) * sizeof(std::size_t) : 0;
+    c.serialize = [=](std::string &buf) {
+      if(binary) {
+        std::size_t n = 1 + numVertPerElm;
+        std::vector<std::size_t> tags((end - begin) * n);
+        std::size_t k = 0;
+        for(std::size_t i = begin; i < end; i++) {
+          MElement *e = (*elements)[i];
+          tags[k] = e->getNum();
+          for(int j = 0; j < numVertPerElm; j++) {
+            tags[k + 1 + j] = e->getVertex(j)->getNum();
+          }
+          k += n;
+        }
+        appendBinary(buf, &tags[0], tags.size() * sizeof(std::size_t));
       }
       else {
-        fprintf(fp, "%.16g %.16g %.16g\n", x, y, z);
+        for(std::size_t i = begin; i < end; i++) {
+          MElement *e = (*elements)[i];
+          appendASCII(buf, "%lu ", e->getNum());
+          for(std::size_t j = 0; j < e->getNumVertices(); j++) {
+            appendASCII(buf, "%lu ", e->getVertex(j)->getNum());
+          }
+          appendASCII(buf, "\n");
+        }
       }
-    }
+    };
+    chunks.push_back(c);
   }
 }
 
@@ -2379,22 +2875,24 @@ static void writeMSH4Nodes(GModel *const model, FILE *fp, bool partitioned,
     }
   }
 
+  std::vector<MSH4OutputChunk> chunks;
   for(auto it = vertices.begin(); it != vertices.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    addMSH4EntityNodesChunks(*it, binary, saveParametric, scalingFactor,
+                             version, chunks);
   }
   for(auto it = edges.begin(); it != edges.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    addMSH4EntityNodesChunks(*it, binary, saveParametric, scalingFactor,
+                             version, chunks);
   }
   for(auto it = faces.begin(); it != faces.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    addMSH4EntityNodesChunks(*it, binary, saveParametric, scalingFactor,
+                             version, chunks);
   }
   for(auto it = regions.begin(); it != regions.end(); ++it) {
-    writeMSH4EntityNodes(*it, fp, binary, saveParametric, scalingFactor,
-                         version);
+    addMSH4EntityNodesChunks(*it, binary, saveParametric, scalingFactor,
+                             version, chunks);
   }
+  writeMSH4OutputChunks(fp, chunks);
 
   if(binary) fprintf(fp, "\n");
 
@@ -2519,51 +3017,15 @@ static void writeMSH4Elements(GModel *const model, FILE *fp, bool partitioned,
       fprintf(fp, "%lu %lu\n", numSection, numElements);
   }
 
+  std::vector<MSH4OutputChunk> chunks;
   for(int dim = 0; dim <= 3; dim++) {
     for(auto it = elementsByType[dim].begin(); it != elementsByType[dim].end();
         ++it) {
-      int entityTag = it->first.first;
-      int elmType = it->first.second;
-      std::size_t numElm = it->second.size();
-      if(binary) {
-        fwrite(&dim, sizeof(int), 1, fp);
-        fwrite(&entityTag, sizeof(int), 1, fp);
-        fwrite(&elmType, sizeof(int), 1, fp);
-        fwrite(&numElm, sizeof(std::size_t), 1, fp);
-      }
-      else {
-        fprintf(fp, "%d %d %d %lu\n", (version >= 4.1) ? dim : entityTag,
-                (version >= 4.1) ? entityTag : dim, elmType, numElm);
-      }
-
-      std::size_t N = it->second.size();
-      if(binary) {
-        const int numVertPerElm = MElement::getInfoMSH(elmType);
-        std::size_t n = 1 + numVertPerElm;
-        std::vector<std::size_t> tags(N * n);
-        std::size_t k = 0;
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          tags[k] = e->getNum();
-          for(int j = 0; j < numVertPerElm; j++) {
-            tags[k + 1 + j] = e->getVertex(j)->getNum();
-          }
-          k += n;
-        }
-        fwrite(&tags[0], sizeof(std::size_t), N * n, fp);
-      }
-      else {
-        for(std::size_t i = 0; i < N; i++) {
-          MElement *e = it->second[i];
-          fprintf(fp, "%lu ", e->getNum());
-          for(std::size_t i = 0; i < e->getNumVertices(); i++) {
-            fprintf(fp, "%lu ", e->getVertex(i)->getNum());
-          }
-          fprintf(fp, "\n");
-        }
-      }
+      addMSH4ElementsChunks(dim, it->first.first, it->first.second,
+                            &it->second, binary, version, chunks);
     }
   }
+  writeMSH4OutputChunks(fp, chunks);
 
   if(binary) fprintf(fp, "\n");
 
@@ -2798,6 +3260,32 @@ static void writeMSH4Parametrizations(GModel *const model, FILE *fp,
   fprintf(fp, "$EndParametrizations\n");
 }
 
+static void writeMSH4Header(GModel *const model, FILE *fp, double version,
+                            bool binary)
+{
+  fprintf(fp, "$MeshFormat\n");
+  fprintf(fp, "%g %d %lu\n", version, (binary ? 1 : 0), sizeof(std::size_t));
+  if(binary) {
+    int one = 1;
+    fwrite(&one, sizeof(int), 1, fp); // swapping byte
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "$EndMeshFormat\n");
+
+  if(model->numPhysicalNames() > 0) {
+    fprintf(fp, "$PhysicalNames\n");
+    fprintf(fp, "%d\n", model->numPhysicalNames());
+    for(auto it = model->firstPhysicalName(); it != model->lastPhysicalName();
+        ++it) {
+      std::string name = it->second;
+      if(name.size() > 128) name.resize(128);
+      fprintf(fp, "%d %d \"%s\"\n", it->first.first, it->first.second,
+              name.c_str());
+    }
+    fprintf(fp, "$EndPhysicalNames\n");
+  }
+}
+
 int GModel::_writeMSH4(const std::string &name, double version, bool binary,
                        bool saveAll, bool saveParametric, double scalingFactor,
                        bool append, int partitionToSave,
@@ -2822,28 +3310,8 @@ int GModel::_writeMSH4(const std::string &name, double version, bool binary,
   // if there are no physicals we save all the elements
   if(noPhysicalGroups()) saveAll = true;
 
-  // header
-  fprintf(fp, "$MeshFormat\n");
-  fprintf(fp, "%g %d %lu\n", version, (binary ? 1 : 0), sizeof(std::size_t));
-  if(binary) {
-    int one = 1;
-    fwrite(&one, sizeof(int), 1, fp); // swapping byte
-    fprintf(fp, "\n");
-  }
-  fprintf(fp, "$EndMeshFormat\n");
-
-  // physicals
-  if(numPhysicalNames() > 0) {
-    fprintf(fp, "$PhysicalNames\n");
-    fprintf(fp, "%d\n", numPhysicalNames());
-    for(auto it = firstPhysicalName(); it != lastPhysicalName(); ++it) {
-      std::string name = it->second;
-      if(name.size() > 128) name.resize(128);
-      fprintf(fp, "%d %d \"%s\"\n", it->first.first, it->first.second,
-              name.c_str());
-    }
-    fprintf(fp, "$EndPhysicalNames\n");
-  }
+  // header and physicals
+  writeMSH4Header(this, fp, version, binary);
 
   // entities
   writeMSH4Entities(this, fp, false, binary, scalingFactor, version,
@@ -2959,6 +3427,209 @@ int GModel::_writePartitionedMSH4(const std::string &baseName, double version,
   return 1;
 }
 
+// Streaming (out-of-core) output: the node and element blocks of each entity
+// are appended to two temporary files as soon as the entity is streamed, so
+// that its mesh can be deleted right away. Since the number of blocks, nodes
+// and elements are only known at the end, the final file is assembled by
+// endStreamMSH4(), by copying the temporary files after the section headers.
+
+class MSH4Stream {
+public:
+  std::string name, nodesName, elementsName;
+  FILE *nodes, *elements;
+  bool binary, saveAll;
+  double scalingFactor;
+  std::size_t numNodeBlocks, numNodes, minNodeTag, maxNodeTag;
+  std::size_t numElementBlocks, numElements, minElementTag, maxElementTag;
+  // bounding boxes of the streamed entities, computed from their mesh
+  std::map<GEntity *, SBoundingBox3d> bounds;
+  MSH4Stream()
+    : nodes(nullptr), elements(nullptr), binary(false), saveAll(true),
+      scalingFactor(1.), numNodeBlocks(0), numNodes(0),
+      minNodeTag(std::numeric_limits<std::size_t>::max()), maxNodeTag(0),
+      numElementBlocks(0), numElements(0),
+      minElementTag(std::numeric_limits<std::size_t>::max()), maxElementTag(0)
+  {
+  }
+  ~MSH4Stream()
+  {
+    if(nodes) fclose(nodes);
+    if(elements) fclose(elements);
+    UnlinkFile(nodesName);
+    UnlinkFile(elementsName);
+  }
+};
+
+static bool copyMSH4StreamFile(FILE *src, FILE *dst)
+{
+  fflush(src);
+  rewind(src);
+  std::vector<char> buf(1 << 20);
+  std::size_t n;
+  while((n = fread(&buf[0], 1, buf.size(), src)) > 0) {
+    if(fwrite(&buf[0], 1, n, dst) != n) return false;
+  }
+  return !ferror(src);
+}
+
+int GModel::beginStreamMSH4(const std::string &name, bool binary,
+                            double scalingFactor)
+{
+  if(_msh4Stream) {
+    Msg::Error("MSH4 stream to '%s' is already open",
+               _msh4Stream->name.c_str());
+    return 0;
+  }
+  MSH4Stream *s = new MSH4Stream();
+  s->name = name;
+  s->nodesName = name + "_nodes.tmp";
+  s->elementsName = name + "_elements.tmp";
+  s->binary = binary;
+  s->saveAll = CTX::instance()->mesh.saveAll || noPhysicalGroups();
+  s->scalingFactor = scalingFactor;
+  s->nodes = Fopen(s->nodesName.c_str(), "w+b");
+  s->elements = Fopen(s->elementsName.c_str(), "w+b");
+  if(!s->nodes || !s->elements) {
+    Msg::Error("Unable to open temporary files for streaming '%s'",
+               name.c_str());
+    delete s;
+    return 0;
+  }
+  _msh4Stream = s;
+  Msg::Info("Streaming mesh to '%s'", name.c_str());
+  return 1;
+}
+
+int GModel::streamMSH4(GEntity *ge)
+{
+  MSH4Stream *s = _msh4Stream;
+  if(!s) {
+    Msg::Error("No MSH4 stream is open");
+    return 0;
+  }
+  if(s->bounds.count(ge)) {
+    Msg::Warning("Mesh of %s %d has already been streamed",
+                 ge->getTypeString().c_str(), ge->tag());
+    return 0;
+  }
+
+  // nodes
+  SBoundingBox3d bb;
+  for(std::size_t i = 0; i < ge->getNumMeshVertices(); i++) {
+    MVertex *v = ge->getMeshVertex(i);
+    bb += v->point();
+    s->minNodeTag = std::min(s->minNodeTag, v->getNum());
+    s->maxNodeTag = std::max(s->maxNodeTag, v->getNum());
+  }
+  s->bounds[ge] = bb.empty() ? ge->bounds() : bb;
+  s->numNodeBlocks++;
+  s->numNodes += ge->getNumMeshVertices();
+  std::vector<MSH4OutputChunk> chunks;
+  addMSH4EntityNodesChunks(ge, s->binary, 0, s->scalingFactor, 4.1, chunks);
+  writeMSH4OutputChunks(s->nodes, chunks);
+
+  // elements, grouped by type
+  if(!s->saveAll && ge->physicals.empty()) return 1;
+  std::map<int, std::vector<MElement *> > elementsByType;
+  for(std::size_t i = 0; i < ge->getNumMeshElements(); i++) {
+    MElement *e = ge->getMeshElement(i);
+    int type = e->getTypeForMSH();
+    if(!type) continue;
+    elementsByType[type].push_back(e);
+    s->minElementTag = std::min(s->minElementTag, e->getNum());
+    s->maxElementTag = std::max(s->maxElementTag, e->getNum());
+  }
+  chunks.clear();
+  for(auto it = elementsByType.begin(); it != elementsByType.end(); ++it) {
+    addMSH4ElementsChunks(ge->dim(), ge->tag(), it->first, &it->second,
+                          s->binary, 4.1, chunks);
+    s->numElementBlocks++;
+    s->numElements += it->second.size();
+  }
+  writeMSH4OutputChunks(s->elements, chunks);
+
+  if(ferror(s->nodes) || ferror(s->elements)) {
+    Msg::Error("Could not write mesh of %s %d to '%s'",
+               ge->getTypeString().c_str(), ge->tag(), s->name.c_str());
+    return 0;
+  }
+  return 1;
+}
+
+int GModel::endStreamMSH4()
+{
+  MSH4Stream *s = _msh4Stream;
+  if(!s) {
+    Msg::Error("No MSH4 stream is open");
+    return 0;
+  }
+
+  // stream the entities whose mesh is still in memory (usually all the
+  // entities of dimension < 3)
+  std::vector<GEntity *> entities;
+  getEntities(entities);
+  for(auto ge : entities) {
+    if(!s->bounds.count(ge)) streamMSH4(ge);
+  }
+  _msh4Stream = nullptr;
+
+  FILE *fp = Fopen(s->name.c_str(), s->binary ? "wb" : "w");
+  if(!fp) {
+    Msg::Error("Unable to open file '%s'", s->name.c_str());
+    delete s;
+    return 0;
+  }
+
+  writeMSH4Header(this, fp, 4.1, s->binary);
+  writeMSH4Entities(this, fp, false, s->binary, s->scalingFactor, 4.1,
+                    &s->bounds);
+
+  bool ok = true;
+  if(s->numNodes) {
+    fprintf(fp, "$Nodes\n");
+    if(s->binary) {
+      std::size_t data[4] = {s->numNodeBlocks, s->numNodes, s->minNodeTag,
+                             s->maxNodeTag};
+      fwrite(data, sizeof(std::size_t), 4, fp);
+    }
+    else {
+      fprintf(fp, "%lu %lu %lu %lu\n", s->numNodeBlocks, s->numNodes,
+              s->minNodeTag, s->maxNodeTag);
+    }
+    if(!copyMSH4StreamFile(s->nodes, fp)) ok = false;
+    if(s->binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndNodes\n");
+  }
+
+  if(s->numElements) {
+    fprintf(fp, "$Elements\n");
+    if(s->binary) {
+      std::size_t data[4] = {s->numElementBlocks, s->numElements,
+                             s->minElementTag, s->maxElementTag};
+      fwrite(data, sizeof(std::size_t), 4, fp);
+    }
+    else {
+      fprintf(fp, "%lu %lu %lu %lu\n", s->numElementBlocks, s->numElements,
+              s->minElementTag, s->maxElementTag);
+    }
+    if(!copyMSH4StreamFile(s->elements, fp)) ok = false;
+    if(s->binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndElements\n");
+  }
+
+  writeMSH4PeriodicNodes(this, fp, s->binary, 4.1);
+
+  fclose(fp);
+
+  if(ok)
+    Msg::Info("Done streaming mesh to '%s' (%lu nodes, %lu elements)",
+              s->name.c_str(), s->numNodes, s->numElements);
+  else
+    Msg::Error("Could not write file '%s'", s->name.c_str());
+  delete s;
+  return ok ? 1 : 0;
+}
+
 static bool getPhyscialNameInfo(const std::string &name, int &parentPhysicalTag,
                                 std::vector<int> &partitions)
 {
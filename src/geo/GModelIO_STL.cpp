@@ -4,6 +4,7 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <algorithm>
 #include <sstream>
@@ -12,13 +13,99 @@
 #include "MLine.h"
 #include "MTriangle.h"
 #include "MQuadrangle.h"
-#include "MVertexRTree.h"
+#include "MVertexHashGrid.h"
 #include "discreteFace.h"
 #include "StringUtils.h"
 #include "Context.h"
 
 static bool invalidChar(char c) { return !(c >= 32 && c <= 126); }
 
+// convert n binary STL facets (50 bytes each: normal, 3 nodes, attribute) to
+// node coordinates
+static void convertSTLFacets(const char *data, std::size_t n, bool swap,
+                             double *xyz, int nthreads)
+{
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    float f[12];
+    memcpy(f, &data[i * 50], 12 * sizeof(float));
+    if(swap) SwapBytes((char *)f, sizeof(float), 12);
+    for(int j = 0; j < 9; j++) xyz[9 * i + j] = f[3 + j];
+  }
+}
+
+// read the (possibly concatenated) solids of a binary STL file, by memory
+// mapping the file if possible; solid i has nodes [start[i], start[i + 1])
+static void readBinarySTL(FILE *fp, std::vector<double> &xyz,
+                          std::vector<std::size_t> &start,
+                          std::vector<std::string> &names, int nthreads)
+{
+  std::size_t fileSize = GetFileSize(fp);
+  void *handle = nullptr;
+  const char *data = fileSize ? MapFileRegion(fp, 0, fileSize, &handle) :
+                                nullptr;
+
+  if(data) {
+    // index the solids, then convert all the facets in parallel
+    std::vector<std::size_t> offsets, counts;
+    std::vector<bool> swaps;
+    std::size_t pos = 0, numFacets = 0;
+    while(pos + 84 <= fileSize) {
+      unsigned int nfacets;
+      memcpy(&nfacets, &data[pos + 80], sizeof(unsigned int));
+      bool swap = false;
+      if(nfacets > 100000000) {
+        Msg::Info("Swapping bytes from binary file");
+        swap = true;
+        SwapBytes((char *)&nfacets, sizeof(unsigned int), 1);
+      }
+      if(!nfacets) break;
+      names.push_back(std::string(&data[pos], strnlen(&data[pos], 80)));
+      start.push_back(3 * numFacets);
+      if(pos + 84 + 50 * (std::size_t)nfacets > fileSize) break;
+      offsets.push_back(pos + 84);
+      counts.push_back(nfacets);
+      swaps.push_back(swap);
+      numFacets += nfacets;
+      pos += 84 + 50 * (std::size_t)nfacets;
+    }
+    xyz.resize(9 * numFacets);
+    std::size_t first = 0;
+    for(std::size_t i = 0; i < offsets.size(); i++) {
+      convertSTLFacets(&data[offsets[i]], counts[i], swaps[i], &xyz[9 * first],
+                       nthreads);
+      first += counts[i];
+    }
+    UnmapFileRegion(handle);
+    return;
+  }
+
+  rewind(fp);
+  while(!feof(fp)) {
+    char header[80];
+    if(!fread(header, sizeof(char), 80, fp)) break;
+    unsigned int nfacets = 0;
+    size_t ret = fread(&nfacets, sizeof(unsigned int), 1, fp);
+    bool swap = false;
+    if(nfacets > 100000000) {
+      Msg::Info("Swapping bytes from binary file");
+      swap = true;
+      SwapBytes((char *)&nfacets, sizeof(unsigned int), 1);
+    }
+    if(ret && nfacets) {
+      names.push_back(std::string(header, strnlen(header, 80)));
+      start.push_back(xyz.size() / 3);
+      std::vector<char> buf(nfacets * 50);
+      ret = fread(&buf[0], sizeof(char), nfacets * 50, fp);
+      if(ret == nfacets * 50) {
+        std::size_t first = xyz.size();
+        xyz.resize(first + 9 * (std::size_t)nfacets);
+        convertSTLFacets(&buf[0], nfacets, swap, &xyz[first], nthreads);
+      }
+    }
+  }
+}
+
 int GModel::readSTL(const std::string &name, double tolerance)
 {
   FILE *fp = Fopen(name.c_str(), "rb");
@@ -27,9 +114,13 @@ int GModel::readSTL(const std::string &name, double tolerance)
     return 0;
   }
 
-  // store triplets of points for each solid found in the file
-  std::vector<std::vector<SPoint3> > points;
-  SBoundingBox3d bbox;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // store the coordinates of the triplets of points of all the solids found
+  // in the file: solid i has points [start[i], start[i + 1])
+  std::vector<double> xyz;
+  std::vector<std::size_t> start;
   std::vector<std::string> names;
 
   // "solid", or binary data header
@@ -39,8 +130,6 @@ int GModel::readSTL(const std::string &name, double tolerance)
     return 0;
   }
 
-  // SPoint3 p0(1.9e6, 4e6, 0);
-
   bool binary = strncmp(buffer, "solid", 5) && strncmp(buffer, "SOLID", 5);
 
   // ASCII STL
@@ -49,7 +138,7 @@ int GModel::readSTL(const std::string &name, double tolerance)
       names.push_back(&buffer[6]);
     else
       names.push_back("");
-    points.resize(1);
+    start.push_back(0);
     while(!feof(fp)) {
       // "facet normal x y z" or "endsolid"
       if(!fgets(buffer, sizeof(buffer), fp)) break;
@@ -61,7 +150,7 @@ int GModel::readSTL(const std::string &name, double tolerance)
             names.push_back(&buffer[6]);
           else
             names.push_back("");
-          points.resize(points.size() + 1);
+          start.push_back(xyz.size() / 3);
           // "facet normal x y z"
           if(!fgets(buffer, sizeof(buffer), fp)) break;
         }
@@ -74,10 +163,9 @@ int GModel::readSTL(const std::string &name, double tolerance)
         char s1[256];
         double x, y, z;
         if(sscanf(buffer, "%s %lf %lf %lf", s1, &x, &y, &z) != 4) break;
-        SPoint3 p(x, y, z);
-        // p -= p0;
-        points.back().push_back(p);
-        bbox += p;
+        xyz.push_back(x);
+        xyz.push_back(y);
+        xyz.push_back(z);
       }
       // "endloop"
       if(!fgets(buffer, sizeof(buffer), fp)) break;
@@ -86,61 +174,27 @@ int GModel::readSTL(const std::string &name, double tolerance)
     }
   }
 
-  // check if we could parse something
-  bool empty = true;
-  for(std::size_t i = 0; i < points.size(); i++) {
-    if(points[i].size()) {
-      empty = false;
-      break;
-    }
-  }
-  if(empty) points.clear();
-
   // binary STL (we also try to read in binary mode if the header told
   // us the format was ASCII but we could not read any vertices)
-  if(binary || empty) {
+  if(binary || xyz.empty()) {
     if(binary)
       Msg::Info("Mesh is in binary format");
     else
       Msg::Info("Wrong ASCII header or empty file: trying binary read");
-    rewind(fp);
-    while(!feof(fp)) {
-      char header[80];
-      if(!fread(header, sizeof(char), 80, fp)) break;
-      unsigned int nfacets = 0;
-      size_t ret = fread(&nfacets, sizeof(unsigned int), 1, fp);
-      bool swap = false;
-      if(nfacets > 100000000) {
-        Msg::Info("Swapping bytes from binary file");
-        swap = true;
-        SwapBytes((char *)&nfacets, sizeof(unsigned int), 1);
-      }
-      if(ret && nfacets) {
-        names.push_back(header);
-        points.resize(points.size() + 1);
-        char *data = new char[nfacets * 50 * sizeof(char)];
-        ret = fread(data, sizeof(char), nfacets * 50, fp);
-        if(ret == nfacets * 50) {
-          for(std::size_t i = 0; i < nfacets; i++) {
-            float *xyz = (float *)&data[i * 50 * sizeof(char)];
-            if(swap) SwapBytes((char *)xyz, sizeof(float), 12);
-            for(int j = 0; j < 3; j++) {
-              SPoint3 p(xyz[3 + 3 * j], xyz[3 + 3 * j + 1], xyz[3 + 3 * j + 2]);
-              // p -= p0;
-              points.back().push_back(p);
-              bbox += p;
-            }
-          }
-        }
-        delete[] data;
-      }
-    }
+    xyz.clear();
+    start.clear();
+    names.clear();
+    readBinarySTL(fp, xyz, start, names, nthreads);
   }
+  fclose(fp);
+
+  std::size_t numPoints = xyz.size() / 3;
+  start.push_back(numPoints);
 
   // cleanup names
-  if(names.size() != points.size()) {
+  if(names.size() + 1 != start.size()) {
     Msg::Debug("Invalid number of names in STL file - should never happen");
-    names.resize(points.size());
+    names.resize(start.size() - 1);
   }
   for(std::size_t i = 0; i < names.size(); i++) {
     names[i].erase(remove_if(names[i].begin(), names[i].end(), invalidChar),
@@ -148,21 +202,19 @@ int GModel::readSTL(const std::string &name, double tolerance)
   }
 
   std::vector<GFace *> faces;
-  for(std::size_t i = 0; i < points.size(); i++) {
-    if(points[i].empty()) {
-      Msg::Error("No facets found in STL file for solid %d %s", i,
+  for(std::size_t i = 0; i < names.size(); i++) {
+    std::size_t n = start[i + 1] - start[i];
+    if(!n) {
+      Msg::Error("No facets found in STL file for solid %lu %s", i,
                  names[i].c_str());
-      fclose(fp);
       return 0;
     }
-    if(points[i].size() % 3) {
-      Msg::Error("Wrong number of points (%d) in STL file for solid %d %s",
-                 points[i].size(), i, names[i].c_str());
-      fclose(fp);
+    if(n % 3) {
+      Msg::Error("Wrong number of points (%lu) in STL file for solid %lu %s",
+                 n, i, names[i].c_str());
       return 0;
     }
-    Msg::Info("%d facets in solid %d %s", points[i].size() / 3, i,
-              names[i].c_str());
+    Msg::Info("%lu facets in solid %lu %s", n / 3, i, names[i].c_str());
     // create face
     GFace *face = new discreteFace(this, getMaxElementaryNumber(2) + 1);
     faces.push_back(face);
@@ -170,63 +222,102 @@ int GModel::readSTL(const std::string &name, double tolerance)
     if(!names[i].empty()) setElementaryName(2, face->tag(), names[i]);
   }
 
-  // create triangles using unique vertices
+  // bounding box, computed by chunks
+  const std::size_t chunk = 65536;
+  std::size_t numChunks = (numPoints + chunk - 1) / chunk;
+  std::vector<SBoundingBox3d> bboxes(numChunks);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t c = 0; c < numChunks; c++) {
+    for(std::size_t i = c * chunk; i < std::min(numPoints, (c + 1) * chunk);
+        i++)
+      bboxes[c] += SPoint3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+  }
+  SBoundingBox3d bbox;
+  for(std::size_t c = 0; c < numChunks; c++) bbox += bboxes[c];
+
+  // weld the points, then create one vertex per unique point, numbered in
+  // the order of the points
   double eps = norm(SVector3(bbox.max(), bbox.min())) * tolerance;
-  std::vector<MVertex *> vertices;
-  for(std::size_t i = 0; i < points.size(); i++)
-    for(std::size_t j = 0; j < points[i].size(); j++)
-      vertices.push_back(
-        new MVertex(points[i][j].x(), points[i][j].y(), points[i][j].z()));
-  MVertexRTree pos(eps);
-  pos.insert(vertices);
-
-  std::set<MFace, MFaceLessThan> unique;
-  int nbDuplic = 0, nbDegen = 0;
-  for(std::size_t i = 0; i < points.size(); i++) {
-    for(std::size_t j = 0; j < points[i].size(); j += 3) {
-      MVertex *v[3];
-      for(int k = 0; k < 3; k++) {
-        double x = points[i][j + k].x();
-        double y = points[i][j + k].y();
-        double z = points[i][j + k].z();
-        v[k] = pos.find(x, y, z);
-        if(!v[k])
-          Msg::Error("Could not find node at position (%.16g, %.16g, %.16g) "
-                     "with tol=%.16g",
-                     x, y, z, eps);
-      }
-      if(!v[0] || !v[1] || !v[2]) {
-        // error
-      }
-      else if(v[0] == v[1] || v[0] == v[2] || v[1] == v[2]) {
-        Msg::Debug("Skipping degenerated triangle %lu %lu %lu", v[0]->getNum(),
-                   v[1]->getNum(), v[2]->getNum());
-        nbDegen++;
-      }
-      else if(CTX::instance()->mesh.stlRemoveDuplicateTriangles) {
-        MFace mf(v[0], v[1], v[2]);
-        if(unique.find(mf) == unique.end()) {
-          faces[i]->triangles.push_back(new MTriangle(v[0], v[1], v[2]));
-          unique.insert(mf);
-        }
-        else {
-          nbDuplic++;
-        }
-      }
-      else {
-        faces[i]->triangles.push_back(new MTriangle(v[0], v[1], v[2]));
+  std::vector<std::size_t> index;
+  MVertexHashGrid::weld(xyz, eps, index, nthreads);
+
+  std::vector<std::size_t> offsets(numChunks + 1, 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t c = 0; c < numChunks; c++) {
+    for(std::size_t i = c * chunk; i < std::min(numPoints, (c + 1) * chunk);
+        i++)
+      if(index[i] == i) offsets[c + 1]++;
+  }
+  for(std::size_t c = 0; c < numChunks; c++) offsets[c + 1] += offsets[c];
+  std::size_t vertexBase = getMaxVertexNumber();
+  std::vector<MVertex *> vertices(numPoints, nullptr);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t c = 0; c < numChunks; c++) {
+    std::size_t num = vertexBase + offsets[c];
+    for(std::size_t i = c * chunk; i < std::min(numPoints, (c + 1) * chunk);
+        i++) {
+      if(index[i] == i)
+        vertices[i] = new MVertex(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2],
+                                  nullptr, ++num);
+    }
+  }
+  setMaxVertexNumber(vertexBase + offsets[numChunks]);
+  std::vector<double>().swap(xyz);
+
+  // flag the triangles to create (skipping degenerate ones and, if
+  // requested, duplicates)
+  std::size_t numTriangles = numPoints / 3;
+  std::vector<char> keep(numTriangles, 1);
+  std::size_t nbDegen = 0, nbDuplic = 0;
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nthreads) reduction(+ : nbDegen)
+  for(std::size_t t = 0; t < numTriangles; t++) {
+    std::size_t a = index[3 * t], b = index[3 * t + 1], c = index[3 * t + 2];
+    if(a == b || a == c || b == c) {
+      keep[t] = 0;
+      nbDegen++;
+    }
+  }
+  if(CTX::instance()->mesh.stlRemoveDuplicateTriangles) {
+    std::set<MFace, MFaceLessThan> unique;
+    for(std::size_t t = 0; t < numTriangles; t++) {
+      if(!keep[t]) continue;
+      MFace mf(vertices[index[3 * t]], vertices[index[3 * t + 1]],
+               vertices[index[3 * t + 2]]);
+      if(!unique.insert(mf).second) {
+        keep[t] = 0;
+        nbDuplic++;
       }
     }
   }
   if(nbDuplic || nbDegen)
-    Msg::Warning("%d duplicate/%d degenerate triangles in STL file", nbDuplic,
-                 nbDegen);
+    Msg::Warning("%lu duplicate/%lu degenerate triangles in STL file",
+                 nbDuplic, nbDegen);
+
+  // create the triangles directly in the (preallocated) face arrays
+  std::size_t elementBase = getMaxElementNumber(), numElements = 0;
+  for(std::size_t i = 0; i < faces.size(); i++) {
+    std::size_t t0 = start[i] / 3, t1 = start[i + 1] / 3;
+    std::vector<std::size_t> first(t1 - t0 + 1, 0);
+    for(std::size_t t = t0; t < t1; t++) first[t - t0 + 1] = keep[t];
+    for(std::size_t t = t0; t < t1; t++) first[t - t0 + 1] += first[t - t0];
+    std::vector<MTriangle *> &triangles = faces[i]->triangles;
+    triangles.resize(first.back());
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nthreads)
+    for(std::size_t t = t0; t < t1; t++) {
+      if(!keep[t]) continue;
+      std::size_t k = first[t - t0];
+      triangles[k] = new MTriangle(
+        vertices[index[3 * t]], vertices[index[3 * t + 1]],
+        vertices[index[3 * t + 2]], (int)(elementBase + numElements + k + 1));
+    }
+    numElements += triangles.size();
+  }
+  setMaxElementNumber(elementBase + numElements);
 
   _associateEntityWithMeshVertices();
 
   _storeVerticesInEntities(vertices); // will delete unused vertices
 
-  fclose(fp);
   return 1;
 }
 
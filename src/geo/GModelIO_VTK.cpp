@@ -3,8 +3,13 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <stdio.h>
+#include <cstdint>
+#include <algorithm>
+#include "GmshConfig.h"
 #include "GModel.h"
 #include "OS.h"
+#include "Context.h"
 #include "MPoint.h"
 #include "MLine.h"
 #include "MTriangle.h"
@@ -13,9 +18,18 @@
 #include "MHexahedron.h"
 #include "MPrism.h"
 #include "MPyramid.h"
+#include "partitionVertex.h"
+#include "partitionEdge.h"
+#include "partitionFace.h"
+#include "partitionRegion.h"
+#include "HilbertCurve.h"
 #include "StringUtils.h"
 #include "GmshVersion.h"
 
+#if defined(HAVE_LIBZ)
+#include <zlib.h>
+#endif
+
 int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
                      double scalingFactor, bool bigEndian)
 {
@@ -128,6 +142,363 @@ int GModel::writeVTK(const std::string &name, bool binary, bool saveAll,
   return 1;
 }
 
+namespace {
+
+  // a data array of a VTU piece, encoded in memory: as text for ASCII files,
+  // or as raw (possibly compressed) bytes to be appended to binary files
+  struct vtuArray {
+    std::string name, type;
+    int numComponents;
+    std::string data;
+    vtuArray(const std::string &n, const std::string &t, int c)
+      : name(n), type(t), numComponents(c)
+    {
+    }
+  };
+
+  // size of the blocks compressed independently, as in VTK
+  const std::size_t vtuBlockSize = 1 << 20;
+
+  void appendVTUValue(std::string &s, double v)
+  {
+    char tmp[32];
+    snprintf(tmp, sizeof(tmp), "%.16g", v);
+    s += tmp;
+  }
+
+  void appendVTUValue(std::string &s, int64_t v)
+  {
+    char tmp[32];
+    snprintf(tmp, sizeof(tmp), "%lld", (long long)v);
+    s += tmp;
+  }
+
+  void appendVTUValue(std::string &s, int32_t v)
+  {
+    char tmp[16];
+    snprintf(tmp, sizeof(tmp), "%d", (int)v);
+    s += tmp;
+  }
+
+  void appendVTUValue(std::string &s, uint8_t v)
+  {
+    char tmp[8];
+    snprintf(tmp, sizeof(tmp), "%d", (int)v);
+    s += tmp;
+  }
+
+  template <class T>
+  bool encodeVTUArray(const std::vector<T> &values, bool binary,
+                      int compression, int nthreads, vtuArray &array)
+  {
+    std::string &out = array.data;
+    out.clear();
+
+    if(!binary) {
+      // format chunks of values concurrently, one tuple per line
+      const std::size_t chunk = 4096 * array.numComponents;
+      std::size_t numChunks = (values.size() + chunk - 1) / chunk;
+      std::vector<std::string> text(numChunks);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(std::size_t c = 0; c < numChunks; c++) {
+        std::size_t end = std::min(values.size(), (c + 1) * chunk);
+        for(std::size_t i = c * chunk; i < end; i++) {
+          appendVTUValue(text[c], values[i]);
+          text[c] += ((i + 1) % array.numComponents) ? ' ' : '\n';
+        }
+      }
+      std::size_t size = 0;
+      for(std::size_t c = 0; c < numChunks; c++) size += text[c].size();
+      out.reserve(size);
+      for(std::size_t c = 0; c < numChunks; c++) out += text[c];
+      return true;
+    }
+
+    const char *data = values.empty() ? nullptr : (const char *)&values[0];
+    uint64_t size = values.size() * sizeof(T);
+
+    if(compression) {
+#if defined(HAVE_LIBZ)
+      // compress the blocks concurrently; the header is the one written by
+      // vtkZLibDataCompressor: number of blocks, size of the blocks, size of
+      // the last block if it is partial, and the compressed size of each block
+      std::size_t numBlocks = (size + vtuBlockSize - 1) / vtuBlockSize;
+      std::vector<std::string> blocks(numBlocks);
+      std::vector<uint64_t> header(3 + numBlocks);
+      header[0] = numBlocks;
+      header[1] = vtuBlockSize;
+      header[2] = size % vtuBlockSize;
+      int errors = 0;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : errors)
+      for(std::size_t b = 0; b < numBlocks; b++) {
+        std::size_t start = b * vtuBlockSize;
+        uLong n = std::min((std::size_t)size - start, vtuBlockSize);
+        uLongf len = compressBound(n);
+        blocks[b].resize(len);
+        if(compress2((Bytef *)&blocks[b][0], &len, (const Bytef *)data + start,
+                     n, compression) != Z_OK)
+          errors++;
+        blocks[b].resize(len);
+        header[3 + b] = len;
+      }
+      if(errors) {
+        Msg::Error("Could not compress VTU array '%s'", array.name.c_str());
+        return false;
+      }
+      std::size_t total = header.size() * sizeof(uint64_t);
+      for(std::size_t b = 0; b < numBlocks; b++) total += blocks[b].size();
+      out.reserve(total);
+      out.append((const char *)&header[0], header.size() * sizeof(uint64_t));
+      for(std::size_t b = 0; b < numBlocks; b++) out += blocks[b];
+      return true;
+#endif
+    }
+
+    out.reserve(sizeof(uint64_t) + size);
+    out.append((const char *)&size, sizeof(uint64_t));
+    if(size) out.append(data, size);
+    return true;
+  }
+
+  void writeVTUFileHeader(FILE *fp, const char *type, bool binary,
+                          int compression)
+  {
+    fprintf(fp, "<?xml version=\"1.0\"?>\n");
+    fprintf(fp,
+            "<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"%s\" "
+            "header_type=\"UInt64\"",
+            type, CTX::instance()->bigEndian ? "BigEndian" : "LittleEndian");
+    if(binary && compression)
+      fprintf(fp, " compressor=\"vtkZLibDataCompressor\"");
+    fprintf(fp, ">\n");
+  }
+
+  const std::vector<int> *getVTUPartitions(GEntity *ge)
+  {
+    switch(ge->geomType()) {
+    case GEntity::PartitionPoint:
+      return &static_cast<partitionVertex *>(ge)->getPartitions();
+    case GEntity::PartitionCurve:
+      return &static_cast<partitionEdge *>(ge)->getPartitions();
+    case GEntity::PartitionSurface:
+      return &static_cast<partitionFace *>(ge)->getPartitions();
+    case GEntity::PartitionVolume:
+      return &static_cast<partitionRegion *>(ge)->getPartitions();
+    default: return nullptr;
+    }
+  }
+
+  bool isVTUGhost(GEntity *ge)
+  {
+    return ge->geomType() == GEntity::GhostCurve ||
+           ge->geomType() == GEntity::GhostSurface ||
+           ge->geomType() == GEntity::GhostVolume;
+  }
+
+  // write the elements of the entities in a .vtu file, as a single piece
+  // with its own node numbering
+  bool writeVTUPiece(const std::string &name,
+                     const std::vector<GEntity *> &entities, bool binary,
+                     bool saveAll, bool havePhysicals, double scalingFactor,
+                     int compression, int nthreads)
+  {
+    std::vector<MElement *> elements;
+    std::vector<int32_t> ids;
+    for(std::size_t i = 0; i < entities.size(); i++) {
+      GEntity *ge = entities[i];
+      if(!ge->physicals.size() && !saveAll) continue;
+      int32_t id = ge->physicals.size() ? ge->physicals[0] : -1;
+      for(std::size_t j = 0; j < ge->getNumMeshElements(); j++) {
+        MElement *e = ge->getMeshElement(j);
+        if(!e->getTypeForVTK()) continue;
+        elements.push_back(e);
+        ids.push_back(id);
+      }
+    }
+    std::size_t numElements = elements.size();
+
+    // cell types, and offsets of the end of each cell in the connectivity
+    std::vector<uint8_t> types(numElements);
+    std::vector<int64_t> offsets(numElements);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for(std::size_t i = 0; i < numElements; i++) {
+      types[i] = (uint8_t)elements[i]->getTypeForVTK();
+      offsets[i] = elements[i]->getNumVertices();
+    }
+    for(std::size_t i = 1; i < numElements; i++) offsets[i] += offsets[i - 1];
+    std::size_t size = numElements ? offsets.back() : 0;
+
+    // the nodes of the piece are the nodes of its elements, ordered by tag
+    std::vector<MVertex *> verts(size);
+    std::vector<std::pair<uint64_t, std::size_t> > tags(size);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for(std::size_t i = 0; i < numElements; i++) {
+      std::size_t start = i ? offsets[i - 1] : 0;
+      for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++) {
+        verts[start + j] = elements[i]->getVertexVTK(j);
+        tags[start + j] = std::make_pair(verts[start + j]->getNum(), start + j);
+      }
+    }
+    SortCurveIndices(tags, nthreads);
+    std::vector<MVertex *> nodes;
+    std::vector<int64_t> connectivity(size);
+    for(std::size_t k = 0; k < size; k++) {
+      if(!k || tags[k].first != tags[k - 1].first)
+        nodes.push_back(verts[tags[k].second]);
+      connectivity[tags[k].second] = nodes.size() - 1;
+    }
+    std::vector<double> points(3 * nodes.size());
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for(std::size_t i = 0; i < nodes.size(); i++) {
+      points[3 * i] = nodes[i]->x() * scalingFactor;
+      points[3 * i + 1] = nodes[i]->y() * scalingFactor;
+      points[3 * i + 2] = nodes[i]->z() * scalingFactor;
+    }
+
+    std::vector<vtuArray> arrays;
+    arrays.push_back(vtuArray("Points", "Float64", 3));
+    arrays.push_back(vtuArray("connectivity", "Int64", 1));
+    arrays.push_back(vtuArray("offsets", "Int64", 1));
+    arrays.push_back(vtuArray("types", "UInt8", 1));
+    if(havePhysicals) arrays.push_back(vtuArray("CellEntityIds", "Int32", 1));
+    if(!encodeVTUArray(points, binary, compression, nthreads, arrays[0]) ||
+       !encodeVTUArray(connectivity, binary, compression, nthreads,
+                       arrays[1]) ||
+       !encodeVTUArray(offsets, binary, compression, nthreads, arrays[2]) ||
+       !encodeVTUArray(types, binary, compression, nthreads, arrays[3]) ||
+       (havePhysicals &&
+        !encodeVTUArray(ids, binary, compression, nthreads, arrays[4])))
+      return false;
+
+    FILE *fp = Fopen(name.c_str(), binary ? "wb" : "w");
+    if(!fp) {
+      Msg::Error("Unable to open file '%s'", name.c_str());
+      return false;
+    }
+
+    writeVTUFileHeader(fp, "UnstructuredGrid", binary, compression);
+    fprintf(fp, "<UnstructuredGrid>\n");
+    fprintf(fp, "<Piece NumberOfPoints=\"%lu\" NumberOfCells=\"%lu\">\n",
+            nodes.size(), numElements);
+    std::size_t offset = 0;
+    for(std::size_t i = 0; i < arrays.size(); i++) {
+      if(i == 0) fprintf(fp, "<Points>\n");
+      if(i == 1) fprintf(fp, "<Cells>\n");
+      if(i == 4) fprintf(fp, "<CellData Scalars=\"CellEntityIds\">\n");
+      fprintf(fp, "<DataArray type=\"%s\" Name=\"%s\"", arrays[i].type.c_str(),
+              arrays[i].name.c_str());
+      if(arrays[i].numComponents > 1)
+        fprintf(fp, " NumberOfComponents=\"%d\"", arrays[i].numComponents);
+      if(binary) {
+        fprintf(fp, " format=\"appended\" offset=\"%lu\"/>\n", offset);
+        offset += arrays[i].data.size();
+      }
+      else {
+        fprintf(fp, " format=\"ascii\">\n");
+        fwrite(arrays[i].data.data(), 1, arrays[i].data.size(), fp);
+        fprintf(fp, "</DataArray>\n");
+      }
+      if(i == 0) fprintf(fp, "</Points>\n");
+      if(i == 3) fprintf(fp, "</Cells>\n");
+      if(i == 4) fprintf(fp, "</CellData>\n");
+    }
+    fprintf(fp, "</Piece>\n");
+    fprintf(fp, "</UnstructuredGrid>\n");
+    if(binary) {
+      fprintf(fp, "<AppendedData encoding=\"raw\">\n_");
+      for(std::size_t i = 0; i < arrays.size(); i++)
+        fwrite(arrays[i].data.data(), 1, arrays[i].data.size(), fp);
+      fprintf(fp, "\n</AppendedData>\n");
+    }
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
+    return true;
+  }
+
+} // namespace
+
+int GModel::writeVTU(const std::string &name, bool binary, bool saveAll,
+                     double scalingFactor, int compression)
+{
+  if(!binary) compression = 0;
+#if !defined(HAVE_LIBZ)
+  if(compression) {
+    Msg::Warning("Gmsh must be compiled with zlib to compress VTU files");
+    compression = 0;
+  }
+#endif
+
+  bool havePhysicals = !noPhysicalGroups();
+  if(!havePhysicals) saveAll = true;
+
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  std::vector<GEntity *> all, entities;
+  getEntities(all);
+  for(std::size_t i = 0; i < all.size(); i++)
+    if(!isVTUGhost(all[i])) entities.push_back(all[i]);
+
+  std::vector<std::string> split = SplitFileName(name);
+  if(split[2] != ".pvtu")
+    return writeVTUPiece(name, entities, binary, saveAll, havePhysicals,
+                         scalingFactor, compression, nthreads) ?
+             1 :
+             0;
+
+  // one piece per partition, each in its own .vtu file, so that they can be
+  // read in parallel
+  std::vector<std::string> pieces;
+  int numPieces = std::max(1, (int)getNumPartitions());
+  for(int p = 1; p <= numPieces; p++) {
+    std::vector<GEntity *> part;
+    if(getNumPartitions()) {
+      for(std::size_t i = 0; i < entities.size(); i++) {
+        const std::vector<int> *partitions = getVTUPartitions(entities[i]);
+        if(partitions && std::find(partitions->begin(), partitions->end(),
+                                   p) != partitions->end())
+          part.push_back(entities[i]);
+      }
+    }
+    else {
+      part = entities;
+    }
+    std::string piece = split[1] + "_" + std::to_string(p) + ".vtu";
+    if(!writeVTUPiece(split[0] + piece, part, binary, saveAll, havePhysicals,
+                      scalingFactor, compression, nthreads))
+      return 0;
+    pieces.push_back(piece);
+  }
+
+  FILE *fp = Fopen(name.c_str(), "w");
+  if(!fp) {
+    Msg::Error("Unable to open file '%s'", name.c_str());
+    return 0;
+  }
+  writeVTUFileHeader(fp, "PUnstructuredGrid", binary, compression);
+  fprintf(fp, "<PUnstructuredGrid GhostLevel=\"0\">\n");
+  fprintf(fp, "<PPoints>\n");
+  fprintf(fp, "<PDataArray type=\"Float64\" Name=\"Points\" "
+              "NumberOfComponents=\"3\"/>\n");
+  fprintf(fp, "</PPoints>\n");
+  fprintf(fp, "<PCells>\n");
+  fprintf(fp, "<PDataArray type=\"Int64\" Name=\"connectivity\"/>\n");
+  fprintf(fp, "<PDataArray type=\"Int64\" Name=\"offsets\"/>\n");
+  fprintf(fp, "<PDataArray type=\"UInt8\" Name=\"types\"/>\n");
+  fprintf(fp, "</PCells>\n");
+  if(havePhysicals) {
+    fprintf(fp, "<PCellData Scalars=\"CellEntityIds\">\n");
+    fprintf(fp, "<PDataArray type=\"Int32\" Name=\"CellEntityIds\"/>\n");
+    fprintf(fp, "</PCellData>\n");
+  }
+  for(std::size_t i = 0; i < pieces.size(); i++)
+    fprintf(fp, "<Piece Source=\"%s\"/>\n", pieces[i].c_str());
+  fprintf(fp, "</PUnstructuredGrid>\n");
+  fprintf(fp, "</VTKFile>\n");
+  fclose(fp);
+  return 1;
+}
+
 int GModel::readVTK(const std::string &name, bool bigEndian)
 {
   FILE *fp = Fopen(name.c_str(), "rb");
@@ -13,6 +13,7 @@
 #include "MPyramid.h"
 #include "MTrihedron.h"
 #include "MElementCut.h"
+#include "MeshMemoryPool.h"
 #include "GmshMessage.h"
 #include "VertexArray.h"
 #include "boundaryLayersData.h"
@@ -38,6 +39,7 @@ GRegion::~GRegion()
 
 void GRegion::deleteMesh()
 {
+  MeshMemoryPool::bulkRelease bulk;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   transfinite_vertices.clear();
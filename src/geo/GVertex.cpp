@@ -9,6 +9,7 @@
 #include "GVertex.h"
 #include "GFace.h"
 #include "MPoint.h"
+#include "MeshMemoryPool.h"
 #include "GmshMessage.h"
 
 GVertex::GVertex(GModel *m, int tag, double ms) : GEntity(m, tag), meshSize(ms)
@@ -19,6 +20,7 @@ GVertex::~GVertex() { GVertex::deleteMesh(); }
 
 void GVertex::deleteMesh()
 {
+  MeshMemoryPool::bulkRelease bulk;
   for(std::size_t i = 0; i < mesh_vertices.size(); i++) delete mesh_vertices[i];
   mesh_vertices.clear();
   for(std::size_t i = 0; i < points.size(); i++) delete points[i];
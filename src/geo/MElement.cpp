@@ -58,11 +58,22 @@ void MElement::forceNum(std::size_t num)
   m->setMaxElementNumber(_num);
 }
 
+// tolerance override of the calling thread (none if negative)
+static thread_local double threadTolerance = -1.;
+
 double MElement::getTolerance() const
 {
+  if(threadTolerance >= 0.) return threadTolerance;
   return CTX::instance()->mesh.toleranceReferenceElement;
 }
 
+double MElement::setThreadTolerance(double tol)
+{
+  double old = threadTolerance;
+  threadTolerance = tol;
+  return old;
+}
+
 bool MElement::_getFaceInfo(const MFace &face, const MFace &other, int &sign,
                             int &rot)
 {
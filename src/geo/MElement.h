@@ -14,6 +14,7 @@
 #include "GmshMessage.h"
 #include "ElementType.h"
 #include "MVertex.h"
+#include "MeshMemoryPool.h"
 #include "MEdge.h"
 #include "MFace.h"
 #include "FuncSpaceData.h"
@@ -60,9 +61,22 @@ public:
   MElement(std::size_t num = 0, int part = 0);
   virtual ~MElement() {}
 
+  // elements are allocated in the mesh memory pool
+  static void *operator new(std::size_t size)
+  {
+    return MeshMemoryPool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size)
+  {
+    MeshMemoryPool::deallocate(p, size);
+  }
+
   // tolerance in reference coordinates to determine if a point is inside an
   // element
   double getTolerance() const;
+  // override the tolerance in the calling thread only (a negative value
+  // removes the override); return the previous override
+  static double setThreadTolerance(double tol);
 
   // return the tag of the element
   virtual std::size_t getNum() const { return _num; }
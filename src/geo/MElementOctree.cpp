@@ -6,7 +6,6 @@
 #include "GModel.h"
 #include "MElement.h"
 #include "MElementOctree.h"
-#include "Octree.h"
 #include "Context.h"
 #include "fullMatrix.h"
 #include "bezierBasis.h"
@@ -61,26 +60,6 @@ void MElementBB(void *a, double *min, double *max)
   min[2] = bb.min().z();
 }
 
-static void MElementCentroid(void *a, double *x)
-{
-  MElement *e = (MElement *)a;
-  MVertex *v = e->getVertex(0);
-  int n = e->getNumVertices();
-  x[0] = v->x();
-  x[1] = v->y();
-  x[2] = v->z();
-  for(int i = 1; i < n; i++) {
-    v = e->getVertex(i);
-    x[0] += v->x();
-    x[1] += v->y();
-    x[2] += v->z();
-  }
-  double oc = 1. / (double)n;
-  x[0] *= oc;
-  x[1] *= oc;
-  x[2] *= oc;
-}
-
 int MElementInEle(void *a, double *x)
 {
   MElement *e = (MElement *)a;
@@ -91,114 +70,82 @@ int MElementInEle(void *a, double *x)
 
 MElementOctree::MElementOctree(GModel *m) : _gm(m)
 {
-  SBoundingBox3d bb = m->bounds();
-  bb.thicken(0.01); // make 1% thicker
-  SPoint3 bbmin = bb.min(), bbmax = bb.max();
-  double min[3] = {bbmin.x(), bbmin.y(), bbmin.z()};
-  double size[3] = {bbmax.x() - bbmin.x(), bbmax.y() - bbmin.y(),
-                    bbmax.z() - bbmin.z()};
-  const int maxElePerBucket = 100; // memory vs. speed trade-off
-  _octree = Octree_Create(maxElePerBucket, min, size, MElementBB,
-                          MElementCentroid, MElementInEle);
   std::vector<GEntity *> entities;
   m->getEntities(entities);
   // do not add Gvertex non-associated to any GEdge
   for(std::size_t i = 0; i < entities.size(); i++) {
-    for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-      if(entities[i]->dim() == 0) {
-        GVertex *gv = dynamic_cast<GVertex *>(entities[i]);
-        if(gv && gv->edges().size() > 0) {
-          Octree_Insert(entities[i]->getMeshElement(j), _octree);
-        }
-      }
-      else
-        Octree_Insert(entities[i]->getMeshElement(j), _octree);
+    if(entities[i]->dim() == 0) {
+      GVertex *gv = dynamic_cast<GVertex *>(entities[i]);
+      if(!gv || gv->edges().empty()) continue;
     }
+    for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++)
+      _elems.push_back(entities[i]->getMeshElement(j));
   }
-  Octree_Arrange(_octree);
+  _build();
 }
 
 MElementOctree::MElementOctree(const std::vector<MElement *> &v)
   : _gm(nullptr), _elems(v)
 {
-  SBoundingBox3d bb;
-  for(std::size_t i = 0; i < v.size(); i++) {
-    for(std::size_t j = 0; j < v[i]->getNumVertices(); j++) {
-      bb += SPoint3(v[i]->getVertex(j)->x(), v[i]->getVertex(j)->y(),
-                    v[i]->getVertex(j)->z());
+  _build();
+}
+
+MElementOctree::~MElementOctree() {}
+
+void MElementOctree::_build()
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  // the bounding boxes of high-order elements are computed with their Bezier
+  // control points, whose bases are created on the fly
+  bool highOrder = false;
+  for(std::size_t i = 0; i < _elems.size(); i++) {
+    if(_elems[i]->getPolynomialOrder() > 1) {
+      highOrder = true;
+      break;
     }
   }
-  bb.thicken(0.01); // make 1% thicker
-  SPoint3 bbmin = bb.min(), bbmax = bb.max();
-  double min[3] = {bbmin.x(), bbmin.y(), bbmin.z()};
-  double size[3] = {bbmax.x() - bbmin.x(), bbmax.y() - bbmin.y(),
-                    bbmax.z() - bbmin.z()};
-  const int maxElePerBucket = 100; // memory vs. speed trade-off
-  _octree = Octree_Create(maxElePerBucket, min, size, MElementBB,
-                          MElementCentroid, MElementInEle);
-  for(std::size_t i = 0; i < v.size(); i++) Octree_Insert(v[i], _octree);
-  Octree_Arrange(_octree);
+  std::vector<double> boxes(6 * _elems.size());
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads) if(!highOrder)
+  for(std::size_t i = 0; i < _elems.size(); i++)
+    MElementBB(_elems[i], &boxes[6 * i], &boxes[6 * i + 3]);
+  _bvh.build(boxes, nthreads);
 }
 
-MElementOctree::~MElementOctree() { Octree_Delete(_octree); }
+void MElementOctree::_findWithTolerance(double *P, int dim, double maxTol,
+                                        bool all,
+                                        std::vector<MElement *> &e) const
+{
+  // the tolerance is only increased in the calling thread, so that concurrent
+  // searches are not affected
+  double tol = CTX::instance()->mesh.toleranceReferenceElement;
+  double old = MElement::setThreadTolerance(-1.);
+  while(e.empty() && tol < maxTol) {
+    tol *= 10.;
+    MElement::setThreadTolerance(tol);
+    for(std::size_t i = 0; i < _elems.size(); i++) {
+      MElement *el = _elems[i];
+      if((dim == -1 || el->getDim() == dim) && MElementInEle(el, P)) {
+        e.push_back(el);
+        if(!all) break;
+      }
+    }
+  }
+  MElement::setThreadTolerance(old);
+}
 
 std::vector<MElement *> MElementOctree::findAll(double x, double y, double z,
                                                 int dim, bool strict) const
 {
-  double maxTol = 1.;
-  double tolIncr = 10.;
-
   double P[3] = {x, y, z};
-  std::vector<void *> v;
   std::vector<MElement *> e;
-  Octree_SearchAll(P, _octree, &v);
-  for(auto it = v.begin(); it != v.end(); ++it) {
-    MElement *el = (MElement *)*it;
-    if(dim == -1 || el->getDim() == dim) e.push_back(el);
-  }
-  if(e.empty() && !strict && _gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
-    while(tol < maxTol) {
-      tol *= tolIncr;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
-      std::vector<GEntity *> entities;
-      _gm->getEntities(entities);
-      for(std::size_t i = 0; i < entities.size(); i++) {
-        for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-          MElement *el = entities[i]->getMeshElement(j);
-          if(dim == -1 || el->getDim() == dim) {
-            if(MElementInEle(el, P)) { e.push_back(el); }
-          }
-        }
-      }
-      if(!e.empty()) {
-        CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-        return e;
-      }
-    }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-  }
-  else if(e.empty() && !strict && !_gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
-    while(tol < maxTol) {
-      tol *= tolIncr;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
-      for(std::size_t i = 0; i < _elems.size(); i++) {
-        MElement *el = _elems[i];
-        if(dim == -1 || el->getDim() == dim) {
-          if(MElementInEle(el, P)) { e.push_back(el); }
-        }
-      }
-      if(!e.empty()) {
-        CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-        return e;
-      }
-    }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-    // Msg::Warning("Point %g %g %g not found",x,y,z);
-  }
+  _bvh.search(P, [&](std::size_t i) {
+    MElement *el = _elems[i];
+    if((dim == -1 || el->getDim() == dim) && MElementInEle(el, P))
+      e.push_back(el);
+    return false;
+  });
+  if(e.empty() && !strict) _findWithTolerance(P, dim, 1., true, e);
   return e;
 }
 
@@ -206,57 +153,17 @@ MElement *MElementOctree::find(double x, double y, double z, int dim,
                                bool strict) const
 {
   double P[3] = {x, y, z};
-  MElement *e = (MElement *)Octree_Search(P, _octree);
-  if(e && (dim == -1 || e->getDim() == dim)) return e;
-  std::vector<void *> l;
-  if(e && e->getDim() != dim) {
-    Octree_SearchAll(P, _octree, &l);
-    for(auto it = l.begin(); it != l.end(); it++) {
-      MElement *el = (MElement *)*it;
-      if(el->getDim() == dim) { return el; }
-    }
-  }
-  if(!strict && _gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
-    while(tol < 1.) {
-      tol *= 10;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
-      std::vector<GEntity *> entities;
-      _gm->getEntities(entities);
-      for(std::size_t i = 0; i < entities.size(); i++) {
-        for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-          e = entities[i]->getMeshElement(j);
-          if(dim == -1 || e->getDim() == dim) {
-            if(MElementInEle(e, P)) {
-              CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-              return e;
-            }
-          }
-        }
-      }
+  MElement *e = nullptr;
+  _bvh.search(P, [&](std::size_t i) {
+    MElement *el = _elems[i];
+    if((dim == -1 || el->getDim() == dim) && MElementInEle(el, P)) {
+      e = el;
+      return true;
     }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-    // Msg::Warning("Point %g %g %g not found",x,y,z);
-  }
-  else if(!strict && !_gm) {
-    double initialTol = CTX::instance()->mesh.toleranceReferenceElement;
-    double tol = initialTol;
-    while(tol < 0.1) {
-      tol *= 10.0;
-      CTX::instance()->mesh.toleranceReferenceElement = tol;
-      for(std::size_t i = 0; i < _elems.size(); i++) {
-        e = _elems[i];
-        if(dim == -1 || e->getDim() == dim) {
-          if(MElementInEle(e, P)) {
-            CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-            return e;
-          }
-        }
-      }
-    }
-    CTX::instance()->mesh.toleranceReferenceElement = initialTol;
-    // Msg::Warning("Point %g %g %g not found",x,y,z);
-  }
-  return nullptr;
+    return false;
+  });
+  if(e || strict) return e;
+  std::vector<MElement *> l;
+  _findWithTolerance(P, dim, _gm ? 1. : 0.1, false, l);
+  return l.empty() ? nullptr : l[0];
 }
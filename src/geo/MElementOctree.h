@@ -7,16 +7,21 @@
 #define MELEMENT_OCTREE
 
 #include <vector>
+#include "BoundingVolumeHierarchy.h"
 
-class Octree;
 class GModel;
 class MElement;
 
+// Search structure for mesh elements, which can be queried concurrently; it
+// was originally an octree, and is now a bounding volume hierarchy
 class MElementOctree {
 private:
-  Octree *_octree;
   GModel *_gm;
   std::vector<MElement *> _elems;
+  BoundingVolumeHierarchy _bvh;
+  void _build();
+  void _findWithTolerance(double *P, int dim, double maxTol, bool all,
+                          std::vector<MElement *> &e) const;
 
 public:
   MElementOctree(GModel *);
@@ -0,0 +1,104 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MTAG_HASH_MAP_H
+#define MTAG_HASH_MAP_H
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "robin_hood.h"
+
+// An open-addressing hash map from (64 bit) mesh node or element tags to
+// values, used to cache sparsely numbered meshes. The map is split into
+// shards, selected by the hashed tag, so that it can be built in parallel
+// (one shard per thread) while lookups remain O(1).
+template <class T> class MTagHashMap {
+private:
+  typedef robin_hood::unordered_flat_map<std::size_t, T> shard;
+  static const std::size_t _numShards = 64;
+  std::vector<shard> _shards;
+  static std::size_t _shardOf(std::size_t tag)
+  {
+    return (robin_hood::hash<std::size_t>()(tag) >> 20) % _numShards;
+  }
+
+public:
+  MTagHashMap() : _shards(_numShards) {}
+  bool empty() const
+  {
+    for(std::size_t i = 0; i < _numShards; i++)
+      if(!_shards[i].empty()) return false;
+    return true;
+  }
+  std::size_t size() const
+  {
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < _numShards; i++) n += _shards[i].size();
+    return n;
+  }
+  void clear()
+  {
+    for(std::size_t i = 0; i < _numShards; i++) shard().swap(_shards[i]);
+  }
+  std::size_t count(std::size_t tag) const
+  {
+    return _shards[_shardOf(tag)].count(tag);
+  }
+  // insert a default value if the tag is not in the map
+  T &operator[](std::size_t tag) { return _shards[_shardOf(tag)][tag]; }
+  // return a pointer to the value, or nullptr if the tag is not in the map
+  // (this does not modify the map, and can thus be called concurrently)
+  const T *find(std::size_t tag) const
+  {
+    const shard &s = _shards[_shardOf(tag)];
+    auto it = s.find(tag);
+    return (it == s.end()) ? nullptr : &it->second;
+  }
+  T *find(std::size_t tag)
+  {
+    shard &s = _shards[_shardOf(tag)];
+    auto it = s.find(tag);
+    return (it == s.end()) ? nullptr : &it->second;
+  }
+  // insert n (tag, value) pairs in parallel; if a tag is already in the map
+  // or appears several times, the first value is kept
+  void insert(const std::pair<std::size_t, T> *values, std::size_t n,
+              int nthreads)
+  {
+    // bucket the pairs by shard (keeping their order), then fill the shards
+    // concurrently
+    std::vector<std::size_t> offsets(_numShards + 1, 0), index(n);
+    for(std::size_t i = 0; i < n; i++)
+      offsets[_shardOf(values[i].first) + 1]++;
+    for(std::size_t i = 0; i < _numShards; i++) offsets[i + 1] += offsets[i];
+    std::vector<std::size_t> pos(offsets.begin(), offsets.end() - 1);
+    for(std::size_t i = 0; i < n; i++)
+      index[pos[_shardOf(values[i].first)]++] = i;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < _numShards; i++) {
+      shard &s = _shards[i];
+      s.reserve(s.size() + offsets[i + 1] - offsets[i]);
+      for(std::size_t j = offsets[i]; j < offsets[i + 1]; j++)
+        s.emplace(values[index[j]].first, values[index[j]].second);
+    }
+  }
+  // get all the (tag, value) pairs, sorted by tag
+  void getSorted(std::vector<std::pair<std::size_t, T> > &values) const
+  {
+    values.clear();
+    values.reserve(size());
+    for(std::size_t i = 0; i < _numShards; i++)
+      for(auto it = _shards[i].begin(); it != _shards[i].end(); ++it)
+        values.push_back(std::make_pair(it->first, it->second));
+    std::sort(values.begin(), values.end(),
+              [](const std::pair<std::size_t, T> &a,
+                 const std::pair<std::size_t, T> &b) {
+                return a.first < b.first;
+              });
+  }
+};
+
+#endif
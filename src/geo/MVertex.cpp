@@ -24,8 +24,15 @@ double angle3Vertices(const MVertex *p1, const MVertex *p2, const MVertex *p3)
 }
 
 MVertex::MVertex(double x, double y, double z, GEntity *ge, std::size_t num)
-  : _visible(1), _order(1), _x(x), _y(y), _z(z), _ge(ge)
+  : _visible(1), _order(1),
+#if defined(HAVE_CONTIGUOUS_NODES)
+    _contiguous(false),
+#endif
+    _ge(ge)
 {
+  _xyz[0] = x;
+  _xyz[1] = y;
+  _xyz[2] = z;
   // we should make GModel a mandatory argument to the constructor
   GModel *m = GModel::current();
   if(num) {
@@ -38,6 +45,75 @@ MVertex::MVertex(double x, double y, double z, GEntity *ge, std::size_t num)
   _index = (long int)num;
 }
 
+MVertex::MVertex(const MVertex &v)
+  : _num(v._num), _index(v._index), _visible(v._visible), _order(v._order),
+#if defined(HAVE_CONTIGUOUS_NODES)
+    _contiguous(false),
+#endif
+    _ge(v._ge)
+{
+  _xyz[0] = v.x();
+  _xyz[1] = v.y();
+  _xyz[2] = v.z();
+}
+
+MVertex &MVertex::operator=(const MVertex &v)
+{
+  if(this == &v) return *this;
+  _num = v._num;
+  _index = v._index;
+  _visible = v._visible;
+  _order = v._order;
+  _ge = v._ge;
+  setXYZ(v.x(), v.y(), v.z());
+#if defined(HAVE_CONTIGUOUS_NODES)
+  if(_contiguous) _setStorageTag();
+#endif
+  return *this;
+}
+
+MVertex::~MVertex()
+{
+#if defined(HAVE_CONTIGUOUS_NODES)
+  if(_contiguous) _releaseStorage();
+#endif
+}
+
+#if defined(HAVE_CONTIGUOUS_NODES)
+
+void MVertex::_setStorage(double *xyz, GEntity *owner)
+{
+  if(_contiguous) _releaseStorage();
+  xyz[0] = _xyz[0];
+  xyz[1] = _xyz[1];
+  xyz[2] = _xyz[2];
+  _storage.xyz = xyz;
+  _storage.owner = owner;
+  _contiguous = true;
+}
+
+void MVertex::_releaseStorage()
+{
+  const double *p = _storage.xyz;
+  GEntity *owner = _storage.owner;
+  owner->_meshVertexViews[(p - owner->_meshVertexCoordinates.data()) / 3] =
+    nullptr;
+  owner->_meshVertexStorageModified = true;
+  double xyz[3] = {p[0], p[1], p[2]};
+  _contiguous = false;
+  _xyz[0] = xyz[0];
+  _xyz[1] = xyz[1];
+  _xyz[2] = xyz[2];
+}
+
+void MVertex::_setStorageTag()
+{
+  GEntity *owner = _storage.owner;
+  std::size_t i = (_storage.xyz - owner->_meshVertexCoordinates.data()) / 3;
+  owner->_meshVertexTags[i] = _num;
+}
+#endif
+
 void MVertex::deleteLast()
 {
   GModel *m = GModel::current();
@@ -50,6 +126,9 @@ void MVertex::forceNum(std::size_t num)
   GModel *m = GModel::current();
   _num = num;
   m->setMaxVertexNumber(_num);
+#if defined(HAVE_CONTIGUOUS_NODES)
+  if(_contiguous) _setStorageTag();
+#endif
 }
 
 void MVertex::writeMSH(FILE *fp, bool binary, bool saveParametric,
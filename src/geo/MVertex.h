@@ -11,9 +11,11 @@
 #include <set>
 #include <map>
 #include <fstream>
+#include "GmshConfig.h"
 #include "SPoint2.h"
 #include "SPoint3.h"
 #include "MVertexBoundaryLayerData.h"
+#include "MeshMemoryPool.h"
 
 class GEntity;
 class GEdge;
@@ -37,15 +39,60 @@ protected:
   long int _index;
   // a visibility and polynomial order flags
   char _visible, _order;
+#if defined(HAVE_CONTIGUOUS_NODES)
+  // set if the coordinates are stored in the contiguous mesh vertex storage
+  // of an entity (see GEntity::setContiguousMeshVertexStorage)
+  bool _contiguous;
+  // the cartesian coordinates of the vertex, or their location in the
+  // contiguous storage and the entity that owns it
+  union {
+    double _xyz[3];
+    struct {
+      double *xyz;
+      GEntity *owner;
+    } _storage;
+  };
+#else
   // the cartesian coordinates of the vertex
-  double _x, _y, _z;
+  double _xyz[3];
+#endif
   // the geometrical entity the vertex is associated with
   GEntity *_ge;
 
+#if defined(HAVE_CONTIGUOUS_NODES)
+  double *_coordinates() { return _contiguous ? _storage.xyz : _xyz; }
+  const double *_coordinates() const
+  {
+    return _contiguous ? _storage.xyz : _xyz;
+  }
+  // move the coordinates to xyz, in the contiguous storage of owner, or back
+  // into the vertex
+  void _setStorage(double *xyz, GEntity *owner);
+  void _releaseStorage();
+  void _setStorageTag();
+  friend class GEntity;
+#else
+  double *_coordinates() { return _xyz; }
+  const double *_coordinates() const { return _xyz; }
+#endif
+
 public:
   MVertex(double x, double y, double z, GEntity *ge = nullptr,
           std::size_t num = 0);
-  virtual ~MVertex() {}
+  // copies never share the contiguous storage of the original vertex
+  MVertex(const MVertex &v);
+  MVertex &operator=(const MVertex &v);
+  virtual ~MVertex();
+
+  // vertices are allocated in the mesh memory pool
+  static void *operator new(std::size_t size)
+  {
+    return MeshMemoryPool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size)
+  {
+    MeshMemoryPool::deallocate(p, size);
+  }
   void deleteLast();
 
   // get/set the visibility flag
@@ -57,26 +104,26 @@ public:
   void setPolynomialOrder(int order) { _order = (char)order; }
 
   // get/set the coordinates
-  double x() const { return _x; }
-  double y() const { return _y; }
-  double z() const { return _z; }
-  double &x() { return _x; }
-  double &y() { return _y; }
-  double &z() { return _z; }
-
-  SPoint3 point() const { return SPoint3(_x, _y, _z); }
-  void setXYZ(double x, double y, double z)
+  double x() const { return _coordinates()[0]; }
+  double y() const { return _coordinates()[1]; }
+  double z() const { return _coordinates()[2]; }
+  double &x() { return _coordinates()[0]; }
+  double &y() { return _coordinates()[1]; }
+  double &z() { return _coordinates()[2]; }
+
+  SPoint3 point() const
   {
-    _x = x;
-    _y = y;
-    _z = z;
+    const double *p = _coordinates();
+    return SPoint3(p[0], p[1], p[2]);
   }
-  void setXYZ(const SPoint3& pt)
+  void setXYZ(double x, double y, double z)
   {
-    _x = pt.x();
-    _y = pt.y();
-    _z = pt.z();
+    double *p = _coordinates();
+    p[0] = x;
+    p[1] = y;
+    p[2] = z;
   }
+  void setXYZ(const SPoint3& pt) { setXYZ(pt.x(), pt.y(), pt.z()); }
 
   // get/set the parent entity
   GEntity *onWhat() const { return _ge; }
@@ -104,9 +151,9 @@ public:
   // measure distance to another vertex
   double distance(MVertex *const v)
   {
-    double dx = _x - v->x();
-    double dy = _y - v->y();
-    double dz = _z - v->z();
+    double dx = x() - v->x();
+    double dy = y() - v->y();
+    double dz = z() - v->z();
     return std::sqrt(dx * dx + dy * dy + dz * dz);
   }
 
@@ -0,0 +1,312 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include "GmshMessage.h"
+#include "Context.h"
+#include "HilbertCurve.h"
+#include "MVertexHashGrid.h"
+
+static const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+MVertexHashGrid::MVertexHashGrid(double tolerance, int nthreads)
+  : _tol(tolerance), _size(2. * tolerance), _nthreads(nthreads),
+    _shards(_numShards)
+{
+  if(!_nthreads) _nthreads = CTX::instance()->numThreads;
+  if(!_nthreads) _nthreads = Msg::GetMaxThreads();
+}
+
+void MVertexHashGrid::_cell(double size, double x, double y, double z,
+                            int64_t c[3])
+{
+  double p[3] = {x, y, z};
+  for(int i = 0; i < 3; i++) {
+    if(size > 0.) {
+      double q = std::floor(p[i] / size);
+      c[i] = (int64_t)std::max(-4.e18, std::min(4.e18, q));
+    }
+    else {
+      // zero tolerance: only identical coordinates match (adding 0. maps -0.
+      // to 0.)
+      double q = p[i] + 0.;
+      std::memcpy(&c[i], &q, sizeof(double));
+    }
+  }
+}
+
+uint64_t MVertexHashGrid::_hash(int64_t i, int64_t j, int64_t k)
+{
+  uint64_t h = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+  h ^= (uint64_t)j * 0xC2B2AE3D27D4EB4FULL;
+  h ^= (uint64_t)k * 0x165667B19E3779F9ULL;
+  h ^= h >> 31;
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= h >> 29;
+  return h;
+}
+
+bool MVertexHashGrid::_match(double size, const double *p, double x,
+                             double y, double z)
+{
+  return std::abs(p[0] - x) <= size && std::abs(p[1] - y) <= size &&
+         std::abs(p[2] - z) <= size;
+}
+
+bool MVertexHashGrid::_match(const MVertex *v, double x, double y,
+                             double z) const
+{
+  double p[3] = {v->x(), v->y(), v->z()};
+  return _match(_size, p, x, y, z);
+}
+
+std::size_t MVertexHashGrid::_weld(const double *xyz, std::size_t n,
+                                   double size, const uint64_t *keys,
+                                   const char *skip, int nthreads,
+                                   std::vector<std::size_t> &first)
+{
+  // sort the points by cell, then by index
+  std::vector<std::pair<uint64_t, std::size_t> > sorted;
+  sorted.reserve(n);
+  for(std::size_t i = 0; i < n; i++)
+    if(!skip || !skip[i]) sorted.push_back(std::make_pair(keys[i], i));
+  SortCurveIndices(sorted, nthreads);
+
+  // smallest j < i that matches point i (and that is kept, if kept is given)
+  auto findFirst = [&](std::size_t i, const std::vector<char> *kept) {
+    const double *p = &xyz[3 * i];
+    int64_t c[3];
+    _cell(size, p[0], p[1], p[2], c);
+    int r = (size > 0.) ? 1 : 0;
+    std::size_t best = none;
+    for(int a = -r; a <= r; a++) {
+      for(int b = -r; b <= r; b++) {
+        for(int d = -r; d <= r; d++) {
+          uint64_t key = _hash(c[0] + a, c[1] + b, c[2] + d);
+          auto it = std::lower_bound(sorted.begin(), sorted.end(),
+                                     std::make_pair(key, (std::size_t)0));
+          for(; it != sorted.end() && it->first == key && it->second < i &&
+                it->second < best;
+              ++it) {
+            std::size_t j = it->second;
+            if((!kept || (*kept)[j]) &&
+               _match(size, &xyz[3 * j], p[0], p[1], p[2])) {
+              best = j;
+              break;
+            }
+          }
+        }
+      }
+    }
+    return best;
+  };
+
+  first.assign(n, none);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t k = 0; k < sorted.size(); k++) {
+    std::size_t i = sorted[k].second;
+    first[i] = findFirst(i, nullptr);
+  }
+
+  // a point is kept if it matches no kept point before it: this is decided
+  // in order, the (rare) case where the first matching point is itself a
+  // duplicate requiring a new search
+  std::vector<char> kept(n, 0);
+  std::size_t num = 0;
+  for(std::size_t i = 0; i < n; i++) {
+    if(skip && skip[i]) continue;
+    std::size_t j = first[i];
+    if(j != none && !kept[j]) j = first[i] = findFirst(i, &kept);
+    if(j == none) kept[i] = 1;
+    else num++;
+  }
+  return num;
+}
+
+std::size_t MVertexHashGrid::weld(const std::vector<double> &xyz,
+                                  double tolerance,
+                                  std::vector<std::size_t> &index,
+                                  int nthreads)
+{
+  if(!nthreads) nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  double size = 2. * tolerance;
+  std::size_t n = xyz.size() / 3;
+  index.clear();
+  if(!n) return 0;
+  std::vector<uint64_t> keys(n);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    int64_t c[3];
+    _cell(size, xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2], c);
+    keys[i] = _hash(c[0], c[1], c[2]);
+  }
+  std::size_t num = _weld(&xyz[0], n, size, &keys[0], nullptr, nthreads,
+                          index);
+  for(std::size_t i = 0; i < n; i++)
+    if(index[i] == none) index[i] = i;
+  return n - num;
+}
+
+std::size_t MVertexHashGrid::_findIndex(double x, double y, double z) const
+{
+  if(_vertices.empty()) return none;
+  int64_t c[3];
+  _cell(_size, x, y, z, c);
+  int r = (_size > 0.) ? 1 : 0;
+  std::size_t best = none;
+  for(int i = -r; i <= r; i++) {
+    for(int j = -r; j <= r; j++) {
+      for(int k = -r; k <= r; k++) {
+        uint64_t key = _hash(c[0] + i, c[1] + j, c[2] + k);
+        const shard &s = _shards[_shardOf(key)];
+        auto it = s.find(key);
+        if(it == s.end()) continue;
+        for(std::size_t n = it->second; n != none; n = _next[n]) {
+          if(n < best && _match(_vertices[n], x, y, z)) best = n;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+void MVertexHashGrid::_link(std::size_t index)
+{
+  uint64_t key = _keys[index];
+  auto it = _shards[_shardOf(key)].emplace(key, index);
+  if(it.second) { _next[index] = none; }
+  else {
+    _next[index] = it.first->second;
+    it.first->second = index;
+  }
+}
+
+void MVertexHashGrid::_warn(MVertex *v, MVertex *out) const
+{
+  Msg::Warning("Node %d (%.16g, %.16g, %.16g) already exists in the "
+               "mesh with tolerance %g as node %d (%.16g, %.16g, %.16g)",
+               v->getNum(), v->x(), v->y(), v->z(), _tol, out->getNum(),
+               out->x(), out->y(), out->z());
+}
+
+MVertex *
+MVertexHashGrid::insert(MVertex *v, bool warnIfExists,
+                        std::set<MVertex *, MVertexPtrLessThan> *duplicates)
+{
+  std::size_t n = _findIndex(v->x(), v->y(), v->z());
+  if(n != none) {
+    MVertex *out = _vertices[n];
+    if(duplicates) {
+      duplicates->insert(out);
+      duplicates->insert(v);
+    }
+    if(warnIfExists) _warn(v, out);
+    return out;
+  }
+  int64_t c[3];
+  _cell(_size, v->x(), v->y(), v->z(), c);
+  _vertices.push_back(v);
+  _keys.push_back(_hash(c[0], c[1], c[2]));
+  _next.push_back(none);
+  _link(_vertices.size() - 1);
+  return nullptr;
+}
+
+std::size_t MVertexHashGrid::insert(const std::vector<MVertex *> &v,
+                                    std::vector<MVertex *> &matches)
+{
+  std::size_t n = v.size();
+  matches.assign(n, nullptr);
+  if(!n) return 0;
+
+  // small sets are not worth the parallel overhead
+  if(n < 1024 || _nthreads < 2) {
+    std::size_t num = 0;
+    for(std::size_t i = 0; i < n; i++) {
+      matches[i] = insert(v[i]);
+      if(matches[i]) num++;
+    }
+    return num;
+  }
+
+  // match the new vertices with the vertices already in the grid
+  std::vector<uint64_t> keys(n);
+  std::vector<double> xyz(3 * n);
+  std::vector<char> skip(n, 0);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(_nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    xyz[3 * i] = v[i]->x();
+    xyz[3 * i + 1] = v[i]->y();
+    xyz[3 * i + 2] = v[i]->z();
+    int64_t c[3];
+    _cell(_size, v[i]->x(), v[i]->y(), v[i]->z(), c);
+    keys[i] = _hash(c[0], c[1], c[2]);
+    std::size_t m = _findIndex(v[i]->x(), v[i]->y(), v[i]->z());
+    if(m != none) {
+      matches[i] = _vertices[m];
+      skip[i] = 1;
+    }
+  }
+
+  // then weld the remaining ones together
+  std::vector<std::size_t> first;
+  _weld(&xyz[0], n, _size, &keys[0], &skip[0], _nthreads, first);
+  std::size_t num = 0;
+  std::vector<char> kept(n, 0);
+  for(std::size_t i = 0; i < n; i++) {
+    if(!skip[i] && first[i] != none) matches[i] = v[first[i]];
+    if(matches[i])
+      num++;
+    else
+      kept[i] = 1;
+  }
+
+  // add the kept vertices, each thread filling its own shards
+  std::size_t base = _vertices.size();
+  for(std::size_t i = 0; i < n; i++) {
+    if(!kept[i]) continue;
+    _vertices.push_back(v[i]);
+    _keys.push_back(keys[i]);
+  }
+  _next.resize(_vertices.size(), none);
+  std::vector<std::vector<std::size_t> > byShard(_numShards);
+  for(std::size_t i = base; i < _vertices.size(); i++)
+    byShard[_shardOf(_keys[i])].push_back(i);
+#pragma omp parallel for schedule(dynamic) num_threads(_nthreads)
+  for(std::size_t s = 0; s < _numShards; s++) {
+    _shards[s].reserve(_shards[s].size() + byShard[s].size());
+    for(std::size_t i = 0; i < byShard[s].size(); i++) _link(byShard[s][i]);
+  }
+
+  return num;
+}
+
+int MVertexHashGrid::insert(std::vector<MVertex *> &v, bool warnIfExists,
+                            std::set<MVertex *, MVertexPtrLessThan> *duplicates)
+{
+  std::vector<MVertex *> matches;
+  std::size_t num = insert(v, matches);
+  if(num && (warnIfExists || duplicates)) {
+    for(std::size_t i = 0; i < v.size(); i++) {
+      if(!matches[i]) continue;
+      if(duplicates) {
+        duplicates->insert(matches[i]);
+        duplicates->insert(v[i]);
+      }
+      if(warnIfExists) _warn(v[i], matches[i]);
+    }
+  }
+  return (int)num;
+}
+
+MVertex *MVertexHashGrid::find(double x, double y, double z) const
+{
+  std::size_t n = _findIndex(x, y, z);
+  return (n == none) ? nullptr : _vertices[n];
+}
@@ -0,0 +1,76 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MVERTEX_HASH_GRID_H
+#define MVERTEX_HASH_GRID_H
+
+#include <vector>
+#include <set>
+#include <cstdint>
+#include "MVertex.h"
+#include "robin_hood.h"
+
+// Stores MVertex pointers in a hashed uniform grid so we can query unique
+// vertices by their coordinates, up to a prescribed tolerance. This is a
+// drop-in replacement for MVertexRTree (two vertices are considered identical
+// if their coordinates differ by at most twice the tolerance), which can in
+// addition weld large sets of vertices in parallel.
+//
+// The grid cells have a size of twice the tolerance, so that the vertices
+// matching a point are in the 27 cells surrounding it. Cells are hashed into
+// shards, each storing the head of a linked list of the vertices in the cells
+// with a given hash: when inserting vertices in bulk, each thread fills its
+// own shards, without locks. When several unique vertices match a point, the
+// one inserted first is returned, so that the result does not depend on the
+// number of threads.
+class MVertexHashGrid {
+private:
+  typedef robin_hood::unordered_flat_map<uint64_t, std::size_t> shard;
+  static const std::size_t _numShards = 64;
+  double _tol, _size;
+  int _nthreads;
+  std::vector<MVertex *> _vertices;
+  std::vector<uint64_t> _keys;
+  std::vector<std::size_t> _next;
+  std::vector<shard> _shards;
+  static void _cell(double size, double x, double y, double z, int64_t c[3]);
+  static uint64_t _hash(int64_t i, int64_t j, int64_t k);
+  static std::size_t _shardOf(uint64_t key) { return key >> 58; }
+  static bool _match(double size, const double *p, double x, double y,
+                     double z);
+  bool _match(const MVertex *v, double x, double y, double z) const;
+  static std::size_t _weld(const double *xyz, std::size_t n, double size,
+                           const uint64_t *keys, const char *skip,
+                           int nthreads, std::vector<std::size_t> &first);
+  std::size_t _findIndex(double x, double y, double z) const;
+  void _link(std::size_t index);
+  void _warn(MVertex *v, MVertex *out) const;
+
+public:
+  MVertexHashGrid(double tolerance = 1.e-8, int nthreads = 0);
+  // insert a vertex; return nullptr if it was inserted, or the existing
+  // vertex that matches it
+  MVertex *insert(MVertex *v, bool warnIfExists = false,
+                  std::set<MVertex *, MVertexPtrLessThan> *duplicates = nullptr);
+  // insert vertices in parallel, with the same result as inserting them one
+  // by one; matches[i] is set to nullptr if v[i] was inserted, or to the
+  // existing vertex that matches it; return the number of vertices not
+  // inserted
+  std::size_t insert(const std::vector<MVertex *> &v,
+                     std::vector<MVertex *> &matches);
+  int insert(std::vector<MVertex *> &v, bool warnIfExists = false,
+             std::set<MVertex *, MVertexPtrLessThan> *duplicates = nullptr);
+  // find a vertex matching the point (this can be called concurrently)
+  MVertex *find(double x, double y, double z) const;
+  std::size_t size() const { return _vertices.size(); }
+  // weld points given by their coordinates (x, y, z triplets) in parallel,
+  // without creating vertices: index[i] is set to the index of the first point
+  // that point i matches (i itself if there is none); return the number of
+  // unique points
+  static std::size_t weld(const std::vector<double> &xyz, double tolerance,
+                          std::vector<std::size_t> &index, int nthreads = 0);
+};
+
+#endif
@@ -0,0 +1,270 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include "MeshMemoryPool.h"
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+  // slabs are aligned on their size, so that the slab containing a block is
+  // found by masking the address of the block
+  const std::size_t slabSize = 1 << 16;
+  const std::size_t granularity = 16;
+  const std::size_t maxBlockSize = 512;
+  const std::size_t numClasses = maxBlockSize / granularity;
+  const int cacheSize = 32;
+
+  struct freeBlock {
+    freeBlock *next;
+  };
+
+  struct slab {
+    std::size_t live; // number of blocks given out (to objects or caches)
+    char *bump, *end; // blocks that have never been given out
+    freeBlock *freeList; // blocks given back to the slab
+    slab *prev, *next; // list of slabs with available blocks
+    bool listed;
+  };
+
+  const std::size_t headerSize = (sizeof(slab) + 63) / 64 * 64;
+
+  struct sizeClass {
+    std::mutex mutex;
+    slab *available;
+    slab *spare; // keep one empty slab to avoid allocation ping-pong
+    sizeClass() : available(nullptr), spare(nullptr) {}
+  };
+
+  struct poolState {
+    sizeClass classes[numClasses];
+    std::atomic<std::size_t> numSlabs;
+    poolState() : numSlabs(0) {}
+  };
+
+  // never destroyed, as mesh objects can be deleted during static destruction
+  poolState &state()
+  {
+    static poolState *s = new poolState();
+    return *s;
+  }
+
+  void release(std::size_t c, freeBlock *b);
+  void releaseAll(std::size_t c, freeBlock *b);
+
+  // per-thread cache of free blocks, to avoid locking on each allocation;
+  // since the cache is refilled with consecutive blocks, objects allocated by
+  // a thread are contiguous. The blocks deallocated during a bulk release are
+  // put aside in the pending lists.
+  struct threadCache {
+    freeBlock *blocks[numClasses];
+    int count[numClasses];
+    freeBlock *pending[numClasses];
+    int bulk; // number of active bulk releases
+    // give the cached blocks back to their slabs when the thread exits, so
+    // that the slabs can be released
+    ~threadCache()
+    {
+      for(std::size_t c = 0; c < numClasses; c++) {
+        releaseAll(c, blocks[c]);
+        releaseAll(c, pending[c]);
+        blocks[c] = pending[c] = nullptr;
+        count[c] = 0;
+      }
+      bulk = 0;
+    }
+  };
+
+  thread_local threadCache cache;
+
+  void resetSlab(slab *s)
+  {
+    s->live = 0;
+    s->bump = (char *)s + headerSize;
+    s->end = (char *)s + slabSize;
+    s->freeList = nullptr;
+    s->prev = s->next = nullptr;
+    s->listed = false;
+  }
+
+  slab *newSlab()
+  {
+    void *mem = nullptr;
+#if defined(WIN32) && !defined(__CYGWIN__)
+    mem = _aligned_malloc(slabSize, slabSize);
+#else
+    if(posix_memalign(&mem, slabSize, slabSize)) mem = nullptr;
+#endif
+    if(!mem) throw std::bad_alloc();
+    state().numSlabs++;
+    slab *s = (slab *)mem;
+    resetSlab(s);
+    return s;
+  }
+
+  void freeSlab(slab *s)
+  {
+    state().numSlabs--;
+#if defined(WIN32) && !defined(__CYGWIN__)
+    _aligned_free(s);
+#else
+    free(s);
+#endif
+  }
+
+  void link(sizeClass &sc, slab *s)
+  {
+    s->prev = nullptr;
+    s->next = sc.available;
+    if(sc.available) sc.available->prev = s;
+    sc.available = s;
+    s->listed = true;
+  }
+
+  void unlink(sizeClass &sc, slab *s)
+  {
+    if(s->prev)
+      s->prev->next = s->next;
+    else
+      sc.available = s->next;
+    if(s->next) s->next->prev = s->prev;
+    s->prev = s->next = nullptr;
+    s->listed = false;
+  }
+
+  void refill(std::size_t c, threadCache &tc)
+  {
+    const std::size_t blockSize = (c + 1) * granularity;
+    sizeClass &sc = state().classes[c];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    while(tc.count[c] < cacheSize / 2) {
+      slab *s = sc.available;
+      if(!s) {
+        if(sc.spare) {
+          s = sc.spare;
+          sc.spare = nullptr;
+        }
+        else {
+          s = newSlab();
+        }
+        link(sc, s);
+      }
+      freeBlock *b;
+      if(s->freeList) {
+        b = s->freeList;
+        s->freeList = b->next;
+      }
+      else {
+        b = (freeBlock *)s->bump;
+        s->bump += blockSize;
+      }
+      s->live++;
+      if(!s->freeList && s->bump + blockSize > s->end) unlink(sc, s);
+      b->next = tc.blocks[c];
+      tc.blocks[c] = b;
+      tc.count[c]++;
+    }
+  }
+
+  // give a block back to its slab; the size class must be locked
+  void releaseLocked(sizeClass &sc, freeBlock *b)
+  {
+    slab *s = (slab *)((std::uintptr_t)b & ~(std::uintptr_t)(slabSize - 1));
+    b->next = s->freeList;
+    s->freeList = b;
+    s->live--;
+    if(!s->listed) link(sc, s);
+    if(!s->live) {
+      unlink(sc, s);
+      if(sc.spare) { freeSlab(s); }
+      else {
+        resetSlab(s);
+        sc.spare = s;
+      }
+    }
+  }
+
+  void release(std::size_t c, freeBlock *b)
+  {
+    sizeClass &sc = state().classes[c];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    releaseLocked(sc, b);
+  }
+
+  // give a list of blocks back to their slabs
+  void releaseAll(std::size_t c, freeBlock *b)
+  {
+    if(!b) return;
+    sizeClass &sc = state().classes[c];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    while(b) {
+      freeBlock *next = b->next;
+      releaseLocked(sc, b);
+      b = next;
+    }
+  }
+
+} // namespace
+
+void *MeshMemoryPool::allocate(std::size_t size)
+{
+  if(!size) size = 1;
+  if(size > maxBlockSize) return ::operator new(size);
+  const std::size_t c = (size - 1) / granularity;
+  threadCache &tc = cache;
+  if(!tc.count[c]) refill(c, tc);
+  freeBlock *b = tc.blocks[c];
+  tc.blocks[c] = b->next;
+  tc.count[c]--;
+  return b;
+}
+
+void MeshMemoryPool::deallocate(void *p, std::size_t size)
+{
+  if(!p) return;
+  if(!size) size = 1;
+  if(size > maxBlockSize) {
+    ::operator delete(p);
+    return;
+  }
+  // blocks are given back to their slab right away (and not cached by the
+  // thread), so that slabs can be released as soon as they are empty, unless
+  // a bulk release is active
+  const std::size_t c = (size - 1) / granularity;
+  threadCache &tc = cache;
+  if(tc.bulk) {
+    freeBlock *b = (freeBlock *)p;
+    b->next = tc.pending[c];
+    tc.pending[c] = b;
+    return;
+  }
+  release(c, (freeBlock *)p);
+}
+
+MeshMemoryPool::bulkRelease::bulkRelease() { cache.bulk++; }
+
+MeshMemoryPool::bulkRelease::~bulkRelease()
+{
+  threadCache &tc = cache;
+  if(--tc.bulk) return;
+  for(std::size_t c = 0; c < numClasses; c++) {
+    releaseAll(c, tc.pending[c]);
+    tc.pending[c] = nullptr;
+  }
+}
+
+std::size_t MeshMemoryPool::getNumSlabs() { return state().numSlabs; }
+
+std::size_t MeshMemoryPool::getMemoryUsage()
+{
+  return state().numSlabs * slabSize;
+}
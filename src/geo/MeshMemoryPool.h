@@ -0,0 +1,41 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MESH_MEMORY_POOL_H
+#define MESH_MEMORY_POOL_H
+
+#include <cstddef>
+
+// A slab allocator for the small objects that make up a mesh (MVertex,
+// MElement and their subclasses), used through their class-specific operator
+// new and delete.
+//
+// Object sizes are rounded up to a multiple of 16 bytes, and objects of each
+// size class are carved out of large aligned slabs. Consecutively created
+// objects are thus contiguous in memory, there is no per-object malloc
+// overhead, and a slab is returned to the system as soon as all the objects
+// it contains have been deleted (e.g. when the mesh of an entity is
+// deleted). Each thread keeps a small cache of free blocks per size class, so
+// that objects can be created concurrently without contention; the cache is
+// given back to the pool when the thread exits.
+class MeshMemoryPool {
+public:
+  static void *allocate(std::size_t size);
+  static void deallocate(void *p, std::size_t size);
+  // while an object of this class exists, the blocks deallocated by the
+  // current thread are put aside, and given back to their slabs all at once
+  // when it is destroyed, locking each size class only once (e.g. when the
+  // mesh of an entity is deleted)
+  class bulkRelease {
+  public:
+    bulkRelease();
+    ~bulkRelease();
+  };
+  // number of slabs and total memory currently reserved by the pool
+  static std::size_t getNumSlabs();
+  static std::size_t getMemoryUsage();
+};
+
+#endif
@@ -208,8 +208,9 @@ SMetric3 buildMetricTangentToSurface(SVector3 &t1, SVector3 &t2, double l_t1,
   return Metric;
 }
 
-double BGM_MeshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
-                                  double Y, double Z)
+// mesh size given the size l3 prescribed by the background field
+static double meshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
+                                     double Y, double Z, double l3)
 {
   // lc from points
   double l1 = MAX_LC;
@@ -221,16 +222,6 @@ double BGM_MeshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
   if(ge && CTX::instance()->mesh.lcFromCurvature > 0 && ge->dim() < 3)
     l2 = LC_MVertex_CURV(ge, U, V);
 
-  // lc from fields
-  double l3 = MAX_LC;
-  if(ge) {
-    FieldManager *fields = ge->model()->getFields();
-    if(fields->getBackgroundField() > 0) {
-      Field *f = fields->get(fields->getBackgroundField());
-      if(f) l3 = (*f)(X, Y, Z, ge);
-    }
-  }
-
   // global lc from entity
   double l4 = ge ? ge->getMeshSize() : MAX_LC;
 
@@ -251,17 +242,46 @@ double BGM_MeshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
   return lc;
 }
 
-// This is the only function that is used by the meshers
-double BGM_MeshSize(GEntity *ge, double U, double V, double X, double Y,
-                    double Z)
+// lc from fields, evaluated at n points at once
+static void backgroundFieldSize(GEntity *ge, std::size_t n, const double *X,
+                                const double *Y, const double *Z, double *l3)
 {
-  if(!ge) Msg::Warning("No entity in background mesh size evaluation");
+  std::fill(l3, l3 + n, MAX_LC);
+  if(ge) {
+    Field *f = ge->model()->getFields()->getBackgroundMeshSizeField();
+    if(f) f->evaluate(n, X, Y, Z, l3, ge);
+  }
+}
 
+double BGM_MeshSizeWithoutScaling(GEntity *ge, double U, double V, double X,
+                                  double Y, double Z)
+{
+  // lc from fields
+  double l3 = MAX_LC;
+  if(ge) {
+    Field *f = ge->model()->getFields()->getBackgroundMeshSizeField();
+    if(f) l3 = (*f)(X, Y, Z, ge);
+  }
+  return meshSizeWithoutScaling(ge, U, V, X, Y, Z, l3);
+}
+
+void BGM_MeshSizeWithoutScaling(GEntity *ge, std::size_t n, const double *U,
+                                const double *V, const double *X,
+                                const double *Y, const double *Z, double *lc)
+{
+  backgroundFieldSize(ge, n, X, Y, Z, lc);
+  for(std::size_t i = 0; i < n; i++)
+    lc[i] = meshSizeWithoutScaling(ge, U[i], V[i], X[i], Y[i], Z[i], lc[i]);
+}
+
+// apply the global constraints and scaling factors to the mesh size
+static double scaleMeshSize(GEntity *ge, double lcWithoutScaling)
+{
   // default size to size of model
   double lc = CTX::instance()->lc;
 
   // min of all sizes
-  lc = std::min(lc, BGM_MeshSizeWithoutScaling(ge, U, V, X, Y, Z));
+  lc = std::min(lc, lcWithoutScaling);
 
   // constrain by lcMin and lcMax
   lc = std::max(lc, CTX::instance()->mesh.lcMin);
@@ -280,6 +300,23 @@ double BGM_MeshSize(GEntity *ge, double U, double V, double X, double Y,
   return lc * CTX::instance()->mesh.lcFactor;
 }
 
+// This is the only function that is used by the meshers
+double BGM_MeshSize(GEntity *ge, double U, double V, double X, double Y,
+                    double Z)
+{
+  if(!ge) Msg::Warning("No entity in background mesh size evaluation");
+  return scaleMeshSize(ge, BGM_MeshSizeWithoutScaling(ge, U, V, X, Y, Z));
+}
+
+void BGM_MeshSize(GEntity *ge, std::size_t n, const double *U, const double *V,
+                  const double *X, const double *Y, const double *Z,
+                  double *lc)
+{
+  if(!ge) Msg::Warning("No entity in background mesh size evaluation");
+  BGM_MeshSizeWithoutScaling(ge, n, U, V, X, Y, Z, lc);
+  for(std::size_t i = 0; i < n; i++) lc[i] = scaleMeshSize(ge, lc[i]);
+}
+
 // anisotropic version of the background field
 SMetric3 BGM_MeshMetric(GEntity *ge, double U, double V, double X, double Y,
                         double Z)
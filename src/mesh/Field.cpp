@@ -8,6 +8,7 @@
 //
 
 #include <cstdlib>
+#include <cstdint>
 #include <limits>
 #include <list>
 #include <cmath>
@@ -16,12 +17,15 @@
 #include <string.h>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include "GmshConfig.h"
 #include "Context.h"
 #include "Field.h"
 #include "GModel.h"
 #include "GModelIO_GEO.h"
 #include "GmshMessage.h"
+#include "OS.h"
 #include "Numeric.h"
 #include "mathEvaluator.h"
 #include "BackgroundMeshTools.h"
@@ -55,6 +59,12 @@ Field::~Field()
     delete it->second;
 }
 
+void Field::evaluate(std::size_t n, const double *x, const double *y,
+                     const double *z, double *val, GEntity *ge)
+{
+  for(std::size_t i = 0; i < n; i++) val[i] = (*this)(x[i], y[i], z[i], ge);
+}
+
 FieldOption *Field::getOption(const std::string &optionName)
 {
   auto it = options.find(optionName);
@@ -65,8 +75,11 @@ FieldOption *Field::getOption(const std::string &optionName)
   return it->second;
 }
 
+std::size_t FieldOption::_numModifications = 0;
+
 void FieldManager::reset()
 {
+  _deleteBackgroundFieldCache();
   for(auto it = begin(); it != end(); it++) { delete it->second; }
   clear();
 }
@@ -91,6 +104,7 @@ Field *FieldManager::newField(int id, const std::string &type_name)
   Field *f = (*mapTypeName[type_name])();
   if(!f) return nullptr;
   f->id = id;
+  _deleteBackgroundFieldCache();
   (*this)[id] = f;
   return f;
 }
@@ -122,6 +136,7 @@ void FieldManager::deleteField(int id)
     Msg::Error("Cannot delete field id %i, it does not exist", id);
     return;
   }
+  _deleteBackgroundFieldCache();
   delete it->second;
   erase(it);
 }
@@ -410,6 +425,24 @@ public:
     }
     return _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    for(std::size_t i = 0; i < n; i++) {
+      bool inside = x[i] >= _xMin && x[i] <= _xMax && y[i] >= _yMin &&
+                    y[i] <= _yMax && z[i] >= _zMin && z[i] <= _zMax;
+      val[i] = inside ? _vIn : _vOut;
+    }
+    if(_thick > 0) {
+      for(std::size_t i = 0; i < n; i++) {
+        if(x[i] >= _xMin && x[i] <= _xMax && y[i] >= _yMin && y[i] <= _yMax &&
+           z[i] >= _zMin && z[i] <= _zMax)
+          continue;
+        double dist = computeDistance(x[i], y[i], z[i]);
+        if(dist <= _thick) val[i] = _vIn + (dist / _thick) * (_vOut - _vIn);
+      }
+    }
+  }
 };
 
 class CylinderField : public Field {
@@ -469,6 +502,23 @@ public:
     return ((dx * dx + dy * dy + dz * dz < _r * _r) && fabs(adx) < 1) ? _vIn :
                                                                         _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    const double a2 = _xa * _xa + _ya * _ya + _za * _za;
+    const double r2 = _r * _r;
+    for(std::size_t i = 0; i < n; i++) {
+      double dx = x[i] - _xc;
+      double dy = y[i] - _yc;
+      double dz = z[i] - _zc;
+      double adx = (_xa * dx + _ya * dy + _za * dz) / a2;
+      dx -= adx * _xa;
+      dy -= adx * _ya;
+      dz -= adx * _za;
+      val[i] = ((dx * dx + dy * dy + dz * dz < r2) && fabs(adx) < 1) ? _vIn :
+                                                                        _vOut;
+    }
+  }
 };
 
 class BallField : public Field {
@@ -520,6 +570,21 @@ public:
     }
     return _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    const double thick = (_thick > 0) ? _thick : 0.;
+    for(std::size_t i = 0; i < n; i++) {
+      double dx = x[i] - _xc;
+      double dy = y[i] - _yc;
+      double dz = z[i] - _zc;
+      double d = sqrt(dx * dx + dy * dy + dz * dz);
+      double dist = d - _r;
+      double v = _vOut;
+      if(thick > 0 && dist <= thick) v = _vIn + (dist / thick) * (_vOut - _vIn);
+      val[i] = (d < _r) ? _vIn : v;
+    }
+  }
 };
 
 class FrustumField : public Field {
@@ -687,6 +752,25 @@ public:
       return MAX_LC;
     }
     double d = (*field)(x, y, z, ge);
+    return _threshold(d);
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    Field *field =
+      (_inField == id) ? nullptr : GModel::current()->getFields()->get(_inField);
+    if(!field) {
+      if(_inField != id) Msg::Warning("Unknown Field %i", _inField);
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    field->evaluate(n, x, y, z, val, ge);
+    for(std::size_t i = 0; i < n; i++) val[i] = _threshold(val[i]);
+  }
+
+private:
+  double _threshold(double d) const
+  {
     if(_stopAtDistMax && d >= _dMax) return MAX_LC;
     double r = (d - _dMin) / (_dMax - _dMin);
     r = std::max(std::min(r, 1.), 0.);
@@ -977,15 +1061,44 @@ public:
 
 class MathEvalExpression {
 private:
-  mathEvaluator *_f;
   std::set<int> _fields;
-
-public:
-  MathEvalExpression() : _f(nullptr) {}
-  ~MathEvalExpression()
+  std::vector<std::string> _expressions, _variables;
+  // identifier of the compiled expression (0 if there is none), unique among
+  // all the expressions compiled in the program
+  std::size_t _id;
+  static std::atomic<std::size_t> _lastId;
+  // mathEvaluator::eval() is not reentrant: each thread evaluates the
+  // expression with its own evaluator, created the first time it is needed
+  // and kept in a thread-local cache. The cache is keyed by the expression
+  // and not by the OpenMP thread number, which is not unique in nested
+  // parallel regions or in threads not created by OpenMP. Entries left by
+  // deleted expressions are discarded when their identifier does not match.
+  typedef std::map<const MathEvalExpression *,
+                   std::pair<std::size_t, std::unique_ptr<mathEvaluator> > >
+    evaluatorCache;
+  static evaluatorCache &_cache()
+  {
+    thread_local evaluatorCache cache;
+    return cache;
+  }
+  mathEvaluator *_getEvaluator()
+  {
+    auto &c = _cache()[this];
+    if(c.first != _id || !c.second) {
+      std::vector<std::string> expressions(_expressions);
+      c.second.reset(new mathEvaluator(expressions, _variables));
+      c.first = _id;
+    }
+    return c.second.get();
+  }
+  bool _eval(const std::vector<double> &values, std::vector<double> &res)
   {
-    if(_f) delete _f;
+    return _getEvaluator()->eval(values, res);
   }
+
+public:
+  MathEvalExpression() : _id(0) {}
+  ~MathEvalExpression() { _cache().erase(this); }
   bool set_function(const std::string &f)
   {
     // get id numbers of fields appearing in the function
@@ -1017,18 +1130,24 @@ public:
       sstream << "F" << *it;
       variables[i++] = sstream.str();
     }
-    if(_f) delete _f;
-    _f = new mathEvaluator(expressions, variables);
+    _id = 0;
+    mathEvaluator *e = new mathEvaluator(expressions, variables);
     if(expressions.empty()) {
-      delete _f;
-      _f = nullptr;
+      delete e;
       return false;
     }
+    _expressions = expressions;
+    _variables = variables;
+    _id = ++_lastId;
+    // keep the evaluator for this thread
+    auto &c = _cache()[this];
+    c.first = _id;
+    c.second.reset(e);
     return true;
   }
   double evaluate(double x, double y, double z, GEntity *ge)
   {
-    if(!_f) return MAX_LC;
+    if(!_id) return MAX_LC;
     std::vector<double> values(3 + _fields.size()), res(1);
     values[0] = x;
     values[1] = y;
@@ -1044,97 +1163,58 @@ public:
         values[i++] = MAX_LC;
       }
     }
-    if(_f->eval(values, res))
+    if(_eval(values, res))
       return res[0];
     else
       return MAX_LC;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge)
+  {
+    if(!_id || !n) {
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    // evaluate the fields appearing in the expression on the whole batch
+    std::vector<std::vector<double> > fieldValues(_fields.size());
+    int k = 0;
+    for(auto it = _fields.begin(); it != _fields.end(); it++, k++) {
+      fieldValues[k].resize(n, MAX_LC);
+      Field *field = GModel::current()->getFields()->get(*it);
+      if(field)
+        field->evaluate(n, x, y, z, &fieldValues[k][0], ge);
+      else
+        Msg::Warning("Unknown Field %i in MathEval", *it);
+    }
+    std::vector<double> values(3 + _fields.size()), res(1);
+    for(std::size_t i = 0; i < n; i++) {
+      values[0] = x[i];
+      values[1] = y[i];
+      values[2] = z[i];
+      for(std::size_t j = 0; j < fieldValues.size(); j++)
+        values[3 + j] = fieldValues[j][i];
+      val[i] = _eval(values, res) ? res[0] : MAX_LC;
+    }
+  }
 };
 
+std::atomic<std::size_t> MathEvalExpression::_lastId(0);
+
 class MathEvalExpressionAniso {
 private:
-  mathEvaluator *_f[6];
-  std::set<int> _fields[6];
+  MathEvalExpression _f[6];
 
 public:
-  MathEvalExpressionAniso()
-  {
-    for(int i = 0; i < 6; i++) _f[i] = nullptr;
-  }
-  ~MathEvalExpressionAniso()
-  {
-    for(int i = 0; i < 6; i++)
-      if(_f[i]) delete _f[i];
-  }
   bool set_function(int iFunction, const std::string &f)
   {
-    // get id numbers of fields appearing in the function
-    _fields[iFunction].clear();
-    std::size_t i = 0;
-    while(i < f.size()) {
-      std::size_t j = 0;
-      if(f[i] == 'F') {
-        std::string id("");
-        while(i + 1 + j < f.size() && f[i + 1 + j] >= '0' &&
-              f[i + 1 + j] <= '9') {
-          id += f[i + 1 + j];
-          j++;
-        }
-        _fields[iFunction].insert(atoi(id.c_str()));
-      }
-      i += j + 1;
-    }
-    std::vector<std::string> expressions(1),
-      variables(3 + _fields[iFunction].size());
-    expressions[0] = f;
-    variables[0] = "x";
-    variables[1] = "y";
-    variables[2] = "z";
-    i = 3;
-    for(auto it = _fields[iFunction].begin(); it != _fields[iFunction].end();
-        it++) {
-      std::ostringstream sstream;
-      sstream << "F" << *it;
-      variables[i++] = sstream.str();
-    }
-    if(_f[iFunction]) delete _f[iFunction];
-    _f[iFunction] = new mathEvaluator(expressions, variables);
-    if(expressions.empty()) {
-      delete _f[iFunction];
-      _f[iFunction] = nullptr;
-      return false;
-    }
-    return true;
+    return _f[iFunction].set_function(f);
   }
   void evaluate(double x, double y, double z, SMetric3 &metr, GEntity *ge)
   {
     const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
-    for(int iFunction = 0; iFunction < 6; iFunction++) {
-      if(!_f[iFunction])
-        metr(index[iFunction][0], index[iFunction][1]) = MAX_LC;
-      else {
-        std::vector<double> values(3 + _fields[iFunction].size()), res(1);
-        values[0] = x;
-        values[1] = y;
-        values[2] = z;
-        int i = 3;
-        for(auto it = _fields[iFunction].begin();
-            it != _fields[iFunction].end(); it++) {
-          Field *field = GModel::current()->getFields()->get(*it);
-          if(field) {
-            values[i++] = (*field)(x, y, z, ge);
-          }
-          else {
-            Msg::Warning("Unknown Field %i", *it);
-            values[i++] = MAX_LC;
-          }
-        }
-        if(_f[iFunction]->eval(values, res))
-          metr(index[iFunction][0], index[iFunction][1]) = res[0];
-        else
-          metr(index[iFunction][0], index[iFunction][1]) = MAX_LC;
-      }
-    }
+    for(int iFunction = 0; iFunction < 6; iFunction++)
+      metr(index[iFunction][0], index[iFunction][1]) =
+        _f[iFunction].evaluate(x, y, z, ge);
   }
 };
 
@@ -1150,21 +1230,34 @@ public:
     options["F"] = new FieldOptionString(
       _f, "Mathematical function to evaluate.", &updateNeeded);
   }
+  void update()
+  {
+    if(updateNeeded) {
+      if(!_expr.set_function(_f))
+        Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
+                   _f.c_str());
+      updateNeeded = false;
+    }
+  }
   using Field::operator();
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
-    double ret = 0;
+    // the expression is normally compiled by FieldManager::initialize()
+    // before meshing; each thread then evaluates it without locking
+    if(updateNeeded) {
 #pragma omp critical
-    {
-      if(updateNeeded) {
-        if(!_expr.set_function(_f))
-          Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                     _f.c_str());
-        updateNeeded = false;
-      }
-      ret = _expr.evaluate(x, y, z, ge);
+      update();
     }
-    return ret;
+    return _expr.evaluate(x, y, z, ge);
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) {
+#pragma omp critical
+      update();
+    }
+    _expr.evaluate(n, x, y, z, val, ge);
   }
   const char *getName() { return "MathEval"; }
   std::string getDescription()
@@ -1218,37 +1311,30 @@ public:
     options["m23"] =
       new FieldOptionString(_f[5], "[Deprecated]", &updateNeeded, true);
   }
+  void update()
+  {
+    if(updateNeeded) {
+      for(int i = 0; i < 6; i++) {
+        if(!_expr.set_function(i, _f[i]))
+          Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
+                     _f[i].c_str());
+      }
+      updateNeeded = false;
+    }
+  }
   void operator()(double x, double y, double z, SMetric3 &metr,
                   GEntity *ge = nullptr)
   {
+    if(updateNeeded) {
 #pragma omp critical
-    {
-      if(updateNeeded) {
-        for(int i = 0; i < 6; i++) {
-          if(!_expr.set_function(i, _f[i]))
-            Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                       _f[i].c_str());
-        }
-        updateNeeded = false;
-      }
-      _expr.evaluate(x, y, z, metr, ge);
+      update();
     }
+    _expr.evaluate(x, y, z, metr, ge);
   }
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
     SMetric3 metr;
-#pragma omp critical
-    {
-      if(updateNeeded) {
-        for(int i = 0; i < 6; i++) {
-          if(!_expr.set_function(i, _f[i]))
-            Msg::Error("Field %i: invalid matheval expression \"%s\"", this->id,
-                       _f[i].c_str());
-        }
-        updateNeeded = false;
-      }
-      _expr.evaluate(x, y, z, metr, ge);
-    }
+    (*this)(x, y, z, metr, ge);
     return metr(0, 0);
   }
   const char *getName() { return "MathEvalAniso"; }
@@ -1527,8 +1613,7 @@ public:
            "See the MathEval Field help to get a description of valid FX, FY "
            "and FZ expressions.";
   }
-  using Field::operator();
-  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  void update()
   {
     if(updateNeeded) {
       for(int i = 0; i < 3; i++) {
@@ -1538,6 +1623,14 @@ public:
       }
       updateNeeded = false;
     }
+  }
+  using Field::operator();
+  double operator()(double x, double y, double z, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) {
+#pragma omp critical
+      update();
+    }
     if(_inField == id) return MAX_LC;
     Field *field = GModel::current()->getFields()->get(_inField);
     if(!field) {
@@ -1549,6 +1642,26 @@ public:
                     _expr[2].evaluate(x, y, z, ge),
                     ge);
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) {
+#pragma omp critical
+      update();
+    }
+    Field *field =
+      (_inField == id) ? nullptr : GModel::current()->getFields()->get(_inField);
+    if(!field || !n) {
+      if(_inField != id && !field) Msg::Warning("Unknown Field %i", _inField);
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    std::vector<double> u(n), v(n), w(n);
+    _expr[0].evaluate(n, x, y, z, &u[0], ge);
+    _expr[1].evaluate(n, x, y, z, &v[0], ge);
+    _expr[2].evaluate(n, x, y, z, &w[0], ge);
+    field->evaluate(n, &u[0], &v[0], &w[0], val, ge);
+  }
   const char *getName() { return "Param"; }
 };
 
@@ -1856,38 +1969,72 @@ public:
   {
     return "Take the minimum value of a list of fields.";
   }
+  void update()
+  {
+    if(updateNeeded) {
+      _fields.clear();
+      for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
+        Field *f = (GModel::current()->getFields()->get(*it));
+        if(!f) Msg::Warning("Unknown Field %i", *it);
+        if(f && *it != id) _fields.push_back(f);
+      }
+      updateNeeded = false;
+    }
+  }
   using Field::operator();
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
+    // the list of fields is normally updated by FieldManager::initialize()
+    // before meshing, so that no lock is taken here
+    if(updateNeeded) {
 #pragma omp critical
-    {
-      if(updateNeeded) {
-        _fields.clear();
-        for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
-          Field *f = (GModel::current()->getFields()->get(*it));
-          if(!f) Msg::Warning("Unknown Field %i", *it);
-          if(f && *it != id) _fields.push_back(f);
-        }
-        updateNeeded = false;
-      }
+      update();
     }
 
     double v = MAX_LC;
     for(auto f : _fields) {
       if(f->isotropic())
         v = std::min(v, (*f)(x, y, z, ge));
+      else
+        v = std::min(v, _anisoSize(f, x, y, z, ge));
+    }
+    return v;
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) {
+#pragma omp critical
+      update();
+    }
+
+    std::fill(val, val + n, MAX_LC);
+    if(!n) return;
+    std::vector<double> tmp(n);
+    for(auto f : _fields) {
+      if(f->isotropic()) {
+        f->evaluate(n, x, y, z, &tmp[0], ge);
+        for(std::size_t i = 0; i < n; i++) val[i] = std::min(val[i], tmp[i]);
+      }
       else {
-        SMetric3 ff;
-        (*f)(x, y, z, ff, ge);
-        fullMatrix<double> V(3, 3);
-        fullVector<double> S(3);
-        ff.eig(V, S, 1);
-        v = std::min(v, sqrt(1. / S(2))); // S(2) is largest eigenvalue
+        for(std::size_t i = 0; i < n; i++)
+          val[i] = std::min(val[i], _anisoSize(f, x[i], y[i], z[i], ge));
       }
     }
-    return v;
   }
   const char *getName() { return "Min"; }
+
+private:
+  static double _anisoSize(Field *f, double x, double y, double z,
+                           GEntity *ge)
+  {
+    SMetric3 ff;
+    (*f)(x, y, z, ff, ge);
+    fullMatrix<double> V(3, 3);
+    fullVector<double> S(3);
+    ff.eig(V, S, 1);
+    return sqrt(1. / S(2)); // S(2) is largest eigenvalue
+  }
 };
 
 class MaxField : public Field {
@@ -1905,38 +2052,72 @@ public:
   {
     return "Take the maximum value of a list of fields.";
   }
+  void update()
+  {
+    if(updateNeeded) {
+      _fields.clear();
+      for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
+        Field *f = (GModel::current()->getFields()->get(*it));
+        if(!f) Msg::Warning("Unknown Field %i", *it);
+        if(f && *it != id) _fields.push_back(f);
+      }
+      updateNeeded = false;
+    }
+  }
   using Field::operator();
   double operator()(double x, double y, double z, GEntity *ge = nullptr)
   {
+    // the list of fields is normally updated by FieldManager::initialize()
+    // before meshing, so that no lock is taken here
+    if(updateNeeded) {
 #pragma omp critical
-    {
-      if(updateNeeded) {
-        _fields.clear();
-        for(auto it = _fieldIds.begin(); it != _fieldIds.end(); it++) {
-          Field *f = (GModel::current()->getFields()->get(*it));
-          if(!f) Msg::Warning("Unknown Field %i", *it);
-          if(f && *it != id) _fields.push_back(f);
-        }
-        updateNeeded = false;
-      }
+      update();
     }
 
     double v = -MAX_LC;
     for(auto f : _fields) {
       if(f->isotropic())
         v = std::max(v, (*f)(x, y, z, ge));
+      else
+        v = std::max(v, _anisoSize(f, x, y, z, ge));
+    }
+    return v;
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(updateNeeded) {
+#pragma omp critical
+      update();
+    }
+
+    std::fill(val, val + n, -MAX_LC);
+    if(!n) return;
+    std::vector<double> tmp(n);
+    for(auto f : _fields) {
+      if(f->isotropic()) {
+        f->evaluate(n, x, y, z, &tmp[0], ge);
+        for(std::size_t i = 0; i < n; i++) val[i] = std::max(val[i], tmp[i]);
+      }
       else {
-        SMetric3 ff;
-        (*f)(x, y, z, ff, ge);
-        fullMatrix<double> V(3, 3);
-        fullVector<double> S(3);
-        ff.eig(V, S, 1);
-        v = std::max(v, sqrt(1. / S(0))); // S(0) is smallest eigenvalue
+        for(std::size_t i = 0; i < n; i++)
+          val[i] = std::max(val[i], _anisoSize(f, x[i], y[i], z[i], ge));
       }
     }
-    return v;
   }
   const char *getName() { return "Max"; }
+
+private:
+  static double _anisoSize(Field *f, double x, double y, double z,
+                           GEntity *ge)
+  {
+    SMetric3 ff;
+    (*f)(x, y, z, ff, ge);
+    fullMatrix<double> V(3, 3);
+    fullVector<double> S(3);
+    ff.eig(V, S, 1);
+    return sqrt(1. / S(0)); // S(0) is smallest eigenvalue
+  }
 };
 
 class RestrictField : public Field {
@@ -2088,6 +2269,12 @@ public:
     }
     return _vOut;
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    // the value only depends on the entity
+    if(n) std::fill(val, val + n, (*this)(x[0], y[0], z[0], ge));
+  }
   const char *getName() { return "Constant"; }
 };
 
@@ -2261,160 +2448,281 @@ public:
 
 class OctreeField : public Field {
 private:
-  // octree field
-  class Cell {
-  private:
-    void *_data;
-    bool _isleaf;
-
-  public:
-    double evaluate(double x, double y, double z) const
-    {
-      if(_isleaf) return *(double *)_data;
-      Cell *sub = (Cell *)_data;
-      int i = x > 0.5 ? 1 : 0;
-      int j = y > 0.5 ? 1 : 0;
-      int k = z > 0.5 ? 1 : 0;
-      return sub[i * 4 + j * 2 + k].evaluate(2 * x - i, 2 * y - j, 2 * z - k);
-    }
-    Cell(){};
-    void init(double x0, double y0, double z0, double l, Field &field,
-              int level)
-    {
-#if 0
-      double v[8] =
-        {field(x0, y0, z0), field(x0, y0, z0 + l), field(x0, y0 + l, z0),
-         field(x0, y0 + l, z0 + l), field(x0 + l, y0, z0), field(x0 + l, y0, z0 + l),
-         field(x0 + l, y0 + l, z0), field(x0 + l, y0 + l, z0 + l)};
-      double dmax = 0;
-      double vmin = v[0];
-      double vc = field(x0+l/2,y0+l/2,z0+l/2);
-      for (int i = 0; i < 8; ++i){
-        dmax = std::max(dmax, std::abs(vc-v[i]));
-        vmin = std::min(vmin, v[i]);
+  // the field is cached on a linear octree: the leaves are stored in arrays,
+  // sorted by the Morton code of their lower corner (in units of the finest
+  // level), together with their level and the values of the field at their 8
+  // corners, which are interpolated trilinearly
+  std::vector<uint64_t> _keys;
+  std::vector<unsigned char> _levels;
+  std::vector<double> _values;
+  int _inFieldId, _minLevel, _maxLevel, _depth;
+  double _tolerance;
+  double _min[3], _l0;
+  static uint64_t _spread(uint64_t x)
+  {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffULL;
+    x = (x | x << 16) & 0x1f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+  }
+  static uint64_t _compact(uint64_t x)
+  {
+    x &= 0x1249249249249249ULL;
+    x = (x | x >> 2) & 0x10c30c30c30c30c3ULL;
+    x = (x | x >> 4) & 0x100f00f00f00f00fULL;
+    x = (x | x >> 8) & 0x1f0000ff0000ffULL;
+    x = (x | x >> 16) & 0x1f00000000ffffULL;
+    x = (x | x >> 32) & 0x1fffff;
+    return x;
+  }
+  static uint64_t _key(uint64_t i, uint64_t j, uint64_t k)
+  {
+    return (_spread(i) << 2) | (_spread(j) << 1) | _spread(k);
+  }
+  static double _trilinear(const double *v, double u, double s, double t)
+  {
+    return (1 - u) * ((1 - s) * ((1 - t) * v[0] + t * v[1]) +
+                      s * ((1 - t) * v[2] + t * v[3])) +
+           u * ((1 - s) * ((1 - t) * v[4] + t * v[5]) +
+                s * ((1 - t) * v[6] + t * v[7]));
+  }
+  struct cell {
+    uint64_t i, j, k; // lower corner, in units of the finest level
+    int level;
+    double v[8]; // values at the corners
+  };
+  void _build(Field *field)
+  {
+    _keys.clear();
+    _levels.clear();
+    _values.clear();
+
+    SBoundingBox3d bb = GModel::current()->bounds();
+    if(bb.empty()) return;
+    SVector3 d = bb.max() - bb.min();
+    _l0 = std::max(std::max(d.x(), d.y()), d.z());
+    if(_l0 <= 0) _l0 = 1.;
+    // enlarge the cube slightly, so that points on the boundary of the model
+    // are strictly inside
+    _l0 *= 1.01;
+    for(int i = 0; i < 3; i++)
+      _min[i] = 0.5 * (bb.min()[i] + bb.max()[i]) - 0.5 * _l0;
+
+    const int maxLevel = std::max(0, std::min(_maxLevel, 20));
+    const int minLevel = std::max(0, std::min(_minLevel, maxLevel));
+    const double h0 = _l0 / (double)(1 << maxLevel);
+
+    // uniform grid of cells at the minimum level
+    std::vector<cell> cells;
+    const uint64_t n = (uint64_t)1 << minLevel;
+    const uint64_t s = (uint64_t)1 << (maxLevel - minLevel);
+    for(uint64_t i = 0; i < n; i++)
+      for(uint64_t j = 0; j < n; j++)
+        for(uint64_t k = 0; k < n; k++)
+          cells.push_back({i * s, j * s, k * s, minLevel, {0}});
+    std::vector<double> x, y, z, v;
+    x.resize(8 * cells.size());
+    y.resize(8 * cells.size());
+    z.resize(8 * cells.size());
+    v.resize(8 * cells.size());
+    for(std::size_t c = 0; c < cells.size(); c++) {
+      for(int l = 0; l < 8; l++) {
+        x[8 * c + l] = _min[0] + (cells[c].i + ((l >> 2) & 1) * s) * h0;
+        y[8 * c + l] = _min[1] + (cells[c].j + ((l >> 1) & 1) * s) * h0;
+        z[8 * c + l] = _min[2] + (cells[c].k + (l & 1) * s) * h0;
       }
-#else
-      double dmax = 0;
-      double vc = field(x0 + l / 2, y0 + l / 2, z0 + l / 2);
-      double vmin = vc;
-      bool split = level > 0;
-      if(level > -4) {
-#define NSAMPLE 2
-        double dl = l / NSAMPLE;
-        for(int i = 0; i <= NSAMPLE; ++i) {
-          for(int j = 0; j <= NSAMPLE; ++j) {
-            for(int k = 0; k <= NSAMPLE; ++k) {
-              double w = field(x0 + i * dl, y0 + j * dl, z0 + k * dl);
-              dmax = std::max(dmax, std::abs(vc - w));
-              vmin = std::min(vmin, w);
-              split |= (dmax / vmin > 0.2 && vmin < l);
-              if(split) break;
+    }
+
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t c = 0; c < cells.size(); c++)
+      field->evaluate(8, &x[8 * c], &y[8 * c], &z[8 * c], &v[8 * c]);
+    for(std::size_t c = 0; c < cells.size(); c++)
+      for(int l = 0; l < 8; l++) cells[c].v[l] = v[8 * c + l];
+
+    // refine the cells level by level: the field is evaluated on the 3x3x3
+    // grid of each cell, and the cell is split if the trilinear interpolation
+    // of the corner values does not match the field within the tolerance
+    std::vector<cell> leaves;
+    std::vector<double> grid;
+    std::vector<char> split;
+    while(cells.size()) {
+      grid.resize(27 * cells.size());
+      split.assign(cells.size(), 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(std::size_t c = 0; c < cells.size(); c++) {
+        const cell &cc = cells[c];
+        double *g = &grid[27 * c];
+        double h = 0.5 * h0 * (double)((uint64_t)1 << (maxLevel - cc.level));
+        double px[19], py[19], pz[19], pv[19];
+        int m = 0;
+        for(int i = 0; i < 3; i++) {
+          for(int j = 0; j < 3; j++) {
+            for(int k = 0; k < 3; k++) {
+              if(i != 1 && j != 1 && k != 1) {
+                g[9 * i + 3 * j + k] = cc.v[(i / 2) * 4 + (j / 2) * 2 + k / 2];
+                continue;
+              }
+              px[m] = _min[0] + cc.i * h0 + i * h;
+              py[m] = _min[1] + cc.j * h0 + j * h;
+              pz[m] = _min[2] + cc.k * h0 + k * h;
+              m++;
+            }
+          }
+        }
+        if(cc.level >= maxLevel) continue;
+        field->evaluate(19, px, py, pz, pv);
+        m = 0;
+        for(int i = 0; i < 3; i++) {
+          for(int j = 0; j < 3; j++) {
+            for(int k = 0; k < 3; k++) {
+              if(i != 1 && j != 1 && k != 1) continue;
+              double f = pv[m++];
+              g[9 * i + 3 * j + k] = f;
+              double err =
+                std::abs(f - _trilinear(cc.v, 0.5 * i, 0.5 * j, 0.5 * k));
+              if(err > _tolerance * std::abs(f)) split[c] = 1;
             }
           }
         }
-#endif
-      }
-      if(split) {
-        _isleaf = false;
-        Cell *sub = new Cell[8];
-        double l2 = l / 2;
-        sub[0].init(x0, y0, z0, l2, field, level - 1);
-        sub[1].init(x0, y0, z0 + l2, l2, field, level - 1);
-        sub[2].init(x0, y0 + l2, z0, l2, field, level - 1);
-        sub[3].init(x0, y0 + l2, z0 + l2, l2, field, level - 1);
-        sub[4].init(x0 + l2, y0, z0, l2, field, level - 1);
-        sub[5].init(x0 + l2, y0, z0 + l2, l2, field, level - 1);
-        sub[6].init(x0 + l2, y0 + l2, z0, l2, field, level - 1);
-        sub[7].init(x0 + l2, y0 + l2, z0 + l2, l2, field, level - 1);
-        _data = (void *)sub;
-      }
-      else {
-        _isleaf = true;
-        _data = (void *)new double;
-        *(double *)_data = vc;
       }
-    }
-    ~Cell()
-    {
-      if(_isleaf) { delete(double *)_data; }
-      else {
-        Cell *sub = (Cell *)_data;
-        delete[] sub;
+      std::vector<cell> next;
+      for(std::size_t c = 0; c < cells.size(); c++) {
+        const cell &cc = cells[c];
+        if(!split[c]) {
+          leaves.push_back(cc);
+          continue;
+        }
+        const double *g = &grid[27 * c];
+        uint64_t hs = (uint64_t)1 << (maxLevel - cc.level - 1);
+        for(int ci = 0; ci < 2; ci++) {
+          for(int cj = 0; cj < 2; cj++) {
+            for(int ck = 0; ck < 2; ck++) {
+              cell sub = {cc.i + ci * hs, cc.j + cj * hs, cc.k + ck * hs,
+                          cc.level + 1, {0}};
+              for(int l = 0; l < 8; l++)
+                sub.v[l] = g[9 * (ci + ((l >> 2) & 1)) +
+                             3 * (cj + ((l >> 1) & 1)) + ck + (l & 1)];
+              next.push_back(sub);
+            }
+          }
+        }
       }
+      cells.swap(next);
     }
-    void print(double x0, double y0, double z0, double l, FILE *f)
-    {
-      if(_isleaf) {
-        fprintf(f, "SP(%g, %g, %g) {%g};\n", x0 + l / 2, y0 + l / 2, z0 + l / 2,
-                *(double *)_data);
-      }
-      else {
-        Cell *sub = (Cell *)_data;
-        double l2 = l / 2;
-        sub[0].print(x0, y0, z0, l2, f);
-        sub[1].print(x0, y0, z0 + l2, l2, f);
-        sub[2].print(x0, y0 + l2, z0, l2, f);
-        sub[3].print(x0, y0 + l2, z0 + l2, l2, f);
-        sub[4].print(x0 + l2, y0, z0, l2, f);
-        sub[5].print(x0 + l2, y0, z0 + l2, l2, f);
-        sub[6].print(x0 + l2, y0 + l2, z0, l2, f);
-        sub[7].print(x0 + l2, y0 + l2, z0 + l2, l2, f);
-      }
+
+    std::sort(leaves.begin(), leaves.end(), [](const cell &a, const cell &b) {
+      return _key(a.i, a.j, a.k) < _key(b.i, b.j, b.k);
+    });
+    _keys.resize(leaves.size());
+    _levels.resize(leaves.size());
+    _values.resize(8 * leaves.size());
+    for(std::size_t c = 0; c < leaves.size(); c++) {
+      _keys[c] = _key(leaves[c].i, leaves[c].j, leaves[c].k);
+      _levels[c] = (unsigned char)leaves[c].level;
+      for(int l = 0; l < 8; l++) _values[8 * c + l] = leaves[c].v[l];
     }
-  };
-  Cell *_root;
-  int _inFieldId;
-  Field *_inField;
-  SBoundingBox3d bounds;
-  double _l0;
+    _depth = maxLevel;
+  }
+  double _interpolate(double x, double y, double z) const
+  {
+    const uint64_t n = (uint64_t)1 << _depth;
+    double u[3] = {(x - _min[0]) / _l0, (y - _min[1]) / _l0,
+                   (z - _min[2]) / _l0};
+    uint64_t c[3];
+    for(int i = 0; i < 3; i++) {
+      u[i] = std::max(0., std::min(1., u[i]));
+      c[i] = std::min((uint64_t)(u[i] * n), n - 1);
+    }
+    // the leaf containing the point is the last one starting before it
+    std::size_t l =
+      std::upper_bound(_keys.begin(), _keys.end(), _key(c[0], c[1], c[2])) -
+      _keys.begin() - 1;
+    double h = (double)((uint64_t)1 << (_depth - _levels[l])) / n;
+    double o[3] = {(double)_compact(_keys[l] >> 2) / n,
+                   (double)_compact(_keys[l] >> 1) / n,
+                   (double)_compact(_keys[l]) / n};
+    double t[3];
+    for(int i = 0; i < 3; i++)
+      t[i] = std::max(0., std::min(1., (u[i] - o[i]) / h));
+    return _trilinear(&_values[8 * l], t[0], t[1], t[2]);
+  }
 
- public:
+public:
   OctreeField()
   {
-    _root = nullptr;
     _inFieldId = 1;
-
-    options["InField"] = new FieldOptionInt
-      (_inFieldId, "Id of the field to represent on the octree", &updateNeeded);
+    _tolerance = 0.05;
+    _minLevel = 3;
+    _maxLevel = 10;
+    _depth = 0;
+    _l0 = 1.;
+    _min[0] = _min[1] = _min[2] = 0.;
+
+    options["InField"] = new FieldOptionInt(
+      _inFieldId, "Id of the field to represent on the octree", &updateNeeded);
+    options["Tolerance"] = new FieldOptionDouble(
+      _tolerance, "Relative tolerance on the interpolated field values",
+      &updateNeeded);
+    options["MinLevel"] = new FieldOptionInt(
+      _minLevel, "Minimum level of refinement of the octree", &updateNeeded);
+    options["MaxLevel"] = new FieldOptionInt(
+      _maxLevel, "Maximum level of refinement of the octree (at most 20)",
+      &updateNeeded);
   }
-  ~OctreeField()
+  OctreeField(int inFieldId, double tolerance) : OctreeField()
   {
-    if(_root) delete _root;
+    _inFieldId = inFieldId;
+    _tolerance = tolerance;
+    updateNeeded = true;
   }
   const char *getName() { return "Octree"; }
   std::string getDescription()
   {
-    return "Pre compute another field on an octree to speed-up evalution.";
+    return "Precompute another field on an adaptive octree to speed-up "
+           "evaluation. The octree is refined until the trilinear "
+           "interpolation of the field in each cell matches the field, "
+           "sampled at the center of the cell and of its faces and edges, "
+           "within the relative Tolerance. The field should not depend on "
+           "the entity being meshed.";
   }
+  std::size_t getNumCells() const { return _keys.size(); }
   void update()
   {
-    if(updateNeeded) {
-      updateNeeded = false;
-      if(_root) {
-        delete _root;
-        _root = nullptr;
-      }
-    }
-    if(!_root) {
-      _inField = _inFieldId >= 0 ?
-        (GModel::current()->getFields()->get(_inFieldId)) :
-        nullptr;
-      if(!_inField) return;
-      GModel::current()->getFields()->get(_inFieldId)->update();
-      bounds = GModel::current()->bounds();
-      _root = new Cell;
-      SVector3 d = bounds.max() - bounds.min();
-      _l0 = std::max(std::max(d.x(), d.y()), d.z());
-      _root->init(bounds.min().x(), bounds.min().y(), bounds.min().z(), _l0,
-                  *_inField, 4);
+    if(!updateNeeded && _keys.size()) return;
+    updateNeeded = false;
+    Field *field = (_inFieldId >= 0 && _inFieldId != id) ?
+                     GModel::current()->getFields()->get(_inFieldId) :
+                     nullptr;
+    if(!field) {
+      Msg::Warning("Unknown Field %i", _inFieldId);
+      return;
     }
+    field->update();
+    double t1 = Cpu(), w1 = TimeOfDay();
+    _build(field);
+    Msg::Info("Octree of field %i: %lu cells (Wall %gs, CPU %gs)", _inFieldId,
+              _keys.size(), TimeOfDay() - w1, Cpu() - t1);
   }
+  using Field::operator();
   virtual double operator()(double X, double Y, double Z, GEntity *ge = nullptr)
   {
-    SPoint3 xmin = bounds.min();
-    SVector3 d = bounds.max() - xmin;
-    return _root->evaluate((X - xmin.x()) / _l0, (Y - xmin.y()) / _l0,
-                           (Z - xmin.z()) / _l0);
+    if(_keys.empty()) return MAX_LC;
+    return _interpolate(X, Y, Z);
+  }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(_keys.empty()) {
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    for(std::size_t i = 0; i < n; i++) val[i] = _interpolate(x[i], y[i], z[i]);
   }
 };
 
@@ -2604,6 +2912,24 @@ public:
     _kdtree->findNeighbors(res, &pt[0], nanoflann::SearchParams(10));
     return sqrt(outDistSqr);
   }
+  void evaluate(std::size_t n, const double *x, const double *y,
+                const double *z, double *val, GEntity *ge = nullptr)
+  {
+    if(!_kdtree) {
+      std::fill(val, val + n, MAX_LC);
+      return;
+    }
+    std::size_t index = 0;
+    for(std::size_t i = 0; i < n; i++) {
+      double pt[3] = {x[i], y[i], z[i]};
+      nanoflann::KNNResultSet<double> res(1);
+      double outDistSqr;
+      res.init(&index, &outDistSqr);
+      _kdtree->findNeighbors(res, &pt[0], nanoflann::SearchParams(10));
+      val[i] = sqrt(outDistSqr);
+    }
+    if(n) _outIndex = index;
+  }
 };
 
 class ExtendField : public Field {
@@ -3211,16 +3537,75 @@ FieldManager::FieldManager()
   mapTypeName["AutomaticMeshSizeField"] =
     new FieldFactoryT<automaticMeshSizeField>();
   _backgroundField = -1;
+  _backgroundFieldCache = nullptr;
+  _backgroundFieldCacheId = -1;
+  _backgroundFieldCacheTolerance = 0.;
+  _backgroundFieldCacheModifications = 0;
+  _backgroundFieldCacheBuilt = false;
 }
 
 void FieldManager::initialize()
 {
-  auto it = begin();
-  for(; it != end(); ++it) it->second->update();
+  bool updated = false;
+  for(auto it = begin(); it != end(); ++it) {
+    if(it->second->updateNeeded) updated = true;
+    it->second->update();
+  }
+
+  // (re)build the octree cache of the background field, if anything it can
+  // depend on has changed since it was built
+  double tol = CTX::instance()->mesh.lcFieldCache;
+  std::size_t modifications = FieldOption::getNumModifications();
+  if(!updated && _backgroundFieldCacheBuilt &&
+     _backgroundFieldCacheId == _backgroundField &&
+     _backgroundFieldCacheTolerance == tol &&
+     _backgroundFieldCacheModifications == modifications)
+    return;
+  _deleteBackgroundFieldCache();
+  _backgroundFieldCacheBuilt = true;
+  _backgroundFieldCacheId = _backgroundField;
+  _backgroundFieldCacheTolerance = tol;
+  _backgroundFieldCacheModifications = modifications;
+  Field *f = (_backgroundField > 0) ? get(_backgroundField) : nullptr;
+  if(tol > 0 && f) {
+    if(!f->isotropic()) {
+      Msg::Warning("Cannot cache anisotropic background field %d", f->id);
+      return;
+    }
+    OctreeField *cache = new OctreeField(_backgroundField, tol);
+    cache->id = -1;
+    cache->update();
+    if(cache->getNumCells())
+      _backgroundFieldCache = cache;
+    else
+      delete cache;
+  }
+}
+
+void FieldManager::_deleteBackgroundFieldCache()
+{
+  if(_backgroundFieldCache) delete _backgroundFieldCache;
+  _backgroundFieldCache = nullptr;
+  _backgroundFieldCacheId = -1;
+  _backgroundFieldCacheBuilt = false;
+}
+
+Field *FieldManager::getBackgroundMeshSizeField()
+{
+  if(_backgroundField <= 0) return nullptr;
+  Field *f = get(_backgroundField);
+  // only use the cache if the background field has not been changed since
+  // the cache was built
+  if(f && _backgroundFieldCache && _backgroundFieldCacheId == _backgroundField &&
+     !f->updateNeeded &&
+     _backgroundFieldCacheModifications == FieldOption::getNumModifications())
+    return _backgroundFieldCache;
+  return f;
 }
 
 FieldManager::~FieldManager()
 {
+  _deleteBackgroundFieldCache();
   for(auto it = mapTypeName.begin(); it != mapTypeName.end(); it++)
     delete it->second;
   for(auto it = begin(); it != end(); it++) delete it->second;
@@ -3229,6 +3614,7 @@ FieldManager::~FieldManager()
 void FieldManager::setBackgroundField(Field *BGF)
 {
   int id = newId();
+  _deleteBackgroundFieldCache();
   (*this)[id] = BGF;
   _backgroundField = id;
 }
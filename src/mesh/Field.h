@@ -51,12 +51,14 @@ class FieldOption {
 private:
   std::string _help;
   bool _deprecated;
+  static std::size_t _numModifications;
 
 protected:
   bool *status;
   inline void modified()
   {
     if(status) *status = true;
+    _numModifications++;
   }
 
 public:
@@ -98,6 +100,8 @@ public:
   virtual std::string string() const { return ""; }
   virtual void string(const std::string value) {}
   bool isDeprecated() { return _deprecated; }
+  // number of modifications of the options of all the fields so far
+  static std::size_t getNumModifications() { return _numModifications; }
 };
 
 class Field {
@@ -126,6 +130,11 @@ public:
                           GEntity *ge = nullptr)
   {
   }
+  // isotropic, for a batch of n points: val[i] is the value at (x[i], y[i],
+  // z[i]). The default implementation calls operator() for each point; fields
+  // override it with kernels that process the whole batch at once
+  virtual void evaluate(std::size_t n, const double *x, const double *y,
+                        const double *z, double *val, GEntity *ge = nullptr);
   bool updateNeeded;
   virtual const char *getName() = 0;
 #if defined(HAVE_POST)
@@ -146,6 +155,16 @@ class FieldManager : public std::map<int, Field *> {
 private:
   int _backgroundField;
   std::vector<int> _boundaryLayerFields;
+  // octree cache of the background field (see Mesh.MeshSizeFieldCache), with
+  // the background field, the tolerance and the number of modifications of the
+  // field options for which it was built: it is only rebuilt when one of them
+  // changes, or when fields are added or deleted
+  Field *_backgroundFieldCache;
+  int _backgroundFieldCacheId;
+  double _backgroundFieldCacheTolerance;
+  std::size_t _backgroundFieldCacheModifications;
+  bool _backgroundFieldCacheBuilt;
+  void _deleteBackgroundFieldCache();
 
 public:
   std::map<std::string, FieldFactory *> mapTypeName;
@@ -176,6 +195,9 @@ public:
       addBoundaryLayerFieldId(tags[i]);
   }
   inline int getBackgroundField() { return _backgroundField; }
+  // get the field used to compute mesh sizes, i.e. the background field or its
+  // octree cache if Mesh.MeshSizeFieldCache is set
+  Field *getBackgroundMeshSizeField();
   inline int getNumBoundaryLayerFields()
   {
     return (int)_boundaryLayerFields.size();
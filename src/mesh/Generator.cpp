@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 #include <stack>
+#include <set>
 #include <stdexcept>
 
 #include "GmshConfig.h"
@@ -25,6 +26,7 @@
 #include "meshGFace.h"
 #include "meshGFaceOptimize.h"
 #include "meshGFaceBDS.h"
+#include "meshGFaceDelaunayInsertion.h"
 #include "meshGRegion.h"
 #include "meshGRegionLocalMeshMod.h"
 #include "meshRelocateVertex.h"
@@ -535,8 +537,15 @@ static void Mesh2D(GModel *m)
 
       int nPending = 0;
       bool exceptions = false;
-      std::vector<GFace *> temp;
-      temp.insert(temp.begin(), f.begin(), f.end());
+      // large surfaces meshed with the parallel Frontal-Delaunay algorithm are
+      // meshed afterwards, one at a time, with all the threads
+      std::vector<GFace *> temp, large;
+      for(auto gf : f) {
+        if(nthreads > 1 && useParallelFrontal(gf))
+          large.push_back(gf);
+        else
+          temp.push_back(gf);
+      }
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
       for(size_t K = 0; K < temp.size(); K++) {
         if(exceptions) continue;
@@ -558,6 +567,14 @@ static void Mesh2D(GModel *m)
         if(!nIter) Msg::ProgressMeter(localPending, false, "Meshing 2D...");
       }
       if(exceptions) throw std::runtime_error(Msg::GetLastError());
+      for(auto gf : large) {
+        if(gf->meshStatistics.status == GFace::PENDING) {
+          backgroundMesh::current()->unset();
+          gf->mesh(true);
+          ++nPending;
+          if(!nIter) Msg::ProgressMeter(nPending, false, "Meshing 2D...");
+        }
+      }
       if(!nPending) break;
       // iter == 2 is for meshing re-parametrized surfaces; after that, we
       // serialize (self-intersections of 1D meshes are not thread safe)!
@@ -828,6 +845,34 @@ static void TestConformity(GModel *gm)
 }
 #endif
 
+// When the mesh is streamed to a file, the mesh of each volume is optimized
+// and written as soon as it is generated, then deleted
+static void StreamMeshGRegion(GModel *m, GRegion *gr,
+                              std::set<GRegion *> &streamed)
+{
+  if(CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
+     CTX::instance()->mesh.algo3d != ALGO_3D_HXT) {
+    for(int i = 0; i < std::max(CTX::instance()->mesh.optimize,
+                                CTX::instance()->mesh.optimizeNetgen);
+        i++) {
+      if(CTX::instance()->mesh.optimize > i) {
+        optimizeMeshGRegion opt;
+        opt(gr);
+      }
+      if(CTX::instance()->mesh.optimizeNetgen > i) {
+        optimizeMeshGRegionNetgen opt;
+        opt(gr);
+      }
+    }
+  }
+  for(std::size_t i = 0; i < gr->getNumMeshElements(); i++)
+    gr->getMeshElement(i)->setVolumePositive();
+  if(m->streamMSH4(gr)) {
+    gr->deleteMesh();
+    streamed.insert(gr);
+  }
+}
+
 static void Mesh3D(GModel *m)
 {
   if(CTX::instance()->abortOnError && Msg::GetErrorCount()) return;
@@ -854,6 +899,18 @@ static void Mesh3D(GModel *m)
   std::vector<GRegion *> delaunay;
   std::for_each(m->firstRegion(), m->lastRegion(), meshGRegion(delaunay));
 
+  // when streaming, all the regions that are now meshed can be written out
+  // (the subdivision of extruded meshes is done)
+  bool stream = m->isStreamingMSH4();
+  std::set<GRegion *> streamed;
+  if(stream) {
+    std::set<GRegion *> pending(delaunay.begin(), delaunay.end());
+    for(auto it = m->firstRegion(); it != m->lastRegion(); ++it) {
+      if(!pending.count(*it) && (*it)->getNumMeshElements())
+        StreamMeshGRegion(m, *it, streamed);
+    }
+  }
+
   // and finally mesh the delaunay regions (again, this is global; but
   // we mesh each connected part separately for performance and mesh
   // quality reasons)
@@ -879,15 +936,31 @@ static void Mesh3D(GModel *m)
   int nb_elements_recombination = 0, nb_hexa_recombination = 0;
 #endif
 
-  for(std::size_t i = 0; i < connected.size(); i++) {
+  if(stream) {
+    // mesh the connected parts one at a time, so that only one of them is in
+    // memory at any time; the volumes of a connected part cannot be meshed
+    // and written one by one, as the boundary recovery can modify the mesh of
+    // the surfaces they share (Steiner points), so a model made of a single
+    // connected part is entirely in memory before being written
+    for(std::size_t i = 0; i < connected.size(); i++) {
+      if(CTX::instance()->abortOnError && Msg::GetErrorCount()) break;
+      std::vector<std::vector<GRegion *> > part(1, connected[i]);
+      MeshDelaunayVolume(part);
+      for(std::size_t j = 0; j < connected[i].size(); j++)
+        StreamMeshGRegion(m, connected[i][j], streamed);
+    }
+  }
+  else {
+    MeshDelaunayVolume(connected);
+  }
+
+#if defined(HAVE_DOMHEX)
+  for(std::size_t i = 0; i < connected.size() && !stream; i++) {
     if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
       Msg::Warning("Aborted 3D meshing");
       break;
     }
 
-    MeshDelaunayVolume(connected[i]);
-
-#if defined(HAVE_DOMHEX)
     // additional code for experimental hex mesh - will eventually be replaced
     // by new HXT-based code
     for(std::size_t j = 0; j < connected[i].size(); j++) {
@@ -936,8 +1009,8 @@ static void Mesh3D(GModel *m)
         time_recombination += (TimeOfDay() - a);
       }
     }
-#endif
   }
+#endif
 
 #if defined(HAVE_DOMHEX)
   if(CTX::instance()->mesh.recombine3DAll) {
@@ -968,7 +1041,7 @@ static void Mesh3D(GModel *m)
     if(CTX::instance()->mesh.meshOnlyVisible && !gr->getVisibility()) continue;
     if(CTX::instance()->mesh.meshOnlyEmpty && gr->getNumMeshElements())
       continue;
-    if(gr->getNumMeshElements() == 0) {
+    if(gr->getNumMeshElements() == 0 && !streamed.count(gr)) {
       debugInfo << gr->tag() << " ";
       emptyRegionFound = true;
     }
@@ -1568,7 +1641,18 @@ void GenerateMesh(GModel *m, int ask)
   }
 
   // 3D mesh
-  if(ask == 3) { Mesh3D(m); }
+  if(ask == 3) {
+    if(!CTX::instance()->mesh.streamFileName.empty()) {
+      if(CTX::instance()->mesh.order > 1 ||
+         CTX::instance()->mesh.algoSubdivide == 2)
+        Msg::Warning("High-order and subdivided volume meshes cannot be "
+                     "streamed: streaming first order volume meshes");
+      m->beginStreamMSH4(CTX::instance()->mesh.streamFileName,
+                         CTX::instance()->mesh.binary,
+                         CTX::instance()->mesh.scalingFactor);
+    }
+    Mesh3D(m);
+  }
 
   // Orient the line and surface meshes so that they match the orientation of
   // the geometrical entities and/or the user orientation constraints
@@ -1621,6 +1705,13 @@ void GenerateMesh(GModel *m, int ask)
   // correspondences
   FixPeriodicMesh(m);
 
+  // write the (in-memory) lower dimensional meshes and assemble the streamed
+  // file
+  if(m->isStreamingMSH4()) m->endStreamMSH4();
+
+  if(CTX::instance()->mesh.contiguousNodeStorage)
+    m->setContiguousMeshVertexStorage(true);
+
   Msg::Info("%d nodes %d elements", m->getNumMeshVertices(),
             m->getNumMeshElements());
 
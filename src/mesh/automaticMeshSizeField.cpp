@@ -154,7 +154,6 @@ static HXTStatus getAllEdgesOfAllFaces(std::vector<GFace *> &faces, HXTMesh *m,
 }
 
 HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
-                   std::map<MVertex *, uint32_t> &v2c,
                    std::vector<MVertex *> &c2v);
 
 HXTStatus Gmsh2Hxt(std::vector<GFace *> &faces, HXTMesh *m,
@@ -1809,6 +1809,10 @@ static bool meshGenerator(GFace *gf, int RECUR_ITER,
   if(CTX::instance()->mesh.algo2d != ALGO_2D_BAMG && !onlyInitialMesh) {
     Msg::Debug("Computing mesh size field at mesh nodes %d",
                edgesToRecover.size());
+    // group the nodes by entity, so that the size field is evaluated on
+    // batches of points
+    std::map<GEntity *, std::vector<std::pair<BDS_Point *, MVertex *> > >
+      nodes;
     auto it = m->points.begin();
     for(; it != m->points.end(); ++it) {
       BDS_Point *pp = *it;
@@ -1816,16 +1820,29 @@ static bool meshGenerator(GFace *gf, int RECUR_ITER,
       if(itv != recoverMap.end()) {
         MVertex *here = itv->second;
         GEntity *ge = here->onWhat();
-        if(ge->dim() == 0) {
-          pp->lcBGM() = BGM_MeshSize(ge, 0, 0, here->x(), here->y(), here->z());
-        }
-        else if(ge->dim() == 1) {
-          double u;
-          here->getParameter(0, u);
-          pp->lcBGM() = BGM_MeshSize(ge, u, 0, here->x(), here->y(), here->z());
-        }
-        else
+        if(ge->dim() <= 1)
+          nodes[ge].push_back(std::make_pair(pp, here));
+        else {
           pp->lcBGM() = MAX_LC;
+          pp->lc() = pp->lcBGM();
+        }
+      }
+    }
+    for(auto itn = nodes.begin(); itn != nodes.end(); ++itn) {
+      GEntity *ge = itn->first;
+      std::size_t n = itn->second.size();
+      std::vector<double> U(n, 0.), V(n, 0.), X(n), Y(n), Z(n), lc(n);
+      for(std::size_t i = 0; i < n; i++) {
+        MVertex *here = itn->second[i].second;
+        if(ge->dim() == 1) here->getParameter(0, U[i]);
+        X[i] = here->x();
+        Y[i] = here->y();
+        Z[i] = here->z();
+      }
+      BGM_MeshSize(ge, n, &U[0], &V[0], &X[0], &Y[0], &Z[0], &lc[0]);
+      for(std::size_t i = 0; i < n; i++) {
+        BDS_Point *pp = itn->second[i].first;
+        pp->lcBGM() = lc[i];
         pp->lc() = pp->lcBGM();
       }
     }
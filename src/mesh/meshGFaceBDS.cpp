@@ -478,12 +478,31 @@ static void splitEdgePass(GFace *gf, BDS_Mesh &m, double MAXE_, int &nb_split,
         mid->u = U;
         mid->v = V;
         mid->lc() = 0.5 * (e->p1->lc() + e->p2->lc());
-        mid->lcBGM() = BGM_MeshSize(gf, U, V, mid->X, mid->Y, mid->Z);
       }
     }
     mids[i] = mid;
   }
 
+  // evaluate the background mesh size at all the new points at once
+  {
+    std::vector<double> U, V, X, Y, Z;
+    for(std::size_t i = 0; i < mids.size(); ++i) {
+      if(!mids[i]) continue;
+      U.push_back(mids[i]->u);
+      V.push_back(mids[i]->v);
+      X.push_back(mids[i]->X);
+      Y.push_back(mids[i]->Y);
+      Z.push_back(mids[i]->Z);
+    }
+    if(U.size()) {
+      std::vector<double> lc(U.size());
+      BGM_MeshSize(gf, U.size(), &U[0], &V[0], &X[0], &Y[0], &Z[0], &lc[0]);
+      std::size_t k = 0;
+      for(std::size_t i = 0; i < mids.size(); ++i)
+        if(mids[i]) mids[i]->lcBGM() = lc[k++];
+    }
+  }
+
   for(std::size_t i = 0; i < edges.size(); ++i) {
     BDS_Edge *e = edges[i].second;
     if(!e->deleted) {
@@ -8,6 +8,7 @@
 #include <map>
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "OS.h"
@@ -410,9 +411,10 @@ static void fourthPoint(double *p1, double *p2, double *p3, double *p4)
 
 MTri3::MTri3(MTriangle *t, double lc, SMetric3 *metric, bidimMeshData *data,
              GFace *gf)
-  : deleted(false), base(t)
+  : deleted(false), lock(0), base(t)
 {
   neigh[0] = neigh[1] = neigh[2] = nullptr;
+  heap_index[0] = heap_index[1] = -1;
   double center[3];
   double pa[3] = {base->getVertex(0)->x(), base->getVertex(0)->y(),
                   base->getVertex(0)->z()};
@@ -552,12 +554,74 @@ void connectTriangles(std::vector<MTri3 *> &l)
   connectTris(l.begin(), l.end(), conn);
 }
 
-void connectTriangles(std::set<MTri3 *, compareTri3Ptr> &l)
+void connectTriangles(MTri3Heap &l)
 {
   std::vector<edgeXface> conn;
   connectTris(l.begin(), l.end(), conn);
 }
 
+void MTri3Heap::_up(std::size_t i)
+{
+  MTri3 *t = _heap[i];
+  while(i > 0) {
+    std::size_t parent = (i - 1) / 2;
+    if(!_before(t, _heap[parent])) break;
+    _set(i, _heap[parent]);
+    i = parent;
+  }
+  _set(i, t);
+}
+
+void MTri3Heap::_down(std::size_t i)
+{
+  MTri3 *t = _heap[i];
+  const std::size_t n = _heap.size();
+  while(1) {
+    std::size_t child = 2 * i + 1;
+    if(child >= n) break;
+    if(child + 1 < n && _before(_heap[child + 1], _heap[child])) child++;
+    if(!_before(_heap[child], t)) break;
+    _set(i, _heap[child]);
+    i = child;
+  }
+  _set(i, t);
+}
+
+void MTri3Heap::insert(MTri3 *t)
+{
+  if(contains(t)) return;
+  _heap.push_back(t);
+  _up(_heap.size() - 1);
+}
+
+void MTri3Heap::pop() { erase(_heap.front()); }
+
+void MTri3Heap::erase(MTri3 *t)
+{
+  if(!contains(t)) return;
+  std::size_t i = t->heap_index[_slot];
+  t->heap_index[_slot] = -1;
+  MTri3 *last = _heap.back();
+  _heap.pop_back();
+  if(last == t) return;
+  _set(i, last);
+  update(last);
+}
+
+void MTri3Heap::update(MTri3 *t)
+{
+  if(!contains(t)) return;
+  std::size_t i = t->heap_index[_slot];
+  _up(i);
+  _down(t->heap_index[_slot]);
+}
+
+void MTri3Heap::clear()
+{
+  for(auto t : _heap) t->heap_index[_slot] = -1;
+  _heap.clear();
+}
+
 static int inCircumCircleXY(MTriangle *t, MVertex *v)
 {
   MVertex *v1 = t->getVertex(0);
@@ -620,6 +684,33 @@ static void recurFindCavityAniso(GFace *gf, std::list<edgeXface> &shell,
   }
 }
 
+// same as recurFindCavityAniso, but without marking the triangles as deleted,
+// so that cavities can be computed concurrently
+static void recurFindCavityAnisoReadOnly(GFace *gf, std::list<edgeXface> &shell,
+                                         std::list<MTri3 *> &cavity,
+                                         double *metric, double *param,
+                                         MTri3 *t, bidimMeshData &data)
+{
+  cavity.push_back(t);
+
+  for(int i = 0; i < 3; i++) {
+    MTri3 *neigh = t->getNeigh(i);
+    edgeXface exf(t, i);
+    // take care of untouchable internal edges
+    auto it = data.internalEdges.find(MEdge(exf._v(0), exf._v(1)));
+    if(!neigh || it != data.internalEdges.end())
+      shell.push_back(exf);
+    else if(std::find(cavity.begin(), cavity.end(), neigh) == cavity.end()) {
+      int circ = inCircumCircleAniso(gf, neigh->tri(), param, metric, data);
+      if(circ)
+        recurFindCavityAnisoReadOnly(gf, shell, cavity, metric, param, neigh,
+                                     data);
+      else
+        shell.push_back(exf);
+    }
+  }
+}
+
 static bool circUV(MTriangle *t, bidimMeshData &data, double *res, GFace *gf)
 {
   int index0 = data.getIndex(t->getVertex(0));
@@ -684,11 +775,11 @@ inline double getSurfUV(MTriangle *t, bidimMeshData &data)
 static int insertVertexB(std::list<edgeXface> &shell,
                          std::list<MTri3 *> &cavity, bool force, GFace *gf,
                          MVertex *v, double *param, MTri3 *t,
-                         std::set<MTri3 *, compareTri3Ptr> &allTets,
-                         std::set<MTri3 *, compareTri3Ptr> *activeTets,
+                         MTri3Heap &allTets, MTri3Heap *activeTets,
                          bidimMeshData &data, double *metric,
                          MTri3 **oneNewTriangle,
-                         bool verifyStarShapeness = true)
+                         bool verifyStarShapeness = true,
+                         std::vector<MTri3 *> *newCavity = nullptr)
 {
   if(cavity.size() == 1) return -1;
 
@@ -787,15 +878,20 @@ static int insertVertexB(std::list<edgeXface> &shell,
   // of the point, and that the point is not too close to an edge
   if(std::abs(oldVolume - newVolume) < EPS * oldVolume && !onePointIsTooClose) {
     connectTris(new_cavity.begin(), new_cavity.end(), conn);
+    // when cavities are processed concurrently, the new triangles and their
+    // neighbors are added to the heaps afterwards by the caller
+    if(newCavity) {
+      newCavity->swap(new_cavity);
+      delete[] newTris;
+      return 1;
+    }
     // 30 % of the time is spent here!
-    allTets.insert(newTris, newTris + shell.size());
+    for(std::size_t i = 0; i < shell.size(); i++) allTets.insert(newTris[i]);
     if(activeTets) {
       for(auto i = new_cavity.begin(); i != new_cavity.end(); ++i) {
         int active_edge;
-        if(isActive(*i, LIMIT_, active_edge) && (*i)->getRadius() > LIMIT_) {
-          if((*activeTets).find(*i) == (*activeTets).end())
-            (*activeTets).insert(*i);
-        }
+        if(isActive(*i, LIMIT_, active_edge) && (*i)->getRadius() > LIMIT_)
+          activeTets->insert(*i);
       }
     }
     delete[] newTris;
@@ -872,7 +968,7 @@ static MTri3 *search4Triangle(MTri3 *t, MVertex *v, int maxx, int &ITER)
 }
 
 static MTri3 *search4Triangle(MTri3 *t, double pt[2], bidimMeshData &data,
-                              std::set<MTri3 *, compareTri3Ptr> &AllTris,
+                              MTri3Heap &AllTris,
                               double uv[2], bool force = false)
 {
   // bool inside = t->inCircumCircle(pt);
@@ -919,23 +1015,18 @@ static MTri3 *search4Triangle(MTri3 *t, double pt[2], bidimMeshData &data,
   return nullptr;
 }
 
-static bool
-insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
-             double center[2], double metric[3], bidimMeshData &data,
-             std::set<MTri3 *, compareTri3Ptr> &AllTris,
-             std::set<MTri3 *, compareTri3Ptr> *ActiveTris = nullptr,
-             MTri3 *worst = nullptr, MTri3 **oneNewTriangle = nullptr,
-             bool testStarShapeness = false)
+static bool insertAPoint(GFace *gf, MTri3 *worst, double center[2],
+                         double metric[3], bidimMeshData &data,
+                         MTri3Heap &AllTris, MTri3Heap *ActiveTris = nullptr,
+                         MTri3 **oneNewTriangle = nullptr,
+                         bool testStarShapeness = false,
+                         const GPoint *precomputedPoint = nullptr,
+                         double precomputedSize = -1.)
 {
-  if(worst) {
-    it = AllTris.find(worst);
-    if(worst != *it) {
-      Msg::Error("Could not insert point");
-      return false;
-    }
+  if(!AllTris.contains(worst)) {
+    Msg::Error("Could not insert point");
+    return false;
   }
-  else
-    worst = *it;
 
   MTri3 *ptin = nullptr;
   std::list<edgeXface> shell;
@@ -963,7 +1054,10 @@ insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
   if(ptin) {
     // we use here local coordinates as real coordinates x,y and z will be
     // computed hereafter
-    GPoint p = gf->point(center[0], center[1]);
+    // (they can also be provided by the caller, together with the background
+    // mesh size, if they were computed beforehand)
+    GPoint p = precomputedPoint ? *precomputedPoint :
+                                  gf->point(center[0], center[1]);
 
     MVertex *v = new MFaceVertex(p.x(), p.y(), p.z(), gf, center[0], center[1]);
 
@@ -973,7 +1067,9 @@ insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
     int index2 = data.getIndex(ptin->tri()->getVertex(2));
     lc1 = (1. - uv[0] - uv[1]) * data.vSizes[index0] +
           uv[0] * data.vSizes[index1] + uv[1] * data.vSizes[index2];
-    if(CTX::instance()->mesh.algo2d == ALGO_2D_BAMG)
+    if(precomputedSize > 0.)
+      lc = precomputedSize;
+    else if(CTX::instance()->mesh.algo2d == ALGO_2D_BAMG)
       lc = 1.;
     else
       lc = BGM_MeshSize(gf, center[0], center[1], p.x(), p.y(), p.z());
@@ -1007,9 +1103,9 @@ insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
                    "parametric domain)",
                    center[0], center[1]);
 
-      AllTris.erase(it);
       worst->forceRadius(-1);
-      AllTris.insert(worst);
+      AllTris.update(worst);
+      if(ActiveTris) ActiveTris->update(worst);
       delete v;
       for(auto itc = cavity.begin(); itc != cavity.end(); ++itc)
         (*itc)->setDeleted(false);
@@ -1023,9 +1119,9 @@ insertAPoint(GFace *gf, std::set<MTri3 *, compareTri3Ptr>::iterator it,
   else {
     for(auto itc = cavity.begin(); itc != cavity.end(); ++itc)
       (*itc)->setDeleted(false);
-    AllTris.erase(it);
     worst->forceRadius(0);
-    AllTris.insert(worst);
+    AllTris.update(worst);
+    if(ActiveTris) ActiveTris->update(worst);
     return false;
   }
 }
@@ -1034,7 +1130,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
                   std::map<MVertex *, MVertex *> *equivalence,
                   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  MTri3Heap AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
 
   if(!buildMeshGenerationDataStructures(gf, AllTris, DATA)) {
@@ -1049,12 +1145,12 @@ void bowyerWatson(GFace *gf, int MAXPNT,
 
   int ITER = 0;
   //int NBDELETED = 0;
-  while(1) {
-    MTri3 *worst = *AllTris.begin();
+  while(!AllTris.empty()) {
+    MTri3 *worst = AllTris.top();
     if(worst->isDeleted()) {
+      AllTris.pop();
       delete worst->tri();
       delete worst;
-      AllTris.erase(AllTris.begin());
       //NBDELETED++;
     }
     else {
@@ -1080,7 +1176,7 @@ void bowyerWatson(GFace *gf, int MAXPNT,
 
       buildMetric(gf, pa, metric);
       circumCenterMetric(worst->tri(), metric, DATA, center, r2);
-      insertAPoint(gf, AllTris.begin(), center, metric, DATA, AllTris);
+      insertAPoint(gf, worst, center, metric, DATA, AllTris);
     }
   }
   splitElementsInBoundaryLayerIfNeeded(gf);
@@ -1286,12 +1382,286 @@ static bool optimalPointFrontalB(GFace *gf, MTri3 *worst, int active_edge,
   return true;
 }
 
+int bidimMeshData::missingIndex(MVertex *mv)
+{
+  Msg::Error("Node %lu is not in the surface mesh data structure",
+             mv->getNum());
+  throw std::runtime_error(Msg::GetLastError());
+}
+
+bool useParallelFrontal(GFace *gf)
+{
+  int threshold = CTX::instance()->mesh.frontalParallelThreshold;
+  if(threshold <= 0 || gf->getMeshingAlgo() != ALGO_2D_FRONTAL) return false;
+  std::size_t n = 0;
+  for(auto ge : gf->edges()) n += ge->getNumMeshElements();
+  for(auto ge : gf->embeddedEdges()) n += ge->getNumMeshElements();
+  return n >= (std::size_t)threshold;
+}
+
+// number of points inserted concurrently in each round of the parallel
+// frontal algorithm; it does not depend on the number of threads, so that the
+// mesh does not either
+static const std::size_t FRONTAL_BATCH_ = 512;
+static const std::size_t FRONTAL_SIZE_BATCH_ = 64;
+
+struct frontalCandidate {
+  MTri3 *worst, *ptin;
+  int active_edge, result;
+  bool valid;
+  double newPoint[2], metric[3], uv[2], lc;
+  GPoint p;
+  MVertex *v;
+  std::list<edgeXface> shell;
+  std::list<MTri3 *> cavity;
+  std::vector<MTri3 *> newCavity;
+};
+
+// compute the new point of a candidate of the parallel frontal algorithm and
+// its cavity, without modifying the mesh
+static void computeFrontalCandidate(GFace *gf, frontalCandidate &fc,
+                                    MTri3Heap &AllTris, bidimMeshData &DATA,
+                                    std::vector<SPoint2> *true_boundary,
+                                    SPoint2 &FAR)
+{
+  fc.ptin = nullptr;
+  fc.v = nullptr;
+  fc.shell.clear();
+  fc.cavity.clear();
+  fc.newCavity.clear();
+  fc.valid = optimalPointFrontalB(gf, fc.worst, fc.active_edge, DATA,
+                                  fc.newPoint, fc.metric);
+  if(fc.valid && true_boundary) {
+    int nnnn;
+    SPoint2 NP(fc.newPoint[0], fc.newPoint[1]);
+    fc.valid = pointInsideParametricDomain(*true_boundary, NP, FAR, nnnn);
+  }
+  if(!fc.valid) return;
+  if(inCircumCircleAniso(gf, fc.worst->tri(), fc.newPoint, fc.metric, DATA)) {
+    recurFindCavityAnisoReadOnly(gf, fc.shell, fc.cavity, fc.metric,
+                                 fc.newPoint, fc.worst, DATA);
+    for(auto itc = fc.cavity.begin(); itc != fc.cavity.end(); ++itc) {
+      if(invMapUV((*itc)->tri(), fc.newPoint, DATA, fc.uv, 1.e-8)) {
+        fc.ptin = *itc;
+        break;
+      }
+    }
+  }
+  else {
+    fc.ptin =
+      search4Triangle(fc.worst, fc.newPoint, DATA, AllTris, fc.uv, false);
+    if(fc.ptin)
+      recurFindCavityAnisoReadOnly(gf, fc.shell, fc.cavity, fc.metric,
+                                   fc.newPoint, fc.ptin, DATA);
+  }
+  if(!fc.ptin) return;
+  fc.p = gf->point(fc.newPoint[0], fc.newPoint[1]);
+  fc.lc = 1.;
+}
+
+// Frontal point insertion where, at each round, the FRONTAL_BATCH_ worst active
+// triangles are processed together, as in delaunayTrgl in 3D:
+//
+// 1. the new points (point on the surface, background mesh size, evaluated
+//    in batches with BGM_MeshSize) and their cavities are computed in
+//    parallel, on a mesh that is only read;
+// 2. the cavities are locked in order: a candidate whose cavity (or the
+//    triangles around it) has already been locked by a previous candidate is
+//    put back in the front, to be recomputed in the next round;
+// 3. the locked cavities, which do not overlap, are retriangulated in
+//    parallel;
+// 4. the new triangles are added to the heaps, in order.
+static void insertPointsFrontalInParallel(
+  GFace *gf, MTri3Heap &AllTris, MTri3Heap &ActiveTris, bidimMeshData &DATA,
+  std::vector<SPoint2> *true_boundary, SPoint2 &FAR,
+  bool testStarShapeness)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads2D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads2D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  const bool bamg = (CTX::instance()->mesh.algo2d == ALGO_2D_BAMG);
+
+  Msg::Debug("Frontal-Delaunay on surface %d using %d threads", gf->tag(),
+             nthreads);
+
+  std::vector<frontalCandidate> c(FRONTAL_BATCH_);
+  std::vector<std::size_t> locked, sized;
+  locked.reserve(FRONTAL_BATCH_);
+  std::vector<double> U, V, X, Y, Z, LC;
+  std::size_t nRounds = 0, nInserted = 0, nRequeued = 0;
+  while(ActiveTris.size()) {
+    std::size_t n = 0;
+    while(n < FRONTAL_BATCH_ && ActiveTris.size()) {
+      frontalCandidate &fc = c[n];
+      fc.worst = ActiveTris.top();
+      ActiveTris.pop();
+      if(!fc.worst->isDeleted() &&
+         isActive(fc.worst, LIMIT_, fc.active_edge) &&
+         fc.worst->getRadius() > LIMIT_)
+        n++;
+    }
+    // rounds are numbered from 1, as triangles are created unlocked
+    const int round = (int)++nRounds;
+
+    // 1. the mesh is only read here
+    bool exceptions = false;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < n; i++) {
+      if(exceptions) {
+        c[i].valid = false;
+        continue;
+      }
+      try { // OpenMP forbids leaving block via exception
+        computeFrontalCandidate(gf, c[i], AllTris, DATA, true_boundary, FAR);
+      }
+      catch(...) {
+        c[i].valid = false;
+        exceptions = true;
+      }
+    }
+    if(exceptions) throw std::runtime_error(Msg::GetLastError());
+
+    // background mesh size at the new points, evaluated in batches of
+    // FRONTAL_SIZE_BATCH_ points
+    if(!bamg) {
+      sized.clear();
+      for(std::size_t i = 0; i < n; i++) {
+        if(c[i].valid && c[i].ptin && c[i].p.succeeded()) sized.push_back(i);
+      }
+      const std::size_t ns = sized.size();
+      U.resize(ns);
+      V.resize(ns);
+      X.resize(ns);
+      Y.resize(ns);
+      Z.resize(ns);
+      LC.resize(ns);
+      for(std::size_t j = 0; j < ns; j++) {
+        frontalCandidate &fc = c[sized[j]];
+        U[j] = fc.newPoint[0];
+        V[j] = fc.newPoint[1];
+        X[j] = fc.p.x();
+        Y[j] = fc.p.y();
+        Z[j] = fc.p.z();
+      }
+      const std::size_t nb =
+        (ns + FRONTAL_SIZE_BATCH_ - 1) / FRONTAL_SIZE_BATCH_;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(std::size_t k = 0; k < nb; k++) {
+        std::size_t b = k * FRONTAL_SIZE_BATCH_;
+        std::size_t e = std::min(ns, b + FRONTAL_SIZE_BATCH_);
+        BGM_MeshSize(gf, e - b, &U[b], &V[b], &X[b], &Y[b], &Z[b], &LC[b]);
+      }
+      for(std::size_t j = 0; j < ns; j++) c[sized[j]].lc = LC[j];
+    }
+
+    // 2. lock the cavities, the triangles around them (whose neighbors will
+    // change) and the worst triangles (whose radius may change), in order
+    locked.clear();
+    for(std::size_t i = 0; i < n; i++) {
+      frontalCandidate &fc = c[i];
+      if(!fc.valid || !fc.ptin || !fc.p.succeeded()) continue;
+      bool isFree = (fc.worst->getLock() != round);
+      for(auto t : fc.cavity) isFree = isFree && (t->getLock() != round);
+      for(auto &e : fc.shell) {
+        MTri3 *o = e.t1->getNeigh(e.i1);
+        isFree = isFree && (!o || o->getLock() != round);
+      }
+      if(!isFree) {
+        fc.valid = false;
+        ActiveTris.insert(fc.worst);
+        nRequeued++;
+        continue;
+      }
+      fc.worst->setLock(round);
+      for(auto t : fc.cavity) t->setLock(round);
+      for(auto &e : fc.shell) {
+        MTri3 *o = e.t1->getNeigh(e.i1);
+        if(o) o->setLock(round);
+      }
+      int index0 = DATA.getIndex(fc.ptin->tri()->getVertex(0));
+      int index1 = DATA.getIndex(fc.ptin->tri()->getVertex(1));
+      int index2 = DATA.getIndex(fc.ptin->tri()->getVertex(2));
+      // new vertices are created here, so that their numbering does not
+      // depend on the number of threads
+      fc.v = new MFaceVertex(fc.p.x(), fc.p.y(), fc.p.z(), gf, fc.newPoint[0],
+                             fc.newPoint[1]);
+      double lc1 = (1. - fc.uv[0] - fc.uv[1]) * DATA.vSizes[index0] +
+                   fc.uv[0] * DATA.vSizes[index1] +
+                   fc.uv[1] * DATA.vSizes[index2];
+      DATA.addVertex(fc.v, fc.newPoint[0], fc.newPoint[1], lc1, fc.lc);
+      locked.push_back(i);
+    }
+
+    // 3. the locked cavities do not overlap
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t j = 0; j < locked.size(); j++) {
+      frontalCandidate &fc = c[locked[j]];
+      fc.result = 0;
+      if(exceptions) continue;
+      for(auto t : fc.cavity) t->setDeleted(true);
+      try { // OpenMP forbids leaving block via exception
+        fc.result = insertVertexB(fc.shell, fc.cavity, false, gf, fc.v,
+                                  fc.newPoint, fc.ptin, AllTris, nullptr, DATA,
+                                  fc.metric, nullptr, testStarShapeness,
+                                  &fc.newCavity);
+      }
+      catch(...) {
+        exceptions = true;
+      }
+      if(fc.result != 1) {
+        for(auto t : fc.cavity) t->setDeleted(false);
+      }
+    }
+    if(exceptions) {
+      for(auto i : locked) {
+        if(c[i].result == 1)
+          gf->mesh_vertices.push_back(c[i].v);
+        else
+          delete c[i].v;
+      }
+      throw std::runtime_error(Msg::GetLastError());
+    }
+
+    // 4. update the heaps, as insertAPoint does
+    for(std::size_t i = 0; i < n; i++) {
+      frontalCandidate &fc = c[i];
+      if(!fc.valid) continue;
+      if(!fc.ptin) {
+        fc.worst->forceRadius(0);
+        AllTris.update(fc.worst);
+      }
+      else if(!fc.v || fc.result != 1) {
+        fc.worst->forceRadius(-1);
+        AllTris.update(fc.worst);
+        if(fc.v) delete fc.v;
+      }
+      else {
+        for(auto t : fc.newCavity) {
+          AllTris.insert(t);
+          int active_edge;
+          if(isActive(t, LIMIT_, active_edge) && t->getRadius() > LIMIT_)
+            ActiveTris.insert(t);
+        }
+        gf->mesh_vertices.push_back(fc.v);
+        nInserted++;
+      }
+    }
+
+    if(nRounds % 100 == 1)
+      Msg::Debug("%7d points created -- %d active triangles",
+                 gf->mesh_vertices.size(), ActiveTris.size());
+  }
+  Msg::Debug("Frontal-Delaunay on surface %d: %lu points inserted in %lu "
+             "rounds (%lu recomputed)", gf->tag(), nInserted, nRounds,
+             nRequeued);
+}
+
 void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
                          std::map<MVertex *, SPoint2> *parametricCoordinates,
                          std::vector<SPoint2> *true_boundary)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
-  std::set<MTri3 *, compareTri3Ptr> ActiveTris;
+  MTri3Heap AllTris(0), ActiveTris(1);
   bidimMeshData DATA(equivalence, parametricCoordinates);
   bool testStarShapeness = true;
   SPoint3 c;
@@ -1305,12 +1675,9 @@ void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
 
   int ITER = 0, active_edge;
   // compute active triangle
-  auto it = AllTris.begin();
-  for(; it != AllTris.end(); ++it) {
-    if(isActive(*it, LIMIT_, active_edge))
+  for(auto it = AllTris.begin(); it != AllTris.end(); ++it) {
+    if((*it)->getRadius() > LIMIT_ && isActive(*it, LIMIT_, active_edge))
       ActiveTris.insert(*it);
-    else if((*it)->getRadius() < LIMIT_)
-      break;
   }
 
   Range<double> RU = gf->parBounds(0);
@@ -1318,7 +1685,12 @@ void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
   SPoint2 FAR(2 * RU.high(), 2 * RV.high());
 
 
-  // insert points
+  // insert points (if done in parallel, the front is empty afterwards and the
+  // loop below exits right away)
+  if(useParallelFrontal(gf))
+    insertPointsFrontalInParallel(gf, AllTris, ActiveTris, DATA, true_boundary,
+                                  FAR, testStarShapeness);
+
   //int ITERATION = 0;
   while(1) {
     //++ITERATION;
@@ -1334,8 +1706,8 @@ void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
 
     //    printf("%d active tris \n",ActiveTris.size());
     if(!ActiveTris.size()) break;
-    MTri3 *worst = (*ActiveTris.begin());
-    ActiveTris.erase(ActiveTris.begin());
+    MTri3 *worst = ActiveTris.top();
+    ActiveTris.pop();
 
     if(!worst->isDeleted() && isActive(worst, LIMIT_, active_edge) &&
        worst->getRadius() > LIMIT_) {
@@ -1348,8 +1720,8 @@ void bowyerWatsonFrontal(GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
         int nnnn;
         if(!true_boundary ||
            pointInsideParametricDomain(*true_boundary, NP, FAR, nnnn))
-          insertAPoint(gf, AllTris.end(), newPoint, metric, DATA, AllTris,
-                       &ActiveTris, worst, nullptr, testStarShapeness);
+          insertAPoint(gf, worst, newPoint, metric, DATA, AllTris, &ActiveTris,
+                       nullptr, testStarShapeness);
       }
     }
   }
@@ -1498,8 +1870,7 @@ void bowyerWatsonFrontalLayers(
   GFace *gf, bool quad, std::map<MVertex *, MVertex *> *equivalence,
   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
-  std::set<MTri3 *, compareTri3Ptr> ActiveTris;
+  MTri3Heap AllTris(0), ActiveTris(1);
   bidimMeshData DATA(equivalence, parametricCoordinates);
 
   if(quad) {
@@ -1514,10 +1885,12 @@ void bowyerWatsonFrontalLayers(
   }
 
   int ITER = 0, active_edge;
-  // compute active triangle
-  auto it = AllTris.begin();
+  // compute active triangle (by decreasing radius)
+  std::vector<MTri3 *> sorted(AllTris.begin(), AllTris.end());
+  std::sort(sorted.begin(), sorted.end(), compareTri3Ptr());
+  auto it = sorted.begin();
   std::set<MEdge, MEdgeLessThan> _front;
-  for(; it != AllTris.end(); ++it) {
+  for(; it != sorted.end(); ++it) {
     if(isActive(*it, LIMIT_, active_edge)) {
       ActiveTris.insert(*it);
       updateActiveEdges(*it, LIMIT_, _front);
@@ -1539,7 +1912,7 @@ void bowyerWatsonFrontalLayers(
     //   _printTris (name, ActiveTris.begin(),  ActiveTris.end(),DATA,true);
     // }
 
-    std::set<MTri3 *, compareTri3Ptr> ActiveTrisNotInFront;
+    std::vector<MTri3 *> ActiveTrisNotInFront;
 
     // printf("%d active triangles\n",ActiveTris.size());
 
@@ -1552,10 +1925,8 @@ void bowyerWatsonFrontalLayers(
            _printTris (name, AllTris, Us,Vs,true);
          }
       */
-      auto WORST_ITER = ActiveTris.begin();
-
-      MTri3 *worst = (*WORST_ITER);
-      ActiveTris.erase(WORST_ITER);
+      MTri3 *worst = ActiveTris.top();
+      ActiveTris.pop();
       if(!worst->isDeleted() &&
          (ITERATION > max_layers ?
             isActive(worst, LIMIT_, active_edge) :
@@ -1578,8 +1949,7 @@ void bowyerWatsonFrontalLayers(
         else
           optimalPointFrontalB(gf, worst, active_edge, DATA, newPoint, metric);
 
-        insertAPoint(gf, AllTris.end(), newPoint, nullptr, DATA, AllTris,
-                     &ActiveTris, worst);
+        insertAPoint(gf, worst, newPoint, nullptr, DATA, AllTris, &ActiveTris);
         // else if (!worst->isDeleted() && worst->getRadius() > LIMIT_){
         //   ActiveTrisNotInFront.insert(worst);
         // }
@@ -1593,7 +1963,7 @@ void bowyerWatsonFrontalLayers(
          */
       }
       else if(!worst->isDeleted() && worst->getRadius() > LIMIT_) {
-        ActiveTrisNotInFront.insert(worst);
+        ActiveTrisNotInFront.push_back(worst);
       }
     }
     _front.clear();
@@ -1622,7 +1992,7 @@ void bowyerWatsonParallelograms(
   GFace *gf, std::map<MVertex *, MVertex *> *equivalence,
   std::map<MVertex *, SPoint2> *parametricCoordinates)
 {
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  MTri3Heap AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
   std::vector<MVertex *> packed;
   std::vector<SMetric3> metrics;
@@ -1664,11 +2034,11 @@ void bowyerWatsonParallelograms(
 
   MTri3 *oneNewTriangle = nullptr;
   for(std::size_t i = 0; i < packed.size();) {
-    MTri3 *worst = *AllTris.begin();
+    MTri3 *worst = AllTris.top();
     if(worst->isDeleted()) {
+      AllTris.pop();
       delete worst->tri();
       delete worst;
-      AllTris.erase(AllTris.begin());
     }
     else {
       double newPoint[2];
@@ -1678,22 +2048,20 @@ void bowyerWatsonParallelograms(
       double metric[3];
       buildMetric(gf, newPoint, metric);
 
-      bool success =
-        insertAPoint(gf, AllTris.begin(), newPoint, metric, DATA, AllTris,
-                     nullptr, oneNewTriangle, &oneNewTriangle);
+      bool success = insertAPoint(gf, oneNewTriangle ? oneNewTriangle : worst,
+                                  newPoint, metric, DATA, AllTris, nullptr,
+                                  &oneNewTriangle);
       if(!success) oneNewTriangle = nullptr;
       i++;
     }
 
     if(1.0 * AllTris.size() > 2.5 * DATA.vSizes.size()) {
-      auto itd = AllTris.begin();
-      while(itd != AllTris.end()) {
-        if((*itd)->isDeleted()) {
-          delete *itd;
-          AllTris.erase(itd++);
-        }
-        else
-          itd++;
+      std::vector<MTri3 *> deleted;
+      for(auto itd = AllTris.begin(); itd != AllTris.end(); ++itd)
+        if((*itd)->isDeleted()) deleted.push_back(*itd);
+      for(auto t : deleted) {
+        AllTris.erase(t);
+        delete t;
       }
     }
   }
@@ -1716,7 +2084,7 @@ void bowyerWatsonParallelogramsConstrained(
   Msg::Error("bowyerWatsonParallelogramsConstrained deprecated");
   return;
 
-  std::set<MTri3 *, compareTri3Ptr> AllTris;
+  MTri3Heap AllTris;
   bidimMeshData DATA(equivalence, parametricCoordinates);
   std::vector<MVertex *> packed;
   std::vector<SMetric3> metrics;
@@ -1737,11 +2105,11 @@ void bowyerWatsonParallelogramsConstrained(
 
   MTri3 *oneNewTriangle = nullptr;
   for(std::size_t i = 0; i < packed.size();) {
-    MTri3 *worst = *AllTris.begin();
+    MTri3 *worst = AllTris.top();
     if(worst->isDeleted()) {
+      AllTris.pop();
       delete worst->tri();
       delete worst;
-      AllTris.erase(AllTris.begin());
     }
     else {
       double newPoint[2];
@@ -1751,22 +2119,20 @@ void bowyerWatsonParallelogramsConstrained(
       double metric[3];
       buildMetric(gf, newPoint, metric);
 
-      bool success =
-        insertAPoint(gf, AllTris.begin(), newPoint, metric, DATA, AllTris,
-                     nullptr, oneNewTriangle, &oneNewTriangle);
+      bool success = insertAPoint(gf, oneNewTriangle ? oneNewTriangle : worst,
+                                  newPoint, metric, DATA, AllTris, nullptr,
+                                  &oneNewTriangle);
       if(!success) oneNewTriangle = nullptr;
       i++;
     }
 
     if(1.0 * AllTris.size() > 2.5 * DATA.vSizes.size()) {
-      auto itd = AllTris.begin();
-      while(itd != AllTris.end()) {
-        if((*itd)->isDeleted()) {
-          delete *itd;
-          AllTris.erase(itd++);
-        }
-        else
-          itd++;
+      std::vector<MTri3 *> deleted;
+      for(auto itd = AllTris.begin(); itd != AllTris.end(); ++itd)
+        if((*itd)->isDeleted()) deleted.push_back(*itd);
+      for(auto t : deleted) {
+        AllTris.erase(t);
+        delete t;
       }
     }
   }
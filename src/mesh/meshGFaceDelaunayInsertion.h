@@ -11,6 +11,7 @@
 #include "STensor3.h"
 #include "GEntity.h"
 #include "MFace.h"
+#include "MeshMemoryPool.h"
 #include <list>
 #include <set>
 #include <map>
@@ -51,8 +52,14 @@ struct bidimMeshData {
   inline int getIndex(MVertex *mv)
   {
     if(mv->onWhat()->dim() == 2) return mv->getIndex();
-    return indices[mv];
+    // no insertion, as this is called concurrently: all the nodes must have
+    // been added with addVertex()
+    auto it = indices.find(mv);
+    if(it == indices.end()) return missingIndex(mv);
+    return it->second;
   }
+  // report a node that has not been added and throw an exception
+  static int missingIndex(MVertex *mv);
   inline MVertex *equivalent(MVertex *v1) const
   {
     if(equivalence) {
@@ -76,13 +83,26 @@ int inCircumCircleAniso(GFace *gf, MTriangle *base, const double *uv,
                         const double *metric, bidimMeshData &data);
 
 class MTri3 {
+  friend class MTri3Heap;
+
 protected:
   bool deleted;
+  int lock; // last round of parallel insertion in which the triangle was used
   double circum_radius;
   MTriangle *base;
   MTri3 *neigh[3];
+  int heap_index[2]; // position in (at most) two MTri3Heaps
 
 public:
+  // triangles are allocated in the mesh memory pool
+  static void *operator new(std::size_t size)
+  {
+    return MeshMemoryPool::allocate(size);
+  }
+  static void operator delete(void *p, std::size_t size)
+  {
+    MeshMemoryPool::deallocate(p, size);
+  }
   /// 2 is euclidian norm, -1 is infinite norm  , 3 quality
   static int radiusNorm;
   bool isDeleted() const { return deleted; }
@@ -116,6 +136,8 @@ public:
     return inCircumCircle(v->x(), v->y());
   }
   inline void setDeleted(bool d) { deleted = d; }
+  inline int getLock() const { return lock; }
+  inline void setLock(int l) { lock = l; }
   inline bool assertNeigh() const
   {
     if(deleted) return true;
@@ -143,13 +165,59 @@ public:
   }
 };
 
+// Indexed binary heap of triangles, ordered with compareTri3Ptr (i.e. with the
+// triangle with the largest radius on top). Each triangle stores its position
+// in the heap, so that testing if a triangle is in the heap, removing it or
+// reordering it after its radius has changed requires no search and no memory
+// allocation. A triangle can be in two heaps at once (e.g. the heap of all the
+// triangles and the heap of the active triangles in the frontal algorithms),
+// provided that they use different slots.
+class MTri3Heap {
+private:
+  std::vector<MTri3 *> _heap;
+  int _slot;
+  compareTri3Ptr _before;
+  void _set(std::size_t i, MTri3 *t)
+  {
+    _heap[i] = t;
+    t->heap_index[_slot] = (int)i;
+  }
+  void _up(std::size_t i);
+  void _down(std::size_t i);
+
+public:
+  typedef std::vector<MTri3 *>::const_iterator const_iterator;
+  MTri3Heap(int slot = 0) : _slot(slot) {}
+  bool empty() const { return _heap.empty(); }
+  std::size_t size() const { return _heap.size(); }
+  // iterate over the triangles (not sorted!)
+  const_iterator begin() const { return _heap.begin(); }
+  const_iterator end() const { return _heap.end(); }
+  MTri3 *top() const { return _heap.front(); }
+  bool contains(const MTri3 *t) const
+  {
+    int i = t->heap_index[_slot];
+    return i >= 0 && i < (int)_heap.size() && _heap[i] == t;
+  }
+  // insert a triangle, if it is not already in the heap
+  void insert(MTri3 *t);
+  void pop();
+  void erase(MTri3 *t);
+  // restore the order after the radius of the triangle has been modified
+  void update(MTri3 *t);
+  void clear();
+};
+
 void connectTriangles(std::list<MTri3 *> &);
 void connectTriangles(std::vector<MTri3 *> &);
-void connectTriangles(std::set<MTri3 *, compareTri3Ptr> &AllTris);
+void connectTriangles(MTri3Heap &AllTris);
 void bowyerWatson(
   GFace *gf, int MAXPNT = 1000000000,
   std::map<MVertex *, MVertex *> *equivalence = nullptr,
   std::map<MVertex *, SPoint2> *parametricCoordinates = nullptr);
+// should the Frontal-Delaunay algorithm insert points in parallel on this
+// (large) surface?
+bool useParallelFrontal(GFace *gf);
 void bowyerWatsonFrontal(
   GFace *gf, std::map<MVertex *, MVertex *> *equivalence = nullptr,
   std::map<MVertex *, SPoint2> *parametricCoordinates = nullptr,
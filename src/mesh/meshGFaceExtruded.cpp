@@ -10,7 +10,7 @@
 #include "MTriangle.h"
 #include "MQuadrangle.h"
 #include "ExtrudeParams.h"
-#include "MVertexRTree.h"
+#include "MVertexHashGrid.h"
 #include "Context.h"
 #include "GmshMessage.h"
 
@@ -83,7 +83,7 @@ createQuaTri(std::vector<MVertex *> &v, GFace *to,
 }
 
 static void
-extrudeMesh(GEdge *from, GFace *to, MVertexRTree &pos,
+extrudeMesh(GEdge *from, GFace *to, MVertexHashGrid &pos,
             std::set<std::pair<MVertex *, MVertex *> > *constrainedEdges)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
@@ -174,7 +174,7 @@ extrudeMesh(GEdge *from, GFace *to, MVertexRTree &pos,
   }
 }
 
-static void copyMesh(GFace *from, GFace *to, MVertexRTree &pos)
+static void copyMesh(GFace *from, GFace *to, MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
 
@@ -297,8 +297,8 @@ int MeshExtrudedSurface(
 
   Msg::Info("Meshing surface %d (Extruded)", gf->tag());
 
-  // build an rtree with all the vertices on the face and its boundary
-  MVertexRTree pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
+  // build a hash grid with all the vertices on the face and its boundary
+  MVertexHashGrid pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
   pos.insert(gf->mesh_vertices);
   std::vector<GEdge *> const &edges = gf->edges();
   for(auto it = edges.begin(); it != edges.end(); it++) {
@@ -4,6 +4,7 @@
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
 #include <stack>
+#include <algorithm>
 #include "GmshConfig.h"
 #include "meshGFaceOptimize.h"
 #include "qualityMeasures.h"
@@ -171,8 +172,8 @@ static void setLcs(MTriangle *t, std::map<MVertex *, double> &vSizes,
   }
 }
 
-bool buildMeshGenerationDataStructures(
-  GFace *gf, std::set<MTri3 *, compareTri3Ptr> &AllTris, bidimMeshData &data)
+bool buildMeshGenerationDataStructures(GFace *gf, MTri3Heap &AllTris,
+                                       bidimMeshData &data)
 {
   std::map<MVertex *, double> vSizesMap;
 
@@ -345,19 +346,19 @@ void splitEquivalentTriangles(GFace *gf, bidimMeshData &data)
   computeEquivalentTriangles(gf, data.equivalence);
 }
 
-void transferDataStructure(GFace *gf,
-                           std::set<MTri3 *, compareTri3Ptr> &AllTris,
-                           bidimMeshData &data)
+void transferDataStructure(GFace *gf, MTri3Heap &AllTris, bidimMeshData &data)
 {
-  while(1) {
-    if(AllTris.begin() == AllTris.end()) break;
-    MTri3 *worst = *AllTris.begin();
+  // transfer the triangles sorted by decreasing radius, as the heap is not
+  // sorted
+  std::vector<MTri3 *> tris(AllTris.begin(), AllTris.end());
+  AllTris.clear();
+  std::sort(tris.begin(), tris.end(), compareTri3Ptr());
+  for(auto worst : tris) {
     if(worst->isDeleted())
       delete worst->tri();
     else
       gf->triangles.push_back(worst->tri());
     delete worst;
-    AllTris.erase(AllTris.begin());
   }
 
   // make sure all the triangles are oriented in the same way in
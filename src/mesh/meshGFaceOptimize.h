@@ -58,11 +58,9 @@ void buildEdgeToElements(std::vector<MElement *> &tris, e2t_cont &adj);
 
 void laplaceSmoothing(GFace *gf, int niter = 1, bool infinity_norm = false);
 
-bool buildMeshGenerationDataStructures(
-  GFace *gf, std::set<MTri3 *, compareTri3Ptr> &AllTris, bidimMeshData &data);
-void transferDataStructure(GFace *gf,
-                           std::set<MTri3 *, compareTri3Ptr> &AllTris,
-                           bidimMeshData &DATA);
+bool buildMeshGenerationDataStructures(GFace *gf, MTri3Heap &AllTris,
+                                       bidimMeshData &data);
+void transferDataStructure(GFace *gf, MTri3Heap &AllTris, bidimMeshData &DATA);
 void computeEquivalences(GFace *gf, bidimMeshData &DATA);
 void recombineIntoQuads(GFace *gf, bool blossom, int topologicalOptiPasses,
                         bool nodeRepositioning, double minqual);
@@ -5,6 +5,11 @@
 
 #include <stdlib.h>
 #include <vector>
+#include <map>
+#include <set>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
 #include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "meshGRegion.h"
@@ -29,6 +34,7 @@
 #include "ExtrudeParams.h"
 #include "OS.h"
 #include "Context.h"
+#include "robustPredicates.h"
 
 void splitQuadRecovery::add(const MFace &f, MVertex *v, GFace *gf)
 {
@@ -84,20 +90,11 @@ int splitQuadRecovery::buildPyramids(GModel *gm)
   return npyram;
 }
 
-void MeshDelaunayVolume(std::vector<GRegion *> &regions)
+// recover the boundary mesh of the connected regions in an initial Delaunay
+// tetrahedralization (stored in the first region)
+static bool recoverBoundary(std::vector<GRegion *> &regions,
+                            splitQuadRecovery &sqr)
 {
-  if(regions.empty()) return;
-
-  if(CTX::instance()->mesh.algo3d == ALGO_3D_HXT) {
-    if(meshGRegionHxt(regions) != 0) { Msg::Error("HXT 3D mesh failed"); }
-    return;
-  }
-
-  if(CTX::instance()->mesh.algo3d != ALGO_3D_DELAUNAY &&
-     CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
-     CTX::instance()->mesh.algo3d != ALGO_3D_MMG3D)
-    return;
-
   GRegion *gr = regions[0];
   std::vector<GFace *> faces = gr->faces();
 
@@ -146,7 +143,6 @@ void MeshDelaunayVolume(std::vector<GRegion *> &regions)
   std::vector<GVertex *> oldEmbVertices = gr->embeddedVertices();
   gr->embeddedVertices() = allEmbVertices;
 
-  splitQuadRecovery sqr;
   bool success = meshGRegionBoundaryRecovery(gr, &sqr);
 
   // sort triangles in all model faces in order to be able to search in vectors
@@ -176,7 +172,38 @@ void MeshDelaunayVolume(std::vector<GRegion *> &regions)
   gr->embeddedEdges() = oldEmbEdges;
   gr->embeddedVertices() = oldEmbVertices;
 
-  if(!success) return;
+  return success;
+}
+
+static void buildPyramids(std::vector<GRegion *> &regions,
+                          splitQuadRecovery &sqr)
+{
+  GRegion *gr = regions[0];
+  if(sqr.buildPyramids(gr->model())) {
+    Msg::Info("Optimizing pyramids for hybrid mesh...");
+    gr->model()->setAllVolumesPositive();
+    RelocateVerticesOfPyramids(regions, 3);
+    // RelocateVertices(regions, 3);
+    Msg::Info("Done optimizing pyramids for hybrid mesh");
+  }
+}
+
+void MeshDelaunayVolume(std::vector<GRegion *> &regions)
+{
+  if(regions.empty()) return;
+
+  if(CTX::instance()->mesh.algo3d == ALGO_3D_HXT) {
+    if(meshGRegionHxt(regions) != 0) { Msg::Error("HXT 3D mesh failed"); }
+    return;
+  }
+
+  if(CTX::instance()->mesh.algo3d != ALGO_3D_DELAUNAY &&
+     CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY &&
+     CTX::instance()->mesh.algo3d != ALGO_3D_MMG3D)
+    return;
+
+  splitQuadRecovery sqr;
+  if(!recoverBoundary(regions, sqr)) return;
 
   // now do insertion of points
   if(CTX::instance()->mesh.algo3d == ALGO_3D_MMG3D) {
@@ -185,16 +212,9 @@ void MeshDelaunayVolume(std::vector<GRegion *> &regions)
     }
   }
   else if(CTX::instance()->mesh.algo3d != ALGO_3D_INITIAL_ONLY) {
-    insertVerticesInRegion(gr, CTX::instance()->mesh.maxIterDelaunay3D, 1.,
-                           true, &sqr);
-
-    if(sqr.buildPyramids(gr->model())) {
-      Msg::Info("Optimizing pyramids for hybrid mesh...");
-      gr->model()->setAllVolumesPositive();
-      RelocateVerticesOfPyramids(regions, 3);
-      // RelocateVertices(regions, 3);
-      Msg::Info("Done optimizing pyramids for hybrid mesh");
-    }
+    insertVerticesInRegion(regions[0], CTX::instance()->mesh.maxIterDelaunay3D,
+                           1., true, &sqr, &regions);
+    buildPyramids(regions, sqr);
 
     // test:
     // bool createBoundaryLayerOneLayer(GRegion *gr, std::vector<GFace *> &
@@ -202,6 +222,140 @@ void MeshDelaunayVolume(std::vector<GRegion *> &regions)
   }
 }
 
+// model entities holding the boundary mesh nodes of the connected regions
+static void getBoundaryEntities(std::vector<GRegion *> &regions,
+                                std::set<GEntity *> &entities)
+{
+  for(auto gr : regions) {
+    std::vector<GFace *> f = gr->faces();
+    f.insert(f.end(), gr->embeddedFaces().begin(), gr->embeddedFaces().end());
+    std::vector<GEdge *> e = gr->embeddedEdges();
+    for(auto gf : f) {
+      entities.insert(gf);
+      e.insert(e.end(), gf->edges().begin(), gf->edges().end());
+      e.insert(e.end(), gf->embeddedEdges().begin(), gf->embeddedEdges().end());
+      entities.insert(gf->embeddedVertices().begin(),
+                      gf->embeddedVertices().end());
+    }
+    for(auto ge : e) {
+      entities.insert(ge);
+      std::vector<GVertex *> v = ge->vertices();
+      entities.insert(v.begin(), v.end());
+    }
+    entities.insert(gr->embeddedVertices().begin(),
+                    gr->embeddedVertices().end());
+  }
+}
+
+void MeshDelaunayVolume(std::vector<std::vector<GRegion *> > &connected)
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // only the refinement step of the Delaunay algorithm is done concurrently:
+  // HXT is already parallel, and the other algorithms rely on global state
+  if(nthreads < 2 || connected.size() < 2 ||
+     CTX::instance()->mesh.algo3d != ALGO_3D_DELAUNAY) {
+    for(std::size_t i = 0; i < connected.size(); i++) {
+      if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
+        Msg::Warning("Aborted 3D meshing");
+        break;
+      }
+      MeshDelaunayVolume(connected[i]);
+    }
+    return;
+  }
+
+  // the boundary recovery uses global state (in tetgen and in the robust
+  // predicates, initialized for the bounding box of each volume), so it is
+  // done sequentially
+  std::size_t n = connected.size();
+  std::vector<splitQuadRecovery> sqr(n);
+  std::vector<std::size_t> numTets(n, 0);
+  double maxx = 0., maxy = 0., maxz = 0.;
+  for(std::size_t i = 0; i < n; i++) {
+    if(CTX::instance()->abortOnError && Msg::GetErrorCount()) {
+      Msg::Warning("Aborted 3D meshing");
+      break;
+    }
+    if(!recoverBoundary(connected[i], sqr[i])) continue;
+    GRegion *gr = connected[i][0];
+    numTets[i] = gr->tetrahedra.size();
+    for(auto t : gr->tetrahedra) {
+      for(std::size_t j = 0; j < 4; j++) {
+        MVertex *v = t->getVertex(j);
+        maxx = std::max(maxx, std::abs(v->x()));
+        maxy = std::max(maxy, std::abs(v->y()));
+        maxz = std::max(maxz, std::abs(v->z()));
+      }
+    }
+  }
+  robustPredicates::exactinit(1, maxx, maxy, maxz);
+
+  // node indices are used during the refinement, so volumes sharing boundary
+  // nodes (on curves or points) cannot be refined at the same time: color the
+  // volumes so that volumes with the same color do not share any node
+  std::map<GEntity *, std::vector<std::size_t> > owners;
+  for(std::size_t i = 0; i < n; i++) {
+    if(!numTets[i]) continue;
+    std::set<GEntity *> entities;
+    getBoundaryEntities(connected[i], entities);
+    for(auto ge : entities) owners[ge].push_back(i);
+  }
+  std::vector<std::set<std::size_t> > neighbors(n);
+  for(auto &o : owners) {
+    for(auto i : o.second)
+      for(auto j : o.second)
+        if(i != j) neighbors[i].insert(j);
+  }
+  std::vector<int> color(n, -1);
+  int numColors = 0;
+  for(std::size_t i = 0; i < n; i++) {
+    if(!numTets[i]) continue;
+    std::set<int> used;
+    for(auto j : neighbors[i]) used.insert(color[j]);
+    int c = 0;
+    while(used.count(c)) c++;
+    color[i] = c;
+    numColors = std::max(numColors, c + 1);
+  }
+
+  Msg::Info("Refining %d volume meshes with %d threads (%d color%s)", (int)n,
+            nthreads, numColors, numColors > 1 ? "s" : "");
+
+  for(int c = 0; c < numColors; c++) {
+    // largest volumes first, for load balancing
+    std::vector<std::size_t> todo;
+    for(std::size_t i = 0; i < n; i++)
+      if(color[i] == c) todo.push_back(i);
+    std::stable_sort(todo.begin(), todo.end(),
+                     [&numTets](std::size_t a, std::size_t b) {
+                       return numTets[a] > numTets[b];
+                     });
+    bool exceptions = false;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t k = 0; k < todo.size(); k++) {
+      if(exceptions) continue;
+      std::vector<GRegion *> &regions = connected[todo[k]];
+      try { // OpenMP forbids leaving block via exception
+        insertVerticesInRegion(regions[0],
+                               CTX::instance()->mesh.maxIterDelaunay3D, 1.,
+                               true, &sqr[todo[k]], &regions);
+      }
+      catch(...) {
+        exceptions = true;
+      }
+    }
+    if(exceptions) throw std::runtime_error(Msg::GetLastError());
+  }
+
+  for(std::size_t i = 0; i < n; i++) {
+    if(numTets[i]) buildPyramids(connected[i], sqr[i]);
+  }
+}
+
 void deMeshGRegion::operator()(GRegion *gr)
 {
   if(gr->isFullyDiscrete()) return;
@@ -250,16 +404,25 @@ void optimizeMeshGRegion::operator()(GRegion *gr, bool always)
 }
 
 bool buildFaceSearchStructure(GModel *model, fs_cont &search,
-                              bool onlyTriangles)
+                              bool onlyTriangles,
+                              const std::vector<GRegion *> *regions)
 {
   search.clear();
 
   std::set<GFace *> faces_to_consider;
-  auto rit = model->firstRegion();
-  while(rit != model->lastRegion()) {
-    std::vector<GFace *> _faces = (*rit)->faces();
-    faces_to_consider.insert(_faces.begin(), _faces.end());
-    rit++;
+  if(regions) {
+    for(auto gr : *regions) {
+      std::vector<GFace *> _faces = gr->faces();
+      faces_to_consider.insert(_faces.begin(), _faces.end());
+    }
+  }
+  else {
+    auto rit = model->firstRegion();
+    while(rit != model->lastRegion()) {
+      std::vector<GFace *> _faces = (*rit)->faces();
+      faces_to_consider.insert(_faces.begin(), _faces.end());
+      rit++;
+    }
   }
 
   auto fit = faces_to_consider.begin();
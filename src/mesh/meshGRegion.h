@@ -51,6 +51,9 @@ public:
 };
 
 void MeshDelaunayVolume(std::vector<GRegion *> &delaunay);
+// mesh each set of connected regions separately; with the Delaunay algorithm,
+// independent sets are refined concurrently
+void MeshDelaunayVolume(std::vector<std::vector<GRegion *> > &connected);
 bool CreateAnEmptyVolumeMesh(GRegion *gr);
 int MeshTransfiniteVolume(GRegion *gr);
 int SubdivideExtrudedMesh(GModel *m);
@@ -64,8 +67,10 @@ GFace *findInFaceSearchStructure(MVertex *p1, MVertex *p2, MVertex *p3,
 GFace *findInFaceSearchStructure(const MFace &f, const fs_cont &search);
 GEdge *findInEdgeSearchStructure(MVertex *p1, MVertex *p2,
                                  const es_cont &search);
+// (if regions is given, only the faces of these regions are considered)
 bool buildFaceSearchStructure(GModel *model, fs_cont &search,
-                              bool onlyTriangles = false);
+                              bool onlyTriangles = false,
+                              const std::vector<GRegion *> *regions = nullptr);
 bool buildEdgeSearchStructure(GModel *model, es_cont &search);
 
 // hybrid mesh recovery structure
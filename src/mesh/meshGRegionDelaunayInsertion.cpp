@@ -22,6 +22,7 @@
 #include "MEdge.h"
 #include "MLine.h"
 #include "ExtrudeParams.h"
+#include "robin_hood.h"
 
 int MTet4::radiusNorm = 2;
 
@@ -618,12 +619,19 @@ static void completeTheSetOfFaces(GModel *model, std::set<GFace *> &faces_bound)
 }
 
 GRegion *getRegionFromBoundingFaces(GModel *model,
-                                    std::set<GFace *> &faces_bound)
+                                    std::set<GFace *> &faces_bound,
+                                    const std::vector<GRegion *> *regions)
 {
   completeTheSetOfFaces(model, faces_bound);
 
-  auto git = model->firstRegion();
-  while(git != model->lastRegion()) {
+  std::vector<GRegion *> all;
+  if(!regions) {
+    all.insert(all.end(), model->firstRegion(), model->lastRegion());
+    regions = &all;
+  }
+
+  auto git = regions->begin();
+  while(git != regions->end()) {
     GRegion *gr = *git;
     ExtrudeParams *ep = gr->meshAttributes.extrude;
     if((ep && ep->mesh.ExtrudeMesh) ||
@@ -873,6 +881,118 @@ void adaptMeshGRegion::operator()(GRegion *gr)
   }
 }
 
+// Parallel optimization: the nodes of the region are partitioned by recursive
+// coordinate bisection, and each tet whose nodes are all in the same part is
+// assigned to that part. Edge swaps and node relocations that only involve
+// tets of a single part are then performed concurrently; the ones that involve
+// several parts are performed sequentially afterwards.
+
+typedef robin_hood::unordered_flat_map<MVertex *, int> vertexPartMap;
+
+static double coordinate(const MVertex *v, int dir)
+{
+  return dir == 0 ? v->x() : (dir == 1 ? v->y() : v->z());
+}
+
+static void bisectVertices(std::vector<MVertex *> &v, std::size_t beg,
+                           std::size_t end, int first, int num,
+                           vertexPartMap &parts)
+{
+  if(num == 1) {
+    for(std::size_t i = beg; i < end; i++) parts[v[i]] = first;
+    return;
+  }
+  double bmin[3] = {1e300, 1e300, 1e300}, bmax[3] = {-1e300, -1e300, -1e300};
+  for(std::size_t i = beg; i < end; i++) {
+    for(int k = 0; k < 3; k++) {
+      bmin[k] = std::min(bmin[k], coordinate(v[i], k));
+      bmax[k] = std::max(bmax[k], coordinate(v[i], k));
+    }
+  }
+  int dir = 0;
+  for(int k = 1; k < 3; k++)
+    if(bmax[k] - bmin[k] > bmax[dir] - bmin[dir]) dir = k;
+  int num1 = num / 2;
+  std::size_t mid = beg + (end - beg) * num1 / num;
+  std::nth_element(v.begin() + beg, v.begin() + mid, v.begin() + end,
+                   [dir](const MVertex *a, const MVertex *b) {
+                     double ca = coordinate(a, dir), cb = coordinate(b, dir);
+                     if(ca != cb) return ca < cb;
+                     return a->getNum() < b->getNum();
+                   });
+  bisectVertices(v, beg, mid, first, num1, parts);
+  bisectVertices(v, mid, end, first + num1, num - num1, parts);
+}
+
+static void setTetPart(MTet4 *t, const vertexPartMap &parts)
+{
+  int p = -1;
+  for(int i = 0; i < 4; i++) {
+    auto it = parts.find(t->tet()->getVertex(i));
+    int q = (it == parts.end()) ? -1 : it->second;
+    if(!i)
+      p = q;
+    else if(q != p)
+      p = -1;
+  }
+  t->setPart(p);
+}
+
+// distribute the tets of quality lower than qMin in the parts
+static void splitByPart(const std::vector<MTet4 *> &allTets, double qMin,
+                        std::vector<std::vector<MTet4 *> > &owned,
+                        std::vector<MTet4 *> &shared)
+{
+  for(auto t : allTets) {
+    if(t->isDeleted() || t->getQuality() >= qMin) continue;
+    if(t->getPart() < 0)
+      shared.push_back(t);
+    else
+      owned[t->getPart()].push_back(t);
+  }
+}
+
+static void swapEdges(const std::vector<MTet4 *> &tets, double qMin,
+                      const qmTetrahedron::Measures &qm,
+                      const std::set<MFace, MFaceLessThan> &embeddedFaces,
+                      const std::set<MEdge, MEdgeLessThan> &embeddedEdges,
+                      std::vector<MTet4 *> &newTets, int &nbESwap,
+                      int part = -1, std::vector<MTet4 *> *blocked = nullptr)
+{
+  for(auto t : tets) {
+    if(t->isDeleted() || t->getQuality() >= qMin) continue;
+    bool b = false;
+    for(int i = 0; i < 6; i++) {
+      MEdge ed = t->tet()->getEdge(i);
+      if(embeddedEdges.find(ed) == embeddedEdges.end()) {
+        if(edgeSwap(newTets, t, i, qm, embeddedFaces, part, &b)) {
+          nbESwap++;
+          break;
+        }
+      }
+    }
+    if(b && blocked && !t->isDeleted()) blocked->push_back(t);
+  }
+}
+
+static void
+relocateVertices(const std::vector<MTet4 *> &tets, double qMin,
+                 const qmTetrahedron::Measures &qm, int &nbReloc,
+                 int part = -1,
+                 std::vector<std::pair<MTet4 *, int> > *blocked = nullptr)
+{
+  for(auto t : tets) {
+    if(t->isDeleted() || t->getQuality() >= qMin) continue;
+    for(int i = 0; i < 4; i++) {
+      bool b = false;
+      if(smoothVertex(t, i, qm, part, &b))
+        nbReloc++;
+      else if(b && blocked)
+        blocked->push_back(std::make_pair(t, i));
+    }
+  }
+}
+
 void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
 {
   double qMin = CTX::instance()->mesh.optimizeThreshold;
@@ -905,6 +1025,37 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
     connectTets(allTets.begin(), allTets.end(), &allEmbeddedFaces);
   }
 
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  // partition the mesh for parallel optimization (with parts of at least 10000
+  // nodes); in deterministic mode the number of parts does not depend on the
+  // number of threads, and new elements are renumbered sequentially
+  bool deterministic = CTX::instance()->mesh.optimizeDeterministic;
+  int numParts = 1;
+  vertexPartMap vertexParts;
+  if(nthreads > 1 || deterministic) {
+    std::vector<MVertex *> vertices;
+    for(auto t : allTets) {
+      for(int i = 0; i < 4; i++) {
+        MVertex *v = t->tet()->getVertex(i);
+        if(vertexParts.emplace(v, -1).second) vertices.push_back(v);
+      }
+    }
+    numParts = (int)std::min<std::size_t>(deterministic ? 64 : 4 * nthreads,
+                                          vertices.size() / 10000);
+    if(numParts > 1) {
+      bisectVertices(vertices, 0, vertices.size(), 0, numParts, vertexParts);
+#pragma omp parallel for schedule(dynamic, 10000) num_threads(nthreads)
+      for(std::size_t i = 0; i < allTets.size(); i++)
+        setTetPart(allTets[i], vertexParts);
+      Msg::Info("Optimizing %d parts with %d thread%s", numParts, nthreads,
+                nthreads > 1 ? "s" : "");
+    }
+  }
+
   double t1 = Cpu(), w1 = TimeOfDay();
   std::vector<MTet4 *> illegals;
   const int nbRanges = 10;
@@ -953,26 +1104,58 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
     illegals.clear();
     for(int i = 0; i < nbRanges; i++) quality_ranges[i] = 0;
 
-    for(auto it = allTets.begin(); it != allTets.end(); ++it) {
-      if(!(*it)->isDeleted()) {
+    if(numParts > 1) {
+      std::vector<std::vector<MTet4 *> > owned(numParts), created(numParts),
+        blocked(numParts);
+      std::vector<MTet4 *> shared;
+      splitByPart(allTets, qMin, owned, shared);
+      std::vector<int> nbSwaps(numParts, 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(int p = 0; p < numParts; p++)
+        swapEdges(owned[p], qMin, qm, allEmbeddedFaces, allEmbeddedEdges,
+                  created[p], nbSwaps[p], p, &blocked[p]);
+      for(int p = 0; p < numParts; p++) {
+        newTets.insert(newTets.end(), created[p].begin(), created[p].end());
+        nbESwap += nbSwaps[p];
+      }
+      for(int p = 0; p < numParts; p++)
+        swapEdges(blocked[p], qMin, qm, allEmbeddedFaces, allEmbeddedEdges,
+                  newTets, nbESwap);
+      swapEdges(shared, qMin, qm, allEmbeddedFaces, allEmbeddedEdges, newTets,
+                nbESwap);
+      for(auto it = allTets.begin(); it != allTets.end(); ++it) {
+        if((*it)->isDeleted()) continue;
         double qq = (*it)->getQuality();
-        if(qq < qMin) {
-          for(int i = 0; i < 6; i++) {
-            MEdge ed = (*it)->tet()->getEdge(i);
-            if(allEmbeddedEdges.find(ed) == allEmbeddedEdges.end()) {
-              if(edgeSwap(newTets, *it, i, qm, allEmbeddedFaces)) {
-                nbESwap++;
-                break;
+        if(qq < sliverLimit) illegals.push_back(*it);
+        for(int i = 0; i < nbRanges; i++) {
+          double low = (double)i / nbRanges;
+          double high = (double)(i + 1) / nbRanges;
+          if(qq >= low && qq < high) quality_ranges[i]++;
+        }
+      }
+    }
+    else {
+      for(auto it = allTets.begin(); it != allTets.end(); ++it) {
+        if(!(*it)->isDeleted()) {
+          double qq = (*it)->getQuality();
+          if(qq < qMin) {
+            for(int i = 0; i < 6; i++) {
+              MEdge ed = (*it)->tet()->getEdge(i);
+              if(allEmbeddedEdges.find(ed) == allEmbeddedEdges.end()) {
+                if(edgeSwap(newTets, *it, i, qm, allEmbeddedFaces)) {
+                  nbESwap++;
+                  break;
+                }
               }
             }
           }
-        }
-        if(!(*it)->isDeleted()) {
-          if(qq < sliverLimit) illegals.push_back(*it);
-          for(int i = 0; i < nbRanges; i++) {
-            double low = (double)i / nbRanges;
-            double high = (double)(i + 1) / nbRanges;
-            if(qq >= low && qq < high) quality_ranges[i]++;
+          if(!(*it)->isDeleted()) {
+            if(qq < sliverLimit) illegals.push_back(*it);
+            for(int i = 0; i < nbRanges; i++) {
+              double low = (double)i / nbRanges;
+              double high = (double)(i + 1) / nbRanges;
+              if(qq >= low && qq < high) quality_ranges[i]++;
+            }
           }
         }
       }
@@ -982,7 +1165,15 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
 
     // add all the new tets in the container
     for(std::size_t i = 0; i < newTets.size(); i++) {
-      if(!newTets[i]->isDeleted()) { allTets.push_back(newTets[i]); }
+      if(!newTets[i]->isDeleted()) {
+        if(numParts > 1) {
+          setTetPart(newTets[i], vertexParts);
+          if(deterministic)
+            newTets[i]->tet()->forceNum(
+              GModel::current()->incrementAndGetMaxElementNumber());
+        }
+        allTets.push_back(newTets[i]);
+      }
       else {
         to_delete.insert(newTets[i]->tet());
         delete newTets[i];
@@ -990,7 +1181,27 @@ void optimizeMesh(GRegion *gr, const qmTetrahedron::Measures &qm)
     }
 
     // relocate vertices
-    if(gr->hexahedra.empty() && gr->prisms.empty() && gr->pyramids.empty()) {
+    if(gr->hexahedra.empty() && gr->prisms.empty() && gr->pyramids.empty() &&
+       numParts > 1) {
+      std::vector<std::vector<MTet4 *> > owned(numParts);
+      std::vector<std::vector<std::pair<MTet4 *, int> > > blocked(numParts);
+      std::vector<MTet4 *> shared;
+      splitByPart(allTets, qMin, owned, shared);
+      std::vector<int> nbRelocs(numParts, 0);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+      for(int p = 0; p < numParts; p++)
+        relocateVertices(owned[p], qMin, qm, nbRelocs[p], p, &blocked[p]);
+      for(int p = 0; p < numParts; p++) {
+        nbReloc += nbRelocs[p];
+        for(auto &b : blocked[p]) {
+          if(b.first->getQuality() < qMin && smoothVertex(b.first, b.second, qm))
+            nbReloc++;
+        }
+      }
+      relocateVertices(shared, qMin, qm, nbReloc);
+    }
+    else if(gr->hexahedra.empty() && gr->prisms.empty() &&
+            gr->pyramids.empty()) {
       for(auto it = allTets.begin(); it != allTets.end(); ++it) {
         if(!(*it)->isDeleted()) {
           double qq = (*it)->getQuality();
@@ -1216,12 +1427,37 @@ static void _deleteUnusedVertices(GRegion *gr)
 
 void insertVerticesInRegion(GRegion *gr, int maxIter,
                             double worstTetRadiusTarget, bool _classify,
-                            splitQuadRecovery *sqr)
+                            splitQuadRecovery *sqr,
+                            const std::vector<GRegion *> *regions)
 {
 #ifdef DEBUG_BOUNDARY_RECOVERY
   testIfBoundaryIsRecovered(gr);
 #endif
 
+  // only consider the given regions (and their faces), so that independent
+  // volumes can be refined concurrently
+  std::vector<GRegion *> allRegions;
+  if(regions)
+    allRegions = *regions;
+  else
+    allRegions.insert(allRegions.end(), gr->model()->firstRegion(),
+                      gr->model()->lastRegion());
+  std::set<GFace *, GEntityPtrLessThan> allFaces;
+  if(regions) {
+    for(auto r : allRegions) {
+      std::vector<GFace *> f = r->faces();
+      std::vector<GFace *> const &f_e = r->embeddedFaces();
+      f.insert(f.end(), f_e.begin(), f_e.end());
+      for(auto gf : f) {
+        allFaces.insert(gf);
+        if(gf->compoundSurface) allFaces.insert(gf->compoundSurface);
+      }
+    }
+  }
+  else {
+    allFaces.insert(gr->model()->firstFace(), gr->model()->lastFace());
+  }
+
   std::vector<double> vSizes, vSizesBGM;
   MTet4Factory myFactory(1600000);
   std::set<MTet4 *, compareTet4Ptr> &allTets = myFactory.getAllTets();
@@ -1232,8 +1468,7 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
     std::map<MVertex *, double, MVertexPtrLessThan> vSizesMap;
     std::set<MVertex *, MVertexPtrLessThan> bndVertices;
 
-    for(auto rit = gr->model()->firstRegion(); rit != gr->model()->lastRegion();
-        ++rit) {
+    for(auto rit = allRegions.begin(); rit != allRegions.end(); ++rit) {
       std::vector<GEdge *> const &e = (*rit)->embeddedEdges();
       for(auto it = e.begin(); it != e.end(); ++it) {
         for(std::size_t i = 0; i < (*it)->lines.size(); i++) {
@@ -1254,8 +1489,7 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
       }
     }
 
-    for(auto rit = gr->model()->firstRegion(); rit != gr->model()->lastRegion();
-        ++rit) {
+    for(auto rit = allRegions.begin(); rit != allRegions.end(); ++rit) {
       std::vector<GVertex *> const &vertices = (*rit)->embeddedVertices();
       for(auto it = vertices.begin(); it != vertices.end(); ++it) {
         MVertex *v = (*it)->getMeshVertex(0);
@@ -1265,8 +1499,7 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
       }
     }
 
-    for(auto it = gr->model()->firstFace(); it != gr->model()->lastFace();
-        ++it) {
+    for(auto it = allFaces.begin(); it != allFaces.end(); ++it) {
       GFace *gf = *it;
       for(std::size_t i = 0; i < gf->triangles.size(); i++) {
         setLcs(gf->triangles[i], vSizesMap, bndVertices);
@@ -1296,7 +1529,8 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
 
   if(_classify) {
     fs_cont search;
-    buildFaceSearchStructure(gr->model(), search, true); // only triangles
+    buildFaceSearchStructure(gr->model(), search, true, // only triangles
+                             regions);
     if(sqr) search.insert(sqr->getTri().begin(), sqr->getTri().end());
 
     for(auto it = allTets.begin(); it != allTets.end(); ++it) {
@@ -1312,7 +1546,7 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
         Msg::Debug("Found %d tets with %d faces (Wall %gs, CPU %gs)",
                    theRegion.size(), faces_bound.size(), _w2 - _w1, _t2 - _t1);
         GRegion *myGRegion =
-          getRegionFromBoundingFaces(gr->model(), faces_bound);
+          getRegionFromBoundingFaces(gr->model(), faces_bound, regions);
         if(myGRegion && myGRegion->tetrahedra.empty()) {
           // a geometrical region (with no mesh) associated to the list of faces
           // has been found
@@ -1357,14 +1591,12 @@ void insertVerticesInRegion(GRegion *gr, int maxIter,
   // store all embedded edges and faces
   std::set<MFace, MFaceLessThan> allEmbeddedFaces;
   std::size_t N = 0;
-  for(auto it = gr->model()->firstRegion(); it != gr->model()->lastRegion();
-      ++it) {
+  for(auto it = allRegions.begin(); it != allRegions.end(); ++it) {
     for(auto e : (*it)->embeddedEdges())
       N += e->getNumMeshElements();
   }
   edgeContainerB allEmbeddedEdges(N);
-  for(auto it = gr->model()->firstRegion(); it != gr->model()->lastRegion();
-      ++it) {
+  for(auto it = allRegions.begin(); it != allRegions.end(); ++it) {
     createAllEmbeddedFaces((*it), allEmbeddedFaces);
     createAllEmbeddedEdges((*it), allEmbeddedEdges);
   }
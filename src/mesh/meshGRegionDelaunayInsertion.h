@@ -48,6 +48,7 @@ class MTet4 {
 
 private:
   bool deleted;
+  int part; // used to optimize the mesh in parallel (-1 if not in a part)
   double circum_radius;
   MTetrahedron *base;
   MTet4 *neigh[4];
@@ -56,17 +57,18 @@ private:
 public:
   static int radiusNorm; // 2 is euclidian norm, -1 is infinite norm
   ~MTet4() {}
-  MTet4() : deleted(false), circum_radius(0.0), base(nullptr), gr(nullptr)
+  MTet4()
+    : deleted(false), part(-1), circum_radius(0.0), base(nullptr), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, double qual)
-    : deleted(false), circum_radius(qual), base(t), gr(nullptr)
+    : deleted(false), part(-1), circum_radius(qual), base(t), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
   }
   MTet4(MTetrahedron *t, const qmTetrahedron::Measures &qm)
-    : deleted(false), base(t), gr(nullptr)
+    : deleted(false), part(-1), base(t), gr(nullptr)
   {
     neigh[0] = neigh[1] = neigh[2] = neigh[3] = nullptr;
     double vol;
@@ -192,6 +194,8 @@ public:
     return std::abs(robustPredicates::orient3d(pa, pb, pc, pd)) / 6.0;
   }
   void setDeleted(bool const d) { deleted = d; }
+  int getPart() const { return part; }
+  void setPart(int p) { part = p; }
   bool assertNeigh() const
   {
     if(deleted) return true;
@@ -215,7 +219,8 @@ void delaunayMeshIn3D(std::vector<MVertex *> &, std::vector<MTetrahedron *> &,
                       bool removeBox = false);
 void insertVerticesInRegion(GRegion *gr, int maxIter,
                             double worstTetRadiusTarget, bool _classify = true,
-                            splitQuadRecovery *sqr = nullptr);
+                            splitQuadRecovery *sqr = nullptr,
+                            const std::vector<GRegion *> *regions = nullptr);
 void bowyerWatsonFrontalLayers(GRegion *gr, bool hex);
 
 struct compareTet4Ptr {
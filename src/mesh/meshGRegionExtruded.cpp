@@ -17,7 +17,7 @@
 #include "meshGFace.h"
 #include "meshGRegion.h"
 #include "Context.h"
-#include "MVertexRTree.h"
+#include "MVertexHashGrid.h"
 
 #if defined(HAVE_QUADTRI)
 #include "QuadTriExtruded3D.h"
@@ -126,7 +126,8 @@ static void createTet(MVertex *v1, MVertex *v2, MVertex *v3, MVertex *v4,
 }
 
 static int getExtrudedVertices(MElement *ele, ExtrudeParams *ep, int j, int k,
-                               MVertexRTree &pos, std::vector<MVertex *> &verts)
+                               MVertexHashGrid &pos,
+                               std::vector<MVertex *> &verts)
 {
   double x[8], y[8], z[8];
   int n = ele->getNumVertices();
@@ -151,7 +152,7 @@ static int getExtrudedVertices(MElement *ele, ExtrudeParams *ep, int j, int k,
   return verts.size();
 }
 
-static void extrudeMesh(GFace *from, GRegion *to, MVertexRTree &pos)
+static void extrudeMesh(GFace *from, GRegion *to, MVertexHashGrid &pos)
 {
   ExtrudeParams *ep = to->meshAttributes.extrude;
 
@@ -234,7 +235,7 @@ static void extrudeMesh(GFace *from, GRegion *to, MVertexRTree &pos)
   }
 }
 
-static void insertAllVertices(GRegion *gr, MVertexRTree &pos)
+static void insertAllVertices(GRegion *gr, MVertexHashGrid &pos)
 {
   pos.insert(gr->mesh_vertices);
   std::vector<MVertex *> embedded = gr->getEmbeddedMeshVertices();
@@ -271,8 +272,8 @@ void meshGRegionExtruded::operator()(GRegion *gr)
   deMeshGRegion dem;
   dem(gr);
 
-  // build an rtree with all the vertices on the boundary of gr
-  MVertexRTree pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
+  // build a hash grid with all the vertices on the boundary of gr
+  MVertexHashGrid pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
   insertAllVertices(gr, pos);
 
   // volume is extruded from a surface
@@ -314,7 +315,7 @@ static void deleteEdge(MVertex *v1, MVertex *v2,
 }
 
 // subdivide the 3 lateral faces of each prism
-static void phase1(GRegion *gr, MVertexRTree &pos,
+static void phase1(GRegion *gr, MVertexHashGrid &pos,
                    std::set<std::pair<MVertex *, MVertex *> > &edges, int ntry)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
@@ -352,7 +353,7 @@ static void phase1(GRegion *gr, MVertexRTree &pos,
 }
 
 // modify lateral edges to make them "tet-compatible"
-static void phase2(GRegion *gr, MVertexRTree &pos,
+static void phase2(GRegion *gr, MVertexHashGrid &pos,
                    std::set<std::pair<MVertex *, MVertex *> > &edges,
                    std::set<std::pair<MVertex *, MVertex *> > &edges_swap,
                    int &swap)
@@ -418,7 +419,7 @@ static void phase2(GRegion *gr, MVertexRTree &pos,
 }
 
 // create tets
-static void phase3(GRegion *gr, MVertexRTree &pos,
+static void phase3(GRegion *gr, MVertexHashGrid &pos,
                    std::set<std::pair<MVertex *, MVertex *> > &edges)
 {
   ExtrudeParams *ep = gr->meshAttributes.extrude;
@@ -487,7 +488,7 @@ int SubdivideExtrudedMesh(GModel *m)
   std::vector<GRegion *> regions_quadToTri;
 #endif
 
-  MVertexRTree pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
+  MVertexHashGrid pos(CTX::instance()->geom.tolerance * CTX::instance()->lc);
   for(auto it = m->firstRegion(); it != m->lastRegion(); it++) {
     ExtrudeParams *ep = (*it)->meshAttributes.extrude;
     if(ep && ep->mesh.ExtrudeMesh && ep->geo.Mode == EXTRUDED_ENTITY &&
@@ -608,8 +609,8 @@ int SubdivideExtrudedMesh(GModel *m)
   // won't mesh the region (should already be done in ExtrudeMesh).
   for(std::size_t i = 0; i < regions_quadToTri.size(); i++) {
     GRegion *gr = regions_quadToTri[i];
-    MVertexRTree pos_local(CTX::instance()->geom.tolerance *
-                           CTX::instance()->lc);
+    MVertexHashGrid pos_local(CTX::instance()->geom.tolerance *
+                              CTX::instance()->lc);
     insertAllVertices(gr, pos_local);
     meshQuadToTriRegionAfterGlobalSubdivide(gr, &edges, pos_local);
   }
@@ -5,6 +5,8 @@
 
 #include <map>
 #include <set>
+#include <atomic>
+#include <algorithm>
 #include <stdexcept>
 
 #include "GmshConfig.h"
@@ -21,6 +23,7 @@
 #include "GmshMessage.h"
 #include "BackgroundMeshTools.h"
 #include "OS.h"
+#include "robin_hood.h"
 
 #if defined(HAVE_HXT)
 
@@ -55,26 +58,47 @@ static HXTStatus nodalSizesCallBack(double *pts, uint32_t *volume,
 
   HXT_INFO("Computing %smesh sizes...", useInterpolatedSize ? "interpolated " : "");
 
+  // the points are processed in chunks, each chunk being split into runs of
+  // consecutive points in the same volume, on which the size field is
+  // evaluated at once
+  const size_t chunkSize = 1024;
+  size_t numChunks = (numPts + chunkSize - 1) / chunkSize;
   int nthreads = getNumThreads();
   bool exceptions = false;
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-  for(size_t i = 0; i < numPts; i++) {
+  for(size_t c = 0; c < numChunks; c++) {
     if(exceptions) continue;
-    if(volume[i] < 0 || volume[i] >= allGR->size()) {
-      Msg::Error("Invalid volume tag %d in mesh size calculation", volume[i]);
-      continue;
-    }
-    GRegion *gr = (*allGR)[volume[i]];
-    try{ // OpenMP forbids leaving block via exception
-      double lc = BGM_MeshSizeWithoutScaling(gr, 0, 0, pts[4 * i + 0],
-                                             pts[4 * i + 1], pts[4 * i + 2]);
-      if(useInterpolatedSize && pts[4 * i + 3] > 0.0)
-        pts[4 * i + 3] = std::min(pts[4 * i + 3], std::min(lcGlob, lc));
-      else
-        pts[4 * i + 3] = std::min(lcGlob, lc);
-    }
-    catch(...) {
-      exceptions = true;
+    std::vector<double> U(chunkSize, 0.), X(chunkSize), Y(chunkSize),
+      Z(chunkSize), lc(chunkSize);
+    size_t end = std::min(numPts, (c + 1) * chunkSize);
+    size_t i = c * chunkSize;
+    while(i < end) {
+      if(volume[i] >= allGR->size()) {
+        Msg::Error("Invalid volume tag %d in mesh size calculation", volume[i]);
+        i++;
+        continue;
+      }
+      size_t n = 0;
+      while(i + n < end && volume[i + n] == volume[i]) {
+        X[n] = pts[4 * (i + n) + 0];
+        Y[n] = pts[4 * (i + n) + 1];
+        Z[n] = pts[4 * (i + n) + 2];
+        n++;
+      }
+      GRegion *gr = (*allGR)[volume[i]];
+      try { // OpenMP forbids leaving block via exception
+        BGM_MeshSizeWithoutScaling(gr, n, &U[0], &U[0], &X[0], &Y[0], &Z[0],
+                                   &lc[0]);
+      } catch(...) {
+        exceptions = true;
+        break;
+      }
+      for(size_t j = 0; j < n; j++, i++) {
+        if(useInterpolatedSize && pts[4 * i + 3] > 0.0)
+          pts[4 * i + 3] = std::min(pts[4 * i + 3], std::min(lcGlob, lc[j]));
+        else
+          pts[4 * i + 3] = std::min(lcGlob, lc[j]);
+      }
     }
   }
 
@@ -186,7 +210,6 @@ static HXTStatus getAllCurves(std::vector<GRegion *> &regions,
 }
 
 static HXTStatus Hxt2Gmsh(std::vector<GRegion *> &regions, HXTMesh *m,
-                          std::map<MVertex *, uint32_t> &v2c,
                           std::vector<MVertex *> &c2v)
 {
   Msg::Debug("Start Hxt2Gmsh");
@@ -284,153 +307,97 @@ static HXTStatus Hxt2Gmsh(std::vector<GRegion *> &regions, HXTMesh *m,
   HXT_CHECK( hxtAlignedFree(&m->triangles.node) );
   HXT_CHECK( hxtAlignedFree(&m->triangles.color) );
 
-#if defined(_OPENMP)
+  // The HXT arrays are released as soon as they have been converted, so that
+  // the peak memory stays close to the size of one copy of the volume mesh.
+  // Each new node is classified on the volume of the first tetrahedron that
+  // contains it, and nodes are stored in each volume by increasing index, so
+  // that the result does not depend on the number of threads.
   int nthreads = getNumThreads();
-  if(nthreads > 1) {
-    const uint32_t nR = regions.size();
-    const uint32_t nV = m->vertices.num;
-
-    size_t* ht_all, *ht_tot; // histograms for tets
-    HXT_CHECK( hxtCalloc(&ht_all, nR * (nthreads + 1), sizeof(size_t)) );
-    uint32_t* hp_all, *hp_tot; // histograms for points
-    HXT_CHECK( hxtCalloc(&hp_all, nR * (nthreads + 1) * 3 + (size_t) nV * nthreads,
-                         sizeof(uint32_t)) );
-    uint32_t* vR_all = hp_all + nR * (nthreads + 1); // color per point and per thread
-
-    #pragma omp parallel num_threads(nthreads)
-    {
-      #pragma omp single
-      {
-        nthreads = omp_get_num_threads(); /* the real number of threads */
-        ht_tot = ht_all + nR * nthreads;
-        hp_tot = hp_all + nR * nthreads;
-      }
-
-      int threadID = omp_get_thread_num();
-      size_t* ht_this = ht_all + nR * threadID;
-      uint32_t* hp_this = hp_all + nR * threadID;
-      uint32_t* vR_this = vR_all + nV * threadID;
-
-      // count the number of tetrahedra in each region in parallel
-      #pragma omp for schedule(static)
-      for(size_t i = 0; i < m->tetrahedra.num; i++) {
-        uint32_t c = m->tetrahedra.color[i];
-        if(c >= nR) continue;
-
-        ht_this[c]++;
-        uint32_t *nodes = &m->tetrahedra.node[4 * i];
-        for(int j = 0; j < 4; j++) {
-          uint32_t pt = nodes[j];
-          if(!c2v[pt])
-            vR_this[pt] = c + 1;
-        }
-      }
-
-      #pragma omp for schedule(static)
-      for(uint32_t pt = 0; pt < nV; pt++) {
-        if(c2v[pt]) continue;
-
-        uint32_t color = 0;
-        for(int thrd = 0; thrd < nthreads; thrd++) {
-          if(vR_all[thrd * nV + pt]) {
-            color = vR_all[thrd * nV + pt];
-            break;
-          }
-        }
-        color--;
-  #ifdef DEBUG
-        if(color >= nR)
-          exit(HXT_ERROR_MSG(HXT_STATUS_ERROR, "no volume or color for pt %u", pt));
-  #endif
-        vR_all[pt] = color;
-        hp_this[color]++;
-      }
-
-      #pragma omp for
-      for(uint32_t c2 = 0; c2 < 2 * nR; c2++) { // parallelism x 2 :p
-        uint32_t c = c2 >> 1;
-        if(c2 & 1) {
-          size_t sumt = 0;
-          for(int j = 0; j < nthreads + 1; j++) {
-            size_t tsumt = ht_all[j * nR + c] + sumt;
-            ht_all[j * nR + c] = sumt;
-            sumt = tsumt;
-          }
-          regions[c]->tetrahedra.resize(ht_tot[c], nullptr);
-        }
-        else {
-          uint32_t sump = 0;
-          for(int j = 0; j < nthreads + 1; j++) {
-            uint32_t tsump = hp_all[j * nR + c] + sump;
-            hp_all[j * nR + c] = sump;
-            sump = tsump;
-          }
-          regions[c]->mesh_vertices.resize(hp_tot[c], nullptr);
-        }
-      }
-
-      #pragma omp for schedule(static)
-      for(uint32_t pt = 0; pt < nV; pt++) {
-        if(c2v[pt]) continue;
-
-        uint32_t c = vR_all[pt];
-        GRegion *gr = regions[c];
-        double *x = &m->vertices.coord[4 * pt];
-        c2v[pt] = new MVertex(x[0], x[1], x[2], gr);
-        gr->mesh_vertices[hp_this[c]++] = c2v[pt];
-      }
-
-
-      #pragma omp for schedule(static)
-      for(size_t i = 0; i < m->tetrahedra.num; i++) {
-        uint32_t c = m->tetrahedra.color[i];
-        if(c >= nR) continue;
-
-        uint32_t *nodes = &m->tetrahedra.node[4 * i];
-        regions[c]->tetrahedra[ht_this[c]++] = new MTetrahedron
-          (c2v[nodes[0]], c2v[nodes[1]], c2v[nodes[2]], c2v[nodes[3]]);
-      }
+  const uint32_t nR = regions.size();
+  const uint32_t nV = m->vertices.num;
+  const uint64_t nT = m->tetrahedra.num;
+
+  std::vector<std::atomic<uint64_t> > first(nV);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(uint32_t pt = 0; pt < nV; pt++) first[pt] = UINT64_MAX;
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for(uint64_t i = 0; i < nT; i++) {
+    if(m->tetrahedra.color[i] >= nR) continue;
+    uint32_t *nodes = &m->tetrahedra.node[4 * i];
+    for(int j = 0; j < 4; j++) {
+      if(c2v[nodes[j]]) continue;
+      uint64_t old = first[nodes[j]];
+      while(i < old && !first[nodes[j]].compare_exchange_weak(old, i)) {}
     }
-
-    HXT_CHECK( hxtFree(&ht_all) );
-    HXT_CHECK( hxtFree(&hp_all) );
   }
-  else
-#endif
-  {
-    for(size_t i = 0; i < m->tetrahedra.num; i++) {
-      uint16_t c = m->tetrahedra.color[i];
-      if(c >= regions.size())
-        continue;
 
-      GRegion *gr = regions[c];
-      MVertex *vv[4];
-      uint32_t *nodes = &m->tetrahedra.node[4 * i];
-      for(int j = 0; j < 4; j++) {
-        if(c2v[nodes[j]]){
-          vv[j] = c2v[nodes[j]];
-          continue;
+  // count the nodes and the tetrahedra in each volume for each chunk (one per
+  // thread) of the static schedule, to compute where each chunk writes
+  std::vector<uint64_t> ht(nR * (nthreads + 1), 0), hp(nR * (nthreads + 1), 0);
+#pragma omp parallel num_threads(nthreads)
+  {
+    int nt = Msg::GetNumThreads(), t = Msg::GetThreadNum();
+    uint64_t *ht_this = &ht[nR * t], *hp_this = &hp[nR * t];
+    uint64_t chunk = (nT + nt - 1) / nt;
+    for(uint64_t i = t * chunk; i < std::min(nT, (t + 1) * chunk); i++) {
+      uint32_t c = m->tetrahedra.color[i];
+      if(c < nR) ht_this[c]++;
+    }
+    uint64_t chunkV = ((uint64_t)nV + nt - 1) / nt;
+    for(uint64_t pt = t * chunkV; pt < std::min((uint64_t)nV, (t + 1) * chunkV);
+        pt++) {
+      if(c2v[pt] || first[pt] == UINT64_MAX) continue;
+      hp_this[m->tetrahedra.color[first[pt]]]++;
+    }
+#pragma omp barrier
+#pragma omp single
+    {
+      for(uint32_t c = 0; c < nR; c++) {
+        uint64_t sumt = 0, sump = 0;
+        for(int j = 0; j < nt; j++) {
+          uint64_t tt = ht[j * nR + c], tp = hp[j * nR + c];
+          ht[j * nR + c] = sumt;
+          hp[j * nR + c] = sump;
+          sumt += tt;
+          sump += tp;
         }
-
-        double *x = &m->vertices.coord[4 * nodes[j]];
-        vv[j] = new MVertex(x[0], x[1], x[2], gr);
-        gr->mesh_vertices.push_back(vv[j]);
-        c2v[nodes[j]] = vv[j];
+        regions[c]->tetrahedra.resize(sumt, nullptr);
+        regions[c]->mesh_vertices.resize(sump, nullptr);
       }
-
-      gr->tetrahedra.push_back(new MTetrahedron(vv[0], vv[1], vv[2], vv[3]));
+    }
+    for(uint64_t pt = t * chunkV; pt < std::min((uint64_t)nV, (t + 1) * chunkV);
+        pt++) {
+      if(c2v[pt] || first[pt] == UINT64_MAX) continue;
+      uint32_t c = m->tetrahedra.color[first[pt]];
+      double *x = &m->vertices.coord[4 * pt];
+      c2v[pt] = new MVertex(x[0], x[1], x[2], regions[c]);
+      regions[c]->mesh_vertices[hp_this[c]++] = c2v[pt];
+    }
+#pragma omp barrier
+#pragma omp single
+    {
+      std::vector<std::atomic<uint64_t> >().swap(first);
+      hxtAlignedFree(&m->vertices.coord);
+    }
+    for(uint64_t i = t * chunk; i < std::min(nT, (t + 1) * chunk); i++) {
+      uint32_t c = m->tetrahedra.color[i];
+      if(c >= nR) continue;
+      uint32_t *nodes = &m->tetrahedra.node[4 * i];
+      regions[c]->tetrahedra[ht_this[c]++] = new MTetrahedron(
+        c2v[nodes[0]], c2v[nodes[1]], c2v[nodes[2]], c2v[nodes[3]]);
     }
   }
+  HXT_CHECK(hxtAlignedFree(&m->tetrahedra.node));
+  HXT_CHECK(hxtAlignedFree(&m->tetrahedra.color));
 
   Msg::Debug("End Hxt2Gmsh");
   return HXT_STATUS_OK;
 }
 
 HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
-                   std::map<MVertex *, uint32_t> &v2c,
                    std::vector<MVertex *> &c2v)
 {
-  std::set<MVertex *, MVertexPtrLessThan> all;
   std::vector<GFace *> surfaces;
   std::vector<GEdge *> curves;
   std::vector<GVertex *> points;
@@ -439,69 +406,85 @@ HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
   HXT_CHECK(getAllSurfaces(regions, m, surfaces));
   HXT_CHECK(getAllCurves(regions, surfaces, m, curves));
 
-  uint64_t index = 0, ntri = 0, nedg = 0, npts = 0;
+  int nthreads = getNumThreads();
+  uint64_t ntri = 0, nedg = 0, npts = 0;
 
   // embedded points in volumes (all other embedded points will be in the
   // curve/surface meshes already)
+  c2v.clear();
   for(GRegion *gr : regions) {
     for(GVertex *gv : gr->embeddedVertices()) {
       points.push_back(gv);
       npts += gv->points.size();
       for(size_t i = 0; i < gv->points.size(); i++) {
         MVertex *v = gv->points[i]->getVertex(0);
-        all.insert(v);
+        c2v.push_back(v);
         if(gv->prescribedMeshSizeAtVertex() != MAX_LC)
           vlc[v] = gv->prescribedMeshSizeAtVertex();
       }
     }
   }
 
+  // offsets of the elements of each curve and surface in the HXT arrays
+  std::vector<uint64_t> curveOffset(curves.size());
   for(size_t j = 0; j < curves.size(); j++) {
     GEdge *ge = curves[j];
+    curveOffset[j] = nedg;
     nedg += ge->lines.size();
     for(size_t i = 0; i < ge->lines.size(); i++) {
-      all.insert(ge->lines[i]->getVertex(0));
-      all.insert(ge->lines[i]->getVertex(1));
+      c2v.push_back(ge->lines[i]->getVertex(0));
+      c2v.push_back(ge->lines[i]->getVertex(1));
     }
   }
 
+  std::vector<uint64_t> surfaceOffset(surfaces.size());
+  for(size_t j = 0; j < surfaces.size(); j++) {
+    surfaceOffset[j] = ntri;
+    ntri += surfaces[j]->triangles.size();
+  }
+  c2v.reserve(c2v.size() + 3 * ntri);
   for(size_t j = 0; j < surfaces.size(); j++) {
     GFace *gf = surfaces[j];
-    ntri += gf->triangles.size();
     for(size_t i = 0; i < gf->triangles.size(); i++) {
-      all.insert(gf->triangles[i]->getVertex(0));
-      all.insert(gf->triangles[i]->getVertex(1));
-      all.insert(gf->triangles[i]->getVertex(2));
+      c2v.push_back(gf->triangles[i]->getVertex(0));
+      c2v.push_back(gf->triangles[i]->getVertex(1));
+      c2v.push_back(gf->triangles[i]->getVertex(2));
     }
   }
 
-  m->vertices.num = m->vertices.size = all.size();
+  // number the nodes by increasing tag (so that the HXT mesh does not depend
+  // on the memory layout), and index them with a hash table instead of a tree
+  std::sort(c2v.begin(), c2v.end(), MVertexPtrLessThan());
+  c2v.erase(std::unique(c2v.begin(), c2v.end()), c2v.end());
+  c2v.shrink_to_fit();
+  robin_hood::unordered_flat_map<MVertex *, uint32_t> v2c;
+  v2c.reserve(c2v.size());
+  for(size_t i = 0; i < c2v.size(); i++) v2c.emplace(c2v[i], (uint32_t)i);
+
+  m->vertices.num = m->vertices.size = c2v.size();
   HXT_CHECK(
     hxtAlignedMalloc(&m->vertices.coord, 4 * m->vertices.num * sizeof(double)));
 
-  size_t count = 0;
-  c2v.resize(all.size());
-  for(MVertex *v : all) {
-    m->vertices.coord[4 * count + 0] = v->x();
-    m->vertices.coord[4 * count + 1] = v->y();
-    m->vertices.coord[4 * count + 2] = v->z();
-    m->vertices.coord[4 * count + 3] = 0;
-    if(CTX::instance()
-         ->mesh.lcFromPoints) { // size on embedded points in volume
+  const bool lcFromPoints = CTX::instance()->mesh.lcFromPoints;
+#pragma omp parallel for num_threads(nthreads)
+  for(size_t i = 0; i < c2v.size(); i++) {
+    MVertex *v = c2v[i];
+    m->vertices.coord[4 * i + 0] = v->x();
+    m->vertices.coord[4 * i + 1] = v->y();
+    m->vertices.coord[4 * i + 2] = v->z();
+    m->vertices.coord[4 * i + 3] = 0;
+    if(lcFromPoints && !vlc.empty()) { // size on embedded points in volume
       auto it = vlc.find(v);
-      if(it != vlc.end()) m->vertices.coord[4 * count + 3] = it->second;
+      if(it != vlc.end()) m->vertices.coord[4 * i + 3] = it->second;
     }
-    v2c[v] = count;
-    c2v[count++] = v;
   }
-  all.clear();
 
   m->points.num = m->points.size = npts;
   HXT_CHECK(
     hxtAlignedMalloc(&m->points.node, (m->points.num) * sizeof(uint32_t)));
   HXT_CHECK(
     hxtAlignedMalloc(&m->points.color, (m->points.num) * sizeof(uint32_t)));
-  index = 0;
+  uint64_t index = 0;
   for(size_t j = 0; j < points.size(); j++) {
     GVertex *gv = points[j];
     for(size_t i = 0; i < gv->points.size(); i++) {
@@ -511,19 +494,23 @@ HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
     }
   }
 
+  // the hash table is only read from now on, so the element arrays can be
+  // filled concurrently
   m->lines.num = m->lines.size = nedg;
   HXT_CHECK(
     hxtAlignedMalloc(&m->lines.node, (m->lines.num) * 2 * sizeof(uint32_t)));
   HXT_CHECK(
     hxtAlignedMalloc(&m->lines.color, (m->lines.num) * sizeof(uint32_t)));
-  index = 0;
   for(size_t j = 0; j < curves.size(); j++) {
     GEdge *ge = curves[j];
+    const uint64_t offset = curveOffset[j];
+#pragma omp parallel for num_threads(nthreads)
     for(size_t i = 0; i < ge->lines.size(); i++) {
-      m->lines.node[2 * index + 0] = v2c[ge->lines[i]->getVertex(0)];
-      m->lines.node[2 * index + 1] = v2c[ge->lines[i]->getVertex(1)];
-      m->lines.color[index] = ge->tag();
-      index++;
+      m->lines.node[2 * (offset + i) + 0] =
+        v2c.find(ge->lines[i]->getVertex(0))->second;
+      m->lines.node[2 * (offset + i) + 1] =
+        v2c.find(ge->lines[i]->getVertex(1))->second;
+      m->lines.color[offset + i] = ge->tag();
     }
   }
 
@@ -532,15 +519,15 @@ HXTStatus Gmsh2Hxt(std::vector<GRegion *> &regions, HXTMesh *m,
                              (m->triangles.num) * 3 * sizeof(uint32_t)));
   HXT_CHECK(hxtAlignedMalloc(&m->triangles.color,
                              (m->triangles.num) * sizeof(uint32_t)));
-  index = 0;
   for(size_t j = 0; j < surfaces.size(); j++) {
     GFace *gf = surfaces[j];
+    const uint64_t offset = surfaceOffset[j];
+#pragma omp parallel for num_threads(nthreads)
     for(size_t i = 0; i < gf->triangles.size(); i++) {
-      m->triangles.node[3 * index + 0] = v2c[gf->triangles[i]->getVertex(0)];
-      m->triangles.node[3 * index + 1] = v2c[gf->triangles[i]->getVertex(1)];
-      m->triangles.node[3 * index + 2] = v2c[gf->triangles[i]->getVertex(2)];
-      m->triangles.color[index] = gf->tag();
-      index++;
+      for(int k = 0; k < 3; k++)
+        m->triangles.node[3 * (offset + i) + k] =
+          v2c.find(gf->triangles[i]->getVertex(k))->second;
+      m->triangles.color[offset + i] = gf->tag();
     }
   }
   return HXT_STATUS_OK;
@@ -553,9 +540,8 @@ static HXTStatus _meshGRegionHxt(std::vector<GRegion *> &regions)
   HXTMesh *mesh;
   HXT_CHECK(hxtMeshCreate(&mesh));
 
-  std::map<MVertex *, uint32_t> v2c;
   std::vector<MVertex *> c2v;
-  Gmsh2Hxt(regions, mesh, v2c, c2v);
+  HXT_CHECK(Gmsh2Hxt(regions, mesh, c2v));
 
   int nthreads = getNumThreads();
 
@@ -587,7 +573,7 @@ static HXTStatus _meshGRegionHxt(std::vector<GRegion *> &regions)
 
   HXT_CHECK(hxtTetMesh(mesh, &options));
 
-  HXT_CHECK(Hxt2Gmsh(regions, mesh, v2c, c2v));
+  HXT_CHECK(Hxt2Gmsh(regions, mesh, c2v));
   HXT_CHECK(hxtMeshDelete(&mesh));
   return HXT_STATUS_OK;
 }
@@ -11,6 +11,8 @@
 #include "MHexahedron.h"
 #include "MPrism.h"
 #include "MPyramid.h"
+#include "Context.h"
+#include "robin_hood.h"
 
 typedef struct {
   int nbr_triangles; // number of different triangles
@@ -58,10 +60,20 @@ void computeNeighboringTetsOfACavity(const std::vector<MTet4 *> &cavity,
   }
 }
 
+// if part >= 0, the cavity (and its neighbors) must only contain tets from
+// this part: otherwise the construction stops, and blocked is set
+static bool inOtherPart(const MTet4 *t, int part, bool *blocked)
+{
+  if(part < 0 || !t || t->getPart() == part) return false;
+  if(blocked) *blocked = true;
+  return true;
+}
+
 bool buildEdgeCavity(MTet4 *t, int iLocalEdge, MVertex **v1, MVertex **v2,
                      std::vector<MTet4 *> &cavity,
                      std::vector<MTet4 *> &outside,
-                     std::vector<MVertex *> &ring)
+                     std::vector<MVertex *> &ring, int part = -1,
+                     bool *blocked = nullptr)
 {
   cavity.clear();
   ring.clear();
@@ -98,6 +110,7 @@ bool buildEdgeCavity(MTet4 *t, int iLocalEdge, MVertex **v1, MVertex **v2,
     }
     t = t->getNeigh(iFace);
     if(!t) return false;
+    if(inOtherPart(t, part, blocked)) return false;
     if(t->isDeleted()) {
       Msg::Warning("Strange edge cavity (tet is deleted)");
       return false;
@@ -126,6 +139,8 @@ bool buildEdgeCavity(MTet4 *t, int iLocalEdge, MVertex **v1, MVertex **v2,
     // printf("%d %d\n",ITER++, cavity.size());
   }
   computeNeighboringTetsOfACavity(cavity, outside);
+  for(std::size_t i = 0; i < outside.size(); i++)
+    if(inOtherPart(outside[i], part, blocked)) return false;
   return true;
 }
 
@@ -236,7 +251,8 @@ void BuildSwapPattern7(SwapPattern *sc)
 
 bool edgeSwap(std::vector<MTet4 *> &newTets, MTet4 *tet, int iLocalEdge,
               const qmTetrahedron::Measures &cr,
-              const std::set<MFace, MFaceLessThan> &embeddedFaces)
+              const std::set<MFace, MFaceLessThan> &embeddedFaces, int part,
+              bool *blocked)
 {
   // static int edges[6][2] =    {{0,1},{0,2},{0,3},{1,2},{1,3},{2,3}};
   int permut[6] = {0, 3, 1, 2, 5, 4};
@@ -248,8 +264,8 @@ bool edgeSwap(std::vector<MTet4 *> &newTets, MTet4 *tet, int iLocalEdge,
   MVertex *v1, *v2;
 
   //  printf("a\n");
-  bool closed =
-    buildEdgeCavity(tet, iLocalEdge, &v1, &v2, cavity, outside, ring);
+  bool closed = buildEdgeCavity(tet, iLocalEdge, &v1, &v2, cavity, outside,
+                                ring, part, blocked);
   //  printf("b\n");
 
   if(!closed) return false;
@@ -339,6 +355,8 @@ bool edgeSwap(std::vector<MTet4 *> &newTets, MTet4 *tet, int iLocalEdge,
     MTet4 *t42 = new MTet4(tr2, tetQuality2[iT]);
     t41->setOnWhat(cavity[0]->onWhat());
     t42->setOnWhat(cavity[0]->onWhat());
+    t41->setPart(part);
+    t42->setPart(part);
     outside.push_back(t41);
     outside.push_back(t42);
     newTets.push_back(t41);
@@ -482,7 +500,8 @@ bool faceSwap(std::vector<MTet4 *> &newTets, MTet4 *t1, int iLocalFace,
   return true;
 }
 
-bool buildVertexCavity_recur(MTet4 *t, MVertex *v, std::vector<MTet4 *> &cavity)
+bool buildVertexCavity_recur(MTet4 *t, MVertex *v, std::vector<MTet4 *> &cavity,
+                             int part = -1, bool *blocked = nullptr)
 {
   if(t->isDeleted()) {
     Msg::Warning("A deleted tet is a neighbor of a non deleted tet"
@@ -503,6 +522,7 @@ bool buildVertexCavity_recur(MTet4 *t, MVertex *v, std::vector<MTet4 *> &cavity)
   }
   for(int i = 0; i < 3; i++) {
     MTet4 *neigh = t->getNeigh(vFac[iV][i]);
+    if(inOtherPart(neigh, part, blocked)) return false;
     if(neigh) {
       bool found = false;
       for(std::size_t j = 0; j < cavity.size(); j++) {
@@ -513,7 +533,7 @@ bool buildVertexCavity_recur(MTet4 *t, MVertex *v, std::vector<MTet4 *> &cavity)
       }
       if(!found) {
         cavity.push_back(neigh);
-        if(!buildVertexCavity_recur(neigh, v, cavity))
+        if(!buildVertexCavity_recur(neigh, v, cavity, part, blocked))
           return false;
       }
     }
@@ -621,7 +641,8 @@ bool collapseVertex(std::vector<MTet4 *> &newTets, MTet4 *t, int iVertex,
   return true;
 }
 
-bool smoothVertex(MTet4 *t, int iVertex, const qmTetrahedron::Measures &cr)
+bool smoothVertex(MTet4 *t, int iVertex, const qmTetrahedron::Measures &cr,
+                  int part, bool *blocked)
 {
   if(t->isDeleted()) {
     Msg::Warning("Impossible to collapse node");
@@ -631,7 +652,8 @@ bool smoothVertex(MTet4 *t, int iVertex, const qmTetrahedron::Measures &cr)
 
   std::vector<MTet4 *> cavity;
   cavity.push_back(t);
-  if(!buildVertexCavity_recur(t, t->tet()->getVertex(iVertex), cavity))
+  if(!buildVertexCavity_recur(t, t->tet()->getVertex(iVertex), cavity, part,
+                              blocked))
     return false;
 
   double xcg = 0, ycg = 0, zcg = 0;
@@ -832,34 +854,87 @@ int LaplaceSmoothing(GRegion *gr)
   fillv_(vertexToElement, (gr)->hexahedra.begin(), (gr)->hexahedra.end());
   fillv_(vertexToElement, (gr)->prisms.begin(), (gr)->prisms.end());
   fillv_(vertexToElement, (gr)->pyramids.begin(), (gr)->pyramids.end());
-  int N = 0;
-  for(std::size_t i = 0; i < gr->mesh_vertices.size(); i++) {
+
+  // color the nodes so that nodes with the same color do not share any
+  // element: they can then be relocated concurrently, and the result does not
+  // depend on the number of threads
+  std::size_t n = gr->mesh_vertices.size();
+  robin_hood::unordered_flat_map<MVertex *, std::size_t> index;
+  for(std::size_t i = 0; i < n; i++) index[gr->mesh_vertices[i]] = i;
+  std::vector<int> color(n, -1);
+  std::vector<std::vector<std::size_t> > colors;
+  std::set<int> types;
+  for(std::size_t i = 0; i < n; i++) {
     MVertex *v = gr->mesh_vertices[i];
-    auto it = vertexToElement.lower_bound(v);
-    auto it_low = it;
+    std::vector<int> used;
     auto it_up = vertexToElement.upper_bound(v);
-    double minQual = 1.e22;
-    double volTot = 0.0;
-    double xold = v->x(), yold = v->y(), zold = v->z();
-    SPoint3 pNew(0, 0, 0);
-    for(; it != it_up; ++it) {
-      minQual = std::min(minQual, it->second->minSICNShapeMeasure());
-      double vol = fabs(it->second->getVolume());
-      SPoint3 cog = it->second->barycenter();
-      pNew += cog * vol;
-      volTot += vol;
+    for(auto it = vertexToElement.lower_bound(v); it != it_up; ++it) {
+      types.insert(it->second->getTypeForMSH());
+      for(std::size_t j = 0; j < it->second->getNumVertices(); j++) {
+        auto itv = index.find(it->second->getVertex(j));
+        if(itv != index.end() && color[itv->second] >= 0)
+          used.push_back(color[itv->second]);
+      }
     }
-    pNew *= (1. / volTot);
-    v->setXYZ(pNew.x(), pNew.y(), pNew.z());
-    double minQual2 = 1.e22;
-    for(it = it_low; it != it_up; ++it) {
-      minQual2 = std::min(minQual2, it->second->minSICNShapeMeasure());
-      if(minQual2 < minQual) {
-        v->setXYZ(xold, yold, zold);
-        break;
+    std::sort(used.begin(), used.end());
+    int c = 0;
+    for(std::size_t j = 0; j < used.size(); j++) {
+      if(used[j] == c) c++;
+      else if(used[j] > c) break;
+    }
+    color[i] = c;
+    if(c >= (int)colors.size()) colors.resize(c + 1);
+    colors[c].push_back(i);
+  }
+
+  // the quality measures build some data structures on the fly, for each type
+  // of element: make sure they are created before the parallel loops
+  for(auto it = vertexToElement.begin(); it != vertexToElement.end(); ++it) {
+    auto itt = types.find(it->second->getTypeForMSH());
+    if(itt == types.end()) continue;
+    it->second->minSICNShapeMeasure();
+    it->second->getVolume();
+    it->second->barycenter();
+    types.erase(itt);
+  }
+
+  int nthreads = CTX::instance()->numThreads;
+  if(CTX::instance()->mesh.maxNumThreads3D > 0)
+    nthreads = CTX::instance()->mesh.maxNumThreads3D;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+
+  int N = 0;
+  for(std::size_t c = 0; c < colors.size(); c++) {
+    const std::vector<std::size_t> &vc = colors[c];
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nthreads) reduction(+ : N)
+    for(std::size_t k = 0; k < vc.size(); k++) {
+      MVertex *v = gr->mesh_vertices[vc[k]];
+      auto it = vertexToElement.lower_bound(v);
+      auto it_low = it;
+      auto it_up = vertexToElement.upper_bound(v);
+      double minQual = 1.e22;
+      double volTot = 0.0;
+      double xold = v->x(), yold = v->y(), zold = v->z();
+      SPoint3 pNew(0, 0, 0);
+      for(; it != it_up; ++it) {
+        minQual = std::min(minQual, it->second->minSICNShapeMeasure());
+        double vol = fabs(it->second->getVolume());
+        SPoint3 cog = it->second->barycenter();
+        pNew += cog * vol;
+        volTot += vol;
+      }
+      pNew *= (1. / volTot);
+      v->setXYZ(pNew.x(), pNew.y(), pNew.z());
+      double minQual2 = 1.e22;
+      for(it = it_low; it != it_up; ++it) {
+        minQual2 = std::min(minQual2, it->second->minSICNShapeMeasure());
+        if(minQual2 < minQual) {
+          v->setXYZ(xold, yold, zold);
+          break;
+        }
       }
+      if(minQual < minQual2) N++;
     }
-    if(minQual < minQual2) N++;
   }
   return N;
 }
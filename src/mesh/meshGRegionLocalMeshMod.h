@@ -14,18 +14,24 @@
 
 enum localMeshModAction { GMSH_DOIT, GMSH_EVALONLY };
 
+// Edge swaps and vertex smoothing can be restricted to the tets of a given
+// part (see MTet4::getPart()), so that several parts can be modified
+// concurrently: if the modification involves a tet from another part,
+// nothing is done and "blocked" is set to true.
+
 int LaplaceSmoothing(GRegion *gr);
 
 bool edgeSwap(std::vector<MTet4 *> &newTets, MTet4 *tet, int iLocalEdge,
               const qmTetrahedron::Measures &cr,
-              const std::set<MFace, MFaceLessThan> &embeddedFaces);
+              const std::set<MFace, MFaceLessThan> &embeddedFaces,
+              int part = -1, bool *blocked = nullptr);
 
 bool faceSwap(std::vector<MTet4 *> &newTets, MTet4 *tet, int iLocalFace,
               const qmTetrahedron::Measures &cr,
               const std::set<MFace, MFaceLessThan> &embeddedFaces);
 
-bool smoothVertex(MTet4 *t, int iLocalVertex,
-                  const qmTetrahedron::Measures &cr);
+bool smoothVertex(MTet4 *t, int iLocalVertex, const qmTetrahedron::Measures &cr,
+                  int part = -1, bool *blocked = nullptr);
 
 bool smoothVertexOptimize(MTet4 *t, int iVertex,
                           const qmTetrahedron::Measures &cr);
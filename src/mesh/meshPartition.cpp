@@ -55,8 +55,6 @@ typedef std::set<std::pair<int, GEntity *>, OriGEntityPtrFullLessThan>
                      std::vector<std::pair<MElement *, std::vector<int> > >,   \
                      MVertexPtrHash, MVertexPtrEqual>
 
-#if defined(HAVE_METIS)
-
 #include "OS.h"
 #include "Context.h"
 #include "partitionRegion.h"
@@ -77,10 +75,24 @@ typedef std::set<std::pair<int, GEntity *>, OriGEntityPtrFullLessThan>
 #include "MTrihedron.h"
 #include "MElementCut.h"
 #include "MPoint.h"
+#include "HilbertCurve.h"
 
+#if defined(HAVE_METIS)
 extern "C" {
 #include <metis.h>
 }
+#else
+// the graph-based partitioners (recursive coordinate bisection and
+// space-filling curves) do not need METIS
+typedef int idx_t;
+#endif
+
+static int getNumThreads()
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  return nthreads;
+}
 
 // Graph of the mesh for partitioning purposes.
 class Graph {
@@ -167,6 +179,12 @@ public:
   }
   void adjncy(std::size_t i, idx_t adjncy) { _adjncy[i] = adjncy; };
   void vertex(std::size_t i, idx_t vertex) { _vertex[i] = vertex; };
+  // flag vertex i as used (can be called concurrently)
+  void markVertex(std::size_t i)
+  {
+#pragma omp atomic write
+    _vertex[i] = 0;
+  }
   void partition(const std::vector<idx_t> &epart)
   {
     // converts into METIS-independent integer type
@@ -206,18 +224,32 @@ public:
   std::vector<std::set<MElement *, MElementPtrLessThan> >
   getBoundaryElements(idx_t size = 0)
   {
-    std::vector<std::set<MElement *, MElementPtrLessThan> > elements(
-      (size ? size : _nparts), std::set<MElement *, MElementPtrLessThan>());
+    const int nthreads = getNumThreads();
+    std::vector<char> boundary(_ne, 0);
+#pragma omp parallel for num_threads(nthreads)
     for(std::size_t i = 0; i < _ne; i++) {
+      if(_element[i]->getDim() != _dim) continue;
       for(idx_t j = _xadj[i]; j < _xadj[i + 1]; j++) {
         if(_partition[i] != _partition[_adjncy[j]]) {
-          if(_element[i]->getDim() == _dim) {
-            elements[_partition[i]].insert(_element[i]);
-          }
+          boundary[i] = 1;
+          break;
         }
       }
     }
 
+    // the sets are filled from sorted vectors, which takes linear time
+    std::vector<std::vector<MElement *> > sorted(size ? size : _nparts);
+    for(std::size_t i = 0; i < _ne; i++) {
+      if(boundary[i]) sorted[_partition[i]].push_back(_element[i]);
+    }
+    std::vector<std::set<MElement *, MElementPtrLessThan> > elements(
+      sorted.size(), std::set<MElement *, MElementPtrLessThan>());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t i = 0; i < sorted.size(); i++) {
+      std::sort(sorted[i].begin(), sorted[i].end(), MElementPtrLessThan());
+      elements[i].insert(sorted[i].begin(), sorted[i].end());
+    }
+
     return elements;
   }
   std::vector<GEntity *> createGhostEntities()
@@ -277,90 +309,104 @@ public:
       }
     }
   }
+  // Get the neighbors of element i in the dual graph, in the order in which
+  // they are first met (as in METIS_MeshToDual), using the node to element
+  // map (nptr, nind). The scratch vectors are provided by the caller, so that
+  // each thread can use its own.
+  void getDualNeighbors(std::size_t i, bool connectedAll,
+                        const std::vector<idx_t> &nptr,
+                        const std::vector<idx_t> &nind,
+                        std::vector<std::pair<idx_t, idx_t> > &candidates,
+                        std::vector<std::pair<idx_t, idx_t> > &neighbors) const
+  {
+    // all the elements sharing a node with element i, with the position at
+    // which they are met; after sorting, the number of nodes shared with
+    // element i is the length of each run
+    candidates.clear();
+    for(idx_t j = _eptr[i]; j < _eptr[i + 1]; j++) {
+      for(idx_t k = nptr[_eind[j]]; k < nptr[_eind[j] + 1]; k++) {
+        if(nind[k] != (idx_t)i)
+          candidates.push_back(
+            std::make_pair(nind[k], (idx_t)candidates.size()));
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    neighbors.clear();
+    for(std::size_t j = 0; j < candidates.size();) {
+      std::size_t l = j + 1;
+      while(l < candidates.size() && candidates[l].first == candidates[j].first)
+        l++;
+      if((int)(l - j) >=
+         (connectedAll ? 1 :
+                         _element[i]->numCommonNodesInDualGraph(
+                           _element[candidates[j].first])))
+        neighbors.push_back(
+          std::make_pair(candidates[j].second, candidates[j].first));
+      j = l;
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+  }
   void createDualGraph(bool connectedAll)
   {
+    const int nthreads = getNumThreads();
+
+    // node to element map; the elements of each node are sorted, so that the
+    // graph does not depend on the number of threads
     std::vector<idx_t> nptr(_nn + 1, 0);
     std::vector<idx_t> nind(_eptr[_ne], 0);
 
-    for(std::size_t i = 0; i < _ne; i++) {
-      for(idx_t j = _eptr[i]; j < _eptr[i + 1]; j++) { nptr[_eind[j]]++; }
+#pragma omp parallel for num_threads(nthreads)
+    for(std::size_t i = 0; i < (std::size_t)_eptr[_ne]; i++) {
+#pragma omp atomic
+      nptr[_eind[i] + 1]++;
     }
+    for(std::size_t i = 0; i < _nn; i++) nptr[i + 1] += nptr[i];
 
-    for(std::size_t i = 1; i < _nn; i++) nptr[i] += nptr[i - 1];
-    for(std::size_t i = _nn; i > 0; i--) nptr[i] = nptr[i - 1];
-    nptr[0] = 0;
-
+    std::vector<idx_t> next(nptr.begin(), nptr.end() - 1);
+#pragma omp parallel for num_threads(nthreads)
     for(std::size_t i = 0; i < _ne; i++) {
       for(idx_t j = _eptr[i]; j < _eptr[i + 1]; j++) {
-        nind[nptr[_eind[j]]++] = i;
+        idx_t k;
+#pragma omp atomic capture
+        k = next[_eind[j]]++;
+        nind[k] = i;
       }
     }
+    next.clear();
 
-    for(std::size_t i = _nn; i > 0; i--) nptr[i] = nptr[i - 1];
-    nptr[0] = 0;
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for(std::size_t i = 0; i < _nn; i++)
+      std::sort(nind.begin() + nptr[i], nind.begin() + nptr[i + 1]);
 
+    // count the neighbors of each element, then fill the adjacency lists
     _xadj = new idx_t[_ne + 1];
-    for(std::size_t i = 0; i < _ne + 1; i++) _xadj[i] = 0;
-
-    std::vector<idx_t> nbrs(_ne, 0);
-    std::vector<idx_t> marker(_ne, 0);
-    for(std::size_t i = 0; i < _ne; i++) {
-      std::size_t l = 0;
-      for(idx_t j = _eptr[i]; j < _eptr[i + 1]; j++) {
-        for(idx_t k = nptr[_eind[j]]; k < nptr[_eind[j] + 1]; k++) {
-          if(nind[k] != (idx_t)i) {
-            if(marker[nind[k]] == 0) nbrs[l++] = nind[k];
-            marker[nind[k]]++;
-          }
-        }
-      }
+    _xadj[0] = 0;
 
-      std::size_t nbrsNeighbors = 0;
-      for(std::size_t j = 0; j < l; j++) {
-        if(marker[nbrs[j]] >=
-           (connectedAll ?
-              1 :
-              _element[i]->numCommonNodesInDualGraph(_element[nbrs[j]])))
-          nbrsNeighbors++;
-        marker[nbrs[j]] = 0;
-        nbrs[j] = 0;
+#pragma omp parallel num_threads(nthreads)
+    {
+      std::vector<std::pair<idx_t, idx_t> > candidates, neighbors;
+#pragma omp for schedule(dynamic, 1024)
+      for(std::size_t i = 0; i < _ne; i++) {
+        getDualNeighbors(i, connectedAll, nptr, nind, candidates, neighbors);
+        _xadj[i + 1] = neighbors.size();
       }
-
-      _xadj[i] = nbrsNeighbors;
     }
 
-    for(std::size_t i = 1; i < _ne; i++) _xadj[i] = _xadj[i] + _xadj[i - 1];
-    for(std::size_t i = _ne; i > 0; i--) _xadj[i] = _xadj[i - 1];
-    _xadj[0] = 0;
+    for(std::size_t i = 0; i < _ne; i++) _xadj[i + 1] += _xadj[i];
 
     _adjncy = new idx_t[_xadj[_ne]];
-    for(idx_t i = 0; i < _xadj[_ne]; i++) _adjncy[i] = 0;
 
-    for(std::size_t i = 0; i < _ne; i++) {
-      std::size_t l = 0;
-      for(idx_t j = _eptr[i]; j < _eptr[i + 1]; j++) {
-        for(idx_t k = nptr[_eind[j]]; k < nptr[_eind[j] + 1]; k++) {
-          if(nind[k] != (idx_t)i) {
-            if(marker[nind[k]] == 0) nbrs[l++] = nind[k];
-            marker[nind[k]]++;
-          }
-        }
-      }
-
-      for(std::size_t j = 0; j < l; j++) {
-        if(marker[nbrs[j]] >=
-           (connectedAll ?
-              1 :
-              _element[i]->numCommonNodesInDualGraph(_element[nbrs[j]]))) {
-          _adjncy[_xadj[i]] = nbrs[j];
-          _xadj[i] = _xadj[i] + 1;
-        }
-        marker[nbrs[j]] = 0;
-        nbrs[j] = 0;
+#pragma omp parallel num_threads(nthreads)
+    {
+      std::vector<std::pair<idx_t, idx_t> > candidates, neighbors;
+#pragma omp for schedule(dynamic, 1024)
+      for(std::size_t i = 0; i < _ne; i++) {
+        getDualNeighbors(i, connectedAll, nptr, nind, candidates, neighbors);
+        for(std::size_t j = 0; j < neighbors.size(); j++)
+          _adjncy[_xadj[i] + j] = neighbors[j].second;
       }
     }
-    for(std::size_t i = _ne; i > 0; i--) _xadj[i] = _xadj[i - 1];
-    _xadj[0] = 0;
   }
   void fillDefaultWeights()
   {
@@ -381,6 +427,7 @@ public:
        CTX::instance()->mesh.partitionPyrWeight == -1 ||
        CTX::instance()->mesh.partitionPriWeight == -1 ||
        CTX::instance()->mesh.partitionHexWeight == -1) {
+#pragma omp parallel for num_threads(getNumThreads())
       for(std::size_t i = 0; i < _ne; i++) {
         if(!_element[i]) { _vwgt[i] = 1; }
         else {
@@ -389,6 +436,7 @@ public:
       }
     }
     else {
+#pragma omp parallel for num_threads(getNumThreads())
       for(std::size_t i = 0; i < _ne; i++) {
         if(!_element[i]) { _vwgt[i] = 1; }
         else {
@@ -442,6 +490,13 @@ static void fillElementsToNodesMap(Graph &graph, GEntity *entity,
   }
 }
 
+template <class ITERATOR>
+static void addElements(std::vector<MElement *> &elements, ITERATOR it_beg,
+                        ITERATOR it_end)
+{
+  elements.insert(elements.end(), it_beg, it_end);
+}
+
 static std::size_t getSizeOfEind(GModel *model)
 {
   std::size_t size = 0;
@@ -494,7 +549,6 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
     std::vector<GEntity *> entities;
     model->getEntities(entities);
 
-    std::set<MVertex *> vertices;
     for(std::size_t i = 0; i < entities.size(); i++) {
       if(entities[i]->dim() == selectDim) {
         switch(entities[i]->dim()) {
@@ -504,17 +558,11 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
         case 0: tmp->add(static_cast<GVertex *>(entities[i])); break;
         default: break;
         }
-        for(std::size_t j = 0; j < entities[i]->getNumMeshElements(); j++) {
-          for(std::size_t k = 0;
-              k < entities[i]->getMeshElement(j)->getNumVertices(); k++) {
-            vertices.insert(entities[i]->getMeshElement(j)->getVertex(k));
-          }
-        }
       }
     }
 
+    // the number of nodes is set once they are numbered below
     graph.ne(tmp->getNumMeshElements());
-    graph.nn(vertices.size());
     graph.dim(tmp->getMeshDim());
     graph.elementResize(graph.ne());
     graph.vertexResize(model->getMaxVertexNumber());
@@ -527,10 +575,6 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
     delete tmp;
   }
 
-  idx_t eptrIndex = 0;
-  idx_t eindIndex = 0;
-  idx_t numVertex = 0;
-
   if(graph.ne() == 0) {
     Msg::Error("No mesh elements were found");
     return 1;
@@ -540,20 +584,19 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
     return 1;
   }
 
+  // The order of the elements must be the same as in createPartitionTopology
+  std::vector<MElement *> elements;
+  elements.reserve(graph.ne());
+
   // Loop over volumes
   if(selectDim < 0 || selectDim == 3) {
     for(auto it = model->firstRegion(); it != model->lastRegion(); ++it) {
       GRegion *r = *it;
-      fillElementsToNodesMap(graph, r, eptrIndex, eindIndex, numVertex,
-                             r->tetrahedra.begin(), r->tetrahedra.end());
-      fillElementsToNodesMap(graph, r, eptrIndex, eindIndex, numVertex,
-                             r->hexahedra.begin(), r->hexahedra.end());
-      fillElementsToNodesMap(graph, r, eptrIndex, eindIndex, numVertex,
-                             r->prisms.begin(), r->prisms.end());
-      fillElementsToNodesMap(graph, r, eptrIndex, eindIndex, numVertex,
-                             r->pyramids.begin(), r->pyramids.end());
-      fillElementsToNodesMap(graph, r, eptrIndex, eindIndex, numVertex,
-                             r->trihedra.begin(), r->trihedra.end());
+      addElements(elements, r->tetrahedra.begin(), r->tetrahedra.end());
+      addElements(elements, r->hexahedra.begin(), r->hexahedra.end());
+      addElements(elements, r->prisms.begin(), r->prisms.end());
+      addElements(elements, r->pyramids.begin(), r->pyramids.end());
+      addElements(elements, r->trihedra.begin(), r->trihedra.end());
     }
   }
 
@@ -561,10 +604,8 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
   if(selectDim < 0 || selectDim == 2) {
     for(auto it = model->firstFace(); it != model->lastFace(); ++it) {
       GFace *f = *it;
-      fillElementsToNodesMap(graph, f, eptrIndex, eindIndex, numVertex,
-                             f->triangles.begin(), f->triangles.end());
-      fillElementsToNodesMap(graph, f, eptrIndex, eindIndex, numVertex,
-                             f->quadrangles.begin(), f->quadrangles.end());
+      addElements(elements, f->triangles.begin(), f->triangles.end());
+      addElements(elements, f->quadrangles.begin(), f->quadrangles.end());
     }
   }
 
@@ -572,8 +613,7 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
   if(selectDim < 0 || selectDim == 1) {
     for(auto it = model->firstEdge(); it != model->lastEdge(); ++it) {
       GEdge *e = *it;
-      fillElementsToNodesMap(graph, e, eptrIndex, eindIndex, numVertex,
-                             e->lines.begin(), e->lines.end());
+      addElements(elements, e->lines.begin(), e->lines.end());
     }
   }
 
@@ -581,143 +621,373 @@ static int makeGraph(GModel *model, Graph &graph, int selectDim)
   if(selectDim < 0 || selectDim == 0) {
     for(auto it = model->firstVertex(); it != model->lastVertex(); ++it) {
       GVertex *v = *it;
-      fillElementsToNodesMap(graph, v, eptrIndex, eindIndex, numVertex,
-                             v->points.begin(), v->points.end());
+      addElements(elements, v->points.begin(), v->points.end());
     }
   }
 
+  const int nthreads = getNumThreads();
+  const std::size_t numElements = std::min(elements.size(), graph.ne());
+
+  // Elements and element to node offsets
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < numElements; i++) {
+    graph.element(i, elements[i]);
+    graph.eptr(i + 1, elements[i]->getNumPrimaryVertices());
+  }
+  for(std::size_t i = 0; i < graph.ne(); i++)
+    graph.eptr(i + 1, graph.eptr(i) + graph.eptr(i + 1));
+
+  // Number the nodes used by the elements consecutively, in the order of
+  // their tags (the dual graph does not depend on this numbering)
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < numElements; i++) {
+    for(std::size_t j = 0; j < elements[i]->getNumPrimaryVertices(); j++)
+      graph.markVertex(elements[i]->getVertex(j)->getNum() - 1);
+  }
+  idx_t numVertex = 0;
+  for(std::size_t i = 0; i < model->getMaxVertexNumber(); i++) {
+    if(graph.vertex(i) == 0) graph.vertex(i, numVertex++);
+  }
+  graph.nn(numVertex);
+
+  // Element to node map
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < numElements; i++) {
+    const std::size_t offset = graph.eptr(i);
+    for(std::size_t j = 0; j < elements[i]->getNumPrimaryVertices(); j++)
+      graph.eind(offset + j,
+                 graph.vertex(elements[i]->getVertex(j)->getNum() - 1));
+  }
+
   return 0;
 }
 
-// Partition a graph created by makeGraph using Metis library. Returns: 0 =
-// success, 1 = error, 2 = exception thrown.
-static int partitionGraph(Graph &graph, bool verbose)
-{
-#ifdef HAVE_METIS
-  std::stringstream opt;
-  try {
-    idx_t metisOptions[METIS_NOPTIONS];
-    METIS_SetDefaultOptions(metisOptions);
+// A set of elements (index[begin], ..., index[end - 1]) to split into numParts
+// partitions, numbered from firstPart
+struct bisectionSet {
+  std::size_t begin, end;
+  idx_t firstPart, numParts;
+};
 
-    opt << "npart:" << graph.nparts();
+// Split the elements of the graph by recursive coordinate bisection of their
+// barycenters: each set of elements is cut by a plane orthogonal to the
+// largest dimension of its bounding box, so that the weight on each side is
+// proportional to the number of partitions it will contain. The sets at a
+// given level of the recursion are split concurrently.
+static void partitionGraphBisection(Graph &graph, std::vector<idx_t> &epart)
+{
+  const int nthreads = getNumThreads();
+  const std::size_t ne = graph.ne();
+  const idx_t *vwgt = graph.vwgt();
+
+  std::vector<SPoint3> barycenters(ne);
+  std::vector<idx_t> index(ne);
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < ne; i++) {
+    index[i] = i;
+    if(graph.element(i)) barycenters[i] = graph.element(i)->barycenter();
+  }
+
+  std::vector<bisectionSet> sets(1), split;
+  sets[0].begin = 0;
+  sets[0].end = ne;
+  sets[0].firstPart = 0;
+  sets[0].numParts = graph.nparts();
+
+  while(!sets.empty()) {
+    split.assign(2 * sets.size(), bisectionSet());
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(std::size_t s = 0; s < sets.size(); s++) {
+      const bisectionSet &set = sets[s];
+      if(set.numParts == 1) {
+        for(std::size_t i = set.begin; i < set.end; i++)
+          epart[index[i]] = set.firstPart;
+        continue;
+      }
+      const idx_t numParts1 = set.numParts / 2;
+
+      SBoundingBox3d bbox;
+      double total = 0.;
+      for(std::size_t i = set.begin; i < set.end; i++) {
+        bbox += barycenters[index[i]];
+        total += vwgt ? vwgt[index[i]] : 1;
+      }
+      // e.g. lower dimensional elements only
+      const bool unitWeights = !vwgt || total <= 0.;
+      if(unitWeights) total = set.end - set.begin;
+      const double target = total * numParts1 / set.numParts;
+
+      int axis = 0;
+      if(!bbox.empty()) {
+        SPoint3 d(bbox.max().x() - bbox.min().x(),
+                  bbox.max().y() - bbox.min().y(),
+                  bbox.max().z() - bbox.min().z());
+        if(d[1] > d[axis]) axis = 1;
+        if(d[2] > d[axis]) axis = 2;
+      }
+      auto less = [&](idx_t a, idx_t b) {
+        if(barycenters[a][axis] != barycenters[b][axis])
+          return barycenters[a][axis] < barycenters[b][axis];
+        return a < b;
+      };
+
+      // weighted selection: [begin, lo) weighs less than the target and
+      // [begin, hi) at least the target, with index[lo, hi) not yet ordered
+      std::size_t lo = set.begin, hi = set.end;
+      double weightLo = 0.;
+      while(hi - lo > 1) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(index.begin() + lo, index.begin() + mid,
+                         index.begin() + hi, less);
+        double w = weightLo;
+        for(std::size_t i = lo; i < mid; i++)
+          w += unitWeights ? 1 : vwgt[index[i]];
+        if(w < target) {
+          lo = mid;
+          weightLo = w;
+        }
+        else
+          hi = mid;
+      }
+      std::size_t cut = lo;
+      if(lo < set.end) {
+        const double w = weightLo + (unitWeights ? 1 : vwgt[index[lo]]);
+        if(w - target < target - weightLo) cut = lo + 1;
+      }
 
-    opt << ", sizeof(idx_t):" << 8 * sizeof(idx_t);
+      split[2 * s].begin = set.begin;
+      split[2 * s].end = cut;
+      split[2 * s].firstPart = set.firstPart;
+      split[2 * s].numParts = numParts1;
+      split[2 * s + 1].begin = cut;
+      split[2 * s + 1].end = set.end;
+      split[2 * s + 1].firstPart = set.firstPart + numParts1;
+      split[2 * s + 1].numParts = set.numParts - numParts1;
+    }
+    sets.clear();
+    for(std::size_t i = 0; i < split.size(); i++)
+      if(split[i].numParts) sets.push_back(split[i]);
+  }
+}
 
-    opt << ", ptype:";
-    switch(CTX::instance()->mesh.metisAlgorithm) {
-    case 1: // Recursive
-      metisOptions[METIS_OPTION_PTYPE] = METIS_PTYPE_RB;
-      opt << "rb";
-      break;
-    case 2: // K-way
-      metisOptions[METIS_OPTION_PTYPE] = METIS_PTYPE_KWAY;
-      opt << "kway";
-      break;
-    default: opt << "default"; break;
+// Split the elements of the graph into consecutive chunks of equal weight
+// along the Hilbert (or Morton) curve through their barycenters.
+static void partitionGraphCurve(Graph &graph, bool hilbert,
+                                std::vector<idx_t> &epart)
+{
+  const int nthreads = getNumThreads();
+  const std::size_t ne = graph.ne();
+  const idx_t *vwgt = graph.vwgt();
+  const idx_t numParts = graph.nparts();
+
+  std::vector<SPoint3> barycenters(ne);
+  SBoundingBox3d bbox;
+#pragma omp parallel num_threads(nthreads)
+  {
+    SBoundingBox3d b;
+#pragma omp for
+    for(std::size_t i = 0; i < ne; i++) {
+      if(graph.element(i)) barycenters[i] = graph.element(i)->barycenter();
+      b += barycenters[i];
+    }
+#pragma omp critical
+    bbox += b;
+  }
+
+  std::vector<std::pair<uint64_t, std::size_t> > indices(ne);
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < ne; i++) {
+    indices[i].first = hilbert ? HilbertIndex(barycenters[i], bbox) :
+                                 MortonIndex(barycenters[i], bbox);
+    indices[i].second = i;
+  }
+  SortCurveIndices(indices, nthreads);
+
+  // weight of the elements before each chunk of the curve
+  std::vector<double> before(nthreads + 1, 0.);
+#pragma omp parallel for num_threads(nthreads)
+  for(int c = 0; c < nthreads; c++) {
+    for(std::size_t i = (ne * c) / nthreads; i < (ne * (c + 1)) / nthreads;
+        i++)
+      before[c + 1] += vwgt ? vwgt[indices[i].second] : 1;
+  }
+  for(int c = 0; c < nthreads; c++) before[c + 1] += before[c];
+  // e.g. lower dimensional elements only
+  const bool unitWeights = !vwgt || before[nthreads] <= 0.;
+  const double total = unitWeights ? ne : before[nthreads];
+
+#pragma omp parallel for num_threads(nthreads)
+  for(int c = 0; c < nthreads; c++) {
+    double w = unitWeights ? (double)((ne * c) / nthreads) : before[c];
+    for(std::size_t i = (ne * c) / nthreads; i < (ne * (c + 1)) / nthreads;
+        i++) {
+      const double wi = unitWeights ? 1 : vwgt[indices[i].second];
+      idx_t part = (idx_t)((w + 0.5 * wi) * numParts / total);
+      epart[indices[i].second] = std::min(part, numParts - 1);
+      w += wi;
     }
+  }
+}
+
+// Partition a graph created by makeGraph using Metis library or one of the
+// built-in partitioners. Returns: 0 = success, 1 = error, 2 = exception thrown.
+static int partitionGraph(Graph &graph, bool verbose)
+{
+  try {
+    idx_t objval = 0;
+    std::vector<idx_t> epart(graph.ne());
+    idx_t numPart = graph.nparts();
+    graph.fillDefaultWeights();
 
-    opt << ", ufactor:";
-    if(CTX::instance()->mesh.metisMaxLoadImbalance >= 0) {
-      metisOptions[METIS_OPTION_UFACTOR] =
-        CTX::instance()->mesh.metisMaxLoadImbalance;
-      opt << CTX::instance()->mesh.metisMaxLoadImbalance;
+    const int algo = CTX::instance()->mesh.partitionAlgorithm;
+    if(algo >= 1 && algo <= 3) {
+      if(verbose)
+        Msg::Info("Running %s with npart:%d",
+                  (algo == 1) ? "recursive coordinate bisection" :
+                  (algo == 2) ? "Hilbert curve partitioner" :
+                                "Morton curve partitioner",
+                  (int)numPart);
+      graph.createDualGraph(false);
+      if(algo == 1)
+        partitionGraphBisection(graph, epart);
+      else
+        partitionGraphCurve(graph, algo == 2, epart);
+      idx_t cut = 0;
+#pragma omp parallel for reduction(+ : cut) num_threads(getNumThreads())
+      for(std::size_t i = 0; i < graph.ne(); i++) {
+        for(idx_t j = graph.xadj(i); j < graph.xadj(i + 1); j++)
+          if(epart[i] != epart[graph.adjncy(j)]) cut++;
+      }
+      objval = cut / 2;
     }
     else {
-      opt << "default";
-    }
+#if defined(HAVE_METIS)
+      std::stringstream opt;
+      idx_t ne = graph.ne();
+      idx_t ncon = 1;
+      idx_t metisOptions[METIS_NOPTIONS];
+      METIS_SetDefaultOptions(metisOptions);
 
-    opt << ", ctype:";
-    switch(CTX::instance()->mesh.metisEdgeMatching) {
-    case 1: // Random matching
-      metisOptions[METIS_OPTION_CTYPE] = METIS_CTYPE_RM;
-      opt << "rm";
-      break;
-    case 2: // Sorted heavy-edge matching
-      metisOptions[METIS_OPTION_CTYPE] = METIS_CTYPE_SHEM;
-      opt << "shem";
-      break;
-    default: opt << "default"; break;
-    }
+      opt << "npart:" << graph.nparts();
 
-    opt << ", rtype:";
-    switch(CTX::instance()->mesh.metisRefinementAlgorithm) {
-    case 1: // FM-based cut refinement
-      metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_FM;
-      opt << "fm";
-      break;
-    case 2: // Greedy boundary refinement
-      metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_GREEDY;
-      opt << "greedy";
-      break;
-    case 3: // Two-sided node FM refinement
-      metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_SEP2SIDED;
-      opt << "sep2sided";
-      break;
-    case 4: // One-sided node FM refinement
-      metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_SEP1SIDED;
-      opt << "sep1sided";
-      break;
-    default: opt << "default"; break;
-    }
+      opt << ", sizeof(idx_t):" << 8 * sizeof(idx_t);
 
-    opt << ", objtype:";
-    switch(CTX::instance()->mesh.metisObjective) {
-    case 1: // Min. cut
-      metisOptions[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_CUT;
-      opt << "cut";
-      break;
-    case 2: // Min. communication volume (slower)
-      metisOptions[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_VOL;
-      opt << "vol";
-      break;
-    default: opt << "default"; break;
-    }
+      opt << ", ptype:";
+      switch(CTX::instance()->mesh.metisAlgorithm) {
+      case 1: // Recursive
+        metisOptions[METIS_OPTION_PTYPE] = METIS_PTYPE_RB;
+        opt << "rb";
+        break;
+      case 2: // K-way
+        metisOptions[METIS_OPTION_PTYPE] = METIS_PTYPE_KWAY;
+        opt << "kway";
+        break;
+      default: opt << "default"; break;
+      }
 
-    opt << ", minconn:";
-    switch(CTX::instance()->mesh.metisMinConn) {
-    case 0:
-      metisOptions[METIS_OPTION_MINCONN] = 0;
-      opt << 0;
-      break;
-    case 1:
-      metisOptions[METIS_OPTION_MINCONN] = 1;
-      opt << 1;
-      break;
-    default: opt << "default"; break;
-    }
+      opt << ", ufactor:";
+      if(CTX::instance()->mesh.metisMaxLoadImbalance >= 0) {
+        metisOptions[METIS_OPTION_UFACTOR] =
+          CTX::instance()->mesh.metisMaxLoadImbalance;
+        opt << CTX::instance()->mesh.metisMaxLoadImbalance;
+      }
+      else {
+        opt << "default";
+      }
+
+      opt << ", ctype:";
+      switch(CTX::instance()->mesh.metisEdgeMatching) {
+      case 1: // Random matching
+        metisOptions[METIS_OPTION_CTYPE] = METIS_CTYPE_RM;
+        opt << "rm";
+        break;
+      case 2: // Sorted heavy-edge matching
+        metisOptions[METIS_OPTION_CTYPE] = METIS_CTYPE_SHEM;
+        opt << "shem";
+        break;
+      default: opt << "default"; break;
+      }
 
-    if(verbose) Msg::Info("Running METIS with %s", opt.str().c_str());
+      opt << ", rtype:";
+      switch(CTX::instance()->mesh.metisRefinementAlgorithm) {
+      case 1: // FM-based cut refinement
+        metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_FM;
+        opt << "fm";
+        break;
+      case 2: // Greedy boundary refinement
+        metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_GREEDY;
+        opt << "greedy";
+        break;
+      case 3: // Two-sided node FM refinement
+        metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_SEP2SIDED;
+        opt << "sep2sided";
+        break;
+      case 4: // One-sided node FM refinement
+        metisOptions[METIS_OPTION_RTYPE] = METIS_RTYPE_SEP1SIDED;
+        opt << "sep1sided";
+        break;
+      default: opt << "default"; break;
+      }
 
-    // C numbering
-    metisOptions[METIS_OPTION_NUMBERING] = 0;
+      opt << ", objtype:";
+      switch(CTX::instance()->mesh.metisObjective) {
+      case 1: // Min. cut
+        metisOptions[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_CUT;
+        opt << "cut";
+        break;
+      case 2: // Min. communication volume (slower)
+        metisOptions[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_VOL;
+        opt << "vol";
+        break;
+      default: opt << "default"; break;
+      }
 
-    idx_t objval;
-    std::vector<idx_t> epart(graph.ne());
-    idx_t ne = graph.ne();
-    idx_t numPart = graph.nparts();
-    idx_t ncon = 1;
-    graph.fillDefaultWeights();
+      opt << ", minconn:";
+      switch(CTX::instance()->mesh.metisMinConn) {
+      case 0:
+        metisOptions[METIS_OPTION_MINCONN] = 0;
+        opt << 0;
+        break;
+      case 1:
+        metisOptions[METIS_OPTION_MINCONN] = 1;
+        opt << 1;
+        break;
+      default: opt << "default"; break;
+      }
 
-    int metisError = 0;
-    graph.createDualGraph(false);
+      if(verbose) Msg::Info("Running METIS with %s", opt.str().c_str());
 
-    if(metisOptions[METIS_OPTION_PTYPE] == METIS_PTYPE_KWAY) {
-      metisError = METIS_PartGraphKway(
-        &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
-        nullptr, &numPart, nullptr, nullptr, metisOptions, &objval, &epart[0]);
-    }
-    else {
-      metisError = METIS_PartGraphRecursive(
-        &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
-        nullptr, &numPart, nullptr, nullptr, metisOptions, &objval, &epart[0]);
-    }
+      // C numbering
+      metisOptions[METIS_OPTION_NUMBERING] = 0;
+
+      int metisError = 0;
+      graph.createDualGraph(false);
 
-    switch(metisError) {
-    case METIS_OK: break;
-    case METIS_ERROR_INPUT: Msg::Error("METIS input error"); return 1;
-    case METIS_ERROR_MEMORY: Msg::Error("METIS memory error"); return 1;
-    case METIS_ERROR:
-    default: Msg::Error("METIS error"); return 1;
+      if(metisOptions[METIS_OPTION_PTYPE] == METIS_PTYPE_KWAY) {
+        metisError = METIS_PartGraphKway(
+          &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
+          nullptr, &numPart, nullptr, nullptr, metisOptions, &objval,
+          &epart[0]);
+      }
+      else {
+        metisError = METIS_PartGraphRecursive(
+          &ne, &ncon, graph.xadj(), graph.adjncy(), graph.vwgt(), nullptr,
+          nullptr, &numPart, nullptr, nullptr, metisOptions, &objval,
+          &epart[0]);
+      }
+
+      switch(metisError) {
+      case METIS_OK: break;
+      case METIS_ERROR_INPUT: Msg::Error("METIS input error"); return 1;
+      case METIS_ERROR_MEMORY: Msg::Error("METIS memory error"); return 1;
+      case METIS_ERROR:
+      default: Msg::Error("METIS error"); return 1;
+      }
+#else
+      Msg::Error("Gmsh must be compiled with METIS support to partition "
+                 "meshes with METIS (see Mesh.PartitionAlgorithm)");
+      return 1;
+#endif
     }
 
     // Check and correct the topology
@@ -742,7 +1012,6 @@ static int partitionGraph(Graph &graph, bool verbose)
     Msg::Error("METIS exception");
     return 2;
   }
-#endif
 
   return 0;
 }
@@ -1483,6 +1752,27 @@ static void getPartitionInVector(
   std::sort(partitions.begin(), partitions.end());
 }
 
+// Get the partitions sharing each mesh face, edge or node in [it_beg, it_end),
+// and, if there are at least 2, the reference element used to orient the
+// partition boundary entity. This is computed concurrently; the partition
+// entities are then created serially, in the order of the iterators.
+template <class ITERATOR>
+static void getPartitionBoundaries(ITERATOR it_beg, ITERATOR it_end,
+                                   std::vector<ITERATOR> &iterators,
+                                   std::vector<std::vector<int> > &partitions,
+                                   std::vector<MElement *> &references)
+{
+  for(ITERATOR it = it_beg; it != it_end; ++it) iterators.push_back(it);
+  partitions.resize(iterators.size());
+  references.resize(iterators.size(), nullptr);
+#pragma omp parallel for schedule(dynamic) num_threads(getNumThreads())
+  for(std::size_t i = 0; i < iterators.size(); i++) {
+    getPartitionInVector(partitions[i], iterators[i]->second);
+    if(partitions[i].size() >= 2)
+      references[i] = getReferenceElement(iterators[i]->second);
+  }
+}
+
 template <class PART_ENTITY, class LESS_PART_ENTITY>
 static PART_ENTITY *createPartitionEntity(
   std::pair<typename std::multimap<PART_ENTITY *, GEntity *,
@@ -1836,14 +2126,17 @@ static void createPartitionTopology(
       }
     }
     int numFaceEntity = model->getMaxElementaryNumber(2);
-    for(auto it = faceToElement.begin(); it != faceToElement.end(); ++it) {
+    std::vector<hashmapface::iterator> iterators;
+    std::vector<std::vector<int> > boundaryPartitions;
+    std::vector<MElement *> references;
+    getPartitionBoundaries(faceToElement.begin(), faceToElement.end(),
+                           iterators, boundaryPartitions, references);
+    for(std::size_t k = 0; k < iterators.size(); k++) {
+      auto it = iterators[k];
       MFace f = it->first;
 
-      std::vector<int> partitions;
-      getPartitionInVector(partitions, it->second);
-      if(partitions.size() < 2) continue;
-
-      MElement *reference = getReferenceElement(it->second);
+      const std::vector<int> &partitions = boundaryPartitions[k];
+      MElement *reference = references[k];
       if(!reference) continue;
 
       partitionFace *pf =
@@ -1922,14 +2215,17 @@ static void createPartitionTopology(
     }
 
     int numEdgeEntity = model->getMaxElementaryNumber(1);
-    for(auto it = edgeToElement.begin(); it != edgeToElement.end(); ++it) {
+    std::vector<hashmapedge::iterator> iterators;
+    std::vector<std::vector<int> > boundaryPartitions;
+    std::vector<MElement *> references;
+    getPartitionBoundaries(edgeToElement.begin(), edgeToElement.end(),
+                           iterators, boundaryPartitions, references);
+    for(std::size_t k = 0; k < iterators.size(); k++) {
+      auto it = iterators[k];
       MEdge e = it->first;
 
-      std::vector<int> partitions;
-      getPartitionInVector(partitions, it->second);
-      if(partitions.size() < 2) continue;
-
-      MElement *reference = getReferenceElement(it->second);
+      const std::vector<int> &partitions = boundaryPartitions[k];
+      MElement *reference = references[k];
       if(!reference) continue;
 
       partitionEdge *pe =
@@ -2004,14 +2300,17 @@ static void createPartitionTopology(
       }
     }
     int numVertexEntity = model->getMaxElementaryNumber(0);
-    for(auto it = vertexToElement.begin(); it != vertexToElement.end(); ++it) {
+    std::vector<hashmapvertex::iterator> iterators;
+    std::vector<std::vector<int> > boundaryPartitions;
+    std::vector<MElement *> references;
+    getPartitionBoundaries(vertexToElement.begin(), vertexToElement.end(),
+                           iterators, boundaryPartitions, references);
+    for(std::size_t k = 0; k < iterators.size(); k++) {
+      auto it = iterators[k];
       MVertex *v = it->first;
 
-      std::vector<int> partitions;
-      getPartitionInVector(partitions, it->second);
-      if(partitions.size() < 2) continue;
-
-      MElement *reference = getReferenceElement(it->second);
+      const std::vector<int> &partitions = boundaryPartitions[k];
+      MElement *reference = references[k];
       if(!reference) continue;
 
       partitionVertex *pv =
@@ -2187,6 +2486,7 @@ bool cmp_hedges(const std::pair<MEdge, size_t> &he0,
 
 int PartitionFaceMinEdgeLength(GFace *gf, int np, double tol)
 {
+#if defined(HAVE_METIS)
   std::vector<std::pair<MEdge, size_t> > halfEdges;
   halfEdges.reserve(gf->triangles.size() * 3);
   for(size_t i = 0; i < gf->triangles.size(); ++i) {
@@ -2260,6 +2560,10 @@ int PartitionFaceMinEdgeLength(GFace *gf, int np, double tol)
     gf->triangles[i]->setPartition(epart[i]);
   }
   return 0;
+#else
+  Msg::Error("Gmsh must be compiled with METIS support to partition meshes");
+  return 0;
+#endif
 }
 
 // Partition a mesh into n parts. Returns: 0 = success, 1 = error
@@ -2281,6 +2585,7 @@ int PartitionMesh(GModel *model, int numPart)
 
   // Assign partitions to elements
   hashmapelementpart elmToPartition;
+  elmToPartition.reserve(graph.ne());
   for(std::size_t i = 0; i < graph.ne(); i++) {
     if(graph.element(i)) {
       if(graph.nparts() > 1) {
@@ -2655,30 +2960,3 @@ int ConvertOldPartitioningToNewOne(GModel *model)
 
   return PartitionUsingThisSplit(model, elmToPartition);
 }
-
-#else
-
-int PartitionMesh(GModel *model, int numPart)
-{
-  Msg::Error("Gmsh must be compiled with METIS support to partition meshes");
-  return 0;
-}
-
-int UnpartitionMesh(GModel *model) { return 0; }
-
-int ConvertOldPartitioningToNewOne(GModel *model) { return 0; }
-
-int PartitionUsingThisSplit(
-  GModel *model, std::vector<std::pair<MElement *, int> > &elmToPartition)
-{
-  Msg::Error("Gmsh must be compiled with METIS support to partition meshes");
-  return 0;
-}
-
-int PartitionFaceMinEdgeLength(GFace *gf, int np, double tol)
-{
-  Msg::Error("Gmsh must be compiled with METIS support to partition meshes");
-  return 0;
-}
-
-#endif
@@ -102,6 +102,7 @@ static void Subdivide(GEdge *ge)
   // 2nd order meshing destroyed the ordering of the vertices on the edge
   std::sort(ge->mesh_vertices.begin(), ge->mesh_vertices.end(),
             MVertexPtrLessThanParam());
+  ge->invalidateMeshVertexStorage();
   for(std::size_t i = 0; i < ge->mesh_vertices.size(); i++)
     ge->mesh_vertices[i]->setPolynomialOrder(1);
   ge->correspondingVertices.insert(ge->correspondingHighOrderVertices.begin(),
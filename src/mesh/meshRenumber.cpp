@@ -0,0 +1,356 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#include <algorithm>
+#include <cstdint>
+#include "meshRenumber.h"
+#include "GEntity.h"
+#include "MVertex.h"
+#include "MElement.h"
+#include "SBoundingBox3d.h"
+#include "HilbertCurve.h"
+#include "GmshMessage.h"
+#include "Context.h"
+#include "OS.h"
+
+static int getNumThreads()
+{
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  return nthreads;
+}
+
+static void getElements(const std::vector<GEntity *> &entities,
+                        std::vector<MElement *> &elements)
+{
+  for(std::size_t i = 0; i < entities.size(); i++) {
+    GEntity *ge = entities[i];
+    for(std::size_t j = 0; j < ge->getNumMeshElements(); j++)
+      elements.push_back(ge->getMeshElement(j));
+  }
+}
+
+// Index the nodes by their position in vertices (using MVertex::setIndex),
+// and build the node to element map: the elements of node i are
+// ind[ptr[i]], ..., ind[ptr[i + 1] - 1], sorted by position in elements.
+// Nodes of the elements that are not in vertices are indexed with -1.
+static void getNodeToElements(const std::vector<MVertex *> &vertices,
+                              const std::vector<MElement *> &elements,
+                              std::vector<std::size_t> &ptr,
+                              std::vector<std::size_t> &ind, int nthreads)
+{
+  for(std::size_t i = 0; i < elements.size(); i++)
+    for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++)
+      elements[i]->getVertex(j)->setIndex(-1);
+  for(std::size_t i = 0; i < vertices.size(); i++) vertices[i]->setIndex(i);
+
+  ptr.assign(vertices.size() + 1, 0);
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++) {
+      const long int v = elements[i]->getVertex(j)->getIndex();
+      if(v < 0) continue;
+#pragma omp atomic
+      ptr[v + 1]++;
+    }
+  }
+  for(std::size_t i = 0; i < vertices.size(); i++) ptr[i + 1] += ptr[i];
+
+  ind.resize(ptr.back());
+  std::vector<std::size_t> next(ptr.begin(), ptr.end() - 1);
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < elements.size(); i++) {
+    for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++) {
+      const long int v = elements[i]->getVertex(j)->getIndex();
+      if(v < 0) continue;
+      std::size_t k;
+#pragma omp atomic capture
+      k = next[v]++;
+      ind[k] = i;
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t i = 0; i < vertices.size(); i++)
+    std::sort(ind.begin() + ptr[i], ind.begin() + ptr[i + 1]);
+}
+
+// Neighbors of node i in the node graph, i.e. the other nodes of its elements
+static void getNodeNeighbors(std::size_t i,
+                             const std::vector<MElement *> &elements,
+                             const std::vector<std::size_t> &ptr,
+                             const std::vector<std::size_t> &ind,
+                             std::vector<std::size_t> &neighbors)
+{
+  neighbors.clear();
+  for(std::size_t j = ptr[i]; j < ptr[i + 1]; j++) {
+    MElement *e = elements[ind[j]];
+    for(std::size_t k = 0; k < e->getNumVertices(); k++) {
+      const long int v = e->getVertex(k)->getIndex();
+      if(v >= 0 && v != (long int)i) neighbors.push_back(v);
+    }
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                  neighbors.end());
+}
+
+// Reverse Cuthill-McKee ordering of the node graph; the graph is built in
+// parallel, the breadth-first traversals are sequential
+static void sortRCM(std::vector<MVertex *> &vertices,
+                    const std::vector<MElement *> &elements, int nthreads)
+{
+  const std::size_t n = vertices.size();
+  std::vector<std::size_t> ptr, ind;
+  getNodeToElements(vertices, elements, ptr, ind, nthreads);
+
+  std::vector<std::size_t> xadj(n + 1, 0), adj;
+#pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<std::size_t> neighbors;
+#pragma omp for schedule(dynamic, 1024)
+    for(std::size_t i = 0; i < n; i++) {
+      getNodeNeighbors(i, elements, ptr, ind, neighbors);
+      xadj[i + 1] = neighbors.size();
+    }
+  }
+  for(std::size_t i = 0; i < n; i++) xadj[i + 1] += xadj[i];
+  adj.resize(xadj[n]);
+#pragma omp parallel num_threads(nthreads)
+  {
+    std::vector<std::size_t> neighbors;
+#pragma omp for schedule(dynamic, 1024)
+    for(std::size_t i = 0; i < n; i++) {
+      getNodeNeighbors(i, elements, ptr, ind, neighbors);
+      std::copy(neighbors.begin(), neighbors.end(), adj.begin() + xadj[i]);
+    }
+  }
+  ptr.clear();
+  ind.clear();
+
+  auto degree = [&](std::size_t i) { return xadj[i + 1] - xadj[i]; };
+  auto lessDegree = [&](std::size_t a, std::size_t b) {
+    if(degree(a) != degree(b)) return degree(a) < degree(b);
+    return a < b;
+  };
+
+  // breadth-first traversal from root, returning the eccentricity of root
+  // and a node of minimum degree in the last level
+  std::vector<long int> level(n, -1);
+  std::vector<std::size_t> queue;
+  auto levels = [&](std::size_t root, std::size_t &last) {
+    queue.clear();
+    queue.push_back(root);
+    level[root] = 0;
+    for(std::size_t i = 0; i < queue.size(); i++) {
+      const std::size_t v = queue[i];
+      for(std::size_t j = xadj[v]; j < xadj[v + 1]; j++) {
+        if(level[adj[j]] < 0) {
+          level[adj[j]] = level[v] + 1;
+          queue.push_back(adj[j]);
+        }
+      }
+    }
+    const long int eccentricity = level[queue.back()];
+    last = queue.back();
+    for(std::size_t i = 0; i < queue.size(); i++) {
+      if(level[queue[i]] == eccentricity && lessDegree(queue[i], last))
+        last = queue[i];
+    }
+    for(std::size_t i = 0; i < queue.size(); i++) level[queue[i]] = -1;
+    return eccentricity;
+  };
+
+  std::vector<std::size_t> order;
+  order.reserve(n);
+  std::vector<char> visited(n, 0);
+  std::vector<std::size_t> neighbors;
+  for(std::size_t s = 0; s < n; s++) {
+    if(visited[s]) continue;
+    // pseudo-peripheral starting node (George and Liu)
+    std::size_t root = s, last;
+    long int eccentricity = levels(root, last);
+    for(int iter = 0; iter < 10; iter++) {
+      std::size_t candidate = last;
+      const long int e = levels(candidate, last);
+      if(e <= eccentricity) break;
+      root = candidate;
+      eccentricity = e;
+    }
+    // Cuthill-McKee traversal, visiting neighbors by increasing degree
+    std::size_t first = order.size();
+    order.push_back(root);
+    visited[root] = 1;
+    for(std::size_t i = first; i < order.size(); i++) {
+      const std::size_t v = order[i];
+      neighbors.clear();
+      for(std::size_t j = xadj[v]; j < xadj[v + 1]; j++) {
+        if(!visited[adj[j]]) {
+          visited[adj[j]] = 1;
+          neighbors.push_back(adj[j]);
+        }
+      }
+      std::sort(neighbors.begin(), neighbors.end(), lessDegree);
+      order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+  }
+
+  std::vector<MVertex *> sorted(n);
+  for(std::size_t i = 0; i < n; i++) sorted[n - 1 - i] = vertices[order[i]];
+  vertices.swap(sorted);
+}
+
+// Breadth-first traversal of the element-to-node graph: elements are visited
+// through their nodes, nodes are numbered in the order in which they are
+// reached; nodes that do not belong to any element come last
+static void sortElementGraph(std::vector<MVertex *> *vertices,
+                             std::vector<MElement *> &elements, int nthreads)
+{
+  std::vector<MVertex *> allVertices;
+  if(!vertices) {
+    for(std::size_t i = 0; i < elements.size(); i++) {
+      for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++)
+        elements[i]->getVertex(j)->setIndex(-1);
+    }
+    for(std::size_t i = 0; i < elements.size(); i++) {
+      for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++) {
+        MVertex *v = elements[i]->getVertex(j);
+        if(v->getIndex() < 0) {
+          v->setIndex(0);
+          allVertices.push_back(v);
+        }
+      }
+    }
+    vertices = &allVertices;
+  }
+
+  const std::size_t n = vertices->size();
+  std::vector<std::size_t> ptr, ind;
+  getNodeToElements(*vertices, elements, ptr, ind, nthreads);
+
+  std::vector<std::size_t> elementOrder, vertexOrder;
+  elementOrder.reserve(elements.size());
+  vertexOrder.reserve(n);
+  std::vector<char> visited(elements.size(), 0), reached(n, 0);
+  for(std::size_t s = 0; s < elements.size(); s++) {
+    if(visited[s]) continue;
+    std::size_t first = elementOrder.size();
+    elementOrder.push_back(s);
+    visited[s] = 1;
+    for(std::size_t i = first; i < elementOrder.size(); i++) {
+      MElement *e = elements[elementOrder[i]];
+      for(std::size_t j = 0; j < e->getNumVertices(); j++) {
+        const long int v = e->getVertex(j)->getIndex();
+        if(v < 0 || reached[v]) continue;
+        reached[v] = 1;
+        vertexOrder.push_back(v);
+        for(std::size_t k = ptr[v]; k < ptr[v + 1]; k++) {
+          if(!visited[ind[k]]) {
+            visited[ind[k]] = 1;
+            elementOrder.push_back(ind[k]);
+          }
+        }
+      }
+    }
+  }
+  for(std::size_t i = 0; i < n; i++)
+    if(!reached[i]) vertexOrder.push_back(i);
+
+  if(vertices != &allVertices) {
+    std::vector<MVertex *> sorted(n);
+    for(std::size_t i = 0; i < n; i++) sorted[i] = (*vertices)[vertexOrder[i]];
+    vertices->swap(sorted);
+  }
+  else {
+    std::vector<MElement *> sorted(elements.size());
+    for(std::size_t i = 0; i < elements.size(); i++)
+      sorted[i] = elements[elementOrder[i]];
+    elements.swap(sorted);
+  }
+}
+
+// Sort objects by a 64 bit key computed in parallel
+template <class T, class KEY>
+static void sortByKey(std::vector<T *> &objects, KEY key, int nthreads)
+{
+  std::vector<std::pair<uint64_t, std::size_t> > keys(objects.size());
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < objects.size(); i++) {
+    keys[i].first = key(objects[i]);
+    keys[i].second = i;
+  }
+  SortCurveIndices(keys, nthreads);
+  std::vector<T *> sorted(objects.size());
+#pragma omp parallel for num_threads(nthreads)
+  for(std::size_t i = 0; i < objects.size(); i++)
+    sorted[i] = objects[keys[i].second];
+  objects.swap(sorted);
+}
+
+void SortMeshVertices(const std::vector<GEntity *> &entities, int algorithm,
+                      std::vector<MVertex *> &vertices)
+{
+  if(algorithm < 1 || algorithm > 3 || vertices.empty()) return;
+  const int nthreads = getNumThreads();
+  double t1 = Cpu(), w1 = TimeOfDay();
+
+  if(algorithm == 2) {
+    SBoundingBox3d bbox;
+    for(std::size_t i = 0; i < vertices.size(); i++)
+      bbox += vertices[i]->point();
+    sortByKey(
+      vertices,
+      [&](MVertex *v) { return HilbertIndex(v->point(), bbox); }, nthreads);
+  }
+  else {
+    std::vector<MElement *> elements;
+    getElements(entities, elements);
+    if(algorithm == 1)
+      sortRCM(vertices, elements, nthreads);
+    else
+      sortElementGraph(&vertices, elements, nthreads);
+  }
+
+  double t2 = Cpu(), w2 = TimeOfDay();
+  Msg::Debug("Sorted %lu nodes for renumbering (Wall %gs, CPU %gs)",
+             vertices.size(), w2 - w1, t2 - t1);
+}
+
+void SortMeshElements(const std::vector<GEntity *> &entities, int algorithm,
+                      std::vector<MElement *> &elements)
+{
+  if(algorithm < 1 || algorithm > 3 || elements.empty()) return;
+  const int nthreads = getNumThreads();
+  double t1 = Cpu(), w1 = TimeOfDay();
+
+  if(algorithm == 1) {
+    sortByKey(
+      elements,
+      [](MElement *e) {
+        std::size_t num = e->getVertex(0)->getNum();
+        for(std::size_t i = 1; i < e->getNumVertices(); i++)
+          num = std::min(num, e->getVertex(i)->getNum());
+        return (uint64_t)num;
+      },
+      nthreads);
+  }
+  else if(algorithm == 2) {
+    SBoundingBox3d bbox;
+    for(std::size_t i = 0; i < elements.size(); i++)
+      for(std::size_t j = 0; j < elements[i]->getNumVertices(); j++)
+        bbox += elements[i]->getVertex(j)->point();
+    sortByKey(
+      elements,
+      [&](MElement *e) { return HilbertIndex(e->barycenter(), bbox); },
+      nthreads);
+  }
+  else {
+    sortElementGraph(nullptr, elements, nthreads);
+  }
+
+  double t2 = Cpu(), w2 = TimeOfDay();
+  Msg::Debug("Sorted %lu elements for renumbering (Wall %gs, CPU %gs)",
+             elements.size(), w2 - w1, t2 - t1);
+}
@@ -0,0 +1,28 @@
+// Gmsh - Copyright (C) 1997-2023 C. Geuzaine, J.-F. Remacle
+//
+// See the LICENSE.txt file in the Gmsh root directory for license information.
+// Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
+
+#ifndef MESH_RENUMBER_H
+#define MESH_RENUMBER_H
+
+#include <vector>
+
+class GEntity;
+class MVertex;
+class MElement;
+
+// Sort the mesh nodes or the mesh elements of the given entities (provided in
+// the order of the entities) to improve locality when they are renumbered in
+// this order. The algorithm is that of Mesh.RenumberAlgorithm: 1: Reverse
+// Cuthill-McKee, 2: Hilbert curve, 3: element-to-node graph traversal
+// (elements are visited breadth-first through their nodes, and nodes are
+// numbered in the order in which they are reached). With Reverse
+// Cuthill-McKee, elements are sorted by their smallest node tag, i.e. they
+// follow the node numbering.
+void SortMeshVertices(const std::vector<GEntity *> &entities, int algorithm,
+                      std::vector<MVertex *> &vertices);
+void SortMeshElements(const std::vector<GEntity *> &entities, int algorithm,
+                      std::vector<MElement *> &elements);
+
+#endif
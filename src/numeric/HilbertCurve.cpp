@@ -3,8 +3,10 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include "SBoundingBox3d.h"
 #include "MVertex.h"
+#include "HilbertCurve.h"
 
 struct HilbertSort {
   // The code for generating table transgc
@@ -269,3 +271,85 @@ void SortHilbert(std::vector<MVertex *> &v)
   // HilbertSort h;
   h.Apply(v);
 }
+
+static const int curveBits = 21;
+
+static void curveCoordinates(const SPoint3 &p, const SBoundingBox3d &bbox,
+                             uint32_t X[3])
+{
+  const uint32_t n = (1u << curveBits) - 1;
+  for(int i = 0; i < 3; i++) {
+    const double l = bbox.max()[i] - bbox.min()[i];
+    double u = (l > 0.) ? (p[i] - bbox.min()[i]) / l : 0.;
+    u = std::min(std::max(u, 0.), 1.);
+    X[i] = (uint32_t)(u * n);
+  }
+}
+
+static uint64_t interleaveBits(const uint32_t X[3])
+{
+  uint64_t index = 0;
+  for(int b = curveBits - 1; b >= 0; b--)
+    for(int i = 0; i < 3; i++) index = (index << 1) | ((X[i] >> b) & 1);
+  return index;
+}
+
+// J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings
+// 707, 2004: the coordinates are transformed in place so that interleaving
+// their bits gives the Hilbert index
+uint64_t HilbertIndex(const SPoint3 &p, const SBoundingBox3d &bbox)
+{
+  uint32_t X[3];
+  curveCoordinates(p, bbox, X);
+  const uint32_t M = 1u << (curveBits - 1);
+  for(uint32_t Q = M; Q > 1; Q >>= 1) {
+    const uint32_t P = Q - 1;
+    for(int i = 0; i < 3; i++) {
+      if(X[i] & Q)
+        X[0] ^= P;
+      else {
+        const uint32_t t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  for(int i = 1; i < 3; i++) X[i] ^= X[i - 1];
+  uint32_t t = 0;
+  for(uint32_t Q = M; Q > 1; Q >>= 1)
+    if(X[2] & Q) t ^= Q - 1;
+  for(int i = 0; i < 3; i++) X[i] ^= t;
+  return interleaveBits(X);
+}
+
+uint64_t MortonIndex(const SPoint3 &p, const SBoundingBox3d &bbox)
+{
+  uint32_t X[3];
+  curveCoordinates(p, bbox, X);
+  return interleaveBits(X);
+}
+
+void SortCurveIndices(std::vector<std::pair<uint64_t, std::size_t> > &indices,
+                      int nthreads)
+{
+  // sort one chunk per thread, then merge the chunks pairwise
+  const std::size_t n = indices.size();
+  if(nthreads < 2 || n < 10000) {
+    std::sort(indices.begin(), indices.end());
+    return;
+  }
+  std::vector<std::size_t> bounds(nthreads + 1);
+  for(int i = 0; i <= nthreads; i++) bounds[i] = (n * i) / nthreads;
+#pragma omp parallel for num_threads(nthreads)
+  for(int i = 0; i < nthreads; i++)
+    std::sort(indices.begin() + bounds[i], indices.begin() + bounds[i + 1]);
+  for(int step = 1; step < nthreads; step *= 2) {
+#pragma omp parallel for num_threads(nthreads)
+    for(int i = 0; i < nthreads - step; i += 2 * step) {
+      const std::size_t end = bounds[std::min(i + 2 * step, nthreads)];
+      std::inplace_merge(indices.begin() + bounds[i],
+                         indices.begin() + bounds[i + step],
+                         indices.begin() + end);
+    }
+  }
+}
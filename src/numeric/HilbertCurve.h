@@ -6,6 +6,24 @@
 #ifndef HILBERT_CURVE
 #define HILBERT_CURVE
 
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+class MVertex;
+class SPoint3;
+class SBoundingBox3d;
+
 void SortHilbert(std::vector<MVertex *> &);
 
+// Index of the point p along the 3D Hilbert curve (or the Morton, i.e.
+// Z-order, curve) filling the box bbox, with 2^21 cells in each direction
+uint64_t HilbertIndex(const SPoint3 &p, const SBoundingBox3d &bbox);
+uint64_t MortonIndex(const SPoint3 &p, const SBoundingBox3d &bbox);
+
+// Sort (index, value) pairs using nthreads threads
+void SortCurveIndices(std::vector<std::pair<uint64_t, std::size_t> > &indices,
+                      int nthreads);
+
 #endif
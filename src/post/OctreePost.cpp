@@ -3,7 +3,6 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
-#include "Octree.h"
 #include "OctreePost.h"
 #include "PView.h"
 #include "PViewData.h"
@@ -58,70 +57,6 @@ static void minmax(int n, double *X, double *Y, double *Z, double *min,
   min[2] = bb.min().z();
 }
 
-static void centroid(int n, double *X, double *Y, double *Z, double *c)
-{
-  const double oc = 1. / (double)n;
-  c[0] = X[0];
-  c[1] = Y[0];
-  c[2] = Z[0];
-  for(int i = 1; i < n; i++) {
-    c[0] += X[i];
-    c[1] += Y[i];
-    c[2] += Z[i];
-  }
-  c[0] *= oc;
-  c[1] *= oc;
-  c[2] *= oc;
-}
-
-static void pntBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[1], *Z = &X[2];
-  minmax(1, X, Y, Z, min, max);
-}
-
-static void linBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[2], *Z = &X[4];
-  minmax(2, X, Y, Z, min, max);
-}
-
-static void triBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[3], *Z = &X[6];
-  minmax(3, X, Y, Z, min, max);
-}
-
-static void quaBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[4], *Z = &X[8];
-  minmax(4, X, Y, Z, min, max);
-}
-
-static void tetBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[4], *Z = &X[8];
-  minmax(4, X, Y, Z, min, max);
-}
-
-static void hexBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[8], *Z = &X[16];
-  minmax(8, X, Y, Z, min, max);
-}
-
-static void priBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[6], *Z = &X[12];
-  minmax(6, X, Y, Z, min, max);
-}
-
-static void pyrBB(void *a, double *min, double *max)
-{
-  double *X = (double *)a, *Y = &X[5], *Z = &X[10];
-  minmax(5, X, Y, Z, min, max);
-}
-
 static int pntInEle(void *a, double *x) { return 1; }
 
 static int linInEle(void *a, double *x)
@@ -180,89 +115,8 @@ static int pyrInEle(void *a, double *x)
   return pyr.isInside(uvw[0], uvw[1], uvw[2]);
 }
 
-static void pntCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[1], *Z = &X[2];
-  centroid(1, X, Y, Z, x);
-}
-
-static void linCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[2], *Z = &X[4];
-  centroid(2, X, Y, Z, x);
-}
-
-static void triCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[3], *Z = &X[6];
-  centroid(3, X, Y, Z, x);
-}
-
-static void quaCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[4], *Z = &X[8];
-  centroid(4, X, Y, Z, x);
-}
-
-static void tetCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[4], *Z = &X[8];
-  centroid(4, X, Y, Z, x);
-}
-
-static void hexCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[8], *Z = &X[16];
-  centroid(8, X, Y, Z, x);
-}
-
-static void priCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[6], *Z = &X[12];
-  centroid(6, X, Y, Z, x);
-}
-
-static void pyrCentroid(void *a, double *x)
-{
-  double *X = (double *)a, *Y = &X[5], *Z = &X[10];
-  centroid(5, X, Y, Z, x);
-}
-
-static void addListOfStuff(Octree *o, std::vector<double> &l, int nbelm)
-{
-  for(std::size_t i = 0; i < l.size(); i += nbelm) Octree_Insert(&l[i], o);
-}
-
 // OctreePost implementation
 
-OctreePost::~OctreePost()
-{
-  Octree_Delete(_sp);
-  Octree_Delete(_vp);
-  Octree_Delete(_tp);
-  Octree_Delete(_sl);
-  Octree_Delete(_vl);
-  Octree_Delete(_tl);
-  Octree_Delete(_st);
-  Octree_Delete(_vt);
-  Octree_Delete(_tt);
-  Octree_Delete(_sq);
-  Octree_Delete(_vq);
-  Octree_Delete(_tq);
-  Octree_Delete(_ss);
-  Octree_Delete(_vs);
-  Octree_Delete(_ts);
-  Octree_Delete(_sh);
-  Octree_Delete(_vh);
-  Octree_Delete(_th);
-  Octree_Delete(_si);
-  Octree_Delete(_vi);
-  Octree_Delete(_ti);
-  Octree_Delete(_sy);
-  Octree_Delete(_vy);
-  Octree_Delete(_ty);
-}
-
 OctreePost::OctreePost(PView *v)
 {
   _create(v->getData(true)); // use adaptive data if available
@@ -272,9 +126,6 @@ OctreePost::OctreePost(PViewData *data) { _create(data); }
 
 void OctreePost::_create(PViewData *data)
 {
-  _sp = _vp = _tp = _sl = _vl = _tl = _st = _vt = _tt = nullptr;
-  _sq = _vq = _tq = _ss = _vs = _ts = _sh = _vh = _th = nullptr;
-  _si = _vi = _ti = _sy = _vy = _ty = nullptr;
   _theViewDataList = nullptr;
   _theViewDataGModel = nullptr;
 
@@ -294,137 +145,66 @@ void OctreePost::_create(PViewData *data)
       return;
     }
 
-    SBoundingBox3d bb = l->getBoundingBox();
-
-    if(CTX::instance()->mesh.algo2d == ALGO_2D_PACK_PRLGRMS ||
-       CTX::instance()->mesh.algo2d == ALGO_2D_QUAD_QUASI_STRUCT) {
-      /* TODO FIXME: ugly temporary fix, but we need larger bbox for the
-       * guiding field sampling on curved surfaces, thicken is not sufficient */
-      bb *= 1.1;
-    }
-    else {
-      bb.thicken(0.01); // make 1% thicker
-    }
+    const int n = l->getNumTimeSteps();
+    _build(_sp, l->SP, 1, 3 + 1 * n, pntInEle);
+    _build(_vp, l->VP, 1, 3 + 3 * n, pntInEle);
+    _build(_tp, l->TP, 1, 3 + 9 * n, pntInEle);
+    _build(_sl, l->SL, 2, 6 + 2 * n, linInEle);
+    _build(_vl, l->VL, 2, 6 + 6 * n, linInEle);
+    _build(_tl, l->TL, 2, 6 + 18 * n, linInEle);
+    _build(_st, l->ST, 3, 9 + 3 * n, triInEle);
+    _build(_vt, l->VT, 3, 9 + 9 * n, triInEle);
+    _build(_tt, l->TT, 3, 9 + 27 * n, triInEle);
+    _build(_sq, l->SQ, 4, 12 + 4 * n, quaInEle);
+    _build(_vq, l->VQ, 4, 12 + 12 * n, quaInEle);
+    _build(_tq, l->TQ, 4, 12 + 36 * n, quaInEle);
+    _build(_ss, l->SS, 4, 12 + 4 * n, tetInEle);
+    _build(_vs, l->VS, 4, 12 + 12 * n, tetInEle);
+    _build(_ts, l->TS, 4, 12 + 36 * n, tetInEle);
+    _build(_sh, l->SH, 8, 24 + 8 * n, hexInEle);
+    _build(_vh, l->VH, 8, 24 + 24 * n, hexInEle);
+    _build(_th, l->TH, 8, 24 + 72 * n, hexInEle);
+    _build(_si, l->SI, 6, 18 + 6 * n, priInEle);
+    _build(_vi, l->VI, 6, 18 + 18 * n, priInEle);
+    _build(_ti, l->TI, 6, 18 + 54 * n, priInEle);
+    _build(_sy, l->SY, 5, 15 + 5 * n, pyrInEle);
+    _build(_vy, l->VY, 5, 15 + 15 * n, pyrInEle);
+    _build(_ty, l->TY, 5, 15 + 45 * n, pyrInEle);
+  }
+}
 
-    SPoint3 bbmin = bb.min(), bbmax = bb.max();
-    double min[3] = {bbmin.x(), bbmin.y(), bbmin.z()};
-    double size[3] = {bbmax.x() - bbmin.x(), bbmax.y() - bbmin.y(),
-                      bbmax.z() - bbmin.z()};
-    const int maxElePerBucket = 100; // memory vs. speed trade-off
-
-    _sp =
-      Octree_Create(maxElePerBucket, min, size, pntBB, pntCentroid, pntInEle);
-    addListOfStuff(_sp, l->SP, 3 + 1 * l->getNumTimeSteps());
-    Octree_Arrange(_sp);
-    _vp =
-      Octree_Create(maxElePerBucket, min, size, pntBB, pntCentroid, pntInEle);
-    addListOfStuff(_vp, l->VP, 3 + 3 * l->getNumTimeSteps());
-    Octree_Arrange(_vp);
-    _tp =
-      Octree_Create(maxElePerBucket, min, size, pntBB, pntCentroid, pntInEle);
-    addListOfStuff(_tp, l->TP, 3 + 9 * l->getNumTimeSteps());
-    Octree_Arrange(_tp);
-
-    _sl =
-      Octree_Create(maxElePerBucket, min, size, linBB, linCentroid, linInEle);
-    addListOfStuff(_sl, l->SL, 6 + 2 * l->getNumTimeSteps());
-    Octree_Arrange(_sl);
-    _vl =
-      Octree_Create(maxElePerBucket, min, size, linBB, linCentroid, linInEle);
-    addListOfStuff(_vl, l->VL, 6 + 6 * l->getNumTimeSteps());
-    Octree_Arrange(_vl);
-    _tl =
-      Octree_Create(maxElePerBucket, min, size, linBB, linCentroid, linInEle);
-    addListOfStuff(_tl, l->TL, 6 + 18 * l->getNumTimeSteps());
-    Octree_Arrange(_tl);
-
-    _st =
-      Octree_Create(maxElePerBucket, min, size, triBB, triCentroid, triInEle);
-    addListOfStuff(_st, l->ST, 9 + 3 * l->getNumTimeSteps());
-    Octree_Arrange(_st);
-    _vt =
-      Octree_Create(maxElePerBucket, min, size, triBB, triCentroid, triInEle);
-    addListOfStuff(_vt, l->VT, 9 + 9 * l->getNumTimeSteps());
-    Octree_Arrange(_vt);
-    _tt =
-      Octree_Create(maxElePerBucket, min, size, triBB, triCentroid, triInEle);
-    addListOfStuff(_tt, l->TT, 9 + 27 * l->getNumTimeSteps());
-    Octree_Arrange(_tt);
-
-    _sq =
-      Octree_Create(maxElePerBucket, min, size, quaBB, quaCentroid, quaInEle);
-    addListOfStuff(_sq, l->SQ, 12 + 4 * l->getNumTimeSteps());
-    Octree_Arrange(_sq);
-    _vq =
-      Octree_Create(maxElePerBucket, min, size, quaBB, quaCentroid, quaInEle);
-    addListOfStuff(_vq, l->VQ, 12 + 12 * l->getNumTimeSteps());
-    Octree_Arrange(_vq);
-    _tq =
-      Octree_Create(maxElePerBucket, min, size, quaBB, quaCentroid, quaInEle);
-    addListOfStuff(_tq, l->TQ, 12 + 36 * l->getNumTimeSteps());
-    Octree_Arrange(_tq);
-
-    _ss =
-      Octree_Create(maxElePerBucket, min, size, tetBB, tetCentroid, tetInEle);
-    addListOfStuff(_ss, l->SS, 12 + 4 * l->getNumTimeSteps());
-    Octree_Arrange(_ss);
-    _vs =
-      Octree_Create(maxElePerBucket, min, size, tetBB, tetCentroid, tetInEle);
-    addListOfStuff(_vs, l->VS, 12 + 12 * l->getNumTimeSteps());
-    Octree_Arrange(_vs);
-    _ts =
-      Octree_Create(maxElePerBucket, min, size, tetBB, tetCentroid, tetInEle);
-    addListOfStuff(_ts, l->TS, 12 + 36 * l->getNumTimeSteps());
-    Octree_Arrange(_ts);
-
-    _sh =
-      Octree_Create(maxElePerBucket, min, size, hexBB, hexCentroid, hexInEle);
-    addListOfStuff(_sh, l->SH, 24 + 8 * l->getNumTimeSteps());
-    Octree_Arrange(_sh);
-    _vh =
-      Octree_Create(maxElePerBucket, min, size, hexBB, hexCentroid, hexInEle);
-    addListOfStuff(_vh, l->VH, 24 + 24 * l->getNumTimeSteps());
-    Octree_Arrange(_vh);
-    _th =
-      Octree_Create(maxElePerBucket, min, size, hexBB, hexCentroid, hexInEle);
-    addListOfStuff(_th, l->TH, 24 + 72 * l->getNumTimeSteps());
-    Octree_Arrange(_th);
-
-    _si =
-      Octree_Create(maxElePerBucket, min, size, priBB, priCentroid, priInEle);
-    addListOfStuff(_si, l->SI, 18 + 6 * l->getNumTimeSteps());
-    Octree_Arrange(_si);
-    _vi =
-      Octree_Create(maxElePerBucket, min, size, priBB, priCentroid, priInEle);
-    addListOfStuff(_vi, l->VI, 18 + 18 * l->getNumTimeSteps());
-    Octree_Arrange(_vi);
-    _ti =
-      Octree_Create(maxElePerBucket, min, size, priBB, priCentroid, priInEle);
-    addListOfStuff(_ti, l->TI, 18 + 54 * l->getNumTimeSteps());
-    Octree_Arrange(_ti);
-
-    _sy =
-      Octree_Create(maxElePerBucket, min, size, pyrBB, pyrCentroid, pyrInEle);
-    addListOfStuff(_sy, l->SY, 15 + 5 * l->getNumTimeSteps());
-    Octree_Arrange(_sy);
-    _vy =
-      Octree_Create(maxElePerBucket, min, size, pyrBB, pyrCentroid, pyrInEle);
-    addListOfStuff(_vy, l->VY, 15 + 15 * l->getNumTimeSteps());
-    Octree_Arrange(_vy);
-    _ty =
-      Octree_Create(maxElePerBucket, min, size, pyrBB, pyrCentroid, pyrInEle);
-    addListOfStuff(_ty, l->TY, 15 + 45 * l->getNumTimeSteps());
-    Octree_Arrange(_ty);
+void OctreePost::_build(elementList &e, std::vector<double> &list, int nbNod,
+                        int stride, int (*inEle)(void *, double *))
+{
+  e.list = &list;
+  e.nbNod = nbNod;
+  e.stride = stride;
+  e.inEle = inEle;
+  std::size_t n = list.size() / stride;
+  if(!n) return;
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  std::vector<double> boxes(6 * n);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+  for(std::size_t i = 0; i < n; i++) {
+    double *X = &list[i * stride], *Y = &X[nbNod], *Z = &X[2 * nbNod];
+    minmax(nbNod, X, Y, Z, &boxes[6 * i], &boxes[6 * i + 3]);
   }
+  e.bvh.build(boxes, nthreads);
 }
 
-static void *getElement(double P[3], Octree *octree, int nbNod, int qn,
-                        double *qx, double *qy, double *qz)
+void *OctreePost::_getElement(double P[3], const elementList &e, int qn,
+                              double *qx, double *qy, double *qz) const
 {
+  if(e.bvh.empty()) return nullptr;
   if(qn && qx && qy && qz) {
     std::vector<void *> v;
-    Octree_SearchAll(P, octree, &v);
-    if(nbNod == qn) {
+    e.bvh.search(P, [&](std::size_t i) {
+      void *a = &(*e.list)[i * e.stride];
+      if(e.inEle(a, P)) v.push_back(a);
+      return false;
+    });
+    if(e.nbNod == qn) {
       // try to use the value from the same geometrical element as the one
       // provided in qx/y/z
       double eps = CTX::instance()->geom.tolerance;
@@ -439,11 +219,16 @@ static void *getElement(double P[3], Octree *octree, int nbNod, int qn,
       }
     }
     if(v.size()) return v[0];
+    return nullptr;
   }
-  else {
-    return Octree_Search(P, octree);
-  }
-  return nullptr;
+  void *found = nullptr;
+  e.bvh.search(P, [&](std::size_t i) {
+    void *a = &(*e.list)[i * e.stride];
+    if(!e.inEle(a, P)) return false;
+    found = a;
+    return true;
+  });
+  return found;
 }
 
 static MElement *getElement(double P[3], GModel *m, int qn, double *qx,
@@ -595,29 +380,37 @@ bool OctreePost::searchScalar(double x, double y, double z, double *values,
   }
 
   if(_theViewDataList) {
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _ss, 4, qn, qx, qy, qz),
-                                          3, 4, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _ss, qn, qx, qy, qz), 3, 4, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _sh, 8, qn, qx, qy, qz),
-                                          3, 8, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _sh, qn, qx, qy, qz), 3, 8, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _si, 6, qn, qx, qy, qz),
-                                          3, 6, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _si, qn, qx, qy, qz), 3, 6, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _sy, 5, qn, qx, qy, qz),
-                                          3, 5, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _sy, qn, qx, qy, qz), 3, 5, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _st, 3, qn, qx, qy, qz),
-                                          2, 3, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _st, qn, qx, qy, qz), 2, 3, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _sq, 4, qn, qx, qy, qz),
-                                          2, 4, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _sq, qn, qx, qy, qz), 2, 4, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 1) && _getValue(getElement(P, _sl, 2, qn, qx, qy, qz),
-                                          1, 2, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 1) &&
+       _getValue(_getElement(P, _sl, qn, qx, qy, qz), 1, 2, 1, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 0) && _getValue(getElement(P, _sp, 1, qn, qx, qy, qz),
-                                          0, 1, 1, P, step, values, size, grad))
+    if((dim < 0 || dim == 0) &&
+       _getValue(_getElement(P, _sp, qn, qx, qy, qz), 0, 1, 1, P, step,
+                 values, size, grad))
       return true;
   }
   else if(_theViewDataGModel) {
@@ -651,29 +444,37 @@ bool OctreePost::searchVector(double x, double y, double z, double *values,
   }
 
   if(_theViewDataList) {
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _vs, 4, qn, qx, qy, qz),
-                                          3, 4, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _vs, qn, qx, qy, qz), 3, 4, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _vh, 8, qn, qx, qy, qz),
-                                          3, 8, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _vh, qn, qx, qy, qz), 3, 8, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _vi, 6, qn, qx, qy, qz),
-                                          3, 6, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _vi, qn, qx, qy, qz), 3, 6, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _vy, 5, qn, qx, qy, qz),
-                                          3, 5, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _vy, qn, qx, qy, qz), 3, 5, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _vt, 3, qn, qx, qy, qz),
-                                          2, 3, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _vt, qn, qx, qy, qz), 2, 3, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _vq, 4, qn, qx, qy, qz),
-                                          2, 4, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _vq, qn, qx, qy, qz), 2, 4, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 1) && _getValue(getElement(P, _vl, 2, qn, qx, qy, qz),
-                                          1, 2, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 1) &&
+       _getValue(_getElement(P, _vl, qn, qx, qy, qz), 1, 2, 3, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 0) && _getValue(getElement(P, _vp, 1, qn, qx, qy, qz),
-                                          0, 1, 3, P, step, values, size, grad))
+    if((dim < 0 || dim == 0) &&
+       _getValue(_getElement(P, _vp, qn, qx, qy, qz), 0, 1, 3, P, step,
+                 values, size, grad))
       return true;
   }
   else if(_theViewDataGModel) {
@@ -707,29 +508,37 @@ bool OctreePost::searchTensor(double x, double y, double z, double *values,
   }
 
   if(_theViewDataList) {
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _ts, 4, qn, qx, qy, qz),
-                                          3, 4, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _ts, qn, qx, qy, qz), 3, 4, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _th, 8, qn, qx, qy, qz),
-                                          3, 8, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _th, qn, qx, qy, qz), 3, 8, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _ti, 6, qn, qx, qy, qz),
-                                          3, 6, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _ti, qn, qx, qy, qz), 3, 6, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 3) && _getValue(getElement(P, _ty, 5, qn, qx, qy, qz),
-                                          3, 5, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 3) &&
+       _getValue(_getElement(P, _ty, qn, qx, qy, qz), 3, 5, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _tt, 3, qn, qx, qy, qz),
-                                          2, 3, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _tt, qn, qx, qy, qz), 2, 3, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 2) && _getValue(getElement(P, _tq, 4, qn, qx, qy, qz),
-                                          2, 4, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 2) &&
+       _getValue(_getElement(P, _tq, qn, qx, qy, qz), 2, 4, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 1) && _getValue(getElement(P, _tl, 2, qn, qx, qy, qz),
-                                          1, 2, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 1) &&
+       _getValue(_getElement(P, _tl, qn, qx, qy, qz), 1, 2, 9, P, step,
+                 values, size, grad))
       return true;
-    if((dim < 0 || dim == 0) && _getValue(getElement(P, _tp, 1, qn, qx, qy, qz),
-                                          0, 1, 9, P, step, values, size, grad))
+    if((dim < 0 || dim == 0) &&
+       _getValue(_getElement(P, _tp, qn, qx, qy, qz), 0, 1, 9, P, step,
+                 values, size, grad))
       return true;
   }
   else if(_theViewDataGModel) {
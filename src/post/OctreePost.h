@@ -6,26 +6,43 @@
 #ifndef OCTREE_POST_H
 #define OCTREE_POST_H
 
-#include "Octree.h"
+#include <vector>
+#include "BoundingVolumeHierarchy.h"
 
 class PView;
 class PViewData;
 class PViewDataList;
 class PViewDataGModel;
 
+// Search structures for the elements of list-based views (the elements of
+// model-based views are searched in the mesh of the model); they can be
+// queried concurrently
 class OctreePost {
 private:
-  Octree *_sp, *_vp, *_tp;
-  Octree *_sl, *_vl, *_tl;
-  Octree *_st, *_vt, *_tt;
-  Octree *_sq, *_vq, *_tq;
-  Octree *_ss, *_vs, *_ts;
-  Octree *_sh, *_vh, *_th;
-  Octree *_si, *_vi, *_ti;
-  Octree *_sy, *_vy, *_ty;
+  // the elements of one list of a list-based view, stored every stride
+  // values, with their bounding volume hierarchy
+  struct elementList {
+    std::vector<double> *list;
+    int nbNod, stride;
+    int (*inEle)(void *, double *);
+    BoundingVolumeHierarchy bvh;
+    elementList() : list(nullptr), nbNod(0), stride(0), inEle(nullptr) {}
+  };
+  elementList _sp, _vp, _tp;
+  elementList _sl, _vl, _tl;
+  elementList _st, _vt, _tt;
+  elementList _sq, _vq, _tq;
+  elementList _ss, _vs, _ts;
+  elementList _sh, _vh, _th;
+  elementList _si, _vi, _ti;
+  elementList _sy, _vy, _ty;
   PViewDataList *_theViewDataList;
   PViewDataGModel *_theViewDataGModel;
   void _create(PViewData *data);
+  void _build(elementList &e, std::vector<double> &list, int nbNod,
+              int stride, int (*inEle)(void *, double *));
+  void *_getElement(double P[3], const elementList &e, int qn, double *qx,
+                    double *qy, double *qz) const;
   bool _getValue(void *in, int dim, int nbNod, int nbComp, double P[3],
                  int step, double *values, double *elementSize, bool grad);
   bool _getValue(void *in, int nbComp, double P[3], int step, double *values,
@@ -34,7 +51,6 @@ private:
 public:
   OctreePost(PView *v);
   OctreePost(PViewData *data);
-  ~OctreePost();
   // search for the value of the View at point x, y, z. Values are interpolated
   // using standard first order shape functions in the post element. If several
   // time steps are present, they are all interpolated unless time step is set
@@ -14,7 +14,7 @@ std::map<std::string, interpolationMatrices> PViewData::_interpolationSchemes;
 
 PViewData::PViewData()
   : _dirty(true), _fileIndex(0), _octree(nullptr), _pc2kdtree(_pc),
-    _kdtree(nullptr), _adaptive(nullptr)
+    _kdtree(nullptr), _kdtreeStep(-1), _adaptive(nullptr)
 {
 }
 
@@ -279,25 +279,11 @@ double PViewData::findClosestNode(double &xn, double &yn, double &zn, int step)
 
 #else
 
-#pragma omp critical
+  // the kdtree is normally built beforehand by initSearch(); if it is not,
+  // the first thread getting here builds it
   if(!_kdtree) {
-    Msg::Debug("Rebuilding kdtree for view data '%s'", _name.c_str());
-    _pc.pts.clear();
-    // FIXME: should directly iterate on mesh nodes for model-based views
-    if(step < 0) step = getFirstNonEmptyTimeStep();
-    for(int ent = 0; ent < getNumEntities(step); ent++) {
-      for(int ele = 0; ele < getNumElements(step, ent); ele++) {
-        int numNodes = getNumNodes(step, ent, ele);
-        for(int nod = 0; nod < numNodes; nod++) {
-          double xx, yy, zz;
-          getNode(step, ent, ele, nod, xx, yy, zz);
-          _pc.pts.push_back(SPoint3(xx, yy, zz));
-        }
-      }
-    }
-    _kdtree = new SPoint3KDTree(3, _pc2kdtree,
-                                nanoflann::KDTreeSingleIndexAdaptorParams(10));
-    _kdtree->buildIndex();
+#pragma omp critical(PViewDataKdtree)
+    if(!_kdtree) _buildKdtree(step);
   }
 
   double query_pt[3] = {x, y, z};
@@ -319,6 +305,45 @@ double PViewData::findClosestNode(double &xn, double &yn, double &zn, int step)
 #endif
 }
 
+void PViewData::_buildKdtree(int step)
+{
+  Msg::Debug("Rebuilding kdtree for view data '%s'", _name.c_str());
+  if(_kdtree) {
+    delete _kdtree;
+    _kdtree = nullptr;
+  }
+  _pc.pts.clear();
+  // FIXME: should directly iterate on mesh nodes for model-based views
+  if(step < 0) step = getFirstNonEmptyTimeStep();
+  for(int ent = 0; ent < getNumEntities(step); ent++) {
+    for(int ele = 0; ele < getNumElements(step, ent); ele++) {
+      int numNodes = getNumNodes(step, ent, ele);
+      for(int nod = 0; nod < numNodes; nod++) {
+        double xx, yy, zz;
+        getNode(step, ent, ele, nod, xx, yy, zz);
+        _pc.pts.push_back(SPoint3(xx, yy, zz));
+      }
+    }
+  }
+  SPoint3KDTree *kdtree = new SPoint3KDTree(
+    3, _pc2kdtree, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+  kdtree->buildIndex();
+  _kdtreeStep = step;
+  _kdtree = kdtree;
+}
+
+void PViewData::initSearch(int step, bool closestNode)
+{
+  if(!_octree) {
+    Msg::Debug("Rebuilding octree for view data '%s'", _name.c_str());
+    _octree = new OctreePost(this);
+  }
+  if(closestNode) {
+    if(step < 0) step = getFirstNonEmptyTimeStep();
+    if(!_kdtree || _kdtreeStep != step) _buildKdtree(step);
+  }
+}
+
 bool PViewData::searchScalar(double x, double y, double z, double *values,
                              int step, double *size, int qn, double *qx,
                              double *qy, double *qz, bool grad, int dim)
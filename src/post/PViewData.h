@@ -43,6 +43,9 @@ private:
   SPoint3Cloud _pc;
   SPoint3CloudAdaptor<SPoint3Cloud> _pc2kdtree;
   SPoint3KDTree *_kdtree;
+  // the time step of the nodes in the kdtree
+  int _kdtreeStep;
+  void _buildKdtree(int step);
 
 protected:
   // adaptive visualization data
@@ -66,6 +69,10 @@ public:
   virtual bool finalize(bool computeMinMax = true,
                         const std::string &interpolationScheme = "");
 
+  // make sure the data of a time step (of all the time steps if step < 0) is
+  // in memory, for data loaded on demand; this can unload other time steps
+  virtual void loadStep(int step) {}
+
   // get/set name
   virtual std::string getName() { return _name; }
   virtual void setName(const std::string &val) { _name = val; }
@@ -300,6 +307,11 @@ public:
   // a simple linear search - we might want to use a kdtree instead
   double findClosestNode(double &xn, double &yn, double &zn, int step);
 
+  // build the search structures used by the functions below if needed, so
+  // that they can then be called concurrently; if closestNode is set, also
+  // build the kdtree used by findClosestNode for the nodes of step
+  virtual void initSearch(int step = -1, bool closestNode = false);
+
   // search for the value of the View at point x, y, z. Values are interpolated
   // using standard first order shape functions in the post element. If several
   // time steps are present, they are all interpolated unless time step is set
@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <algorithm>
 #include "PView.h"
 #include "PViewDataGModel.h"
 #include "MPoint.h"
@@ -16,6 +17,7 @@
 #include "MElementCut.h"
 #include "Numeric.h"
 #include "GmshMessage.h"
+#include "Context.h"
 #include "pyramidalBasis.h"
 
 PViewDataGModel::PViewDataGModel(DataType type)
@@ -85,6 +87,36 @@ static MElement *_getOneElementOfGivenType(GModel *m, int type)
   return nullptr;
 }
 
+std::size_t PViewDataGModel::_useCounter = 0;
+
+void PViewDataGModel::_updateMinMax(int step,
+                                    const std::vector<std::size_t> *indices,
+                                    int tensorRep)
+{
+  stepData<double> *sd = _steps[step];
+  int numComp = sd->getNumComponents();
+  std::size_t n = indices ? indices->size() : sd->getNumData();
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  const std::size_t chunk = 65536;
+  const std::size_t numChunks = (n + chunk - 1) / chunk;
+  std::vector<double> mins(numChunks, VAL_INF), maxs(numChunks, -VAL_INF);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for(std::size_t c = 0; c < numChunks; c++) {
+    for(std::size_t i = c * chunk; i < std::min(n, (c + 1) * chunk); i++) {
+      double *d = sd->getData(indices ? (*indices)[i] : i);
+      if(!d) continue;
+      double val = ComputeScalarRep(numComp, d, tensorRep);
+      mins[c] = std::min(mins[c], val);
+      maxs[c] = std::max(maxs[c], val);
+    }
+  }
+  for(std::size_t c = 0; c < numChunks; c++) {
+    sd->setMin(std::min(sd->getMin(), mins[c]));
+    sd->setMax(std::max(sd->getMax(), maxs[c]));
+  }
+}
+
 bool PViewDataGModel::finalize(bool computeMinMax,
                                const std::string &interpolationScheme)
 {
@@ -93,19 +125,18 @@ bool PViewDataGModel::finalize(bool computeMinMax,
     _max = -VAL_INF;
     int tensorRep = 0; // Von-Mises: we could/should be able to choose this
     for(int step = 0; step < getNumTimeSteps(); step++) {
+      if(!_steps[step]->isLoaded()) {
+        // keep the min/max of the steps loaded on demand that are not in
+        // memory
+        _min = std::min(_min, _steps[step]->getMin());
+        _max = std::max(_max, _steps[step]->getMax());
+        continue;
+      }
       _steps[step]->setMin(VAL_INF);
       _steps[step]->setMax(-VAL_INF);
       if(_type == NodeData || _type == ElementData) {
         // treat these 2 special cases separately for maximum efficiency
-        int numComp = _steps[step]->getNumComponents();
-        for(std::size_t i = 0; i < _steps[step]->getNumData(); i++) {
-          double *d = _steps[step]->getData(i);
-          if(d) {
-            double val = ComputeScalarRep(numComp, d, tensorRep);
-            _steps[step]->setMin(std::min(_steps[step]->getMin(), val));
-            _steps[step]->setMax(std::max(_steps[step]->getMax(), val));
-          }
-        }
+        _updateMinMax(step, nullptr, tensorRep);
       }
       else {
         // general case (slower)
@@ -272,7 +303,7 @@ int PViewDataGModel::getNumTimeSteps() { return _steps.size(); }
 int PViewDataGModel::getFirstNonEmptyTimeStep(int start)
 {
   for(std::size_t i = start; i < _steps.size(); i++)
-    if(_steps[i]->getNumData()) return i;
+    if(_steps[i]->hasData()) return i;
   return start;
 }
 
@@ -305,6 +336,7 @@ double PViewDataGModel::getMin(int step, bool onlyVisible, int tensorRep,
   }
 
   if(step < 0) return _min;
+  _load(step);
   return _steps[step]->getMin();
 }
 
@@ -331,6 +363,7 @@ double PViewDataGModel::getMax(int step, bool onlyVisible, int tensorRep,
   }
 
   if(step < 0) return _max;
+  _load(step);
   return _steps[step]->getMax();
 }
 
@@ -347,6 +380,16 @@ SBoundingBox3d PViewDataGModel::getBoundingBox(int step)
   return _steps[step]->getBoundingBox();
 }
 
+void PViewDataGModel::initSearch(int step, bool closestNode)
+{
+  PViewData::initSearch(step, closestNode);
+  // the elements are searched in the mesh of the model(s)
+  for(std::size_t step = 0; step < _steps.size(); step++) {
+    GModel *m = _steps[step]->getModel();
+    if(m) m->buildMeshElementOctree();
+  }
+}
+
 int PViewDataGModel::getNumScalars(int step)
 {
   if(_steps.empty()) return 0;
@@ -601,6 +644,7 @@ int PViewDataGModel::getNumComponents(int step, int ent, int ele)
 
 int PViewDataGModel::getNumValues(int step, int ent, int ele)
 {
+  _load(step);
   if(_type == ElementNodeData) {
     MElement *e = _getElement(step, ent, ele);
     return _steps[step]->getMult(e->getNum()) *
@@ -620,6 +664,7 @@ int PViewDataGModel::getNumValues(int step, int ent, int ele)
 
 void PViewDataGModel::getValue(int step, int ent, int ele, int idx, double &val)
 {
+  _load(step);
   MElement *e = _getElement(step, ent, ele);
   if(_type == ElementNodeData || _type == ElementData) {
     val = _steps[step]->getData(e->getNum())[idx];
@@ -639,6 +684,7 @@ void PViewDataGModel::getValue(int step, int ent, int ele, int idx, double &val)
 void PViewDataGModel::getValue(int step, int ent, int ele, int nod, int comp,
                                double &val)
 {
+  _load(step);
   MElement *e = _getElement(step, ent, ele);
   switch(_type) {
   case NodeData: {
@@ -667,6 +713,9 @@ void PViewDataGModel::getValue(int step, int ent, int ele, int nod, int comp,
 void PViewDataGModel::setValue(int step, int ent, int ele, int nod, int comp,
                                double val)
 {
+  // the data no longer matches the file it was loaded from
+  _load(step);
+  _steps[step]->getFileBlocks().clear();
   MElement *e = _getElement(step, ent, ele);
   switch(_type) {
   case NodeData: {
@@ -813,6 +862,7 @@ bool PViewDataGModel::skipElement(int step, int ent, int ele,
                                   bool checkVisibility, int samplingRate)
 {
   if(step >= getNumTimeSteps()) return true;
+  _load(step);
   stepData<double> *sd = _steps[step];
   if(!_steps[step]->getNumData()) return true;
   MElement *e = _getElement(step, ent, ele);
@@ -829,11 +879,62 @@ bool PViewDataGModel::skipElement(int step, int ent, int ele,
 
 bool PViewDataGModel::hasTimeStep(int step)
 {
-  if(step >= 0 && step < getNumTimeSteps() && _steps[step]->getNumData())
+  if(step >= 0 && step < getNumTimeSteps() && _steps[step]->hasData())
     return true;
   return false;
 }
 
+void PViewDataGModel::loadStep(int step)
+{
+  std::vector<int> steps;
+  if(step < 0) {
+    for(int i = 0; i < getNumTimeSteps(); i++) steps.push_back(i);
+  }
+  else if(step < getNumTimeSteps()) {
+    steps.push_back(step);
+  }
+  for(std::size_t i = 0; i < steps.size(); i++) {
+    _load(steps[i]);
+    _steps[steps[i]]->setLastUse(++_useCounter);
+  }
+  _unloadSteps(steps);
+}
+
+void PViewDataGModel::_unloadSteps(const std::vector<int> &keep)
+{
+  double budget = CTX::instance()->post.lazyLoadingMemory;
+  if(!CTX::instance()->post.lazyLoading || budget <= 0.) return;
+  std::set<int> kept(keep.begin(), keep.end());
+  double mem = 0.;
+  std::vector<std::pair<std::size_t, stepData<double> *> > candidates;
+  for(std::size_t i = 0; i < PView::list.size(); i++) {
+    PViewDataGModel *d =
+      dynamic_cast<PViewDataGModel *>(PView::list[i]->getData());
+    if(!d) continue;
+    for(int step = 0; step < d->getNumTimeSteps(); step++) {
+      stepData<double> *sd = d->_steps[step];
+      // only the steps that can be read again from file count against the
+      // budget
+      if(!sd->getFileBlocks().size() || !sd->getNumData()) continue;
+      mem += sd->getMemoryInMb();
+      if(d != this || !kept.count(step))
+        candidates.push_back(std::make_pair(sd->getLastUse(), sd));
+    }
+  }
+  if(mem <= budget) return;
+  std::sort(candidates.begin(), candidates.end());
+  for(std::size_t i = 0; i < candidates.size() && mem > budget; i++) {
+    mem -= candidates[i].second->getMemoryInMb();
+    candidates[i].second->destroyData();
+  }
+  static bool first = true;
+  if(mem > budget && first) {
+    Msg::Warning("Post-processing data loaded on demand (%g Mb) exceeds "
+                 "the memory budget (%g Mb)", mem, budget);
+    first = false;
+  }
+}
+
 bool PViewDataGModel::hasPartition(int step, int part)
 {
   if(step < 0 || step >= getNumTimeSteps()) return false;
@@ -863,6 +964,7 @@ bool PViewDataGModel::hasModel(GModel *model, int step)
 bool PViewDataGModel::getValueByIndex(int step, int dataIndex, int nod,
                                       int comp, double &val)
 {
+  _load(step);
   double *d = _steps[step]->getData(dataIndex);
   if(!d) return false;
 
@@ -27,18 +27,23 @@ private:
   // the number of components in the data (one stepData contains only
   // a single field type)
   int _numComp;
-  // the values, indexed by MVertex or MElement id numbers (If the
-  // numbering is sparse, or if we only have data for high-id
-  // entities, the vector has zero entries and is thus not
-  // optimal. This is the price to pay if we want 1) rapid access to
-  // the data and 2) not to store any additional info in MVertex or
-  // MElement)
+  // the values, stored contiguously, and the offset in this array of the
+  // values of each MVertex or MElement id number (If the numbering is sparse,
+  // or if we only have data for high-id entities, the offset table has
+  // unused entries and is thus not optimal. This is the price to pay if we
+  // want 1) rapid access to the data and 2) not to store any additional info
+  // in MVertex or MElement)
   //
   // FIXME: we should change this design and store a vector<int> of tags, and do
   // indirect addressing, even if it's a bit slower...
-  std::vector<Real *> *_data;
+  std::vector<Real> _values;
+  std::vector<std::size_t> _offsets;
+  // the number of values no longer referenced by the offset table (after the
+  // data of an index has been replaced by data of a different size)
+  std::size_t _unused;
+  static const std::size_t _none = (std::size_t)-1;
   // a vector containing the multiplying factor allowing to compute
-  // the number of values stored in _data for each index (number of
+  // the number of values stored for each index (number of
   // values = getMult() * getNumComponents()). If _mult is empty, a
   // default value of "1" is assumed
   std::vector<int> _mult;
@@ -48,15 +53,30 @@ private:
   // a set of all "partitions" encountered in the data
   std::set<int> _partitions;
 
+public:
+  // the location of a block of data in a file
+  struct fileBlock {
+    std::string fileName;
+    std::size_t offset;
+    int numEnt;
+    bool binary, swap;
+  };
+
+private:
+  // the blocks of data of the step, if it is loaded on demand (the data can
+  // then be unloaded and read again), and the time of its last use
+  std::vector<fileBlock> _fileBlocks;
+  std::size_t _lastUse;
+
 public:
   stepData(GModel *model, int numComp, const std::string &fileName = "",
            int fileIndex = -1, double time = 0., double min = VAL_INF,
            double max = -VAL_INF)
     : _model(model), _fileName(fileName), _fileIndex(fileIndex), _time(time),
-      _min(min), _max(max), _numComp(numComp), _data(0)
+      _min(min), _max(max), _numComp(numComp), _unused(0), _lastUse(0)
   {
   }
-  stepData(stepData<Real> &other) : _data(0)
+  stepData(stepData<Real> &other)
   {
     _model = other._model;
     _entities = other._entities;
@@ -67,21 +87,14 @@ public:
     _min = other._min;
     _max = other._max;
     _numComp = other._numComp;
-    if(other._data) {
-      std::size_t n = other.getNumData();
-      _data = new std::vector<Real *>(n, (Real *)0);
-      for(std::size_t i = 0; i < n; i++) {
-        Real *d = other.getData(i);
-        if(d) {
-          int m = other.getMult(i) * _numComp;
-          (*_data)[i] = new Real[m];
-          for(int j = 0; j < m; j++) (*_data)[i][j] = d[j];
-        }
-      }
-    }
+    _values = other._values;
+    _offsets = other._offsets;
+    _unused = other._unused;
     _mult = other._mult;
     _gaussPoints = other._gaussPoints;
     _partitions = other._partitions;
+    _fileBlocks = other._fileBlocks;
+    _lastUse = other._lastUse;
   }
   ~stepData() { destroyData(); }
   void fillEntities() { _model->getEntities(_entities); }
@@ -106,48 +119,90 @@ public:
   void setMin(double min) { _min = min; }
   double getMax() { return _max; }
   void setMax(double max) { _max = max; }
-  std::size_t getNumData()
-  {
-    if(!_data) return 0;
-    return _data->size();
-  }
+  std::size_t getNumData() { return _offsets.size(); }
   void resizeData(int n)
   {
-    if(!_data) _data = new std::vector<Real *>(n, (Real *)0);
-    if(n > (int)_data->size()) _data->resize(n, (Real *)0);
+    if(n > (int)_offsets.size()) _offsets.resize(n, (std::size_t)_none);
   }
+  // reserve memory for n more values
+  void reserveData(std::size_t n) { _values.reserve(_values.size() + n); }
+  // get the values of an index, or allocate them (zero-initialized) if
+  // needed: the returned pointer is invalidated by the next allocation
   Real *getData(int index, bool allocIfNeeded = false, int mult = 1)
   {
     if(index < 0) return 0;
     if(allocIfNeeded) {
-      if(index >= (int)getNumData()) resizeData(index + 100); // optimize this
-      if(!(*_data)[index]) {
-        (*_data)[index] = new Real[_numComp * mult];
-        for(int i = 0; i < _numComp * mult; i++) (*_data)[index][i] = 0.;
-      }
-      if(mult > 1) {
-        if(index >= (int)_mult.size())
-          _mult.resize(index + 100, 1); // optimize this
-        _mult[index] = mult;
+      if(index >= (int)_offsets.size())
+        resizeData(std::max(index + 1, 2 * (int)_offsets.size()));
+      std::size_t &o = _offsets[index];
+      if(o == _none || getMult(index) != mult) {
+        if(o != _none) _unused += getMult(index) * _numComp;
+        o = _values.size();
+        _values.resize(o + _numComp * mult, 0.);
+        _setMult(index, mult);
       }
     }
     else {
-      if(index >= (int)getNumData()) return 0;
+      if(index >= (int)_offsets.size()) return 0;
     }
-    return (*_data)[index];
+    std::size_t o = _offsets[index];
+    return (o == _none) ? 0 : &_values[o];
   }
-  void destroyData()
+  // set the data of n indices at once: the data of indices[i] is made of
+  // size(i) values (a multiple of the number of components), which are
+  // written in parallel by copy(i, dest); if an index appears several times,
+  // its last data is kept
+  template <class S, class C>
+  void setData(const std::size_t *indices, std::size_t n, S size, C copy,
+               int nthreads)
   {
-    if(_data) {
-      for(unsigned int i = 0; i < _data->size(); i++)
-        if((*_data)[i]) delete[](*_data)[i];
-      delete _data;
-      _data = 0;
+    if(!n) return;
+    std::size_t imax = 0;
+    for(std::size_t i = 0; i < n; i++) imax = std::max(imax, indices[i]);
+    resizeData(imax + 1);
+    // mark the indices from the last one, to detect duplicates
+    const std::size_t mark = _none - 1;
+    std::vector<std::size_t> dest(n);
+    for(std::size_t i = n; i > 0; i--) {
+      std::size_t &o = _offsets[indices[i - 1]];
+      dest[i - 1] = (o == mark) ? mark : o;
+      o = mark;
+    }
+    // reuse the existing storage if it has the right size, and append the
+    // data of the other indices
+    std::size_t numValues = _values.size();
+    for(std::size_t i = 0; i < n; i++) {
+      if(dest[i] == mark) continue;
+      std::size_t index = indices[i];
+      int mult = (int)size(i) / _numComp;
+      if(dest[i] != _none && getMult(index) != mult) {
+        _unused += getMult(index) * _numComp;
+        dest[i] = _none;
+      }
+      if(dest[i] == _none) {
+        dest[i] = numValues;
+        numValues += _numComp * mult;
+        _setMult(index, mult);
+      }
+      _offsets[index] = dest[i];
     }
+    _values.resize(numValues);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for(std::size_t i = 0; i < n; i++) {
+      if(dest[i] != mark) copy(i, &_values[dest[i]]);
+    }
+    if(_unused > _values.size() / 2) _compact();
+  }
+  void destroyData()
+  {
+    std::vector<Real>().swap(_values);
+    std::vector<std::size_t>().swap(_offsets);
+    std::vector<int>().swap(_mult);
+    _unused = 0;
   }
   void renumberData(const std::map<int, int> &mapping)
   {
-    if(!_data) return;
+    if(_offsets.empty()) return;
     int imax = 0, imin = 0;
     for(auto m : mapping) {
       imax = std::max(imax, m.second);
@@ -157,11 +212,11 @@ public:
       Msg::Warning("Wrong destination index %d in step data renumbering", imin);
       return;
     }
-    std::vector<Real *> data2(imax + 1, nullptr);
+    std::vector<std::size_t> offsets2(imax + 1, (std::size_t)_none);
     std::vector<int> mult2(imax + 1, 1);
     for(auto m : mapping) {
-      if(m.first >= 0 && m.first < (int)_data->size()) {
-        data2[m.second] = (*_data)[m.first];
+      if(m.first >= 0 && m.first < (int)_offsets.size()) {
+        offsets2[m.second] = _offsets[m.first];
       }
       else {
         Msg::Warning("Wrong source index %d in step data renumbering", m.first);
@@ -170,8 +225,11 @@ public:
       if(m.first >= 0 && m.first < (int)_mult.size())
         mult2[m.second] = _mult[m.first];
     }
-    *_data = data2;
+    _offsets = offsets2;
     _mult = mult2;
+    _compact();
+    // the data no longer matches the file
+    _fileBlocks.clear();
   }
   std::vector<double> &getGaussPoints(int msh)
   {
@@ -179,11 +237,38 @@ public:
     return _gaussPoints[msh];
   }
   std::set<int> &getPartitions() { return _partitions; }
+  std::vector<fileBlock> &getFileBlocks() { return _fileBlocks; }
+  bool isLoaded() { return _fileBlocks.empty() || !_offsets.empty(); }
+  bool hasData() { return !_offsets.empty() || !_fileBlocks.empty(); }
+  std::size_t getLastUse() { return _lastUse; }
+  void setLastUse(std::size_t time) { _lastUse = time; }
   double getMemoryInMb()
   {
-    double b = 0.;
-    for(std::size_t i = 0; i < getNumData(); i++) b += getMult(i);
-    return b * getNumComponents() * sizeof(Real) / 1024. / 1024.;
+    return (_values.size() * sizeof(Real) +
+            _offsets.size() * sizeof(std::size_t)) /
+           1024. / 1024.;
+  }
+
+private:
+  void _setMult(int index, int mult)
+  {
+    if(mult == 1 && index >= (int)_mult.size()) return;
+    if(index >= (int)_mult.size()) _mult.resize(_offsets.size(), 1);
+    _mult[index] = mult;
+  }
+  // store the values in the order of the indices, without unused values
+  void _compact()
+  {
+    std::vector<Real> values;
+    values.reserve(_values.size() - std::min(_unused, _values.size()));
+    for(std::size_t i = 0; i < _offsets.size(); i++) {
+      if(_offsets[i] == _none) continue;
+      std::size_t o = _offsets[i], m = getMult(i) * _numComp;
+      _offsets[i] = values.size();
+      values.insert(values.end(), _values.begin() + o, _values.begin() + o + m);
+    }
+    _values.swap(values);
+    _unused = 0;
   }
 };
 
@@ -208,6 +293,32 @@ private:
   // cache last element to speed up loops
   MElement *_getElement(int step, int ent, int ele);
   MVertex *_getNode(MElement *e, int nod);
+  // store the data of the given tags in parallel; values(i) returns a pointer
+  // to the values of tags[i] and their number
+  template <class F>
+  void _setData(int step, const std::vector<std::size_t> &tags, int numComp,
+                F values);
+  // update the min/max of a NodeData or ElementData step with the data of the
+  // given indices (all the indices if none are given), in parallel
+  void _updateMinMax(int step, const std::vector<std::size_t> *indices = nullptr,
+                     int tensorRep = 0);
+  // read the data records of a step in an MSH file
+  bool _readMSHData(FILE *fp, bool binary, bool swap, int step, int numComp,
+                    int numEnt);
+  // read the data of a step loaded on demand, if it is not in memory (this
+  // does not unload other steps, so that it can be called when accessing the
+  // data)
+  bool _loadStep(int step);
+  void _load(int step)
+  {
+    if(!_steps[step]->isLoaded()) _loadStep(step);
+  }
+  // unload the least recently used steps loaded on demand of all the views,
+  // except the given steps of this view, until the memory used by the steps
+  // loaded on demand fits in the budget (does nothing without lazy loading)
+  void _unloadSteps(const std::vector<int> &keep);
+  // counter for the last use of the steps
+  static std::size_t _useCounter;
 
 public:
   PViewDataGModel(DataType type = NodeData);
@@ -264,12 +375,14 @@ public:
   bool skipElement(int step, int ent, int ele, bool checkVisibility = false,
                    int samplingRate = 1);
   bool hasTimeStep(int step);
+  void loadStep(int step);
   bool hasPartition(int step, int part);
   bool hasMultipleMeshes();
   bool hasModel(GModel *model, int step = -1);
   bool isNodeData() { return _type == NodeData; }
   bool useGaussPoints() { return _type == GaussPointData; }
   GModel *getModel(int step) { return _steps[step]->getModel(); }
+  void initSearch(int step = -1, bool closestNode = false);
   GEntity *getEntity(int step, int ent);
   MElement *getElement(int step, int entity, int element);
 
@@ -320,8 +433,9 @@ public:
   void importLists(int N[24], std::vector<double> *V[24]);
   stepData<double> *getStepData(int step)
   {
-    if(step >= 0 && step < (int)_steps.size()) return _steps[step];
-    return nullptr;
+    if(step < 0 || step >= (int)_steps.size()) return nullptr;
+    _load(step);
+    return _steps[step];
   }
   void sendToServer(const std::string &name);
 };
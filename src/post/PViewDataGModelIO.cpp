@@ -3,6 +3,7 @@
 // See the LICENSE.txt file in the Gmsh root directory for license information.
 // Please report all issues on https://gitlab.onelab.info/gmsh/gmsh/issues.
 
+#include <cstring>
 #include "GmshConfig.h"
 #include "GmshMessage.h"
 #include "PViewDataGModel.h"
@@ -16,6 +17,29 @@
 #include "CGNSCommon.h"
 #include "CGNSConventions.h"
 
+template <class F>
+void PViewDataGModel::_setData(int step, const std::vector<std::size_t> &tags,
+                               int numComp, F values)
+{
+  // the number of values stored for each tag is a multiple of the number of
+  // components, missing values being set to zero
+  _load(step);
+  _steps[step]->getFileBlocks().clear();
+  int nthreads = CTX::instance()->numThreads;
+  if(!nthreads) nthreads = Msg::GetMaxThreads();
+  auto size = [&values, numComp](std::size_t i) {
+    std::size_t mult = std::max((std::size_t)1, values(i).second / numComp);
+    return mult * numComp;
+  };
+  auto copy = [&values, &size](std::size_t i, double *d) {
+    std::pair<const double *, std::size_t> v = values(i);
+    std::size_t n = size(i), m = std::min(n, v.second);
+    std::copy(v.first, v.first + m, d);
+    std::fill(d + m, d + n, 0.);
+  };
+  _steps[step]->setData(tags.data(), tags.size(), size, copy, nthreads);
+}
+
 bool PViewDataGModel::addData(GModel *model,
                               const std::map<int, std::vector<double> > &data,
                               int step, double time, int partition, int numComp)
@@ -39,11 +63,18 @@ bool PViewDataGModel::addData(GModel *model,
                                      model->getNumMeshElements();
   _steps[step]->resizeData(numEnt);
 
+  std::vector<std::size_t> tags;
+  std::vector<const std::vector<double> *> values;
+  tags.reserve(data.size());
+  values.reserve(data.size());
   for(auto it = data.begin(); it != data.end(); it++) {
-    int mult = it->second.size() / numComp;
-    double *d = _steps[step]->getData(it->first, true, mult);
-    for(int j = 0; j < numComp * mult; j++) d[j] = it->second[j];
+    if(it->first < 0) continue;
+    tags.push_back(it->first);
+    values.push_back(&it->second);
   }
+  _setData(step, tags, numComp, [&values](std::size_t i) {
+    return std::make_pair(values[i]->data(), values[i]->size());
+  });
   if(partition >= 0) _steps[step]->getPartitions().insert(partition);
   finalize();
   return true;
@@ -77,11 +108,9 @@ bool PViewDataGModel::addData(GModel *model,
                                      model->getNumMeshElements();
   _steps[step]->resizeData(numEnt);
 
-  for(std::size_t i = 0; i < data.size(); i++) {
-    int mult = data[i].size() / numComp;
-    double *d = _steps[step]->getData(tags[i], true, mult);
-    for(int j = 0; j < numComp * mult; j++) d[j] = data[i][j];
-  }
+  _setData(step, tags, numComp, [&data](std::size_t i) {
+    return std::make_pair(data[i].data(), data[i].size());
+  });
   if(partition >= 0) _steps[step]->getPartitions().insert(partition);
   finalize();
   return true;
@@ -116,12 +145,9 @@ bool PViewDataGModel::addData(GModel *model,
                                      model->getNumMeshElements();
   _steps[step]->resizeData(numEnt);
 
-  int mult = stride / numComp;
-  for(std::size_t i = 0; i < tags.size(); i++) {
-    double *d = _steps[step]->getData(tags[i], true, mult);
-    int k = i * stride;
-    for(std::size_t j = 0; j < stride; j++) d[j] = data[k + j];
-  }
+  _setData(step, tags, numComp, [&data, stride](std::size_t i) {
+    return std::make_pair(&data[i * stride], stride);
+  });
   if(partition >= 0) _steps[step]->getPartitions().insert(partition);
   finalize();
   return true;
@@ -158,8 +184,124 @@ bool PViewDataGModel::readMSH(const std::string &viewName,
   if(numSteps > maxSteps) return true;
   */
 
+  stepData<double> *sd = _steps[step];
+  if(CTX::instance()->post.lazyLoading && (sd->getFileBlocks().size() ||
+                                           !sd->getNumData())) {
+    // only record the location of the data, and skip it
+    stepData<double>::fileBlock b;
+    b.fileName = fileName;
+    b.offset = GetFilePosition(fp);
+    b.numEnt = numEnt;
+    b.binary = binary;
+    b.swap = swap;
+    if(sd->isLoaded() && sd->getNumData()) {
+      // the step is in memory: read the data as well
+      if(!_readMSHData(fp, binary, swap, step, numComp, numEnt)) return false;
+    }
+    else if(binary && (_type == NodeData || _type == ElementData)) {
+      std::size_t recSize = sizeof(int) + numComp * sizeof(double);
+      if(!SetFilePosition(fp, b.offset + numEnt * recSize)) return false;
+    }
+    else if(binary) {
+      for(int i = 0; i < numEnt; i++) {
+        int rec[2];
+        if(fread(rec, sizeof(int), 2, fp) != 2) return false;
+        if(swap) SwapBytes((char *)rec, sizeof(int), 2);
+        if(rec[1] < 0 ||
+           fseek(fp, (long)rec[1] * numComp * sizeof(double), SEEK_CUR))
+          return false;
+      }
+    }
+    // (ASCII data is skipped by the caller, up to the end of the section)
+    sd->getFileBlocks().push_back(b);
+  }
+  else if(!_readMSHData(fp, binary, swap, step, numComp, numEnt)) {
+    return false;
+  }
+  if(partition >= 0) sd->getPartitions().insert(partition);
+
+  finalize(false, interpolationScheme);
+  return true;
+}
+
+bool PViewDataGModel::_loadStep(int step)
+{
+  bool ok = true;
+#pragma omp critical(PViewDataGModelLoadStep)
+  {
+    stepData<double> *sd = _steps[step];
+    if(!sd->isLoaded()) {
+      std::vector<stepData<double>::fileBlock> &blocks = sd->getFileBlocks();
+      Msg::Info("Loading time step %d of view '%s'", step, getName().c_str());
+      for(std::size_t i = 0; i < blocks.size() && ok; i++) {
+        FILE *fp = Fopen(blocks[i].fileName.c_str(), "rb");
+        if(!fp) {
+          Msg::Error("Unable to open file '%s'", blocks[i].fileName.c_str());
+          ok = false;
+          break;
+        }
+        ok = SetFilePosition(fp, blocks[i].offset) &&
+             _readMSHData(fp, blocks[i].binary, blocks[i].swap, step,
+                          sd->getNumComponents(), blocks[i].numEnt);
+        fclose(fp);
+      }
+      if(!ok) {
+        Msg::Error("Could not read data of time step %d in msh file", step);
+        // do not try again
+        blocks.clear();
+      }
+      sd->setLastUse(++_useCounter);
+    }
+  }
+  return ok;
+}
+
+bool PViewDataGModel::_readMSHData(FILE *fp, bool binary, bool swap, int step,
+                                   int numComp, int numEnt)
+{
   _steps[step]->resizeData(numEnt);
 
+  if(binary && (_type == NodeData || _type == ElementData)) {
+    // the records have a fixed size: read them by blocks, store their values
+    // and compute their min/max in parallel
+    int nthreads = CTX::instance()->numThreads;
+    if(!nthreads) nthreads = Msg::GetMaxThreads();
+    const std::size_t recSize = sizeof(int) + numComp * sizeof(double);
+    const std::size_t blockSize = 65536;
+    std::vector<char> buf;
+    std::vector<std::size_t> tags;
+    _steps[step]->reserveData((std::size_t)numEnt * numComp);
+    Msg::StartProgressMeter(numEnt);
+    for(std::size_t first = 0; first < (std::size_t)numEnt;
+        first += blockSize) {
+      std::size_t n = std::min(blockSize, (std::size_t)numEnt - first);
+      buf.resize(n * recSize);
+      if(fread(&buf[0], recSize, n, fp) != n) return false;
+      tags.resize(n);
+      for(std::size_t i = 0; i < n; i++) {
+        int num;
+        memcpy(&num, &buf[i * recSize], sizeof(int));
+        if(swap) SwapBytes((char *)&num, sizeof(int), 1);
+        if(num < 0) return false;
+        tags[i] = num;
+      }
+      _steps[step]->setData(
+        tags.data(), n, [numComp](std::size_t) { return numComp; },
+        [&buf, recSize, numComp, swap](std::size_t i, double *d) {
+          memcpy(d, &buf[i * recSize + sizeof(int)], numComp * sizeof(double));
+          if(swap) SwapBytes((char *)d, sizeof(double), numComp);
+        },
+        nthreads);
+      _updateMinMax(step, &tags);
+      if(numEnt > 100000)
+        Msg::ProgressMeter(first + n, true, "Reading data");
+    }
+    Msg::StopProgressMeter();
+    _min = std::min(_min, _steps[step]->getMin());
+    _max = std::max(_max, _steps[step]->getMax());
+    return true;
+  }
+
   Msg::StartProgressMeter(numEnt);
   for(int i = 0; i < numEnt; i++) {
     int num;
@@ -206,9 +348,6 @@ bool PViewDataGModel::readMSH(const std::string &viewName,
     if(numEnt > 100000) Msg::ProgressMeter(i + 1, true, "Reading data");
   }
   Msg::StopProgressMeter();
-  if(partition >= 0) _steps[step]->getPartitions().insert(partition);
-
-  finalize(false, interpolationScheme);
   return true;
 }
 
@@ -237,6 +376,7 @@ bool PViewDataGModel::writeMSH(const std::string &fileName, double version,
   int numFile = 0;
 
   for(std::size_t step = 0; step < _steps.size(); step++) {
+    loadStep(step);
     int numEnt = 0, numComp = _steps[step]->getNumComponents();
     for(std::size_t i = 0; i < _steps[step]->getNumData(); i++)
       if(_steps[step]->getData(i)) numEnt++;
@@ -995,6 +1135,7 @@ bool PViewDataGModel::writeMED(const std::string &fileName)
   // compute profile
   char *profileName = (char *)"nodeProfile";
   std::vector<med_int> profile, indices;
+  loadStep(0);
   for(std::size_t i = 0; i < _steps[0]->getNumData(); i++) {
     if(_steps[0]->getData(i)) {
       MVertex *v = _steps[0]->getModel()->getMeshVertexByTag(i);
@@ -1049,6 +1190,7 @@ bool PViewDataGModel::writeMED(const std::string &fileName)
     return false;
   }
   for(std::size_t step = 0; step < _steps.size(); step++) {
+    loadStep(step);
     std::size_t n = 0;
     for(std::size_t i = 0; i < _steps[step]->getNumData(); i++)
       if(_steps[step]->getData(i)) n++;
@@ -1124,6 +1266,8 @@ void PViewDataGModel::sendToServer(const std::string &name)
     return;
   }
 
+  loadStep(-1);
+
   int numEnt = 0, numComp = 0;
   for(std::size_t step = 0; step < _steps.size(); step++) {
     int nc = _steps[step]->getNumComponents();
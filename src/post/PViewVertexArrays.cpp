@@ -1533,6 +1533,9 @@ public:
       return false;
     }
 
+    // load the displayed step if needed
+    p->getData()->loadStep(opt->timeStep);
+
     if(opt->useGenRaise) opt->createGeneralRaise();
 
     if(opt->rangeType == PViewOptions::Custom) {